@@ -0,0 +1,154 @@
+#include "chessArena.h"
+
+#include <stdlib.h>
+
+// ------------------ DEFINES ---------------- //
+
+/**
+ * The first chunk only holds a tournament and its empty game list, so a small
+ * tournament costs little more than the baseline mallocs did.
+ * Later chunks are sized from the allocation that needed them and grow geometrically.
+ * */
+#define FIRST_CHUNK_SIZE 192
+#define MAX_CHUNK_SIZE (64 * 1024)
+
+typedef union chess_max_align_t {
+    void* pointer;
+    long long integer;
+    double floating;
+} MaxAlign;
+
+#define ALIGN(size) (((size) + sizeof(MaxAlign) - 1) / sizeof(MaxAlign) * sizeof(MaxAlign))
+
+typedef struct chess_arena_chunk_t {
+    struct chess_arena_chunk_t* next; // the previous (older) chunk
+    size_t size;                      // usable bytes in this chunk
+    size_t used;
+} *Chunk;
+
+struct chess_arena_t {
+    Chunk chunks;           // the newest chunk, where allocations are made
+    size_t next_chunk_size; // chunks grow geometrically up to MAX_CHUNK_SIZE
+};
+
+// the first chunk lives in the same malloc as the arena itself
+#define ARENA_HEADER_SIZE ALIGN(sizeof(struct chess_arena_t))
+#define CHUNK_HEADER_SIZE ALIGN(sizeof(struct chess_arena_chunk_t))
+#define CHUNK_DATA(chunk) ((char*)(chunk) + CHUNK_HEADER_SIZE)
+
+// ------------------ FUNCTIONS DECLARATIONS ---------------- //
+
+static Chunk addChunk(Arena arena, size_t min_size);
+static void freeChunksUntil(Chunk chunk, Chunk last);
+
+// ------------------ FUNCTIONS IMPLEMENTATION ---------------- //
+
+Arena arenaCreate(void)
+{
+    Arena arena = (Arena)malloc(ARENA_HEADER_SIZE + CHUNK_HEADER_SIZE + FIRST_CHUNK_SIZE);
+    if (arena == NULL)
+    {
+        return NULL;
+    }
+    Chunk first = (Chunk)((char*)arena + ARENA_HEADER_SIZE);
+    first->next = NULL;
+    first->size = FIRST_CHUNK_SIZE;
+    first->used = 0;
+
+    arena->chunks = first;
+    arena->next_chunk_size = 2 * FIRST_CHUNK_SIZE;
+    return arena;
+}
+
+void* arenaAlloc(Arena arena, size_t size)
+{
+    size = ALIGN(size);
+    Chunk chunk = arena->chunks;
+    if (chunk->size - chunk->used < size)
+    {
+        chunk = addChunk(arena, size);
+        if (chunk == NULL)
+        {
+            return NULL;
+        }
+    }
+    void* memory = CHUNK_DATA(chunk) + chunk->used;
+    chunk->used += size;
+    return memory;
+}
+
+ArenaMark arenaGetMark(Arena arena)
+{
+    ArenaMark mark = { arena->chunks, arena->chunks->used };
+    return mark;
+}
+
+void* arenaRewind(Arena arena, ArenaMark mark, size_t size)
+{
+    size = ALIGN(size);
+    Chunk mark_chunk = (Chunk)mark.chunk;
+    if (mark_chunk->size - mark.used >= size)
+    {
+        freeChunksUntil(arena->chunks, mark_chunk);
+        arena->chunks = mark_chunk;
+        mark_chunk->used = mark.used + size;
+        return CHUNK_DATA(mark_chunk) + mark.used;
+    }
+
+    Chunk chunk = (Chunk)malloc(CHUNK_HEADER_SIZE + size);
+    if (chunk == NULL)
+    {
+        return NULL;
+    }
+    freeChunksUntil(arena->chunks, mark_chunk);
+    mark_chunk->used = mark.used;
+    chunk->next = mark_chunk;
+    chunk->size = size;
+    chunk->used = size;
+    arena->chunks = chunk;
+    return CHUNK_DATA(chunk);
+}
+
+void arenaDestroy(Arena arena)
+{
+    if (arena == NULL)
+    {
+        return;
+    }
+    // the last chunk is the first one, freed with the arena
+    freeChunksUntil(arena->chunks, (Chunk)((char*)arena + ARENA_HEADER_SIZE));
+    free(arena);
+}
+
+/**
+ * Add a new chunk with at least min_size free bytes and make it the current chunk.
+ * */
+static Chunk addChunk(Arena arena, size_t min_size)
+{
+    size_t size = arena->next_chunk_size > min_size ? arena->next_chunk_size : min_size;
+    Chunk chunk = (Chunk)malloc(CHUNK_HEADER_SIZE + size);
+    if (chunk == NULL)
+    {
+        return NULL;
+    }
+    chunk->next = arena->chunks;
+    chunk->size = size;
+    chunk->used = 0;
+
+    arena->chunks = chunk;
+    arena->next_chunk_size = size < MAX_CHUNK_SIZE / 2 ? 2 * size : MAX_CHUNK_SIZE;
+    return chunk;
+}
+
+/**
+ * Free the chunks from chunk (newest) up to, but not including, last.
+ * */
+static void freeChunksUntil(Chunk chunk, Chunk last)
+{
+    while (chunk != last)
+    {
+        Chunk next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#ifndef _CHESSARENA_H_
+#define _CHESSARENA_H_
+
+#include <stddef.h>
+
+typedef struct chess_arena_t *Arena;
+
+/**
+ * A position inside an arena, see arenaGetMark and arenaRewind.
+ * */
+typedef struct chess_arena_mark_t {
+    void* chunk;
+    size_t used;
+} ArenaMark;
+
+/**
+ * Create an empty memory region.
+ * Memory taken from an arena can't be freed one piece at a time,
+ * it is all released together by arenaDestroy.
+ * Return NULL if malloc failed.
+ * */
+Arena arenaCreate(void);
+
+/**
+ * Return size bytes from the arena, aligned for any basic type.
+ * Return NULL if malloc failed.
+ * */
+void* arenaAlloc(Arena arena, size_t size);
+
+/**
+ * Return the current position of the arena.
+ * */
+ArenaMark arenaGetMark(Arena arena);
+
+/**
+ * Release everything allocated after mark, and return size new bytes allocated right after it.
+ * The new memory is obtained before anything is released, so if malloc fails
+ * the arena is left untouched and NULL is returned.
+ * NOTE: the returned memory may overlap the released allocations.
+ * */
+void* arenaRewind(Arena arena, ArenaMark mark, size_t size);
+
+/**
+ * Release all the memory of the arena at once, including the arena itself.
+ * Costs one free per chunk of the arena, regardless of how many allocations were made.
+ * */
+void arenaDestroy(Arena arena);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,162 @@
+#define _POSIX_C_SOURCE 200809L // fork, waitpid, fileno
+
+#include "chessSystemExt.h"
+#include "chessSystemPrivate.h"
+#include "chessLocks.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+// ------------------ DEFINES ---------------- //
+
+#define NO_PROCESS 0
+
+struct chess_save_t {
+    pid_t writer;       // the process writing the file, or NO_PROCESS once its result is known
+    ChessResult result;
+};
+
+typedef enum {
+    SAVE_STATISTICS,
+    SAVE_LEVELS
+} SaveType;
+
+// ------------------ FUNCTIONS DECLARATIONS ---------------- //
+
+static ChessSave startSave(ChessSystem chess, SaveType type, char* path_file, FILE* file, ChessResult* result);
+static ChessResult saveNow(ChessSystem chess, SaveType type, char* path_file, FILE* file);
+static void reapWriter(ChessSave save, bool wait);
+
+// ------------------ FUNCTIONS IMPLEMENTATION ---------------- //
+
+ChessSave chessSaveTournamentStatisticsAsync(ChessSystem chess, char* path_file, ChessResult* result)
+{
+    return startSave(chess, SAVE_STATISTICS, path_file, NULL, result);
+}
+
+ChessSave chessSavePlayersLevelsAsync(ChessSystem chess, FILE* file, ChessResult* result)
+{
+    return startSave(chess, SAVE_LEVELS, NULL, file, result);
+}
+
+bool chessSavePoll(ChessSave save)
+{
+    if (save == NULL)
+    {
+        return true;
+    }
+    reapWriter(save, false);
+    return save->writer == NO_PROCESS;
+}
+
+ChessResult chessSaveWait(ChessSave save)
+{
+    if (save == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    reapWriter(save, true);
+    ChessResult result = save->result;
+    free(save);
+    return result;
+}
+
+static ChessSave startSave(ChessSystem chess, SaveType type, char* path_file, FILE* file, ChessResult* result)
+{
+    if (chess == NULL || (type == SAVE_LEVELS && file == NULL))
+    {
+        if (result != NULL)
+        {
+            *result = CHESS_NULL_ARGUMENT;
+        }
+        return NULL;
+    }
+    ChessSave handle = (ChessSave)malloc(sizeof(*handle));
+    if (handle == NULL)
+    {
+        if (result != NULL)
+        {
+            *result = CHESS_OUT_OF_MEMORY;
+        }
+        return NULL;
+    }
+    handle->writer = NO_PROCESS;
+    if (result != NULL)
+    {
+        *result = CHESS_SUCCESS;
+    }
+
+    // a stream without a file (a memory stream) can only be written by this process
+    if (type == SAVE_LEVELS && fileno(file) < 0)
+    {
+        handle->result = saveNow(chess, type, path_file, file);
+        return handle;
+    }
+
+    // what was written to the stream before must not be written by both processes
+    if (file != NULL)
+    {
+        fflush(file);
+    }
+    // the child sees the system as it is now, while the parent goes on changing it.
+    // no other thread may be in the middle of a change when the system is copied.
+    lockSystem(chess->locks, true);
+    // the games the child would update may be stored in files it shares with the parent
+    removalsApplyAll(chess->removals, chess->players, chess->tournaments);
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        // the child has a single thread, and the locks, the versions, the trace, the pool and the feed are the parent's
+        chess->locks = NULL;
+        chess->versions = NULL;
+        chess->trace = NULL;
+        chess->pool = NULL;
+        chess->feed = NULL;
+        _exit(saveNow(chess, type, path_file, file));
+    }
+    unlockSystem(chess->locks);
+    if (pid < 0)
+    {
+        handle->result = saveNow(chess, type, path_file, file);
+        return handle;
+    }
+    handle->writer = pid;
+    return handle;
+}
+
+static ChessResult saveNow(ChessSystem chess, SaveType type, char* path_file, FILE* file)
+{
+    if (type == SAVE_STATISTICS)
+    {
+        return chessSaveTournamentStatistics(chess, path_file);
+    }
+    return chessSavePlayersLevels(chess, file);
+}
+
+/**
+ * Check whether the writer is over, waiting for it if wait is true.
+ * Its exit status is the result of the save.
+ * */
+static void reapWriter(ChessSave save, bool wait)
+{
+    if (save->writer == NO_PROCESS)
+    {
+        return;
+    }
+    int status;
+    pid_t pid = waitpid(save->writer, &status, wait ? 0 : WNOHANG);
+    while (pid < 0 && errno == EINTR)
+    {
+        pid = waitpid(save->writer, &status, wait ? 0 : WNOHANG);
+    }
+    if (pid == 0) // still running
+    {
+        return;
+    }
+    save->result = pid == save->writer && WIFEXITED(status) ? (ChessResult)WEXITSTATUS(status) : CHESS_SAVE_FAILURE;
+    save->writer = NO_PROCESS;
+}
@@ -0,0 +1,186 @@
+#include "chessBitmap.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// ------------------ DEFINES ---------------- //
+
+#define BITS_PER_WORD 64
+#define WORDS_PER_PAGE 4
+#define IDS_PER_PAGE (BITS_PER_WORD * WORDS_PER_PAGE)
+#define INITIAL_CAPACITY 4
+
+typedef struct chess_bitmap_page_t {
+    int first_id;                              // a multiple of IDS_PER_PAGE
+    unsigned long long words[WORDS_PER_PAGE];
+} Page;
+
+struct chess_bitmap_t {
+    Page* pages;  // sorted by first_id
+    int size;
+    int capacity;
+};
+
+// ------------------ FUNCTIONS DECLARATIONS ---------------- //
+
+static int findPage(Bitmap bitmap, int first_id);
+static bool isPageEmpty(const Page* page);
+
+// ------------------ FUNCTIONS IMPLEMENTATION ---------------- //
+
+Bitmap bitmapCreate(void)
+{
+    Bitmap bitmap = (Bitmap)malloc(sizeof(*bitmap));
+    if (bitmap == NULL)
+    {
+        return NULL;
+    }
+    bitmap->pages = NULL;
+    bitmap->size = 0;
+    bitmap->capacity = 0;
+    return bitmap;
+}
+
+void bitmapDestroy(Bitmap bitmap)
+{
+    if (bitmap == NULL)
+    {
+        return;
+    }
+    free(bitmap->pages);
+    free(bitmap);
+}
+
+bool bitmapSet(Bitmap bitmap, int id)
+{
+    int first_id = id - id % IDS_PER_PAGE;
+    int index = findPage(bitmap, first_id);
+    if (index == bitmap->size || bitmap->pages[index].first_id != first_id)
+    {
+        if (bitmap->size == bitmap->capacity)
+        {
+            int new_capacity = bitmap->capacity ? 2 * bitmap->capacity : INITIAL_CAPACITY;
+            Page* new_pages = (Page*)realloc(bitmap->pages, sizeof(Page) * new_capacity);
+            if (new_pages == NULL)
+            {
+                return false;
+            }
+            bitmap->pages = new_pages;
+            bitmap->capacity = new_capacity;
+        }
+        memmove(&bitmap->pages[index + 1], &bitmap->pages[index], sizeof(Page) * (bitmap->size - index));
+        memset(&bitmap->pages[index], 0, sizeof(Page));
+        bitmap->pages[index].first_id = first_id;
+        bitmap->size++;
+    }
+
+    int bit = id % IDS_PER_PAGE;
+    bitmap->pages[index].words[bit / BITS_PER_WORD] |= 1ULL << (bit % BITS_PER_WORD);
+    return true;
+}
+
+void bitmapClear(Bitmap bitmap, int id)
+{
+    int first_id = id - id % IDS_PER_PAGE;
+    int index = findPage(bitmap, first_id);
+    if (index < bitmap->size && bitmap->pages[index].first_id == first_id)
+    {
+        // atomic, since threads adding games to different tournaments clear ids of the same word
+        int bit = id % IDS_PER_PAGE;
+        __atomic_fetch_and(&bitmap->pages[index].words[bit / BITS_PER_WORD],
+                           ~(1ULL << (bit % BITS_PER_WORD)), __ATOMIC_RELAXED);
+    }
+}
+
+bool bitmapGet(Bitmap bitmap, int id)
+{
+    int first_id = id - id % IDS_PER_PAGE;
+    int index = findPage(bitmap, first_id);
+    if (index == bitmap->size || bitmap->pages[index].first_id != first_id)
+    {
+        return false;
+    }
+    int bit = id % IDS_PER_PAGE;
+    unsigned long long word = __atomic_load_n(&bitmap->pages[index].words[bit / BITS_PER_WORD], __ATOMIC_RELAXED);
+    return (word >> (bit % BITS_PER_WORD)) & 1;
+}
+
+int bitmapGetNext(Bitmap bitmap, int id)
+{
+    int index = findPage(bitmap, id - id % IDS_PER_PAGE);
+    for (; index < bitmap->size; index++)
+    {
+        const Page* page = &bitmap->pages[index];
+        int first_bit = id > page->first_id ? id - page->first_id : 0;
+        for (int bit = first_bit; bit < IDS_PER_PAGE; bit++)
+        {
+            if ((page->words[bit / BITS_PER_WORD] >> (bit % BITS_PER_WORD)) & 1)
+            {
+                return page->first_id + bit;
+            }
+        }
+    }
+    return -1;
+}
+
+void bitmapCompact(Bitmap bitmap)
+{
+    int size = 0;
+    for (int i = 0; i < bitmap->size; i++)
+    {
+        if (!isPageEmpty(&bitmap->pages[i]))
+        {
+            bitmap->pages[size++] = bitmap->pages[i];
+        }
+    }
+    bitmap->size = size;
+
+    if (size == 0)
+    {
+        free(bitmap->pages);
+        bitmap->pages = NULL;
+        bitmap->capacity = 0;
+        return;
+    }
+    Page* new_pages = (Page*)realloc(bitmap->pages, sizeof(Page) * size);
+    if (new_pages != NULL) // if realloc failed the old (bigger) array is still fine
+    {
+        bitmap->pages = new_pages;
+        bitmap->capacity = size;
+    }
+}
+
+/**
+ * Binary search for the page that starts at first_id.
+ * Return its index, or the index where it should be inserted.
+ * */
+static int findPage(Bitmap bitmap, int first_id)
+{
+    int low = 0;
+    int high = bitmap->size;
+    while (low < high)
+    {
+        int middle = low + (high - low) / 2;
+        if (bitmap->pages[middle].first_id < first_id)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+static bool isPageEmpty(const Page* page)
+{
+    for (int i = 0; i < WORDS_PER_PAGE; i++)
+    {
+        if (page->words[i] != 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
\ No newline at end of file
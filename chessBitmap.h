@@ -0,0 +1,45 @@
+#ifndef _CHESSBITMAP_H_
+#define _CHESSBITMAP_H_
+
+#include <stdbool.h>
+
+/**
+ * A set of non-negative ids, one bit per id.
+ * Bits are kept in small pages sorted by id, and only pages with a set bit
+ * take memory, so sparse ids stay compact.
+ * */
+typedef struct chess_bitmap_t *Bitmap;
+
+/**
+ * Create an empty bitmap. Return NULL if malloc failed.
+ * */
+Bitmap bitmapCreate(void);
+
+void bitmapDestroy(Bitmap bitmap);
+
+/**
+ * Add id to the bitmap.
+ * Return false if malloc failed (and then the bitmap is left untouched).
+ * */
+bool bitmapSet(Bitmap bitmap, int id);
+
+/**
+ * Remove id from the bitmap. Its page is released by bitmapCompact once it becomes empty.
+ * May be called by several threads at once, and along with bitmapGet.
+ * */
+void bitmapClear(Bitmap bitmap, int id);
+
+bool bitmapGet(Bitmap bitmap, int id);
+
+/**
+ * Return the smallest id in the bitmap that is >= id, or -1 if there is none.
+ * Used to go over all the ids: for (id = bitmapGetNext(b, 0); id >= 0; id = bitmapGetNext(b, id + 1))
+ * */
+int bitmapGetNext(Bitmap bitmap, int id);
+
+/**
+ * Release empty pages and unused capacity.
+ * */
+void bitmapCompact(Bitmap bitmap);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,294 @@
+#include "chessSystemExt.h"
+#include "chessSystemPrivate.h"
+#include "chessTournament.h"
+#include "chessPlayer.h"
+#include "chessGame.h"
+#include "mapExt.h"
+
+#include <stdlib.h>
+
+// ------------------ DEFINES ---------------- //
+
+#define NO_KEY 0 // ids are positive, so every key is after it
+
+struct chess_games_cursor_t {
+    ChessSystem chess;
+    int tournament_id;
+    unsigned long serial;  // of the tournament it was opened on, see tournamentGetSerial
+    bool frozen;           // whether the games were frozen when iterator was last used
+    GameIterator iterator;
+};
+
+/**
+ * The players and tournaments cursors resume after the last key they returned.
+ * */
+typedef struct chess_map_cursor_t {
+    ChessSystem chess;
+    int last_key;
+    bool done;
+} MapCursor;
+
+struct chess_players_cursor_t {
+    MapCursor position;
+};
+
+struct chess_tournaments_cursor_t {
+    MapCursor position;
+};
+
+/**
+ * Copy the element of key into rows[index]. chess is there for the rows that need more
+ * than the element, like the location of a tournament.
+ * Return false if the element is not returned by the cursor.
+ * */
+typedef bool (*FillRow)(ChessSystem chess, int key, MapDataElement data, void* rows, int index);
+
+// ------------------ FUNCTIONS DECLARATIONS ---------------- //
+
+static void setResult(ChessResult* result, ChessResult value);
+static void mapCursorInit(MapCursor* cursor, ChessSystem chess);
+static int mapCursorNext(MapCursor* cursor, Map map, FillRow fill, void* rows, int capacity);
+static bool fillPlayerRow(ChessSystem chess, int key, MapDataElement data, void* rows, int index);
+static bool fillTournamentRow(ChessSystem chess, int key, MapDataElement data, void* rows, int index);
+static Winner getWinner(const GameRecord* game);
+
+// ------------------ FUNCTIONS IMPLEMENTATION ---------------- //
+
+ChessGamesCursor chessGamesCursorOpen(ChessSystem chess, int tournament_id, ChessResult* result)
+{
+    if (chess == NULL)
+    {
+        setResult(result, CHESS_NULL_ARGUMENT);
+        return NULL;
+    }
+    if (tournament_id <= 0)
+    {
+        setResult(result, CHESS_INVALID_ID);
+        return NULL;
+    }
+    Tournament tournament = mapGet(chess->tournaments, &tournament_id);
+    if (tournament == NULL)
+    {
+        setResult(result, CHESS_TOURNAMENT_NOT_EXIST);
+        return NULL;
+    }
+    ChessGamesCursor cursor = (ChessGamesCursor)malloc(sizeof(*cursor));
+    if (cursor == NULL)
+    {
+        setResult(result, CHESS_OUT_OF_MEMORY);
+        return NULL;
+    }
+    cursor->chess = chess;
+    cursor->tournament_id = tournament_id;
+    cursor->serial = tournamentGetSerial(tournament);
+    cursor->frozen = gameListIsFrozen(tournamentGetGames(tournament));
+    gameIteratorInit(&cursor->iterator);
+    setResult(result, CHESS_SUCCESS);
+    return cursor;
+}
+
+int chessGamesCursorNext(ChessGamesCursor cursor, ChessGameRow* rows, int capacity)
+{
+    if (cursor == NULL || rows == NULL)
+    {
+        return 0;
+    }
+    ChessSystem chess = cursor->chess;
+    Tournament tournament = mapGet(chess->tournaments, &cursor->tournament_id);
+    // a tournament added again with the same id is another one, its games are not read by the iterator
+    if (tournament == NULL || tournamentGetSerial(tournament) != cursor->serial)
+    {
+        return 0;
+    }
+    removalsApplyToTournament(chess->removals, chess->players, chess->tournaments, cursor->tournament_id);
+    GameList games = tournamentGetGames(tournament);
+    if (gameListIsFrozen(games) != cursor->frozen)
+    {
+        // the tournament ended since the last batch. an iterator over the frozen list
+        // has to find its position by reading it from the start, once.
+        int index = cursor->iterator.index;
+        gameIteratorInit(&cursor->iterator);
+        while (cursor->iterator.index < index)
+        {
+            if (!gameIteratorNext(games, &cursor->iterator))
+            {
+                break;
+            }
+        }
+        cursor->frozen = !cursor->frozen;
+    }
+
+    int count = 0;
+    while (count < capacity && gameIteratorNext(games, &cursor->iterator))
+    {
+        const GameRecord* game = &cursor->iterator.game;
+        rows[count].tournament_id = cursor->tournament_id;
+        rows[count].first_player = game->player1_id;
+        rows[count].second_player = game->player2_id;
+        rows[count].winner = getWinner(game);
+        rows[count].play_time = game->length;
+        count++;
+    }
+    return count;
+}
+
+void chessGamesCursorClose(ChessGamesCursor cursor)
+{
+    free(cursor);
+}
+
+ChessPlayersCursor chessPlayersCursorOpen(ChessSystem chess, ChessResult* result)
+{
+    if (chess == NULL)
+    {
+        setResult(result, CHESS_NULL_ARGUMENT);
+        return NULL;
+    }
+    ChessPlayersCursor cursor = (ChessPlayersCursor)malloc(sizeof(*cursor));
+    if (cursor == NULL)
+    {
+        setResult(result, CHESS_OUT_OF_MEMORY);
+        return NULL;
+    }
+    mapCursorInit(&cursor->position, chess);
+    setResult(result, CHESS_SUCCESS);
+    return cursor;
+}
+
+int chessPlayersCursorNext(ChessPlayersCursor cursor, ChessPlayerStats* rows, int capacity)
+{
+    if (cursor == NULL || rows == NULL)
+    {
+        return 0;
+    }
+    ChessSystem chess = cursor->position.chess;
+    removalsApplyAll(chess->removals, chess->players, chess->tournaments);
+    return mapCursorNext(&cursor->position, chess->players, fillPlayerRow, rows, capacity);
+}
+
+void chessPlayersCursorClose(ChessPlayersCursor cursor)
+{
+    free(cursor);
+}
+
+ChessTournamentsCursor chessTournamentsCursorOpen(ChessSystem chess, ChessResult* result)
+{
+    if (chess == NULL)
+    {
+        setResult(result, CHESS_NULL_ARGUMENT);
+        return NULL;
+    }
+    ChessTournamentsCursor cursor = (ChessTournamentsCursor)malloc(sizeof(*cursor));
+    if (cursor == NULL)
+    {
+        setResult(result, CHESS_OUT_OF_MEMORY);
+        return NULL;
+    }
+    mapCursorInit(&cursor->position, chess);
+    setResult(result, CHESS_SUCCESS);
+    return cursor;
+}
+
+int chessTournamentsCursorNext(ChessTournamentsCursor cursor, ChessTournamentRow* rows, int capacity)
+{
+    if (cursor == NULL || rows == NULL)
+    {
+        return 0;
+    }
+    return mapCursorNext(&cursor->position, cursor->position.chess->tournaments, fillTournamentRow, rows, capacity);
+}
+
+void chessTournamentsCursorClose(ChessTournamentsCursor cursor)
+{
+    free(cursor);
+}
+
+static void setResult(ChessResult* result, ChessResult value)
+{
+    if (result != NULL)
+    {
+        *result = value;
+    }
+}
+
+static void mapCursorInit(MapCursor* cursor, ChessSystem chess)
+{
+    cursor->chess = chess;
+    cursor->last_key = NO_KEY;
+    cursor->done = false;
+}
+
+/**
+ * Fill up to capacity rows with the elements of map whose keys are after the last key returned.
+ * The map is sorted by key, so the walk starts right after that key and stops as soon as the batch is full.
+ * */
+static int mapCursorNext(MapCursor* cursor, Map map, FillRow fill, void* rows, int capacity)
+{
+    if (cursor->done || capacity <= 0)
+    {
+        return 0;
+    }
+    int count = 0;
+    bool full = false;
+    MAP_FOREACH_AFTER(int*, key, map, &cursor->last_key)
+    {
+        if (fill(cursor->chess, *key, mapGetCurrentData(map), rows, count))
+        {
+            cursor->last_key = *key;
+            full = ++count == capacity;
+        }
+        if (full)
+        {
+            break;
+        }
+    }
+    // a batch that ended without filling up reached the end of the map
+    cursor->done = !full;
+    return count;
+}
+
+static bool fillPlayerRow(ChessSystem chess, int key, MapDataElement data, void* rows, int index)
+{
+    (void)chess; // a player row needs nothing outside the player
+    Player player = data;
+    if (!playerExists(player)) // kept only until chessCompact, see chessGetPlayersStats
+    {
+        return false;
+    }
+    ChessPlayerStats* stats = (ChessPlayerStats*)rows + index;
+    stats->player_id = key;
+    stats->result = CHESS_SUCCESS;
+    stats->average_play_time = playerGetAveragePlayTime(player);
+    stats->level = playerGetLevel(player);
+    stats->wins = playerGetNumOfWins(player);
+    stats->losses = playerGetNumOfLoses(player);
+    stats->draws = playerGetNumOfDraws(player);
+    return true;
+}
+
+static bool fillTournamentRow(ChessSystem chess, int key, MapDataElement data, void* rows, int index)
+{
+    Tournament tournament = data;
+    TournamentSummary summary;
+    tournamentGetSummary(tournament, &summary);
+    ChessTournamentRow* row = (ChessTournamentRow*)rows + index;
+    row->tournament_id = key;
+    row->location = locationGet(chess->locations, summary.location_id);
+    row->max_games_per_player = summary.max_games_per_player;
+    row->ended = tournamentHasEnded(tournament);
+    row->winner_id = summary.winners_id;
+    row->num_of_games = summary.num_of_games;
+    row->num_of_players = summary.num_of_players;
+    row->longest_game_time = summary.longest_game_time;
+    row->average_game_time = summary.average_game_time;
+    return true;
+}
+
+static Winner getWinner(const GameRecord* game)
+{
+    if (game->winners_id == GAME_DRAW)
+    {
+        return DRAW;
+    }
+    return game->winners_id == game->player1_id ? FIRST_PLAYER : SECOND_PLAYER;
+}
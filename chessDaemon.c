@@ -0,0 +1,704 @@
+#define _POSIX_C_SOURCE 200809L // sockets, poll, sigaction, open_memstream
+
+/**
+ * chessd: hosts one system and serves the requests of local clients over a Unix domain socket,
+ * in the protocol of chessProtocol.h, so they don't have to build the system again for every call.
+ *
+ * Every client is served by one thread, in turns: a turn runs at most REQUESTS_PER_TURN requests of
+ * a client, so a client that sends a large batch doesn't hold back the others, and the responses of
+ * a turn are sent at once. A client is read again only once the requests it sent were run, and isn't
+ * served while it leaves too many responses unread. The statistics are saved by a child process
+ * (see chessSaveTournamentStatisticsAsync): only the client that asked for them waits for the save.
+ *
+ * usage: chessd socket [snapshot] [workers]
+ * A socket file already at that path is replaced, any other file makes chessd exit.
+ * The system is loaded from the snapshot if the file exists, and saved to it once chessd is stopped
+ * (by SIGINT or SIGTERM). workers are the threads of the bulk operations (see chessCreateWithOptions).
+ * Exits with 0 once stopped, 1 if it could not start or the snapshot could not be saved.
+ * */
+
+#include "chessSystemExt.h"
+#include "chessProtocol.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+// ------------------ DEFINES ---------------- //
+
+#define REQUESTS_PER_TURN 64
+#define RECEIVE_SIZE (1 << 16)
+#define MAX_UNREAD_OUTPUT (1 << 22) // responses a client may leave unread and still be served
+#define SAVE_POLL_MILLISECONDS 1
+#define LISTEN_BACKLOG 128
+#define INITIAL_CAPACITY 16
+#define WORD_SIZE 4
+#define DOUBLE_SIZE 8
+#define RESULT_SIZE 1
+#define PLAYER_STATS_SIZE (WORD_SIZE + RESULT_SIZE + 2 * DOUBLE_SIZE + 3 * WORD_SIZE)
+#define MAX_ARGS 5
+
+typedef struct buffer_t {
+    unsigned char* bytes;
+    size_t start; // what was already consumed
+    size_t size;
+    size_t capacity;
+} Buffer;
+
+typedef struct client_t {
+    int socket;          // -1 once closed, while its save still runs
+    Buffer input;
+    Buffer output;
+    ChessSave save;      // the save its next response waits for, NULL if none
+    unsigned long save_id;
+} Client;
+
+typedef struct daemon_t {
+    ChessSystem chess;
+    int listener;
+    Client* clients;
+    struct pollfd* polled; // the listener, then the clients
+    int num_of_clients;
+    int capacity;
+} Daemon;
+
+static volatile sig_atomic_t stopping = 0;
+
+// ------------------ FUNCTIONS DECLARATIONS ---------------- //
+
+static ChessSystem createSystem(const char* snapshot, const ChessSystemOptions* options);
+static int openListener(const char* path);
+static void stop(int signal_number);
+static void serveClients(Daemon* daemon);
+static void acceptClients(Daemon* daemon);
+static void removeClosedClients(Daemon* daemon, bool wait);
+static bool receiveRequests(Client* client);
+static bool hasRequest(const Client* client);
+static bool serveRequests(ChessSystem chess, Client* client);
+static bool runRequest(ChessSystem chess, Client* client, unsigned long id, int command,
+                       const unsigned char* body, size_t size);
+static bool runTextRequest(ChessSystem chess, Client* client, unsigned long id, int command,
+                           const unsigned char* body, size_t size);
+static bool savePlayersLevels(ChessSystem chess, Buffer* output, unsigned long id);
+static bool getPlayersStats(ChessSystem chess, Buffer* output, unsigned long id, const int* ids, int n);
+static bool endTournaments(ChessSystem chess, Buffer* output, unsigned long id, const int* ids, int n);
+static bool finishSave(Client* client);
+static bool sendResponses(Client* client);
+static unsigned char* appendResponse(Buffer* output, unsigned long id, ChessResult result, size_t size);
+static bool reserve(Buffer* buffer, size_t size);
+static int* readWords(const unsigned char* bytes, int n);
+static void putWord(unsigned char* bytes, unsigned long value);
+static unsigned long getWord(const unsigned char* bytes);
+static void putDouble(unsigned char* bytes, double value);
+
+// ------------------ FUNCTIONS IMPLEMENTATION ---------------- //
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s socket [snapshot] [workers]\n", argv[0]);
+        return 1;
+    }
+    const char* snapshot = argc > 2 ? argv[2] : NULL;
+    ChessSystemOptions options = { argc > 3 ? atoi(argv[3]) : 0 };
+    ChessSystem chess = createSystem(snapshot, &options);
+    if (chess == NULL)
+    {
+        fprintf(stderr, "%s: can't create the system\n", snapshot == NULL ? argv[0] : snapshot);
+        return 1;
+    }
+    int listener = openListener(argv[1]);
+    if (listener < 0)
+    {
+        perror(argv[1]);
+        chessDestroy(chess);
+        return 1;
+    }
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = stop; // without SA_RESTART, so poll returns at once
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    // the clients are added as they connect
+    Daemon daemon = { chess, listener, NULL, (struct pollfd*)malloc(sizeof(struct pollfd)), 0, 0 };
+    if (daemon.polled == NULL)
+    {
+        fprintf(stderr, "out of memory\n");
+        close(listener);
+        unlink(argv[1]);
+        chessDestroy(chess);
+        return 1;
+    }
+    serveClients(&daemon);
+    for (int i = 0; i < daemon.num_of_clients; i++)
+    {
+        close(daemon.clients[i].socket);
+        daemon.clients[i].socket = -1;
+    }
+    removeClosedClients(&daemon, true);
+    free(daemon.clients);
+    free(daemon.polled);
+    close(listener);
+    unlink(argv[1]);
+
+    int status = 0;
+    if (snapshot != NULL && chessSaveSnapshot(chess, snapshot) != CHESS_SUCCESS)
+    {
+        fprintf(stderr, "%s: can't save the system\n", snapshot);
+        status = 1;
+    }
+    chessDestroy(chess);
+    return status;
+}
+
+static ChessSystem createSystem(const char* snapshot, const ChessSystemOptions* options)
+{
+    if (snapshot == NULL || access(snapshot, F_OK) != 0)
+    {
+        return chessCreateWithOptions(options);
+    }
+    ChessResult result;
+    return chessLoadSnapshotWithOptions(snapshot, options, &result);
+}
+
+/**
+ * Return the listening socket, or -1 (with errno set) if it could not be opened.
+ * */
+static int openListener(const char* path)
+{
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address.sun_path))
+    {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    strcpy(address.sun_path, path);
+
+    // a socket there was left by a chessd that was killed, anything else is not ours to remove
+    struct stat status;
+    if (lstat(path, &status) == 0)
+    {
+        if (!S_ISSOCK(status.st_mode))
+        {
+            errno = EEXIST;
+            return -1;
+        }
+        unlink(path);
+    }
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0)
+    {
+        return -1;
+    }
+    if (bind(listener, (struct sockaddr*)&address, sizeof(address)) != 0
+        || listen(listener, LISTEN_BACKLOG) != 0
+        || fcntl(listener, F_SETFL, O_NONBLOCK) != 0)
+    {
+        int error = errno;
+        close(listener);
+        errno = error;
+        return -1;
+    }
+    return listener;
+}
+
+static void stop(int signal_number)
+{
+    (void)signal_number;
+    stopping = 1;
+}
+
+static void serveClients(Daemon* daemon)
+{
+    while (!stopping)
+    {
+        // don't block while some client has requests to run, or a save to wait for
+        int timeout = -1;
+        daemon->polled[0].fd = daemon->listener;
+        daemon->polled[0].events = POLLIN;
+        for (int i = 0; i < daemon->num_of_clients; i++)
+        {
+            Client* client = &daemon->clients[i];
+            bool reading = client->output.size - client->output.start <= MAX_UNREAD_OUTPUT;
+            if (client->save != NULL)
+            {
+                timeout = SAVE_POLL_MILLISECONDS;
+            }
+            else if (reading && hasRequest(client))
+            {
+                timeout = 0;
+            }
+            daemon->polled[i + 1].fd = client->socket;
+            daemon->polled[i + 1].events = (short)((reading && client->save == NULL && !hasRequest(client) ? POLLIN : 0)
+                                                   | (client->output.size > client->output.start ? POLLOUT : 0));
+            daemon->polled[i + 1].revents = 0;
+        }
+        if (poll(daemon->polled, daemon->num_of_clients + 1, timeout) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            perror("poll");
+            return;
+        }
+
+        for (int i = 0; i < daemon->num_of_clients; i++)
+        {
+            Client* client = &daemon->clients[i];
+            bool open = client->socket >= 0;
+            if (open && (daemon->polled[i + 1].revents & (POLLIN | POLLHUP | POLLERR)) != 0)
+            {
+                open = receiveRequests(client);
+            }
+            if (open && client->save != NULL && chessSavePoll(client->save))
+            {
+                open = finishSave(client);
+            }
+            if (open && client->save == NULL)
+            {
+                open = serveRequests(daemon->chess, client);
+            }
+            if (open)
+            {
+                open = sendResponses(client);
+            }
+            if (!open && client->socket >= 0)
+            {
+                close(client->socket);
+                client->socket = -1;
+            }
+        }
+        removeClosedClients(daemon, false);
+        if ((daemon->polled[0].revents & POLLIN) != 0)
+        {
+            acceptClients(daemon);
+        }
+    }
+}
+
+static void acceptClients(Daemon* daemon)
+{
+    for (;;)
+    {
+        int socket = accept(daemon->listener, NULL, NULL);
+        if (socket < 0)
+        {
+            return; // no more clients waiting (or too many files open, they'll be accepted later)
+        }
+        if (daemon->num_of_clients == daemon->capacity)
+        {
+            int capacity = daemon->capacity == 0 ? INITIAL_CAPACITY : 2 * daemon->capacity;
+            Client* clients = (Client*)realloc(daemon->clients, sizeof(Client) * capacity);
+            if (clients != NULL)
+            {
+                daemon->clients = clients;
+            }
+            struct pollfd* polled = (struct pollfd*)realloc(daemon->polled, sizeof(struct pollfd) * (capacity + 1));
+            if (polled != NULL)
+            {
+                daemon->polled = polled;
+            }
+            if (clients == NULL || polled == NULL)
+            {
+                close(socket);
+                continue;
+            }
+            daemon->capacity = capacity;
+        }
+        if (fcntl(socket, F_SETFL, O_NONBLOCK) != 0)
+        {
+            close(socket);
+            continue;
+        }
+        Client* client = &daemon->clients[daemon->num_of_clients++];
+        memset(client, 0, sizeof(*client));
+        client->socket = socket;
+        client->save = NULL;
+    }
+}
+
+/**
+ * Release the clients that were closed, once their saves are over (wait for them if wait is true).
+ * */
+static void removeClosedClients(Daemon* daemon, bool wait)
+{
+    int kept = 0;
+    for (int i = 0; i < daemon->num_of_clients; i++)
+    {
+        Client* client = &daemon->clients[i];
+        if (client->socket < 0 && (wait || client->save == NULL || chessSavePoll(client->save)))
+        {
+            if (client->save != NULL)
+            {
+                chessSaveWait(client->save);
+            }
+            free(client->input.bytes);
+            free(client->output.bytes);
+            continue;
+        }
+        daemon->clients[kept++] = *client;
+    }
+    daemon->num_of_clients = kept;
+}
+
+/**
+ * Read what the client sent. Return false if it closed the connection, or it failed.
+ * */
+static bool receiveRequests(Client* client)
+{
+    if (!reserve(&client->input, RECEIVE_SIZE))
+    {
+        return false;
+    }
+    ssize_t received = recv(client->socket, client->input.bytes + client->input.size, RECEIVE_SIZE, 0);
+    if (received < 0)
+    {
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    }
+    client->input.size += (size_t)received;
+    return received > 0;
+}
+
+static bool hasRequest(const Client* client)
+{
+    const Buffer* input = &client->input;
+    size_t available = input->size - input->start;
+    return available >= WORD_SIZE && available - WORD_SIZE >= getWord(input->bytes + input->start);
+}
+
+/**
+ * Run the next requests of the client, and append their responses to its output.
+ * Return false if the client sent a request that can't be parsed, or its response can't be kept.
+ * */
+static bool serveRequests(ChessSystem chess, Client* client)
+{
+    Buffer* input = &client->input;
+    for (int served = 0; served < REQUESTS_PER_TURN && client->save == NULL; served++)
+    {
+        if (client->output.size - client->output.start > MAX_UNREAD_OUTPUT)
+        {
+            break;
+        }
+        size_t available = input->size - input->start;
+        if (available < WORD_SIZE)
+        {
+            break;
+        }
+        const unsigned char* request = input->bytes + input->start;
+        unsigned long size = getWord(request);
+        if (size < CHESS_PROTOCOL_HEADER_SIZE - WORD_SIZE || size > CHESS_PROTOCOL_MAX_REQUEST)
+        {
+            return false;
+        }
+        if (available - WORD_SIZE < size)
+        {
+            break;
+        }
+        if (!runRequest(chess, client, getWord(request + WORD_SIZE), request[2 * WORD_SIZE],
+                        request + CHESS_PROTOCOL_HEADER_SIZE, size + WORD_SIZE - CHESS_PROTOCOL_HEADER_SIZE))
+        {
+            return false;
+        }
+        input->start += WORD_SIZE + size;
+    }
+    if (input->start == input->size)
+    {
+        input->start = 0;
+        input->size = 0;
+    }
+    return true;
+}
+
+static bool runRequest(ChessSystem chess, Client* client, unsigned long id, int command,
+                       const unsigned char* body, size_t size)
+{
+    int args[MAX_ARGS] = { 0 };
+    for (int i = 0; i < MAX_ARGS && (size_t)(i + 1) * WORD_SIZE <= size; i++)
+    {
+        args[i] = (int)getWord(body + i * WORD_SIZE);
+    }
+    Buffer* output = &client->output;
+    switch (command)
+    {
+        case CHESS_COMMAND_ADD_GAME:
+            return size == 5 * WORD_SIZE
+                   && appendResponse(output, id, chessAddGame(chess, args[0], args[1], args[2], (Winner)args[3],
+                                                              args[4]), 0) != NULL;
+        case CHESS_COMMAND_REMOVE_TOURNAMENT:
+            return size == WORD_SIZE && appendResponse(output, id, chessRemoveTournament(chess, args[0]), 0) != NULL;
+        case CHESS_COMMAND_REMOVE_PLAYER:
+            return size == WORD_SIZE && appendResponse(output, id, chessRemovePlayer(chess, args[0]), 0) != NULL;
+        case CHESS_COMMAND_END_TOURNAMENT:
+            return size == WORD_SIZE && appendResponse(output, id, chessEndTournament(chess, args[0]), 0) != NULL;
+        case CHESS_COMMAND_CALCULATE_AVERAGE_PLAY_TIME:
+        {
+            if (size != WORD_SIZE)
+            {
+                return false;
+            }
+            ChessResult result;
+            double average = chessCalculateAveragePlayTime(chess, args[0], &result);
+            unsigned char* response = appendResponse(output, id, result, DOUBLE_SIZE);
+            if (response != NULL)
+            {
+                putDouble(response, average);
+            }
+            return response != NULL;
+        }
+        case CHESS_COMMAND_SAVE_PLAYERS_LEVELS:
+            return size == 0 && savePlayersLevels(chess, output, id);
+        case CHESS_COMMAND_GET_PLAYERS_STATS:
+        case CHESS_COMMAND_END_TOURNAMENTS:
+        {
+            if (size % WORD_SIZE != 0)
+            {
+                return false;
+            }
+            int n = (int)(size / WORD_SIZE);
+            int* ids = readWords(body, n);
+            bool served = ids == NULL ? appendResponse(output, id, CHESS_OUT_OF_MEMORY, 0) != NULL
+                          : command == CHESS_COMMAND_GET_PLAYERS_STATS ? getPlayersStats(chess, output, id, ids, n)
+                          : endTournaments(chess, output, id, ids, n);
+            free(ids);
+            return served;
+        }
+        default:
+            return runTextRequest(chess, client, id, command, body, size);
+    }
+}
+
+/**
+ * The commands whose last argument is a text.
+ * */
+static bool runTextRequest(ChessSystem chess, Client* client, unsigned long id, int command,
+                           const unsigned char* body, size_t size)
+{
+    size_t text_start = command == CHESS_COMMAND_ADD_TOURNAMENT ? 2 * WORD_SIZE : 0;
+    if ((command != CHESS_COMMAND_ADD_TOURNAMENT && command != CHESS_COMMAND_SAVE_TOURNAMENT_STATISTICS
+         && command != CHESS_COMMAND_SAVE_SNAPSHOT) || size < text_start)
+    {
+        return false;
+    }
+    char* text = (char*)malloc(size - text_start + 1);
+    if (text == NULL)
+    {
+        return appendResponse(&client->output, id, CHESS_OUT_OF_MEMORY, 0) != NULL;
+    }
+    memcpy(text, body + text_start, size - text_start);
+    text[size - text_start] = '\0';
+
+    ChessResult result;
+    if (command == CHESS_COMMAND_ADD_TOURNAMENT)
+    {
+        result = chessAddTournament(chess, (int)getWord(body), (int)getWord(body + WORD_SIZE), text);
+    }
+    else if (command == CHESS_COMMAND_SAVE_SNAPSHOT)
+    {
+        result = chessSaveSnapshot(chess, text);
+    }
+    else
+    {
+        // the child has its own copy of the path
+        client->save = chessSaveTournamentStatisticsAsync(chess, text, &result);
+        client->save_id = id;
+    }
+    free(text);
+    return client->save != NULL || appendResponse(&client->output, id, result, 0) != NULL;
+}
+
+static bool savePlayersLevels(ChessSystem chess, Buffer* output, unsigned long id)
+{
+    char* text = NULL;
+    size_t size = 0;
+    FILE* stream = open_memstream(&text, &size);
+    if (stream == NULL)
+    {
+        return appendResponse(output, id, CHESS_OUT_OF_MEMORY, 0) != NULL;
+    }
+    ChessResult result = chessSavePlayersLevels(chess, stream);
+    if (fclose(stream) != 0)
+    {
+        result = CHESS_OUT_OF_MEMORY;
+    }
+    if (result != CHESS_SUCCESS)
+    {
+        size = 0;
+    }
+    unsigned char* response = appendResponse(output, id, result, size);
+    if (response != NULL)
+    {
+        memcpy(response, text, size);
+    }
+    free(text);
+    return response != NULL;
+}
+
+static bool getPlayersStats(ChessSystem chess, Buffer* output, unsigned long id, const int* ids, int n)
+{
+    ChessPlayerStats* stats = (ChessPlayerStats*)malloc(sizeof(ChessPlayerStats) * (n + 1));
+    ChessResult result = stats == NULL ? CHESS_OUT_OF_MEMORY : chessGetPlayersStats(chess, ids, n, stats);
+    int size = result == CHESS_SUCCESS ? n : 0;
+    unsigned char* response = appendResponse(output, id, result, (size_t)size * PLAYER_STATS_SIZE);
+    for (int i = 0; response != NULL && i < size; i++, response += PLAYER_STATS_SIZE)
+    {
+        putWord(response, (unsigned long)stats[i].player_id);
+        response[WORD_SIZE] = (unsigned char)stats[i].result;
+        putDouble(response + WORD_SIZE + RESULT_SIZE, stats[i].average_play_time);
+        putDouble(response + WORD_SIZE + RESULT_SIZE + DOUBLE_SIZE, stats[i].level);
+        putWord(response + WORD_SIZE + RESULT_SIZE + 2 * DOUBLE_SIZE, (unsigned long)stats[i].wins);
+        putWord(response + 2 * WORD_SIZE + RESULT_SIZE + 2 * DOUBLE_SIZE, (unsigned long)stats[i].losses);
+        putWord(response + 3 * WORD_SIZE + RESULT_SIZE + 2 * DOUBLE_SIZE, (unsigned long)stats[i].draws);
+    }
+    free(stats);
+    return response != NULL;
+}
+
+static bool endTournaments(ChessSystem chess, Buffer* output, unsigned long id, const int* ids, int n)
+{
+    ChessResult* results = (ChessResult*)malloc(sizeof(ChessResult) * (n + 1));
+    ChessResult result = results == NULL ? CHESS_OUT_OF_MEMORY : chessEndTournaments(chess, ids, n, results);
+    int size = result == CHESS_SUCCESS ? n : 0;
+    unsigned char* response = appendResponse(output, id, result, (size_t)size * RESULT_SIZE);
+    for (int i = 0; response != NULL && i < size; i++)
+    {
+        response[i] = (unsigned char)results[i];
+    }
+    free(results);
+    return response != NULL;
+}
+
+/**
+ * Append the response of the save the client waited for.
+ * */
+static bool finishSave(Client* client)
+{
+    ChessResult result = chessSaveWait(client->save);
+    client->save = NULL;
+    return appendResponse(&client->output, client->save_id, result, 0) != NULL;
+}
+
+/**
+ * Send as much of the output as the socket takes. Return false if the connection failed.
+ * */
+static bool sendResponses(Client* client)
+{
+    Buffer* output = &client->output;
+    while (output->start < output->size)
+    {
+        // a client that closed its end must not kill the daemon with SIGPIPE
+        ssize_t sent = send(client->socket, output->bytes + output->start, output->size - output->start, MSG_NOSIGNAL);
+        if (sent < 0)
+        {
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        }
+        output->start += (size_t)sent;
+    }
+    output->start = 0;
+    output->size = 0;
+    return true;
+}
+
+/**
+ * Append a response with size bytes of returned values to output, and return where they go.
+ * Return NULL if malloc failed.
+ * */
+static unsigned char* appendResponse(Buffer* output, unsigned long id, ChessResult result, size_t size)
+{
+    if (!reserve(output, CHESS_PROTOCOL_HEADER_SIZE + size))
+    {
+        return NULL;
+    }
+    unsigned char* response = output->bytes + output->size;
+    putWord(response, (unsigned long)(CHESS_PROTOCOL_HEADER_SIZE - WORD_SIZE + size));
+    putWord(response + WORD_SIZE, id);
+    response[2 * WORD_SIZE] = (unsigned char)result;
+    output->size += CHESS_PROTOCOL_HEADER_SIZE + size;
+    return response + CHESS_PROTOCOL_HEADER_SIZE;
+}
+
+/**
+ * Make room for size more bytes at the end of buffer, moving what is left of it to its start.
+ * */
+static bool reserve(Buffer* buffer, size_t size)
+{
+    if (buffer->start > 0 && buffer->size + size > buffer->capacity)
+    {
+        memmove(buffer->bytes, buffer->bytes + buffer->start, buffer->size - buffer->start);
+        buffer->size -= buffer->start;
+        buffer->start = 0;
+    }
+    if (buffer->size + size <= buffer->capacity)
+    {
+        return true;
+    }
+    size_t capacity = buffer->capacity == 0 ? RECEIVE_SIZE : buffer->capacity;
+    while (capacity < buffer->size + size)
+    {
+        capacity *= 2;
+    }
+    unsigned char* bytes = (unsigned char*)realloc(buffer->bytes, capacity);
+    if (bytes == NULL)
+    {
+        return false;
+    }
+    buffer->bytes = bytes;
+    buffer->capacity = capacity;
+    return true;
+}
+
+/**
+ * Return a new array of the n numbers of bytes, NULL if malloc failed.
+ * */
+static int* readWords(const unsigned char* bytes, int n)
+{
+    int* words = (int*)malloc(sizeof(int) * (n + 1));
+    for (int i = 0; words != NULL && i < n; i++)
+    {
+        words[i] = (int)getWord(bytes + i * WORD_SIZE);
+    }
+    return words;
+}
+
+static void putWord(unsigned char* bytes, unsigned long value)
+{
+    for (int i = 0; i < WORD_SIZE; i++)
+    {
+        bytes[i] = (unsigned char)(value >> (8 * i));
+    }
+}
+
+static unsigned long getWord(const unsigned char* bytes)
+{
+    unsigned long value = 0;
+    for (int i = 0; i < WORD_SIZE; i++)
+    {
+        value |= (unsigned long)bytes[i] << (8 * i);
+    }
+    return value;
+}
+
+static void putDouble(unsigned char* bytes, double value)
+{
+    unsigned long long bits;
+    memcpy(&bits, &value, sizeof(bits));
+    for (int i = 0; i < DOUBLE_SIZE; i++)
+    {
+        bytes[i] = (unsigned char)(bits >> (8 * i));
+    }
+}
@@ -0,0 +1,400 @@
+#define _POSIX_C_SOURCE 200809L // mkdir
+
+#include "chessSystemExt.h"
+#include "chessSystemPrivate.h"
+#include "chessTournament.h"
+#include "chessPlayer.h"
+#include "chessGame.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/stat.h>
+
+/*
+ * Layout of a column file: a header ("CHSC", version, encoding, block size, number of values (8 bytes)),
+ * then blocks of up to BLOCK_SIZE values. Every block stands alone, so a reader can skip any of them:
+ * its reference (8 bytes), its bit width (1 byte), then every value minus the reference,
+ * in width bits, least significant bit first.
+ * With DELTA encoding the packed values are the differences from the previous value of the block,
+ * and the first value of a block is stored as a difference from 0.
+ * Every number is little endian.
+ */
+
+// ------------------ DEFINES ---------------- //
+
+#define COLUMN_MAGIC "CHSC"
+#define COLUMN_VERSION 1
+#define COLUMN_HEADER_SIZE 24
+#define BLOCK_SIZE 128
+#define SCHEMA_FILE "schema"
+#define COLUMN_SUFFIX ".col"
+#define WORD_SIZE 4
+
+typedef enum {
+    ENCODING_PACKED, // frame of reference, bit-packed
+    ENCODING_DELTA   // differences, then as ENCODING_PACKED
+} Encoding;
+
+typedef struct chess_column_t {
+    const char* table;
+    const char* name;
+    const char* type;
+    Encoding encoding;
+} Column;
+
+typedef struct chess_column_writer_t {
+    FILE* file;
+    Encoding encoding;
+    long long values[BLOCK_SIZE];
+    int num_of_values;          // in the current block
+    unsigned long long size;    // number of values written
+    bool failed;
+} ColumnWriter;
+
+typedef enum {
+    GAMES_TOURNAMENT_ID,
+    GAMES_PLAYER1,
+    GAMES_PLAYER2,
+    GAMES_WINNER,
+    GAMES_LENGTH,
+    NUM_OF_GAME_COLUMNS
+} GameColumn;
+
+typedef enum {
+    PLAYERS_ID,
+    PLAYERS_WINS,
+    PLAYERS_LOSSES,
+    PLAYERS_DRAWS,
+    PLAYERS_TOTAL_TIME,
+    NUM_OF_PLAYER_COLUMNS
+} PlayerColumn;
+
+static const Column GAME_COLUMNS[NUM_OF_GAME_COLUMNS] = {
+    { "games", "tournament_id", "int32", ENCODING_DELTA }, // games are exported by tournament
+    { "games", "player1", "int32", ENCODING_PACKED },      // 0 if the player was removed
+    { "games", "player2", "int32", ENCODING_PACKED },
+    { "games", "winner", "int32", ENCODING_PACKED },       // a Winner
+    { "games", "length", "int32", ENCODING_PACKED }
+};
+
+static const Column PLAYER_COLUMNS[NUM_OF_PLAYER_COLUMNS] = {
+    { "players", "id", "int32", ENCODING_DELTA },          // ascending
+    { "players", "wins", "int32", ENCODING_PACKED },
+    { "players", "losses", "int32", ENCODING_PACKED },
+    { "players", "draws", "int32", ENCODING_PACKED },
+    { "players", "total_time", "uint32", ENCODING_PACKED }
+};
+
+// ------------------ FUNCTIONS DECLARATIONS ---------------- //
+
+static void exportGames(ChessSystem chess, ColumnWriter writers[NUM_OF_GAME_COLUMNS]);
+static void exportPlayers(ChessSystem chess, ColumnWriter writers[NUM_OF_PLAYER_COLUMNS]);
+static bool openColumns(const char* dir, const Column* columns, ColumnWriter* writers, int num_of_columns);
+static bool closeColumns(ColumnWriter* writers, int num_of_columns);
+static bool writeSchema(const char* dir, const ColumnWriter* games, const ColumnWriter* players);
+static void writeSchemaTable(FILE* file, const Column* columns, const ColumnWriter* writers, int num_of_columns);
+static char* filePath(const char* dir, const char* table, const char* name, const char* suffix);
+
+static bool columnOpen(ColumnWriter* writer, const char* path, Encoding encoding);
+static void columnAdd(ColumnWriter* writer, long long value);
+static void columnFlushBlock(ColumnWriter* writer);
+static bool columnClose(ColumnWriter* writer);
+static void writeHeader(ColumnWriter* writer);
+static void putWord(unsigned char* bytes, unsigned long value);
+static int bitWidth(unsigned long long value);
+
+// ------------------ FUNCTIONS IMPLEMENTATION ---------------- //
+
+ChessResult chessExportColumnar(ChessSystem chess, const char* dir)
+{
+    if (chess == NULL || dir == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    if (mkdir(dir, 0777) != 0 && errno != EEXIST)
+    {
+        return CHESS_SAVE_FAILURE;
+    }
+
+    ColumnWriter games[NUM_OF_GAME_COLUMNS];
+    ColumnWriter players[NUM_OF_PLAYER_COLUMNS];
+    if (!openColumns(dir, GAME_COLUMNS, games, NUM_OF_GAME_COLUMNS))
+    {
+        return CHESS_SAVE_FAILURE;
+    }
+    if (!openColumns(dir, PLAYER_COLUMNS, players, NUM_OF_PLAYER_COLUMNS))
+    {
+        closeColumns(games, NUM_OF_GAME_COLUMNS);
+        return CHESS_SAVE_FAILURE;
+    }
+
+    removalsApplyAll(chess->removals, chess->players, chess->tournaments);
+    exportGames(chess, games);
+    exportPlayers(chess, players);
+
+    // the schema is written last, so a complete schema means complete columns
+    bool result = closeColumns(games, NUM_OF_GAME_COLUMNS);
+    result = closeColumns(players, NUM_OF_PLAYER_COLUMNS) && result;
+    result = result && writeSchema(dir, games, players);
+    return result ? CHESS_SUCCESS : CHESS_SAVE_FAILURE;
+}
+
+static void exportGames(ChessSystem chess, ColumnWriter writers[NUM_OF_GAME_COLUMNS])
+{
+    MAP_FOREACH(int*, tournament_id, chess->tournaments)
+    {
+        GameList games = tournamentGetGames(mapGet(chess->tournaments, tournament_id));
+        GameIterator iterator;
+        gameIteratorInit(&iterator);
+        while (gameIteratorNext(games, &iterator))
+        {
+            const GameRecord* game = &iterator.game;
+            Winner winner = game->winners_id == GAME_DRAW       ? DRAW
+                            : game->winners_id == game->player1_id ? FIRST_PLAYER
+                                                                   : SECOND_PLAYER;
+            columnAdd(&writers[GAMES_TOURNAMENT_ID], *tournament_id);
+            columnAdd(&writers[GAMES_PLAYER1], game->player1_id);
+            columnAdd(&writers[GAMES_PLAYER2], game->player2_id);
+            columnAdd(&writers[GAMES_WINNER], winner);
+            columnAdd(&writers[GAMES_LENGTH], game->length);
+        }
+        free(tournament_id);
+    }
+}
+
+static void exportPlayers(ChessSystem chess, ColumnWriter writers[NUM_OF_PLAYER_COLUMNS])
+{
+    MAP_FOREACH(int*, player_id, chess->players)
+    {
+        PlayerSummary summary;
+        playerGetSummary(mapGet(chess->players, player_id), &summary);
+        columnAdd(&writers[PLAYERS_ID], summary.id);
+        columnAdd(&writers[PLAYERS_WINS], summary.num_of_wins);
+        columnAdd(&writers[PLAYERS_LOSSES], summary.num_of_loses);
+        columnAdd(&writers[PLAYERS_DRAWS], summary.num_of_draws);
+        columnAdd(&writers[PLAYERS_TOTAL_TIME], summary.total_time);
+        free(player_id);
+    }
+}
+
+/**
+ * Open the file of every column. Return false (with none of them open) if one can't be opened.
+ * */
+static bool openColumns(const char* dir, const Column* columns, ColumnWriter* writers, int num_of_columns)
+{
+    for (int i = 0; i < num_of_columns; i++)
+    {
+        char* path = filePath(dir, columns[i].table, columns[i].name, COLUMN_SUFFIX);
+        bool opened = (path != NULL && columnOpen(&writers[i], path, columns[i].encoding));
+        free(path);
+        if (!opened)
+        {
+            closeColumns(writers, i);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool closeColumns(ColumnWriter* writers, int num_of_columns)
+{
+    bool result = true;
+    for (int i = 0; i < num_of_columns; i++)
+    {
+        result = columnClose(&writers[i]) && result;
+    }
+    return result;
+}
+
+/**
+ * Write the schema file: a line per table, with its number of rows,
+ * then a line per column, with its type, encoding and file.
+ * */
+static bool writeSchema(const char* dir, const ColumnWriter* games, const ColumnWriter* players)
+{
+    char* path = filePath(dir, SCHEMA_FILE, NULL, "");
+    if (path == NULL)
+    {
+        return false;
+    }
+    FILE* file = fopen(path, "w");
+    free(path);
+    if (file == NULL)
+    {
+        return false;
+    }
+    fprintf(file, "chess-columnar %d\n", COLUMN_VERSION);
+    writeSchemaTable(file, GAME_COLUMNS, games, NUM_OF_GAME_COLUMNS);
+    writeSchemaTable(file, PLAYER_COLUMNS, players, NUM_OF_PLAYER_COLUMNS);
+    bool result = !ferror(file);
+    return (fclose(file) == 0) && result;
+}
+
+static void writeSchemaTable(FILE* file, const Column* columns, const ColumnWriter* writers, int num_of_columns)
+{
+    fprintf(file, "table %s %llu\n", columns[0].table, writers[0].size);
+    for (int i = 0; i < num_of_columns; i++)
+    {
+        fprintf(file, "column %s %s %s %s.%s%s\n", columns[i].name, columns[i].type,
+                columns[i].encoding == ENCODING_DELTA ? "delta" : "packed",
+                columns[i].table, columns[i].name, COLUMN_SUFFIX);
+    }
+}
+
+/**
+ * Return dir/table.name<suffix> (or dir/table<suffix> if name is NULL), allocated with malloc.
+ * */
+static char* filePath(const char* dir, const char* table, const char* name, const char* suffix)
+{
+    size_t size = strlen(dir) + 1 + strlen(table) + 1 + (name ? strlen(name) : 0) + strlen(suffix) + 1;
+    char* path = (char*)malloc(size);
+    if (path != NULL)
+    {
+        sprintf(path, "%s/%s%s%s%s", dir, table, name ? "." : "", name ? name : "", suffix);
+    }
+    return path;
+}
+
+// ------------------ COLUMNS ---------------- //
+
+static bool columnOpen(ColumnWriter* writer, const char* path, Encoding encoding)
+{
+    writer->file = fopen(path, "wb");
+    if (writer->file == NULL)
+    {
+        return false;
+    }
+    writer->encoding = encoding;
+    writer->num_of_values = 0;
+    writer->size = 0;
+    writer->failed = false;
+    writeHeader(writer); // rewritten with the final size by columnClose
+    return true;
+}
+
+static void columnAdd(ColumnWriter* writer, long long value)
+{
+    writer->values[writer->num_of_values++] = value;
+    if (writer->num_of_values == BLOCK_SIZE)
+    {
+        columnFlushBlock(writer);
+    }
+}
+
+static void columnFlushBlock(ColumnWriter* writer)
+{
+    int size = writer->num_of_values;
+    if (size == 0)
+    {
+        return;
+    }
+    long long* values = writer->values;
+    if (writer->encoding == ENCODING_DELTA)
+    {
+        for (int i = size - 1; i > 0; i--)
+        {
+            values[i] -= values[i - 1];
+        }
+    }
+
+    long long reference = values[0];
+    long long maximum = values[0];
+    for (int i = 1; i < size; i++)
+    {
+        reference = values[i] < reference ? values[i] : reference;
+        maximum = values[i] > maximum ? values[i] : maximum;
+    }
+    int width = bitWidth((unsigned long long)(maximum - reference));
+
+    // reference, width and the packed values; the values of a column never span more than 34 bits
+    unsigned char block[9 + BLOCK_SIZE * 8];
+    unsigned long long bits = (unsigned long long)reference;
+    for (int i = 0; i < 8; i++)
+    {
+        block[i] = (unsigned char)(bits >> (8 * i));
+    }
+    block[8] = (unsigned char)width;
+    size_t position = 9;
+    unsigned long long pending = 0;
+    int num_of_pending = 0;
+    for (int i = 0; i < size; i++)
+    {
+        pending |= (unsigned long long)(values[i] - reference) << num_of_pending;
+        num_of_pending += width;
+        while (num_of_pending >= 8)
+        {
+            block[position++] = (unsigned char)pending;
+            pending >>= 8;
+            num_of_pending -= 8;
+        }
+    }
+    if (num_of_pending > 0)
+    {
+        block[position++] = (unsigned char)pending;
+    }
+
+    if (fwrite(block, 1, position, writer->file) != position)
+    {
+        writer->failed = true;
+    }
+    writer->size += size;
+    writer->num_of_values = 0;
+}
+
+/**
+ * Write the last block and the final header, and close the file.
+ * Return false if anything could not be written.
+ * */
+static bool columnClose(ColumnWriter* writer)
+{
+    columnFlushBlock(writer);
+    if (fseek(writer->file, 0, SEEK_SET) != 0)
+    {
+        writer->failed = true;
+    }
+    else
+    {
+        writeHeader(writer);
+    }
+    bool result = !writer->failed;
+    return (fclose(writer->file) == 0) && result;
+}
+
+static void writeHeader(ColumnWriter* writer)
+{
+    unsigned char header[COLUMN_HEADER_SIZE];
+    memcpy(header, COLUMN_MAGIC, WORD_SIZE);
+    putWord(header + 4, COLUMN_VERSION);
+    putWord(header + 8, writer->encoding);
+    putWord(header + 12, BLOCK_SIZE);
+    putWord(header + 16, (unsigned long)(writer->size & 0xFFFFFFFFu));
+    putWord(header + 20, (unsigned long)(writer->size >> 32));
+    if (fwrite(header, 1, COLUMN_HEADER_SIZE, writer->file) != COLUMN_HEADER_SIZE)
+    {
+        writer->failed = true;
+    }
+}
+
+static void putWord(unsigned char* bytes, unsigned long value)
+{
+    bytes[0] = (unsigned char)value;
+    bytes[1] = (unsigned char)(value >> 8);
+    bytes[2] = (unsigned char)(value >> 16);
+    bytes[3] = (unsigned char)(value >> 24);
+}
+
+/**
+ * Return the number of bits needed to hold value.
+ * */
+static int bitWidth(unsigned long long value)
+{
+    int width = 0;
+    while (value > 0)
+    {
+        width++;
+        value >>= 1;
+    }
+    return width;
+}
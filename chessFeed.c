@@ -0,0 +1,298 @@
+#define _POSIX_C_SOURCE 200809L // pthreads
+
+#include "chessFeed.h"
+#include "chessSystemExt.h"
+#include "chessSystemPrivate.h"
+
+#include <stdlib.h>
+#include <limits.h>
+#include <pthread.h>
+
+/*
+ * A ring is written by one thread at a time (the lock of the feed) and read by any number of threads
+ * without locks. Event s goes to slot s % capacity. The slot holds s + 1 once the event is written,
+ * and 0 while an event is written into it. The writer clears the slot, writes the event, sets the slot
+ * to s + 1 and only then counts the event in head. A reader copies a slot between two reads of its
+ * sequence: if the sequence changed, or is not the one it expects, the writer lapped it.
+ * Every field of a slot is read and written atomically, so a copy that is thrown away is harmless.
+ */
+
+// ------------------ DEFINES ---------------- //
+
+#define DEFAULT_RING_CAPACITY 4096
+#define MAX_RING_CAPACITY (1 << 30)
+
+typedef struct chess_slot_t {
+    unsigned long long sequence; // of the event + 1, 0 while it is written
+    int type;
+    int args[CHESS_EVENT_MAX_ARGS];
+} Slot;
+
+struct chess_subscription_t {
+    unsigned long long head; // events written (atomic)
+    unsigned int mask;
+    unsigned long long capacity; // a power of 2
+    Slot* slots;
+    ChessSubscription next;
+};
+
+struct chess_feed_t {
+    pthread_mutex_t lock; // events of a shared system are sent by several threads
+    ChessSubscription subscriptions; // changed only while the system is locked exclusively
+};
+
+// ------------------ FUNCTIONS DECLARATIONS ---------------- //
+
+static Feed feedCreate(void);
+static ChessSubscription subscriptionCreate(unsigned int mask, int ring_capacity);
+static void subscriptionDestroy(ChessSubscription subscription);
+static void writeEvent(ChessSubscription subscription, ChessEventType type, const int* args, int num_of_args);
+static bool readEvent(ChessSubscription subscription, unsigned long long sequence, ChessEvent* event);
+static int addOverflow(ChessEvent* events, int size, unsigned long long sequence, unsigned long long missed);
+
+// ------------------ FUNCTIONS IMPLEMENTATION ---------------- //
+
+ChessSubscription chessSubscribe(ChessSystem chess, unsigned int mask, int ring_capacity, ChessResult* result)
+{
+    ChessResult ignored;
+    result = result == NULL ? &ignored : result;
+    if (chess == NULL)
+    {
+        *result = CHESS_NULL_ARGUMENT;
+        return NULL;
+    }
+    ChessSubscription subscription = subscriptionCreate(mask, ring_capacity);
+    if (subscription == NULL)
+    {
+        *result = CHESS_OUT_OF_MEMORY;
+        return NULL;
+    }
+
+    // no change is in the middle of sending its event
+    lockSystem(chess->locks, true);
+    if (chess->feed == NULL)
+    {
+        chess->feed = feedCreate();
+    }
+    if (chess->feed == NULL)
+    {
+        unlockSystem(chess->locks);
+        subscriptionDestroy(subscription);
+        *result = CHESS_OUT_OF_MEMORY;
+        return NULL;
+    }
+    subscription->next = chess->feed->subscriptions;
+    chess->feed->subscriptions = subscription;
+    unlockSystem(chess->locks);
+    *result = CHESS_SUCCESS;
+    return subscription;
+}
+
+int chessSubscriptionRead(ChessSubscription subscription, unsigned long long* position, ChessEvent* events, int capacity)
+{
+    if (subscription == NULL || position == NULL || events == NULL)
+    {
+        return 0;
+    }
+    int size = 0;
+    while (size < capacity)
+    {
+        unsigned long long head = __atomic_load_n(&subscription->head, __ATOMIC_ACQUIRE);
+        if (*position > head)
+        {
+            *position = head; // a position of another subscription
+        }
+        if (head - *position > subscription->capacity)
+        {
+            unsigned long long oldest = head - subscription->capacity;
+            size = addOverflow(events, size, *position, oldest - *position);
+            *position = oldest;
+        }
+        else if (*position == head)
+        {
+            break;
+        }
+        else if (readEvent(subscription, *position, &events[size]))
+        {
+            size++;
+            (*position)++;
+        }
+        else
+        {
+            // the writer is already past this event, the ones after it may still be read
+            size = addOverflow(events, size, *position, 1);
+            (*position)++;
+        }
+    }
+    return size;
+}
+
+void chessUnsubscribe(ChessSystem chess, ChessSubscription subscription)
+{
+    if (chess == NULL || subscription == NULL)
+    {
+        return;
+    }
+    lockSystem(chess->locks, true);
+    ChessSubscription* link = chess->feed == NULL ? NULL : &chess->feed->subscriptions;
+    while (link != NULL && *link != NULL && *link != subscription)
+    {
+        link = &(*link)->next;
+    }
+    if (link != NULL && *link != NULL)
+    {
+        *link = subscription->next;
+        subscriptionDestroy(subscription);
+    }
+    unlockSystem(chess->locks);
+}
+
+void feedPublish(Feed feed, ChessEventType type, const int* args, int num_of_args)
+{
+    // the system is locked, so the subscriptions can't change meanwhile
+    if (feed == NULL || feed->subscriptions == NULL)
+    {
+        return;
+    }
+    pthread_mutex_lock(&feed->lock);
+    for (ChessSubscription subscription = feed->subscriptions; subscription != NULL; subscription = subscription->next)
+    {
+        if ((subscription->mask & (unsigned int)type) != 0)
+        {
+            writeEvent(subscription, type, args, num_of_args);
+        }
+    }
+    pthread_mutex_unlock(&feed->lock);
+}
+
+void feedDestroy(Feed feed)
+{
+    if (feed == NULL)
+    {
+        return;
+    }
+    while (feed->subscriptions != NULL)
+    {
+        ChessSubscription next = feed->subscriptions->next;
+        subscriptionDestroy(feed->subscriptions);
+        feed->subscriptions = next;
+    }
+    pthread_mutex_destroy(&feed->lock);
+    free(feed);
+}
+
+static Feed feedCreate(void)
+{
+    Feed feed = (Feed)malloc(sizeof(*feed));
+    if (feed == NULL)
+    {
+        return NULL;
+    }
+    if (pthread_mutex_init(&feed->lock, NULL) != 0)
+    {
+        free(feed);
+        return NULL;
+    }
+    feed->subscriptions = NULL;
+    return feed;
+}
+
+static ChessSubscription subscriptionCreate(unsigned int mask, int ring_capacity)
+{
+    if (ring_capacity <= 0)
+    {
+        ring_capacity = DEFAULT_RING_CAPACITY;
+    }
+    if (ring_capacity > MAX_RING_CAPACITY)
+    {
+        return NULL;
+    }
+    unsigned long long capacity = 1;
+    while (capacity < (unsigned long long)ring_capacity)
+    {
+        capacity *= 2;
+    }
+    ChessSubscription subscription = (ChessSubscription)malloc(sizeof(*subscription));
+    if (subscription == NULL)
+    {
+        return NULL;
+    }
+    // a slot of sequence 0 holds no event yet
+    subscription->slots = (Slot*)calloc(capacity, sizeof(Slot));
+    if (subscription->slots == NULL)
+    {
+        free(subscription);
+        return NULL;
+    }
+    subscription->head = 0;
+    subscription->mask = mask;
+    subscription->capacity = capacity;
+    subscription->next = NULL;
+    return subscription;
+}
+
+static void subscriptionDestroy(ChessSubscription subscription)
+{
+    free(subscription->slots);
+    free(subscription);
+}
+
+/**
+ * Only called under the lock of the feed, so head is only written here.
+ * */
+static void writeEvent(ChessSubscription subscription, ChessEventType type, const int* args, int num_of_args)
+{
+    unsigned long long sequence = __atomic_load_n(&subscription->head, __ATOMIC_RELAXED);
+    Slot* slot = &subscription->slots[sequence & (subscription->capacity - 1)];
+    __atomic_store_n(&slot->sequence, 0, __ATOMIC_RELAXED);
+    // a reader that sees any field of the new event sees the slot cleared too
+    __atomic_store_n(&slot->type, (int)type, __ATOMIC_RELEASE);
+    for (int i = 0; i < CHESS_EVENT_MAX_ARGS; i++)
+    {
+        __atomic_store_n(&slot->args[i], i < num_of_args ? args[i] : 0, __ATOMIC_RELEASE);
+    }
+    __atomic_store_n(&slot->sequence, sequence + 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&subscription->head, sequence + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * Copy event sequence into event. Return false if it was overwritten.
+ * */
+static bool readEvent(ChessSubscription subscription, unsigned long long sequence, ChessEvent* event)
+{
+    Slot* slot = &subscription->slots[sequence & (subscription->capacity - 1)];
+    if (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != sequence + 1)
+    {
+        return false;
+    }
+    // and the sequence is checked again only after the copy
+    event->type = (ChessEventType)__atomic_load_n(&slot->type, __ATOMIC_ACQUIRE);
+    event->sequence = sequence;
+    for (int i = 0; i < CHESS_EVENT_MAX_ARGS; i++)
+    {
+        event->args[i] = __atomic_load_n(&slot->args[i], __ATOMIC_ACQUIRE);
+    }
+    return __atomic_load_n(&slot->sequence, __ATOMIC_RELAXED) == sequence + 1;
+}
+
+/**
+ * Report missed events from sequence on, in the overflow event that ends events if there is one.
+ * Return the new size of events.
+ * */
+static int addOverflow(ChessEvent* events, int size, unsigned long long sequence, unsigned long long missed)
+{
+    ChessEvent* overflow = size > 0 ? &events[size - 1] : NULL;
+    if (overflow == NULL || overflow->type != CHESS_EVENT_OVERFLOW)
+    {
+        overflow = &events[size++];
+        overflow->type = CHESS_EVENT_OVERFLOW;
+        overflow->sequence = sequence;
+        for (int i = 0; i < CHESS_EVENT_MAX_ARGS; i++)
+        {
+            overflow->args[i] = 0;
+        }
+    }
+    missed += (unsigned long long)overflow->args[0];
+    overflow->args[0] = missed > INT_MAX ? INT_MAX : (int)missed;
+    return size;
+}
@@ -0,0 +1,24 @@
+#ifndef _CHESSFEED_H_
+#define _CHESSFEED_H_
+
+#include "chessSystemExt.h"
+
+/**
+ * The subscriptions of a ChessSystem. They are made and read through chessSystemExt.h,
+ * this header is what chessSystem.c needs to feed them.
+ * */
+typedef struct chess_feed_t *Feed;
+
+/**
+ * Send an event to every subscription whose mask has its type. Does nothing if feed is NULL.
+ * args are as listed in ChessEventType. Several threads may send events at once,
+ * each event is written to every ring before the next one.
+ * */
+void feedPublish(Feed feed, ChessEventType type, const int* args, int num_of_args);
+
+/**
+ * Destroy the subscriptions left and the feed.
+ * */
+void feedDestroy(Feed feed);
+
+#endif
\ No newline at end of file
@@ -1,23 +1,37 @@
+#define _POSIX_C_SOURCE 200809L // mkstemp, ftruncate, mmap
+
 #include "chessGame.h"
 
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
 
-// ------------------ STRUCT FUNCTIONS ---------------- //
+// ------------------ DEFINES ---------------- //
 
-static MapDataElement copyGame(MapDataElement game);
-// the next functions are implemented in utils.h
-void freeSimple(MapDataElement game);
-MapKeyElement copyInt(MapKeyElement key);
-int compare(MapKeyElement key1, MapKeyElement key2);
+#define GAMES_PER_BLOCK 32     // games are stored in fixed size blocks, so they never move.
+#define INITIAL_NUM_OF_BLOCKS 4
 
-static void (*freeGameKey)(MapDataElement) = freeSimple;
-static void (*freeGameData)(MapDataElement) = freeSimple; // no mallocs in Game
-static MapKeyElement (*copyGameKey)(MapKeyElement) = copyInt;
-static MapDataElement (*copyGameData)(MapDataElement) = copyGame;
-static int (*compareGameKeys)(MapKeyElement, MapKeyElement) = compare;
+/**
+ * Frozen lists store 2 bits per game for the result, followed by one varint
+ * sequence per game: zigzag(player1 - previous player1), zigzag(player2 - player1), length.
+ * */
+#define RESULT_DRAW 0
+#define RESULT_FIRST_PLAYER 1
+#define RESULT_SECOND_PLAYER 2
+#define RESULTS_PER_BYTE 4
+#define MAX_VARINT_SIZE 10
 
-// ------------------ DEFINES ---------------- //
+/**
+ * Lists stored in files map their blocks a segment at a time, so mapped blocks never move either.
+ * The size of a segment is a multiple of the page size of any system.
+ * */
+#define BLOCKS_PER_SEGMENT 128
+#define SEGMENT_SIZE (BLOCKS_PER_SEGMENT * GAMES_PER_BLOCK * sizeof(struct chess_game_t))
+#define FILE_TEMPLATE "/games.XXXXXX"
+#define NO_FILE -1
 
 struct chess_game_t {
     unsigned int length;
@@ -26,59 +40,349 @@ struct chess_game_t {
     unsigned int winners_id; // 0 = DRAW
 };
 
+struct chess_game_list_t {
+    Arena arena;
+    int size;
+    int num_of_blocks;
+    int blocks_capacity;
+    Game* blocks;            // <(int)index / GAMES_PER_BLOCK, (Game)block>, NULL if frozen
+    unsigned char* frozen;   // the encoded games of a frozen list, NULL if active
+    int frozen_size;
+    char* directory;         // where the games are stored, NULL if they are in the arena (malloc'd)
+    int file;                // the file of the blocks of an active list stored in a file, or NO_FILE
+};
+
+// ------------------ FUNCTIONS DECLARATIONS ---------------- //
+
+static bool growBlocks(GameList list);
+static bool addBlock(GameList list, const struct chess_game_t* games, int num_of_games);
+static Game mapBlock(GameList list, int block);
+static int createFile(const char* directory);
+static void unmapBlocks(GameList list);
+static GameList freezeToFile(GameList list, Arena arena, ArenaMark mark, const unsigned char* buffer, int frozen_size);
+static int encodeGames(GameList list, unsigned char* buffer);
+static int writeVarint(unsigned char* buffer, unsigned long long value);
+static int readVarint(const unsigned char* buffer, unsigned long long* value);
+static unsigned long long zigzagEncode(long long value);
+static long long zigzagDecode(unsigned long long value);
+
 // ------------------ FUNCTIONS IMPLEMENTATION ---------------- //
 
-Map gameCreateMap(void)
+GameList gameListCreate(Arena arena)
 {
-    return mapCreate(copyGameData, copyGameKey, freeGameData, freeGameKey, compareGameKeys);
+    GameList list = (GameList)arenaAlloc(arena, sizeof(*list));
+    if (list == NULL)
+    {
+        return NULL;
+    }
+    list->blocks = (Game*)arenaAlloc(arena, sizeof(Game) * INITIAL_NUM_OF_BLOCKS);
+    if (list->blocks == NULL)
+    {
+        return NULL;
+    }
+    list->arena = arena;
+    list->size = 0;
+    list->num_of_blocks = 0;
+    list->blocks_capacity = INITIAL_NUM_OF_BLOCKS;
+    list->frozen = NULL;
+    list->frozen_size = 0;
+    list->directory = NULL;
+    list->file = NO_FILE;
+    return list;
 }
 
-int gameGetPlayer1ID(Game game)
+bool gameListMoveToFile(GameList list, const char* directory)
 {
-    return game->player1_id;
+    if (list->size > 0 || list->num_of_blocks > 0 || gameListIsFrozen(list) || list->directory != NULL)
+    {
+        return false;
+    }
+    list->directory = (char*)malloc(strlen(directory) + 1);
+    if (list->directory == NULL)
+    {
+        return false;
+    }
+    strcpy(list->directory, directory);
+    list->file = createFile(directory);
+    if (list->file == NO_FILE)
+    {
+        free(list->directory);
+        list->directory = NULL;
+        return false;
+    }
+    return true;
 }
 
-int gameGetPlayer2ID(Game game)
+void gameListRelease(GameList list)
 {
-    return game->player2_id;
+    if (list->directory == NULL)
+    {
+        return;
+    }
+    if (gameListIsFrozen(list))
+    {
+        munmap(list->frozen, list->frozen_size);
+    }
+    else
+    {
+        unmapBlocks(list);
+        close(list->file);
+    }
+    free(list->directory);
+    list->directory = NULL;
 }
 
-bool gameAddToMap(Map map, int game_id, int length, int player1_id, int player2_id, int winners_id)
+GameList gameListCopy(GameList list, Arena arena)
 {
-    Game game = (Game)malloc(sizeof(*game));
-    if (game == NULL)
+    if (gameListIsFrozen(list))
+    {
+        GameList new_list = (GameList)arenaAlloc(arena, sizeof(*new_list) + list->frozen_size);
+        if (new_list == NULL)
+        {
+            return NULL;
+        }
+        *new_list = *list;
+        new_list->arena = arena;
+        new_list->directory = NULL; // copies are always in memory
+        new_list->file = NO_FILE;
+        new_list->frozen = (unsigned char*)(new_list + 1);
+        memcpy(new_list->frozen, list->frozen, list->frozen_size);
+        return new_list;
+    }
+
+    GameList new_list = gameListCreate(arena);
+    if (new_list == NULL)
+    {
+        return NULL;
+    }
+    for (int i = 0; i < list->size; i += GAMES_PER_BLOCK)
+    {
+        int num_of_games = list->size - i < GAMES_PER_BLOCK ? list->size - i : GAMES_PER_BLOCK;
+        if (!addBlock(new_list, list->blocks[i / GAMES_PER_BLOCK], num_of_games))
+        {
+            return NULL; // whatever was allocated is released with the arena
+        }
+    }
+    return new_list;
+}
+
+int gameListGetSize(GameList list)
+{
+    return list->size;
+}
+
+Game gameListGet(GameList list, int index)
+{
+    return &list->blocks[index / GAMES_PER_BLOCK][index % GAMES_PER_BLOCK];
+}
+
+bool gameListAdd(GameList list, int length, int player1_id, int player2_id, int winners_id)
+{
+    if (list->size % GAMES_PER_BLOCK == 0 && !addBlock(list, NULL, 0)) // all blocks are full
     {
         return false;
     }
 
+    Game game = gameListGet(list, list->size);
     game->length     = length;
     game->player1_id = player1_id;
     game->player2_id = player2_id;
     game->winners_id = winners_id;
+    list->size++;
+
+    return true;
+}
+
+int gameListGetDumpSize(GameList list)
+{
+    if (gameListIsFrozen(list))
+    {
+        return list->frozen_size;
+    }
+    return list->size * sizeof(struct chess_game_t);
+}
+
+void gameListDump(GameList list, void* buffer)
+{
+    if (gameListIsFrozen(list))
+    {
+        memcpy(buffer, list->frozen, list->frozen_size);
+        return;
+    }
+    for (int i = 0; i < list->size; i += GAMES_PER_BLOCK)
+    {
+        int num_of_games = list->size - i < GAMES_PER_BLOCK ? list->size - i : GAMES_PER_BLOCK;
+        memcpy((Game)buffer + i, list->blocks[i / GAMES_PER_BLOCK], sizeof(struct chess_game_t) * num_of_games);
+    }
+}
+
+GameList gameListRestore(Arena arena, const void* data, int size, int num_of_games, bool frozen)
+{
+    if (frozen)
+    {
+        GameList list = (GameList)arenaAlloc(arena, sizeof(*list) + size);
+        if (list == NULL || size < (num_of_games + RESULTS_PER_BYTE - 1) / RESULTS_PER_BYTE)
+        {
+            return NULL;
+        }
+        list->arena = arena;
+        list->size = num_of_games;
+        list->num_of_blocks = 0;
+        list->blocks_capacity = 0;
+        list->blocks = NULL;
+        list->frozen = (unsigned char*)(list + 1);
+        list->frozen_size = size;
+        list->directory = NULL;
+        list->file = NO_FILE;
+        memcpy(list->frozen, data, size);
+        return list;
+    }
+
+    if (size != num_of_games * (int)sizeof(struct chess_game_t))
+    {
+        return NULL;
+    }
+    GameList list = gameListCreate(arena);
+    if (list == NULL)
+    {
+        return NULL;
+    }
+    for (int i = 0; i < num_of_games; i += GAMES_PER_BLOCK)
+    {
+        int block_size = num_of_games - i < GAMES_PER_BLOCK ? num_of_games - i : GAMES_PER_BLOCK;
+        if (!addBlock(list, (const struct chess_game_t*)data + i, block_size))
+        {
+            return NULL;
+        }
+    }
+    return list;
+}
+
+void gameListRemove(GameList list, int index)
+{
+    for (int i = index + 1; i < list->size; i++)
+    {
+        *gameListGet(list, i - 1) = *gameListGet(list, i);
+    }
+    list->size--;
+    // an emptied block stays allocated and is reused by the next gameListAdd
+}
+
+int gameGetPlayer1ID(Game game)
+{
+    return game->player1_id;
+}
 
-    if (mapPut(map, &game_id, game) != MAP_SUCCESS)
+int gameGetPlayer2ID(Game game)
+{
+    return game->player2_id;
+}
+
+GameList gameListFreeze(GameList list, Arena arena, ArenaMark mark)
+{
+    if (gameListIsFrozen(list))
+    {
+        return list;
+    }
+    int results_size = (list->size + RESULTS_PER_BYTE - 1) / RESULTS_PER_BYTE;
+    unsigned char* buffer = (unsigned char*)malloc(results_size + 3 * MAX_VARINT_SIZE * list->size);
+    if (buffer == NULL)
+    {
+        return NULL;
+    }
+    int size = list->size;
+    int frozen_size = encodeGames(list, buffer);
+    if (list->directory != NULL)
+    {
+        GameList new_list = freezeToFile(list, arena, mark, buffer, frozen_size);
+        free(buffer);
+        return new_list;
+    }
+
+    // the old list is released here, only buffer and the local copies are still valid
+    GameList new_list = (GameList)arenaRewind(arena, mark, sizeof(*new_list) + frozen_size);
+    if (new_list == NULL)
+    {
+        free(buffer);
+        return NULL;
+    }
+    new_list->arena = arena;
+    new_list->size = size;
+    new_list->num_of_blocks = 0;
+    new_list->blocks_capacity = 0;
+    new_list->blocks = NULL;
+    new_list->frozen = (unsigned char*)(new_list + 1);
+    new_list->frozen_size = frozen_size;
+    new_list->directory = NULL;
+    new_list->file = NO_FILE;
+    memcpy(new_list->frozen, buffer, frozen_size);
+
+    free(buffer);
+    return new_list;
+}
+
+bool gameListIsFrozen(GameList list)
+{
+    return list->frozen != NULL;
+}
+
+void gameIteratorInit(GameIterator* iterator)
+{
+    iterator->index = 0;
+    iterator->offset = 0;
+    iterator->game.player1_id = 0;
+}
+
+bool gameIteratorNext(GameList list, GameIterator* iterator)
+{
+    if (iterator->index >= list->size)
     {
-        free(game);
         return false;
-    } 
+    }
+    GameRecord* record = &iterator->game;
+    if (!gameListIsFrozen(list))
+    {
+        Game game = gameListGet(list, iterator->index++);
+        record->player1_id = game->player1_id;
+        record->player2_id = game->player2_id;
+        record->winners_id = game->winners_id;
+        record->length     = game->length;
+        return true;
+    }
+
+    if (iterator->offset == 0) // skip the results
+    {
+        iterator->offset = (list->size + RESULTS_PER_BYTE - 1) / RESULTS_PER_BYTE;
+    }
+    unsigned long long value;
+    const unsigned char* data = list->frozen;
+    iterator->offset += readVarint(data + iterator->offset, &value);
+    record->player1_id += zigzagDecode(value);
+    iterator->offset += readVarint(data + iterator->offset, &value);
+    record->player2_id = record->player1_id + zigzagDecode(value);
+    iterator->offset += readVarint(data + iterator->offset, &value);
+    record->length = value;
 
-    free(game);
+    int index = iterator->index++;
+    int result = (data[index / RESULTS_PER_BYTE] >> (2 * (index % RESULTS_PER_BYTE))) & 3;
+    record->winners_id = result == RESULT_FIRST_PLAYER  ? record->player1_id
+                       : result == RESULT_SECOND_PLAYER ? record->player2_id
+                       : GAME_DRAW;
     return true;
 }
 
-int gameExists(Map games, int player1_id, int player2_id)
+int gameExists(GameList games, int player1_id, int player2_id)
 {
-    MAP_FOREACH(int*, key, games)
+    unsigned int id1 = player1_id;
+    unsigned int id2 = player2_id;
+    for (int i = 0; i < games->size; i++)
     {
-        Game game = mapGet(games, key);
-        if((game->player1_id == player1_id && game->player2_id == player2_id)
-        || (game->player2_id == player1_id && game->player1_id == player2_id))
+        Game game = gameListGet(games, i);
+        if((game->player1_id == id1 && game->player2_id == id2)
+        || (game->player2_id == id1 && game->player1_id == id2))
         {
-            int n = *key;
-            free(key);
-            return n;
+            return i + 1;
         }
-        free(key);
     }
 
     return 0;
@@ -86,12 +390,16 @@ int gameExists(Map games, int player1_id, int player2_id)
 
 bool gameHasPlayer(Game game, int player_id)
 {
-    return (player_id == game->player1_id || player_id == game->player2_id);
+    return ((unsigned int)player_id == game->player1_id || (unsigned int)player_id == game->player2_id);
 }
 
 void gameRemovePlayer(Game game, Player player, Player other_player, int tournament_id)
 {
-    int player_to_remove = playerGetID(player);
+    gameRemovePlayerID(game, playerGetID(player), other_player, tournament_id);
+}
+
+void gameRemovePlayerID(Game game, int player_to_remove, Player other_player, int tournament_id)
+{
     if (!gameHasPlayer(game, player_to_remove))
     {
         return;
@@ -99,7 +407,7 @@ void gameRemovePlayer(Game game, Player player, Player other_player, int tournam
 
     int last_winner = game->winners_id;
     // remove player from game, update winner.
-    if (player_to_remove == game->player1_id)
+    if ((unsigned int)player_to_remove == game->player1_id)
     {
         game->player1_id = 0;
         game->winners_id = game->player2_id;
@@ -110,7 +418,7 @@ void gameRemovePlayer(Game game, Player player, Player other_player, int tournam
         game->winners_id = game->player1_id;
     }
 
-    if (game->winners_id == 0) // both players were removed
+    if (game->winners_id == 0 || other_player == NULL) // both players were removed
     {
         return;
     }
@@ -127,38 +435,258 @@ void gameRemovePlayer(Game game, Player player, Player other_player, int tournam
     // else the winner stays winner, do nothing.
 }
 
-void gameRemove(Game game, Player player1, Player player2, int tournament_id)
+void gameRemove(GameRecord game, Player player1, Player player2, int tournament_id)
 {
-    if (!game->winners_id)
+    if (!game.winners_id)
     {
-        playerRemoveFromGame(player1, PLAYER_DRAW, game->length, tournament_id);
-        playerRemoveFromGame(player2, PLAYER_DRAW, game->length, tournament_id);
+        playerRemoveFromGame(player1, PLAYER_DRAW, game.length, tournament_id);
+        playerRemoveFromGame(player2, PLAYER_DRAW, game.length, tournament_id);
         return;
     }
-    Player winner = game->winners_id == playerGetID(player1) ? player1 : player2;
-    Player loser  = game->winners_id == playerGetID(player1) ? player2 : player1; 
-    playerRemoveFromGame(winner, PLAYER_WINNER, game->length, tournament_id);
-    playerRemoveFromGame(loser, PLAYER_LOSER, game->length, tournament_id);
+    // compare with the game's ids, a removed player is NULL here
+    Player winner = game.winners_id == game.player1_id ? player1 : player2;
+    Player loser  = game.winners_id == game.player1_id ? player2 : player1;
+    playerRemoveFromGame(winner, PLAYER_WINNER, game.length, tournament_id);
+    playerRemoveFromGame(loser, PLAYER_LOSER, game.length, tournament_id);
+}
+
+// ------------------ STATIC FUNCTIONS IMPLEMENTATION ---------------- //
+
+/**
+ * Make room for a new block at the end of a list whose blocks are all full,
+ * and copy num_of_games games into it (they become part of the list).
+ * A block left empty by gameListRemove is reused.
+ * */
+static bool addBlock(GameList list, const struct chess_game_t* games, int num_of_games)
+{
+    int block = list->size / GAMES_PER_BLOCK;
+    if (block == list->num_of_blocks)
+    {
+        if (block == list->blocks_capacity && !growBlocks(list))
+        {
+            return false;
+        }
+        list->blocks[block] = list->directory != NULL
+                              ? mapBlock(list, block)
+                              : (Game)arenaAlloc(list->arena, sizeof(struct chess_game_t) * GAMES_PER_BLOCK);
+        if (list->blocks[block] == NULL)
+        {
+            return false;
+        }
+        list->num_of_blocks++;
+    }
+    if (num_of_games > 0)
+    {
+        memcpy(list->blocks[block], games, sizeof(struct chess_game_t) * num_of_games);
+        list->size += num_of_games;
+    }
+    return true;
+}
+
+/**
+ * Return a new block for a list stored in a file.
+ * The first block of every segment grows the file by a segment and maps it.
+ * Return NULL if that failed.
+ * */
+static Game mapBlock(GameList list, int block)
+{
+    if (block % BLOCKS_PER_SEGMENT != 0)
+    {
+        return list->blocks[block - 1] + GAMES_PER_BLOCK;
+    }
+    off_t offset = (off_t)(block / BLOCKS_PER_SEGMENT) * SEGMENT_SIZE;
+    if (ftruncate(list->file, offset + SEGMENT_SIZE) != 0)
+    {
+        return NULL;
+    }
+    void* segment = mmap(NULL, SEGMENT_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, list->file, offset);
+    return segment == MAP_FAILED ? NULL : (Game)segment;
+}
+
+/**
+ * Create a file for games in directory, and return its descriptor (or NO_FILE).
+ * The file is unlinked at once: it lives as long as it is open or mapped, and never outlives the process.
+ * */
+static int createFile(const char* directory)
+{
+    char* path = (char*)malloc(strlen(directory) + sizeof(FILE_TEMPLATE));
+    if (path == NULL)
+    {
+        return NO_FILE;
+    }
+    strcpy(path, directory);
+    strcat(path, FILE_TEMPLATE);
+    int file = mkstemp(path);
+    if (file >= 0)
+    {
+        unlink(path);
+    }
+    free(path);
+    return file < 0 ? NO_FILE : file;
 }
 
-// ------------------ STRUCT FUNCTIONS IMPLEMENTATION ---------------- //
+static void unmapBlocks(GameList list)
+{
+    for (int block = 0; block < list->num_of_blocks; block += BLOCKS_PER_SEGMENT)
+    {
+        munmap(list->blocks[block], SEGMENT_SIZE);
+    }
+}
 
-MapDataElement copyGame(MapDataElement game)
+/**
+ * The part of gameListFreeze for a list stored in a file: the encoded games are written to a new file
+ * and mapped read-only, and the file of the blocks is released.
+ * Return NULL (leaving the list untouched) if that failed.
+ * */
+static GameList freezeToFile(GameList list, Arena arena, ArenaMark mark, const unsigned char* buffer, int frozen_size)
 {
-    if(game == NULL)
+    int file = createFile(list->directory);
+    if (file == NO_FILE)
+    {
+        return NULL;
+    }
+    int written = 0;
+    while (written < frozen_size)
+    {
+        ssize_t result = write(file, buffer + written, frozen_size - written);
+        if (result < 0 && errno != EINTR)
+        {
+            close(file);
+            return NULL;
+        }
+        written += result < 0 ? 0 : (int)result;
+    }
+    void* frozen = mmap(NULL, frozen_size, PROT_READ, MAP_SHARED, file, 0);
+    close(file); // the mapping keeps the file
+    if (frozen == MAP_FAILED)
     {
         return NULL;
     }
-    Game new_game = (Game)malloc(sizeof(*new_game));
-    if(new_game == NULL)
+
+    // the blocks directory is released with the old list, so the segments are kept aside until then
+    int num_of_segments = (list->num_of_blocks + BLOCKS_PER_SEGMENT - 1) / BLOCKS_PER_SEGMENT;
+    Game* segments = (Game*)malloc(sizeof(Game) * (num_of_segments > 0 ? num_of_segments : 1));
+    if (segments == NULL)
     {
+        munmap(frozen, frozen_size);
         return NULL;
     }
+    for (int i = 0; i < num_of_segments; i++)
+    {
+        segments[i] = list->blocks[i * BLOCKS_PER_SEGMENT];
+    }
+    int size = list->size;
+    int blocks_file = list->file;
+    char* directory = list->directory;
+    GameList new_list = (GameList)arenaRewind(arena, mark, sizeof(*new_list));
+    if (new_list == NULL)
+    {
+        free(segments);
+        munmap(frozen, frozen_size);
+        return NULL;
+    }
+    for (int i = 0; i < num_of_segments; i++)
+    {
+        munmap(segments[i], SEGMENT_SIZE);
+    }
+    free(segments);
+    close(blocks_file);
+
+    new_list->arena = arena;
+    new_list->size = size;
+    new_list->num_of_blocks = 0;
+    new_list->blocks_capacity = 0;
+    new_list->blocks = NULL;
+    new_list->frozen = (unsigned char*)frozen;
+    new_list->frozen_size = frozen_size;
+    new_list->directory = directory;
+    new_list->file = NO_FILE;
+    return new_list;
+}
+
+/**
+ * Double the number of blocks the list can point to.
+ * The old directory stays in the arena, it is small compared to the blocks themselves.
+ * */
+static bool growBlocks(GameList list)
+{
+    Game* new_blocks = (Game*)arenaAlloc(list->arena, sizeof(Game) * 2 * list->blocks_capacity);
+    if (new_blocks == NULL)
+    {
+        return false;
+    }
+    memcpy(new_blocks, list->blocks, sizeof(Game) * list->blocks_capacity);
+    list->blocks = new_blocks;
+    list->blocks_capacity *= 2;
+    return true;
+}
+
+/**
+ * Write the frozen form of an active list into buffer, return its size in bytes.
+ * */
+static int encodeGames(GameList list, unsigned char* buffer)
+{
+    int results_size = (list->size + RESULTS_PER_BYTE - 1) / RESULTS_PER_BYTE;
+    memset(buffer, 0, results_size);
+    int offset = results_size;
+    long long last_player1_id = 0;
+    for (int i = 0; i < list->size; i++)
+    {
+        Game game = gameListGet(list, i);
+        int result = game->winners_id == GAME_DRAW        ? RESULT_DRAW
+                   : game->winners_id == game->player1_id ? RESULT_FIRST_PLAYER
+                   : RESULT_SECOND_PLAYER;
+        buffer[i / RESULTS_PER_BYTE] |= result << (2 * (i % RESULTS_PER_BYTE));
+
+        offset += writeVarint(buffer + offset, zigzagEncode((long long)game->player1_id - last_player1_id));
+        offset += writeVarint(buffer + offset,
+                              zigzagEncode((long long)game->player2_id - (long long)game->player1_id));
+        offset += writeVarint(buffer + offset, game->length);
+        last_player1_id = game->player1_id;
+    }
+    return offset;
+}
 
-    new_game->length     = ((Game)game)->length;
-    new_game->player1_id = ((Game)game)->player1_id;
-    new_game->player2_id = ((Game)game)->player2_id;
-    new_game->winners_id = ((Game)game)->winners_id;
+/**
+ * Write value 7 bits at a time, lowest bits first. Return the number of bytes written.
+ * */
+static int writeVarint(unsigned char* buffer, unsigned long long value)
+{
+    int size = 0;
+    while (value >= 0x80)
+    {
+        buffer[size++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    buffer[size++] = (unsigned char)value;
+    return size;
+}
 
-    return (MapDataElement)new_game;
+/**
+ * Read a value written by writeVarint. Return the number of bytes read.
+ * */
+static int readVarint(const unsigned char* buffer, unsigned long long* value)
+{
+    int size = 0;
+    int shift = 0;
+    *value = 0;
+    do
+    {
+        *value |= (unsigned long long)(buffer[size] & 0x7F) << shift;
+        shift += 7;
+    } while (buffer[size++] & 0x80);
+    return size;
+}
+
+/**
+ * Map small negative and positive numbers to small unsigned numbers (0, -1, 1, -2, ... -> 0, 1, 2, 3, ...).
+ * */
+static unsigned long long zigzagEncode(long long value)
+{
+    return value < 0 ? ((unsigned long long)(-(value + 1)) << 1) | 1 : (unsigned long long)value << 1;
+}
+
+static long long zigzagDecode(unsigned long long value)
+{
+    return (value & 1) ? -(long long)(value >> 1) - 1 : (long long)(value >> 1);
 }
\ No newline at end of file
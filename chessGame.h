@@ -2,22 +2,119 @@
 #define _CHESSGAME_H_
 
 #include "chessPlayer.h"
+#include "chessArena.h"
 
 #define GAME_DRAW 0 // winners_id if the game ended with a draw.
 
 typedef struct chess_game_t *Game;
+typedef struct chess_game_list_t *GameList;
 
 /**
- * Create a map of players.
+ * A copy of a game's data, as read by a GameIterator.
  * */
-Map gameCreateMap(void);
+typedef struct chess_game_record_t {
+    int player1_id;
+    int player2_id;
+    int winners_id;
+    int length;
+} GameRecord;
 
 /**
- * Create a new game.
- * Add that game to the required map.
+ * Reads the games of a list one by one, in the order they were added.
+ * Works on both active and frozen lists. Holds no resources, so it can be simply dropped.
+ * */
+typedef struct chess_game_iterator_t {
+    int index;        // index of the next game
+    int offset;       // position of the next game in a frozen list
+    GameRecord game;  // the last game read
+} GameIterator;
+
+/**
+ * Create an empty list of games.
+ * The list and all of its games are allocated from arena, and released with it.
+ * Return NULL if an error occured (malloc failed).
+ * */
+GameList gameListCreate(Arena arena);
+
+/**
+ * Store the games of an empty list in a file of directory instead of in its arena.
+ * The blocks of games are mapped from the file, so the system pages them in and out as needed,
+ * and a frozen list is mapped from a file of its own.
+ * Return false if an error occured (the file could not be created), and then the list is left untouched.
+ * */
+bool gameListMoveToFile(GameList list, const char* directory);
+
+/**
+ * Release the files of a list, before its arena is released. Does nothing for a list kept in memory.
+ * */
+void gameListRelease(GameList list);
+
+/**
+ * Copy a list of games into another arena.
+ * The copy is kept in memory, even if list is stored in a file.
+ * Return NULL if an error occured (malloc failed).
+ * */
+GameList gameListCopy(GameList list, Arena arena);
+
+/**
+ * Create a new game at the end of the list.
  * Return false if an error occured (malloc failed), otherwise return true.
  * */
-bool gameAddToMap(Map map, int game_id, int length, int player1_id, int player2_id, int winners_id);
+bool gameListAdd(GameList list, int length, int player1_id, int player2_id, int winners_id);
+
+/**
+ * Remove the game at index from the list, keeping the order of the other games.
+ * Cheap for the last game of the list, which is the only one removed in practice.
+ * */
+void gameListRemove(GameList list, int index);
+
+/**
+ * Return the game at index (0 <= index < gameListGetSize(list)).
+ * Games keep the order in which they were added.
+ * */
+Game gameListGet(GameList list, int index);
+
+int gameListGetSize(GameList list);
+
+/**
+ * Convert a list into its compact read-only form (used once a tournament has ended).
+ * The list must be the last thing allocated in arena after mark: everything after mark
+ * is released and replaced by the frozen list.
+ * Return the frozen list, or NULL if malloc failed (and then the list is left untouched).
+ * NOTE: only gameListGetSize, gameListCopy and the iterator functions work on a frozen list.
+ * */
+GameList gameListFreeze(GameList list, Arena arena, ArenaMark mark);
+
+bool gameListIsFrozen(GameList list);
+
+/**
+ * Return the size in bytes of the raw form of a list, see gameListDump.
+ * */
+int gameListGetDumpSize(GameList list);
+
+/**
+ * Write the raw form of a list into buffer (gameListGetDumpSize(list) bytes).
+ * The raw form of a frozen list is its encoding, and of an active list its game records.
+ * It holds no pointers, so it can be stored as is and given back to gameListRestore.
+ * */
+void gameListDump(GameList list, void* buffer);
+
+/**
+ * Create a list inside arena from the raw form written by gameListDump.
+ * Return NULL if malloc failed or if size does not fit num_of_games.
+ * */
+GameList gameListRestore(Arena arena, const void* data, int size, int num_of_games, bool frozen);
+
+/**
+ * Start reading a list from its first game.
+ * */
+void gameIteratorInit(GameIterator* iterator);
+
+/**
+ * Read the next game of the list into iterator->game.
+ * Return false if there are no more games.
+ * */
+bool gameIteratorNext(GameList list, GameIterator* iterator);
 
 /**
  * Remove a player from a game.
@@ -25,17 +122,23 @@ bool gameAddToMap(Map map, int game_id, int length, int player1_id, int player2_
  * */
 void gameRemovePlayer(Game game, Player player, Player other_player, int tournament_id);
 
+/**
+ * Like gameRemovePlayer, for a player given by its id (it may already be out of the system).
+ * other_player is NULL if it is removed too, then no one is updated.
+ * */
+void gameRemovePlayerID(Game game, int player_id, Player other_player, int tournament_id);
+
 /**
  * Update the statistics of the players when removing a game from the system.
  * */
-void gameRemove(Game game, Player player1, Player player2, int tournament_id);
+void gameRemove(GameRecord game, Player player1, Player player2, int tournament_id);
 
 /**
- * Return game's key, if such game exist on the list.
- * If game does not exist, return 0 (reminder: key > 0). 
+ * Return game's index + 1, if such game exist on the list.
+ * If game does not exist, return 0.
  * NOTE: The order of the players doesn't matter.
  * */
-int gameExists(Map games, int player1_id, int player2_id);
+int gameExists(GameList games, int player1_id, int player2_id);
 
 // Simple getters.
 
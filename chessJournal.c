@@ -0,0 +1,896 @@
+#define _POSIX_C_SOURCE 200809L // fsync, fork, mmap, pthreads, readdir
+
+#include "chessJournal.h"
+#include "chessSystemExt.h"
+#include "chessSystemPrivate.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/*
+ * A journal is a chain of generations. Log n holds the records logged while it was open,
+ * and snapshot n holds the state of the system before the first record of log n.
+ * So a system is recovered from its latest snapshot and every log from there on.
+ *
+ * log:    "CHSJ", version, then records: body size, body checksum, body.
+ * body:   record type, its int arguments, and the location of JOURNAL_ADD_TOURNAMENT.
+ * Every number is a 4 bytes little endian int.
+ */
+
+// ------------------ DEFINES ---------------- //
+
+#define LOG_MAGIC "CHSJ"
+#define LOG_VERSION 1
+#define WORD_SIZE 4
+#define LOG_HEADER_SIZE (2 * WORD_SIZE)
+#define RECORD_HEADER_SIZE (2 * WORD_SIZE)
+#define MAX_RECORD_ARGS 5
+#define DEFAULT_MAX_BATCH_RECORDS 64
+#define DEFAULT_MAX_DELAY_MS 10
+#define INITIAL_BUFFER_SIZE 4096
+#define MAX_GENERATION_DIGITS 10
+#define LOG_SUFFIX ".log"
+#define SNAPSHOT_SUFFIX ".snap"
+#define NO_GENERATION 0 // generations start at 1
+
+typedef struct chess_journal_buffer_t {
+    unsigned char* data;
+    size_t size;
+    size_t capacity;
+} Buffer;
+
+struct chess_journal_t {
+    char* path;
+    int generation;          // of the log being written
+    int file;
+    int max_batch_records;
+    int max_delay_ms;
+    pid_t compactor;         // the process writing a snapshot, or 0
+    int compaction_generation;
+    pthread_t flusher;
+    pthread_mutex_t lock;    // guards every field below
+    pthread_cond_t wake;     // the flusher has something to do
+    pthread_cond_t synced;   // the flusher made records durable
+    Buffer pending;          // records that were not written yet
+    Buffer writing;          // the batch the flusher is writing
+    int num_of_pending;
+    long num_of_appended;
+    long num_of_durable;
+    struct timespec oldest;  // when the oldest pending record was appended
+    bool force;              // write the pending records without waiting for the bounds
+    bool closing;
+    bool failed;
+};
+
+/**
+ * The generations found on disk, NO_GENERATION where there are none.
+ * */
+typedef struct chess_journal_generations_t {
+    int first_log;
+    int last_log;
+    int last_snapshot;
+    int last;
+} Generations;
+
+typedef void (*FileVisitor)(int generation, bool snapshot, void* context);
+
+// ------------------ FUNCTIONS DECLARATIONS ---------------- //
+
+static Journal journalCreate(const char* path, int generation, const ChessJournalOptions* options,
+                             ChessResult* result);
+static void* flushRecords(void* argument);
+static bool syncJournal(Journal journal);
+static void reapCompactor(Journal journal, bool wait);
+static bool isSystemEmpty(ChessSystem chess);
+static int openLog(const char* path, int generation);
+static bool writeAll(int file, const unsigned char* data, size_t size);
+static bool reserve(Buffer* buffer, size_t size);
+static struct timespec addMilliseconds(struct timespec time, int milliseconds);
+
+static ChessResult replayLog(ChessSystem chess, const char* name);
+static ChessResult replayRecord(ChessSystem chess, const unsigned char* body, size_t size);
+
+static char* fileName(const char* path, int generation, const char* suffix);
+static bool scanFiles(const char* path, FileVisitor visit, void* context);
+static bool parseFileName(const char* name, const char* base, int* generation, bool* snapshot);
+static void addGeneration(int generation, bool snapshot, void* context);
+static void removeFileIfOlder(int generation, bool snapshot, void* context);
+static bool findGenerations(const char* path, Generations* generations);
+
+static unsigned int checksum(const unsigned char* data, size_t size);
+static void putWord(unsigned char* bytes, unsigned long value);
+static unsigned long getWord(const unsigned char* bytes);
+
+// ------------------ FUNCTIONS IMPLEMENTATION ---------------- //
+
+ChessResult chessJournalOpen(ChessSystem chess, const char* path, const ChessJournalOptions* options)
+{
+    if (chess == NULL || path == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    journalDestroy(chess->journal);
+    chess->journal = NULL;
+
+    Generations generations;
+    if (!findGenerations(path, &generations))
+    {
+        return CHESS_SAVE_FAILURE;
+    }
+    int generation = generations.last + 1;
+    if (generations.last == NO_GENERATION && !isSystemEmpty(chess))
+    {
+        // the records alone won't bring back what the system already holds
+        char* name = fileName(path, generation, SNAPSHOT_SUFFIX);
+        if (name == NULL)
+        {
+            return CHESS_OUT_OF_MEMORY;
+        }
+        ChessResult result = chessSaveSnapshot(chess, name);
+        free(name);
+        if (result != CHESS_SUCCESS)
+        {
+            return result;
+        }
+    }
+
+    ChessResult result;
+    chess->journal = journalCreate(path, generation, options, &result);
+    return result;
+}
+
+ChessResult chessJournalSync(ChessSystem chess)
+{
+    if (chess == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    if (chess->journal == NULL)
+    {
+        return CHESS_SUCCESS;
+    }
+    reapCompactor(chess->journal, false);
+    return syncJournal(chess->journal) ? CHESS_SUCCESS : CHESS_SAVE_FAILURE;
+}
+
+ChessResult chessJournalCompact(ChessSystem chess)
+{
+    if (chess == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    Journal journal = chess->journal;
+    if (journal == NULL)
+    {
+        return CHESS_SAVE_FAILURE;
+    }
+    reapCompactor(journal, false);
+    if (journal->compactor != 0)
+    {
+        return CHESS_SUCCESS;
+    }
+
+    int generation = journal->generation + 1;
+    char* snapshot_name = fileName(journal->path, generation, SNAPSHOT_SUFFIX);
+    if (snapshot_name == NULL)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
+    int file = openLog(journal->path, generation);
+    if (file < 0)
+    {
+        free(snapshot_name);
+        return CHESS_SAVE_FAILURE;
+    }
+
+    // switch to the new log once the old one is complete.
+    // a failed old log doesn't matter, the snapshot replaces it.
+    syncJournal(journal);
+    pthread_mutex_lock(&journal->lock);
+    close(journal->file);
+    journal->file = file;
+    journal->generation = generation;
+    pthread_mutex_unlock(&journal->lock);
+
+    // the child sees the system as it is now, while the parent goes on changing it.
+    // the games the child would update may be stored in files it shares with the parent.
+    removalsApplyAll(chess->removals, chess->players, chess->tournaments);
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        _exit(chessSaveSnapshot(chess, snapshot_name) == CHESS_SUCCESS ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+    free(snapshot_name);
+    if (pid < 0)
+    {
+        return CHESS_SAVE_FAILURE;
+    }
+    journal->compactor = pid;
+    journal->compaction_generation = generation;
+    if (chess->games_in_files)
+    {
+        // games stored in files are shared with the child instead of copied on write,
+        // so the system must not change before the snapshot is complete
+        reapCompactor(journal, true);
+    }
+    return CHESS_SUCCESS;
+}
+
+ChessSystem chessRecoverFromJournal(const char* path, ChessResult* result)
+{
+    if (path == NULL)
+    {
+        *result = CHESS_NULL_ARGUMENT;
+        return NULL;
+    }
+    Generations generations;
+    if (!findGenerations(path, &generations))
+    {
+        *result = CHESS_SAVE_FAILURE;
+        return NULL;
+    }
+
+    ChessSystem chess;
+    int first_log = generations.first_log;
+    if (generations.last_snapshot != NO_GENERATION)
+    {
+        char* name = fileName(path, generations.last_snapshot, SNAPSHOT_SUFFIX);
+        if (name == NULL)
+        {
+            *result = CHESS_OUT_OF_MEMORY;
+            return NULL;
+        }
+        chess = chessLoadSnapshot(name, result);
+        free(name);
+        if (chess == NULL)
+        {
+            return NULL;
+        }
+        first_log = generations.last_snapshot;
+    }
+    else
+    {
+        chess = chessCreate();
+        if (chess == NULL)
+        {
+            *result = CHESS_OUT_OF_MEMORY;
+            return NULL;
+        }
+    }
+
+    *result = CHESS_SUCCESS;
+    for (int generation = first_log; generation <= generations.last_log && *result == CHESS_SUCCESS; generation++)
+    {
+        char* name = fileName(path, generation, LOG_SUFFIX);
+        *result = (name == NULL) ? CHESS_OUT_OF_MEMORY : replayLog(chess, name);
+        free(name);
+    }
+    if (*result != CHESS_SUCCESS)
+    {
+        chessDestroy(chess);
+        return NULL;
+    }
+    return chess;
+}
+
+void journalRecord(Journal journal, JournalRecordType type, const int* args, int num_of_args, const char* text)
+{
+    if (journal == NULL)
+    {
+        return;
+    }
+    size_t text_length = (text == NULL) ? 0 : strlen(text);
+    size_t body_size = WORD_SIZE * (1 + num_of_args) + text_length;
+
+    pthread_mutex_lock(&journal->lock);
+    if (!reserve(&journal->pending, RECORD_HEADER_SIZE + body_size))
+    {
+        journal->failed = true;
+        pthread_mutex_unlock(&journal->lock);
+        return;
+    }
+    unsigned char* record = journal->pending.data + journal->pending.size;
+    unsigned char* body = record + RECORD_HEADER_SIZE;
+    putWord(body, (unsigned long)type);
+    for (int i = 0; i < num_of_args; i++)
+    {
+        putWord(body + WORD_SIZE * (1 + i), (unsigned long)(unsigned int)args[i]);
+    }
+    if (text_length > 0)
+    {
+        memcpy(body + WORD_SIZE * (1 + num_of_args), text, text_length);
+    }
+    putWord(record, (unsigned long)body_size);
+    putWord(record + WORD_SIZE, checksum(body, body_size));
+    journal->pending.size += RECORD_HEADER_SIZE + body_size;
+    journal->num_of_appended++;
+
+    // the flusher only needs to hear about the first record of a batch, and about a full batch
+    if (journal->num_of_pending++ == 0)
+    {
+        clock_gettime(CLOCK_REALTIME, &journal->oldest);
+        pthread_cond_signal(&journal->wake);
+    }
+    else if (journal->num_of_pending >= journal->max_batch_records)
+    {
+        pthread_cond_signal(&journal->wake);
+    }
+    pthread_mutex_unlock(&journal->lock);
+}
+
+void journalWaitForCompaction(Journal journal)
+{
+    if (journal != NULL)
+    {
+        reapCompactor(journal, true);
+    }
+}
+
+void journalDestroy(Journal journal)
+{
+    if (journal == NULL)
+    {
+        return;
+    }
+    pthread_mutex_lock(&journal->lock);
+    journal->closing = true;
+    pthread_cond_signal(&journal->wake);
+    pthread_mutex_unlock(&journal->lock);
+    pthread_join(journal->flusher, NULL);
+    reapCompactor(journal, true);
+
+    close(journal->file);
+    pthread_cond_destroy(&journal->synced);
+    pthread_cond_destroy(&journal->wake);
+    pthread_mutex_destroy(&journal->lock);
+    free(journal->pending.data);
+    free(journal->writing.data);
+    free(journal->path);
+    free(journal);
+}
+
+// ------------------ THE JOURNAL ---------------- //
+
+static Journal journalCreate(const char* path, int generation, const ChessJournalOptions* options,
+                             ChessResult* result)
+{
+    *result = CHESS_OUT_OF_MEMORY;
+    Journal journal = (Journal)calloc(1, sizeof(*journal));
+    if (journal == NULL)
+    {
+        return NULL;
+    }
+    journal->path = (char*)malloc(strlen(path) + 1);
+    if (journal->path == NULL || !reserve(&journal->pending, INITIAL_BUFFER_SIZE)
+        || !reserve(&journal->writing, INITIAL_BUFFER_SIZE))
+    {
+        free(journal->path);
+        free(journal->pending.data);
+        free(journal->writing.data);
+        free(journal);
+        return NULL;
+    }
+    strcpy(journal->path, path);
+    journal->generation = generation;
+    journal->max_batch_records = DEFAULT_MAX_BATCH_RECORDS;
+    journal->max_delay_ms = DEFAULT_MAX_DELAY_MS;
+    if (options != NULL && options->max_batch_records > 0)
+    {
+        journal->max_batch_records = options->max_batch_records;
+    }
+    if (options != NULL && options->max_delay_ms > 0)
+    {
+        journal->max_delay_ms = options->max_delay_ms;
+    }
+
+    journal->file = openLog(path, generation);
+    if (journal->file < 0)
+    {
+        *result = CHESS_SAVE_FAILURE;
+    }
+    else if (pthread_mutex_init(&journal->lock, NULL) == 0)
+    {
+        if (pthread_cond_init(&journal->wake, NULL) == 0)
+        {
+            if (pthread_cond_init(&journal->synced, NULL) == 0)
+            {
+                if (pthread_create(&journal->flusher, NULL, flushRecords, journal) == 0)
+                {
+                    *result = CHESS_SUCCESS;
+                    return journal;
+                }
+                pthread_cond_destroy(&journal->synced);
+            }
+            pthread_cond_destroy(&journal->wake);
+        }
+        pthread_mutex_destroy(&journal->lock);
+    }
+    if (journal->file >= 0)
+    {
+        close(journal->file);
+    }
+    free(journal->path);
+    free(journal->pending.data);
+    free(journal->writing.data);
+    free(journal);
+    return NULL;
+}
+
+/**
+ * The flusher thread: writes and fsyncs the pending records once there are max_batch_records
+ * of them, once the oldest is max_delay_ms old, or when asked to.
+ * */
+static void* flushRecords(void* argument)
+{
+    Journal journal = (Journal)argument;
+    pthread_mutex_lock(&journal->lock);
+    while (true)
+    {
+        if (journal->num_of_pending == 0)
+        {
+            if (journal->closing)
+            {
+                break;
+            }
+            pthread_cond_wait(&journal->wake, &journal->lock);
+            continue;
+        }
+        if (!journal->force && !journal->closing && journal->num_of_pending < journal->max_batch_records)
+        {
+            struct timespec deadline = addMilliseconds(journal->oldest, journal->max_delay_ms);
+            if (pthread_cond_timedwait(&journal->wake, &journal->lock, &deadline) != ETIMEDOUT)
+            {
+                continue;
+            }
+        }
+
+        // take the batch, and let the writers fill the other buffer meanwhile
+        Buffer batch = journal->pending;
+        journal->pending = journal->writing;
+        journal->writing = batch;
+        int num_of_records = journal->num_of_pending;
+        journal->num_of_pending = 0;
+        journal->force = false;
+        int file = journal->file;
+        pthread_mutex_unlock(&journal->lock);
+
+        bool written = writeAll(file, batch.data, batch.size) && fsync(file) == 0;
+
+        pthread_mutex_lock(&journal->lock);
+        journal->writing.size = 0;
+        if (!written)
+        {
+            journal->failed = true;
+        }
+        journal->num_of_durable += num_of_records;
+        pthread_cond_broadcast(&journal->synced);
+    }
+    pthread_mutex_unlock(&journal->lock);
+    return NULL;
+}
+
+/**
+ * Wait until every record appended so far is durable. Return false if the journal failed.
+ * */
+static bool syncJournal(Journal journal)
+{
+    pthread_mutex_lock(&journal->lock);
+    if (journal->num_of_durable < journal->num_of_appended)
+    {
+        journal->force = true;
+        pthread_cond_signal(&journal->wake);
+    }
+    while (journal->num_of_durable < journal->num_of_appended)
+    {
+        pthread_cond_wait(&journal->synced, &journal->lock);
+    }
+    bool result = !journal->failed;
+    pthread_mutex_unlock(&journal->lock);
+    return result;
+}
+
+/**
+ * Check whether the running compaction (if any) is over, waiting for it if wait is true.
+ * Once its snapshot is complete, the files it replaces are deleted.
+ * */
+static void reapCompactor(Journal journal, bool wait)
+{
+    if (journal->compactor == 0)
+    {
+        return;
+    }
+    int status;
+    pid_t pid = waitpid(journal->compactor, &status, wait ? 0 : WNOHANG);
+    if (pid == 0) // still running
+    {
+        return;
+    }
+    if (pid == journal->compactor && WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS)
+    {
+        scanFiles(journal->path, removeFileIfOlder, journal);
+    }
+    journal->compactor = 0;
+}
+
+static bool isSystemEmpty(ChessSystem chess)
+{
+    return mapGetSize(chess->tournaments) == 0 && mapGetSize(chess->players) == 0
+           && bitmapGetNext(chess->former_players, 0) < 0;
+}
+
+/**
+ * Create the log of a generation and write its header. Return its descriptor, or -1.
+ * */
+static int openLog(const char* path, int generation)
+{
+    char* name = fileName(path, generation, LOG_SUFFIX);
+    if (name == NULL)
+    {
+        return -1;
+    }
+    int file = open(name, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    unsigned char header[LOG_HEADER_SIZE];
+    memcpy(header, LOG_MAGIC, WORD_SIZE);
+    putWord(header + WORD_SIZE, LOG_VERSION);
+    if (file >= 0 && (!writeAll(file, header, LOG_HEADER_SIZE) || fsync(file) != 0))
+    {
+        close(file);
+        unlink(name);
+        file = -1;
+    }
+    free(name);
+    return file;
+}
+
+static bool writeAll(int file, const unsigned char* data, size_t size)
+{
+    while (size > 0)
+    {
+        ssize_t written = write(file, data, size);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        size -= (size_t)written;
+    }
+    return true;
+}
+
+/**
+ * Make room for size more bytes in a buffer. Return false if malloc failed.
+ * */
+static bool reserve(Buffer* buffer, size_t size)
+{
+    if (buffer->size + size <= buffer->capacity)
+    {
+        return true;
+    }
+    size_t new_capacity = buffer->capacity ? buffer->capacity : INITIAL_BUFFER_SIZE;
+    while (new_capacity < buffer->size + size)
+    {
+        new_capacity *= 2;
+    }
+    unsigned char* new_data = (unsigned char*)realloc(buffer->data, new_capacity);
+    if (new_data == NULL)
+    {
+        return false;
+    }
+    buffer->data = new_data;
+    buffer->capacity = new_capacity;
+    return true;
+}
+
+static struct timespec addMilliseconds(struct timespec time, int milliseconds)
+{
+    time.tv_sec += milliseconds / 1000;
+    time.tv_nsec += (long)(milliseconds % 1000) * 1000000L;
+    if (time.tv_nsec >= 1000000000L)
+    {
+        time.tv_sec++;
+        time.tv_nsec -= 1000000000L;
+    }
+    return time;
+}
+
+// ------------------ RECOVERY ---------------- //
+
+/**
+ * Apply every record of a log to chess, up to the first torn one.
+ * A missing log is skipped: it is a generation that was never written to.
+ * */
+static ChessResult replayLog(ChessSystem chess, const char* name)
+{
+    int file = open(name, O_RDONLY);
+    if (file < 0)
+    {
+        return errno == ENOENT ? CHESS_SUCCESS : CHESS_SAVE_FAILURE;
+    }
+    struct stat file_stat;
+    if (fstat(file, &file_stat) != 0)
+    {
+        close(file);
+        return CHESS_SAVE_FAILURE;
+    }
+    size_t size = (size_t)file_stat.st_size;
+    if (size < LOG_HEADER_SIZE) // died before the header was written
+    {
+        close(file);
+        return CHESS_SUCCESS;
+    }
+    void* data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file); // the mapping keeps the file alive
+    if (data == MAP_FAILED)
+    {
+        return CHESS_SAVE_FAILURE;
+    }
+    posix_madvise(data, size, POSIX_MADV_SEQUENTIAL);
+
+    const unsigned char* position = (const unsigned char*)data;
+    const unsigned char* end = position + size;
+    ChessResult result = CHESS_SUCCESS;
+    if (memcmp(position, LOG_MAGIC, WORD_SIZE) != 0 || getWord(position + WORD_SIZE) != LOG_VERSION)
+    {
+        result = CHESS_SAVE_FAILURE;
+    }
+    position += LOG_HEADER_SIZE;
+    while (result == CHESS_SUCCESS && (size_t)(end - position) >= RECORD_HEADER_SIZE)
+    {
+        size_t body_size = getWord(position);
+        const unsigned char* body = position + RECORD_HEADER_SIZE;
+        if (body_size > (size_t)(end - body) || checksum(body, body_size) != getWord(position + WORD_SIZE))
+        {
+            break; // torn
+        }
+        result = replayRecord(chess, body, body_size);
+        position = body + body_size;
+    }
+    munmap(data, size);
+    return result;
+}
+
+/**
+ * Apply one record to chess. Only malloc failures and invalid records are errors:
+ * the calls succeeded when they were logged, so they succeed again.
+ * */
+static ChessResult replayRecord(ChessSystem chess, const unsigned char* body, size_t size)
+{
+    int args[MAX_RECORD_ARGS];
+    int num_of_args = 0;
+    bool has_location = false;
+    JournalRecordType type = (size >= WORD_SIZE) ? (JournalRecordType)getWord(body) : 0;
+    switch (type)
+    {
+        case JOURNAL_ADD_TOURNAMENT:
+            num_of_args = 2;
+            has_location = true;
+            break;
+        case JOURNAL_ADD_GAME:
+            num_of_args = 5;
+            break;
+        case JOURNAL_REMOVE_TOURNAMENT:
+        case JOURNAL_REMOVE_PLAYER:
+        case JOURNAL_END_TOURNAMENT:
+            num_of_args = 1;
+            break;
+        default:
+            return CHESS_SAVE_FAILURE;
+    }
+    size_t args_size = WORD_SIZE * (1 + num_of_args);
+    if (size < args_size || (!has_location && size != args_size))
+    {
+        return CHESS_SAVE_FAILURE;
+    }
+    for (int i = 0; i < num_of_args; i++)
+    {
+        args[i] = (int)(unsigned int)getWord(body + WORD_SIZE * (1 + i));
+    }
+
+    ChessResult result = CHESS_SUCCESS;
+    switch (type)
+    {
+        case JOURNAL_ADD_TOURNAMENT:
+        {
+            size_t length = size - args_size;
+            char* location = (char*)malloc(length + 1);
+            if (location == NULL)
+            {
+                return CHESS_OUT_OF_MEMORY;
+            }
+            memcpy(location, body + args_size, length);
+            location[length] = '\0';
+            result = chessAddTournament(chess, args[0], args[1], location);
+            free(location);
+            break;
+        }
+        case JOURNAL_ADD_GAME:
+            result = chessAddGame(chess, args[0], args[1], args[2], (Winner)args[3], args[4]);
+            break;
+        case JOURNAL_REMOVE_TOURNAMENT:
+            result = chessRemoveTournament(chess, args[0]);
+            break;
+        case JOURNAL_REMOVE_PLAYER:
+            result = chessRemovePlayer(chess, args[0]);
+            break;
+        case JOURNAL_END_TOURNAMENT:
+            result = chessEndTournament(chess, args[0]);
+            break;
+    }
+    return result == CHESS_OUT_OF_MEMORY ? CHESS_OUT_OF_MEMORY : CHESS_SUCCESS;
+}
+
+// ------------------ FILES ---------------- //
+
+/**
+ * Return path.<generation><suffix>, allocated with malloc, or NULL if malloc failed.
+ * */
+static char* fileName(const char* path, int generation, const char* suffix)
+{
+    char* name = (char*)malloc(strlen(path) + 1 + MAX_GENERATION_DIGITS + strlen(suffix) + 1);
+    if (name != NULL)
+    {
+        sprintf(name, "%s.%d%s", path, generation, suffix);
+    }
+    return name;
+}
+
+/**
+ * Call visit for every journal file of path. Return false if its directory can't be read.
+ * */
+static bool scanFiles(const char* path, FileVisitor visit, void* context)
+{
+    const char* slash = strrchr(path, '/');
+    const char* base = (slash == NULL) ? path : slash + 1;
+    size_t directory_length = (slash == NULL) ? 1 : (slash == path ? 1 : (size_t)(slash - path));
+    char* directory = (char*)malloc(directory_length + 1);
+    if (directory == NULL)
+    {
+        return false;
+    }
+    memcpy(directory, slash == NULL ? "." : path, directory_length);
+    directory[directory_length] = '\0';
+
+    DIR* entries = opendir(directory);
+    free(directory);
+    if (entries == NULL)
+    {
+        return false;
+    }
+    struct dirent* entry;
+    while ((entry = readdir(entries)) != NULL)
+    {
+        int generation;
+        bool snapshot;
+        if (parseFileName(entry->d_name, base, &generation, &snapshot))
+        {
+            visit(generation, snapshot, context);
+        }
+    }
+    closedir(entries);
+    return true;
+}
+
+/**
+ * Check whether name is base.<generation>.log or base.<generation>.snap.
+ * */
+static bool parseFileName(const char* name, const char* base, int* generation, bool* snapshot)
+{
+    size_t base_length = strlen(base);
+    if (strncmp(name, base, base_length) != 0 || name[base_length] != '.')
+    {
+        return false;
+    }
+    const char* digits = name + base_length + 1;
+    const char* position = digits;
+    long value = 0;
+    while (*position >= '0' && *position <= '9' && position - digits < MAX_GENERATION_DIGITS - 1)
+    {
+        value = 10 * value + (*position++ - '0');
+    }
+    if (position == digits || value == NO_GENERATION)
+    {
+        return false;
+    }
+    *generation = (int)value;
+    *snapshot = (strcmp(position, SNAPSHOT_SUFFIX) == 0);
+    return *snapshot || strcmp(position, LOG_SUFFIX) == 0;
+}
+
+static void addGeneration(int generation, bool snapshot, void* context)
+{
+    Generations* generations = (Generations*)context;
+    if (snapshot)
+    {
+        if (generation > generations->last_snapshot)
+        {
+            generations->last_snapshot = generation;
+        }
+    }
+    else
+    {
+        if (generations->first_log == NO_GENERATION || generation < generations->first_log)
+        {
+            generations->first_log = generation;
+        }
+        if (generation > generations->last_log)
+        {
+            generations->last_log = generation;
+        }
+    }
+    if (generation > generations->last)
+    {
+        generations->last = generation;
+    }
+}
+
+/**
+ * Delete a file older than the compaction that just completed.
+ * */
+static void removeFileIfOlder(int generation, bool snapshot, void* context)
+{
+    Journal journal = (Journal)context;
+    if (generation >= journal->compaction_generation)
+    {
+        return;
+    }
+    char* name = fileName(journal->path, generation, snapshot ? SNAPSHOT_SUFFIX : LOG_SUFFIX);
+    if (name != NULL)
+    {
+        unlink(name);
+        free(name);
+    }
+}
+
+static bool findGenerations(const char* path, Generations* generations)
+{
+    generations->first_log = NO_GENERATION;
+    generations->last_log = NO_GENERATION;
+    generations->last_snapshot = NO_GENERATION;
+    generations->last = NO_GENERATION;
+    return scanFiles(path, addGeneration, generations);
+}
+
+// ------------------ HELPERS ---------------- //
+
+/**
+ * FNV-1a hash of a record body.
+ * */
+static unsigned int checksum(const unsigned char* data, size_t size)
+{
+    unsigned int hash = 2166136261u;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static void putWord(unsigned char* bytes, unsigned long value)
+{
+    bytes[0] = (unsigned char)value;
+    bytes[1] = (unsigned char)(value >> 8);
+    bytes[2] = (unsigned char)(value >> 16);
+    bytes[3] = (unsigned char)(value >> 24);
+}
+
+static unsigned long getWord(const unsigned char* bytes)
+{
+    return (unsigned long)bytes[0] | (unsigned long)bytes[1] << 8
+           | (unsigned long)bytes[2] << 16 | (unsigned long)bytes[3] << 24;
+}
@@ -0,0 +1,37 @@
+#ifndef _CHESSJOURNAL_H_
+#define _CHESSJOURNAL_H_
+
+/**
+ * The journal of a ChessSystem: an append-only log of its successful mutations.
+ * It is opened and managed through chessSystemExt.h, this header is what chessSystem.c
+ * needs to feed it.
+ * */
+typedef struct chess_journal_t *Journal;
+
+typedef enum chess_journal_record_type_t {
+    JOURNAL_ADD_TOURNAMENT = 1, // tournament id, max games per player, then the location
+    JOURNAL_ADD_GAME,           // tournament id, first player, second player, winner, play time
+    JOURNAL_REMOVE_TOURNAMENT,  // tournament id
+    JOURNAL_REMOVE_PLAYER,      // player id
+    JOURNAL_END_TOURNAMENT      // tournament id
+} JournalRecordType;
+
+/**
+ * Append a record to the journal. It is written and fsync'd later, together with the records
+ * around it (see ChessJournalOptions).
+ * text may be NULL. If the record can't be kept (malloc failed), the journal remembers it
+ * failed and chessJournalSync reports it.
+ * */
+void journalRecord(Journal journal, JournalRecordType type, const int* args, int num_of_args, const char* text);
+
+/**
+ * Wait for a running compaction (if any), so the next chessJournalCompact starts a new one.
+ * */
+void journalWaitForCompaction(Journal journal);
+
+/**
+ * Write every pending record, wait for a running compaction and close the journal.
+ * */
+void journalDestroy(Journal journal);
+
+#endif
@@ -0,0 +1,663 @@
+#define _POSIX_C_SOURCE 200809L // mmap, posix_madvise
+
+#include "chessSystemExt.h"
+#include "chessSystemPrivate.h"
+#include "chessTournament.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// ------------------ DEFINES ---------------- //
+
+#define NUM_OF_FIELDS 5
+#define FIELD_SIZE 4 // bytes of each field in a binary record
+#define BINARY_RECORD_SIZE (NUM_OF_FIELDS * FIELD_SIZE)
+
+typedef enum {
+    FIELD_TOURNAMENT_ID,
+    FIELD_FIRST_PLAYER,
+    FIELD_SECOND_PLAYER,
+    FIELD_WINNER,
+    FIELD_PLAY_TIME
+} Field;
+
+/**
+ * Where errors are reported to, see ChessLoadErrorHandler.
+ * */
+typedef struct chess_load_reporter_t {
+    ChessLoadErrorHandler on_error;
+    void* context;
+} Reporter;
+
+/**
+ * A well formed record, kept to be added later.
+ * */
+typedef struct chess_load_record_t {
+    int fields[NUM_OF_FIELDS];
+    long record;
+} Record;
+
+typedef struct chess_load_record_list_t {
+    Record* records;
+    long size;
+    long capacity;
+} RecordList;
+
+/**
+ * Reports kept to be made later, in the order of their records. A Reporter of collectError.
+ * */
+typedef struct chess_load_error_list_t {
+    ChessLoadError* errors;
+    long size;
+    long capacity;
+    bool out_of_memory; // some report could not be kept
+} ErrorList;
+
+/**
+ * Where the records of a file go: to chess at once, or to records if it is not NULL.
+ * */
+typedef struct chess_load_target_t {
+    ChessSystem chess;
+    Reporter reporter;
+    RecordList* records;
+} Target;
+
+/**
+ * The tournaments a worker fills in a system of its own (see loadInParallel).
+ * */
+typedef struct chess_load_shard_t {
+    ChessSystem system;
+    const RecordList* records;
+    const int* shard_of_record; // the shard of every record, -1 for the records left to the system itself
+    int index;
+    ErrorList errors;
+    ChessResult result;
+} Shard;
+
+// ------------------ FUNCTIONS DECLARATIONS ---------------- //
+
+static ChessResult load(Target* target, const void* data, size_t size, ChessFileFormat format);
+static ChessResult loadCsv(Target* target, const char* data, size_t size);
+static ChessResult loadBinary(Target* target, const unsigned char* data, size_t size);
+static const char* parseInt(const char* position, const char* end, int* value);
+static ChessResult addRecord(Target* target, const int fields[NUM_OF_FIELDS], long record);
+static void report(Reporter reporter, long record, bool malformed, ChessResult result);
+
+static bool canLoadInParallel(ChessSystem chess);
+static int findOpenEmptyTournaments(ChessSystem chess, int* ids, int capacity);
+static ChessResult loadInParallel(ChessSystem chess, const void* data, size_t size, ChessFileFormat format,
+                                  Reporter reporter, const int* candidates, int num_of_candidates);
+static int assignShards(const RecordList* records, const int* candidates, int num_of_candidates,
+                        int num_of_shards, int* shard_of_record, int* shard_of_candidate);
+static ChessResult createShards(ChessSystem chess, Shard* shards, int num_of_shards,
+                                const int* candidates, const int* shard_of_candidate, int num_of_candidates);
+static void loadShards(void* context, int begin, int end);
+static void destroyShards(Shard* shards, int num_of_shards);
+static bool keepRecord(RecordList* records, const int fields[NUM_OF_FIELDS], long record);
+static void collectError(const ChessLoadError* error, void* context);
+static bool appendErrors(ErrorList* list, const ErrorList* other);
+static bool reserveErrors(ErrorList* list, long size);
+static int compareErrors(const void* error1, const void* error2);
+static int compareInts(const void* value1, const void* value2);
+
+// ------------------ FUNCTIONS IMPLEMENTATION ---------------- //
+
+ChessResult chessLoadGamesFromFile(ChessSystem chess, const char* path, ChessFileFormat format,
+                                   ChessLoadErrorHandler on_error, void* context)
+{
+    if (chess == NULL || path == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    int file = open(path, O_RDONLY);
+    if (file < 0)
+    {
+        return CHESS_SAVE_FAILURE;
+    }
+    struct stat file_stat;
+    if (fstat(file, &file_stat) != 0)
+    {
+        close(file);
+        return CHESS_SAVE_FAILURE;
+    }
+    size_t size = (size_t)file_stat.st_size;
+    if (size == 0) // mmap can't map an empty file
+    {
+        close(file);
+        return CHESS_SUCCESS;
+    }
+    void* data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file); // the mapping keeps the file alive
+    if (data == MAP_FAILED)
+    {
+        return CHESS_SAVE_FAILURE;
+    }
+    posix_madvise(data, size, POSIX_MADV_SEQUENTIAL);
+
+    Reporter reporter = { on_error, context };
+    ChessResult result = CHESS_SUCCESS;
+    int* candidates = NULL;
+    int num_of_candidates = 0;
+    if (canLoadInParallel(chess))
+    {
+        int capacity = mapGetSize(chess->tournaments);
+        candidates = (int*)malloc(sizeof(int) * (capacity > 0 ? capacity : 1));
+        if (candidates == NULL)
+        {
+            result = CHESS_OUT_OF_MEMORY;
+        }
+        else
+        {
+            num_of_candidates = findOpenEmptyTournaments(chess, candidates, capacity);
+        }
+    }
+    if (result == CHESS_SUCCESS)
+    {
+        if (num_of_candidates > 0)
+        {
+            result = loadInParallel(chess, data, size, format, reporter, candidates, num_of_candidates);
+        }
+        else
+        {
+            Target target = { chess, reporter, NULL };
+            result = load(&target, data, size, format);
+        }
+    }
+    free(candidates);
+
+    munmap(data, size);
+    return result;
+}
+
+static ChessResult load(Target* target, const void* data, size_t size, ChessFileFormat format)
+{
+    return format == CHESS_FORMAT_CSV
+           ? loadCsv(target, (const char*)data, size)
+           : loadBinary(target, (const unsigned char*)data, size);
+}
+
+static ChessResult loadCsv(Target* target, const char* data, size_t size)
+{
+    const char* position = data;
+    const char* end = data + size;
+    long line = 0;
+    while (position < end)
+    {
+        line++;
+        const char* line_end = memchr(position, '\n', end - position);
+        if (line_end == NULL)
+        {
+            line_end = end;
+        }
+        const char* content_end = (line_end > position && line_end[-1] == '\r') ? line_end - 1 : line_end;
+        if (content_end == position) // empty line
+        {
+            position = line_end + 1;
+            continue;
+        }
+
+        int fields[NUM_OF_FIELDS];
+        const char* field = position;
+        for (int i = 0; i < NUM_OF_FIELDS && field != NULL; i++)
+        {
+            field = parseInt(field, content_end, &fields[i]);
+            if (field != NULL && i < NUM_OF_FIELDS - 1)
+            {
+                field = (field < content_end && *field == ',') ? field + 1 : NULL;
+            }
+        }
+
+        if (field != content_end)
+        {
+            report(target->reporter, line, true, CHESS_SUCCESS);
+        }
+        else if (addRecord(target, fields, line) == CHESS_OUT_OF_MEMORY)
+        {
+            return CHESS_OUT_OF_MEMORY;
+        }
+        position = line_end + 1;
+    }
+    return CHESS_SUCCESS;
+}
+
+static ChessResult loadBinary(Target* target, const unsigned char* data, size_t size)
+{
+    long num_of_records = (long)(size / BINARY_RECORD_SIZE);
+    for (long record = 0; record < num_of_records; record++)
+    {
+        const unsigned char* bytes = data + record * BINARY_RECORD_SIZE;
+        int fields[NUM_OF_FIELDS];
+        for (int i = 0; i < NUM_OF_FIELDS; i++, bytes += FIELD_SIZE)
+        {
+            unsigned long value = (unsigned long)bytes[0] | (unsigned long)bytes[1] << 8
+                                | (unsigned long)bytes[2] << 16 | (unsigned long)bytes[3] << 24;
+            fields[i] = value > INT_MAX ? (int)((long long)value - 0x100000000LL) : (int)value;
+        }
+        if (addRecord(target, fields, record) == CHESS_OUT_OF_MEMORY)
+        {
+            return CHESS_OUT_OF_MEMORY;
+        }
+    }
+    if (size % BINARY_RECORD_SIZE != 0) // a truncated last record
+    {
+        report(target->reporter, num_of_records, true, CHESS_SUCCESS);
+    }
+    return CHESS_SUCCESS;
+}
+
+/**
+ * Parse a decimal integer (with an optional '-') that starts at position.
+ * Return the position right after it, or NULL if there is no valid int there.
+ * */
+static const char* parseInt(const char* position, const char* end, int* value)
+{
+    bool negative = (position < end && *position == '-');
+    if (negative)
+    {
+        position++;
+    }
+    const char* digits = position;
+    long long result = 0;
+    while (position < end && *position >= '0' && *position <= '9')
+    {
+        result = 10 * result + (*position - '0');
+        if (result > (long long)INT_MAX + 1)
+        {
+            return NULL;
+        }
+        position++;
+    }
+    if (position == digits || (!negative && result > INT_MAX))
+    {
+        return NULL;
+    }
+    *value = (int)(negative ? -result : result);
+    return position;
+}
+
+/**
+ * Add the game of one record (or keep it, see Target), and report it if it was not added.
+ * Return the result of chessAddGame, or CHESS_SUCCESS if the record was reported as malformed.
+ * */
+static ChessResult addRecord(Target* target, const int fields[NUM_OF_FIELDS], long record)
+{
+    int winner = fields[FIELD_WINNER];
+    if (winner != FIRST_PLAYER && winner != SECOND_PLAYER && winner != DRAW)
+    {
+        report(target->reporter, record, true, CHESS_SUCCESS);
+        return CHESS_SUCCESS;
+    }
+    if (target->records != NULL)
+    {
+        return keepRecord(target->records, fields, record) ? CHESS_SUCCESS : CHESS_OUT_OF_MEMORY;
+    }
+    ChessResult result = chessAddGame(target->chess, fields[FIELD_TOURNAMENT_ID], fields[FIELD_FIRST_PLAYER],
+                                      fields[FIELD_SECOND_PLAYER], (Winner)winner, fields[FIELD_PLAY_TIME]);
+    if (result != CHESS_SUCCESS)
+    {
+        report(target->reporter, record, false, result);
+    }
+    return result;
+}
+
+static void report(Reporter reporter, long record, bool malformed, ChessResult result)
+{
+    if (reporter.on_error == NULL)
+    {
+        return;
+    }
+    ChessLoadError error = { record, malformed, result };
+    reporter.on_error(&error, reporter.context);
+}
+// ------------------ LOADING ON THE WORKERS ---------------- //
+
+/**
+ * Whether the records may be added on the workers of the system. They go to systems of their own then,
+ * which other threads, a trace, a journal or the subscriptions would not see in file order,
+ * and which keep their games in memory.
+ * */
+static bool canLoadInParallel(ChessSystem chess)
+{
+    return chess->pool != NULL && chess->locks == NULL && chess->trace == NULL && chess->journal == NULL
+           && chess->feed == NULL && chess->games_directory == NULL;
+}
+
+/**
+ * Fill ids with the ids of the tournaments that are open and have no games, by increasing id.
+ * Return their number.
+ * */
+static int findOpenEmptyTournaments(ChessSystem chess, int* ids, int capacity)
+{
+    int count = 0;
+    MAP_FOREACH(int*, tournament_id, chess->tournaments)
+    {
+        Tournament tournament = mapGet(chess->tournaments, tournament_id);
+        if (count < capacity && !tournamentHasEnded(tournament) && tournamentGetNumOfGames(tournament) == 0)
+        {
+            ids[count++] = *tournament_id;
+        }
+        free(tournament_id);
+    }
+    return count;
+}
+
+/**
+ * Whether a game is added only depends on the games added to its tournament before it, and the statistics
+ * of the players are sums, so the open tournaments without games (the candidates) can be filled apart
+ * and merged into chess (see chessMerge).
+ * The records are parsed first. The candidates are split between a system per thread, by the number of
+ * their records, and the systems are merged into chess once they are filled. The records of the other
+ * tournaments are added to chess itself afterwards. The reports are kept, and made in the order of their
+ * records once every record was added.
+ * */
+static ChessResult loadInParallel(ChessSystem chess, const void* data, size_t size, ChessFileFormat format,
+                                  Reporter reporter, const int* candidates, int num_of_candidates)
+{
+    RecordList records = { NULL, 0, 0 };
+    ErrorList errors = { NULL, 0, 0, false };
+    Target target = { chess, { collectError, &errors }, &records };
+    ChessResult result = load(&target, data, size, format);
+
+    int num_of_shards = 0;
+    int* shard_of_record = (int*)malloc(sizeof(int) * (records.size > 0 ? records.size : 1));
+    int* shard_of_candidate = (int*)malloc(sizeof(int) * num_of_candidates);
+    Shard* shards = (Shard*)malloc(sizeof(Shard) * (poolGetNumOfWorkers(chess->pool) + 1));
+    if (shard_of_record == NULL || shard_of_candidate == NULL || shards == NULL)
+    {
+        result = CHESS_OUT_OF_MEMORY;
+    }
+    if (result == CHESS_SUCCESS)
+    {
+        num_of_shards = assignShards(&records, candidates, num_of_candidates, poolGetNumOfWorkers(chess->pool) + 1,
+                                     shard_of_record, shard_of_candidate);
+        if (num_of_shards < 0)
+        {
+            num_of_shards = 0;
+            result = CHESS_OUT_OF_MEMORY;
+        }
+    }
+    if (result == CHESS_SUCCESS)
+    {
+        result = createShards(chess, shards, num_of_shards, candidates, shard_of_candidate, num_of_candidates);
+    }
+
+    if (result == CHESS_SUCCESS)
+    {
+        for (int i = 0; i < num_of_shards; i++)
+        {
+            shards[i].records = &records;
+            shards[i].shard_of_record = shard_of_record;
+        }
+        poolFor(chess->pool, num_of_shards, 1, loadShards, shards);
+        for (int i = 0; i < num_of_shards && result == CHESS_SUCCESS; i++)
+        {
+            result = shards[i].result;
+            if (result == CHESS_SUCCESS)
+            {
+                result = chessMerge(chess, shards[i].system);
+            }
+            if (result == CHESS_SUCCESS && !appendErrors(&errors, &shards[i].errors))
+            {
+                result = CHESS_OUT_OF_MEMORY;
+            }
+        }
+    }
+
+    target.records = NULL;
+    for (long i = 0; i < records.size && result == CHESS_SUCCESS; i++)
+    {
+        if (shard_of_record[i] < 0)
+        {
+            if (addRecord(&target, records.records[i].fields, records.records[i].record) == CHESS_OUT_OF_MEMORY)
+            {
+                result = CHESS_OUT_OF_MEMORY;
+            }
+        }
+    }
+    if (errors.out_of_memory)
+    {
+        result = CHESS_OUT_OF_MEMORY;
+    }
+
+    if (result == CHESS_SUCCESS)
+    {
+        // no two reports are of the same record
+        poolSort(chess->pool, errors.errors, (int)errors.size, sizeof(ChessLoadError), compareErrors);
+        for (long i = 0; i < errors.size; i++)
+        {
+            report(reporter, errors.errors[i].record, errors.errors[i].malformed, errors.errors[i].result);
+        }
+    }
+    destroyShards(shards, num_of_shards);
+    free(shards);
+    free(shard_of_candidate);
+    free(shard_of_record);
+    free(errors.errors);
+    free(records.records);
+    return result;
+}
+
+/**
+ * Give every candidate with records to the shard with the fewest records so far, and set the shard of
+ * every record (-1 for the records of other tournaments) and of every candidate (-1 for those without records).
+ * Return the number of shards that got candidates, or -1 if malloc failed.
+ * */
+static int assignShards(const RecordList* records, const int* candidates, int num_of_candidates,
+                        int num_of_shards, int* shard_of_record, int* shard_of_candidate)
+{
+    long* loads = (long*)malloc(sizeof(long) * num_of_shards);
+    if (loads == NULL)
+    {
+        return -1;
+    }
+    // count the records of every candidate, and keep the candidate of every record meanwhile
+    for (int i = 0; i < num_of_candidates; i++)
+    {
+        shard_of_candidate[i] = 0;
+    }
+    for (long i = 0; i < records->size; i++)
+    {
+        const int* candidate = bsearch(&records->records[i].fields[FIELD_TOURNAMENT_ID], candidates,
+                                       num_of_candidates, sizeof(int), compareInts);
+        shard_of_record[i] = candidate == NULL ? -1 : (int)(candidate - candidates);
+        if (candidate != NULL)
+        {
+            shard_of_candidate[candidate - candidates]++;
+        }
+    }
+
+    int used = 0;
+    for (int i = 0; i < num_of_candidates; i++)
+    {
+        int count = shard_of_candidate[i];
+        if (count == 0)
+        {
+            shard_of_candidate[i] = -1;
+            continue;
+        }
+        int lightest = 0;
+        if (used < num_of_shards)
+        {
+            lightest = used++;
+            loads[lightest] = 0;
+        }
+        else
+        {
+            for (int shard = 1; shard < num_of_shards; shard++)
+            {
+                lightest = loads[shard] < loads[lightest] ? shard : lightest;
+            }
+        }
+        loads[lightest] += count;
+        shard_of_candidate[i] = lightest;
+    }
+    free(loads);
+
+    for (long i = 0; i < records->size; i++)
+    {
+        if (shard_of_record[i] >= 0)
+        {
+            shard_of_record[i] = shard_of_candidate[shard_of_record[i]];
+        }
+    }
+    return used;
+}
+
+/**
+ * Create the system of every shard, with its candidates as they are in chess.
+ * */
+static ChessResult createShards(ChessSystem chess, Shard* shards, int num_of_shards,
+                                const int* candidates, const int* shard_of_candidate, int num_of_candidates)
+{
+    ChessResult result = CHESS_SUCCESS;
+    for (int i = 0; i < num_of_shards; i++)
+    {
+        shards[i].system = chessCreate();
+        shards[i].index = i;
+        shards[i].errors = (ErrorList){ NULL, 0, 0, false };
+        shards[i].result = CHESS_SUCCESS;
+        if (shards[i].system == NULL)
+        {
+            result = CHESS_OUT_OF_MEMORY;
+        }
+    }
+    for (int i = 0; i < num_of_candidates && result == CHESS_SUCCESS; i++)
+    {
+        if (shard_of_candidate[i] < 0)
+        {
+            continue;
+        }
+        int tournament_id = candidates[i];
+        Tournament tournament = mapGet(chess->tournaments, &tournament_id);
+        const char* location = locationGet(chess->locations, tournamentGetLocationID(tournament));
+        if (chessAddTournament(shards[shard_of_candidate[i]].system, tournament_id,
+                               tournamentGetMaxGamesPerPlayer(tournament), location) != CHESS_SUCCESS)
+        {
+            result = CHESS_OUT_OF_MEMORY;
+        }
+    }
+    return result;
+}
+
+static void loadShards(void* context, int begin, int end)
+{
+    Shard* shards = (Shard*)context;
+    for (int i = begin; i < end; i++)
+    {
+        Shard* shard = &shards[i];
+        Target target = { shard->system, { collectError, &shard->errors }, NULL };
+        for (long j = 0; j < shard->records->size && shard->result == CHESS_SUCCESS; j++)
+        {
+            if (shard->shard_of_record[j] == shard->index
+                && addRecord(&target, shard->records->records[j].fields, shard->records->records[j].record)
+                   == CHESS_OUT_OF_MEMORY)
+            {
+                shard->result = CHESS_OUT_OF_MEMORY;
+            }
+        }
+        if (shard->errors.out_of_memory)
+        {
+            shard->result = CHESS_OUT_OF_MEMORY;
+        }
+    }
+}
+
+static void destroyShards(Shard* shards, int num_of_shards)
+{
+    for (int i = 0; i < num_of_shards; i++)
+    {
+        chessDestroy(shards[i].system);
+        free(shards[i].errors.errors);
+    }
+}
+
+static bool keepRecord(RecordList* records, const int fields[NUM_OF_FIELDS], long record)
+{
+    if (records->size == records->capacity)
+    {
+        long capacity = records->capacity > 0 ? 2 * records->capacity : 1024;
+        Record* new_records = (Record*)realloc(records->records, sizeof(Record) * capacity);
+        if (new_records == NULL)
+        {
+            return false;
+        }
+        records->records = new_records;
+        records->capacity = capacity;
+    }
+    memcpy(records->records[records->size].fields, fields, sizeof(int) * NUM_OF_FIELDS);
+    records->records[records->size].record = record;
+    records->size++;
+    return true;
+}
+
+static void collectError(const ChessLoadError* error, void* context)
+{
+    ErrorList* list = (ErrorList*)context;
+    if (!reserveErrors(list, list->size + 1))
+    {
+        list->out_of_memory = true;
+        return;
+    }
+    list->errors[list->size++] = *error;
+}
+
+/**
+ * Append the reports of other to list. Return false if malloc failed.
+ * */
+static bool appendErrors(ErrorList* list, const ErrorList* other)
+{
+    if (other->size == 0)
+    {
+        return true;
+    }
+    if (!reserveErrors(list, list->size + other->size))
+    {
+        return false;
+    }
+    memcpy(list->errors + list->size, other->errors, sizeof(ChessLoadError) * other->size);
+    list->size += other->size;
+    return true;
+}
+
+/**
+ * Make room for size reports in list. Return false if malloc failed.
+ * */
+static bool reserveErrors(ErrorList* list, long size)
+{
+    if (size <= list->capacity)
+    {
+        return true;
+    }
+    long capacity = list->capacity > 0 ? 2 * list->capacity : 64;
+    while (capacity < size)
+    {
+        capacity *= 2;
+    }
+    ChessLoadError* new_errors = (ChessLoadError*)realloc(list->errors, sizeof(ChessLoadError) * capacity);
+    if (new_errors == NULL)
+    {
+        return false;
+    }
+    list->errors = new_errors;
+    list->capacity = capacity;
+    return true;
+}
+
+static int compareErrors(const void* error1, const void* error2)
+{
+    long record1 = ((const ChessLoadError*)error1)->record;
+    long record2 = ((const ChessLoadError*)error2)->record;
+    return (record1 > record2) - (record1 < record2);
+}
+
+static int compareInts(const void* value1, const void* value2)
+{
+    int int1 = *(const int*)value1;
+    int int2 = *(const int*)value2;
+    return (int1 > int2) - (int1 < int2);
+}
@@ -0,0 +1,185 @@
+#include "chessLocation.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// ------------------ DEFINES ---------------- //
+
+#define INITIAL_CAPACITY 16
+#define EMPTY_SLOT 0 // slots hold (location_id + 1), so 0 means empty.
+
+struct chess_location_pool_t {
+    char** locations; // <(int)location_id, (char*)location>
+    int size;
+    int capacity;
+    int* slots;       // open addressing hash table of (location_id + 1), twice as big as capacity.
+};
+
+// ------------------ FUNCTIONS DECLARATIONS ---------------- //
+
+static bool isLocationValid(const char* location);
+static unsigned int hashLocation(const char* location);
+static int* findSlot(LocationPool pool, const char* location);
+static bool growPool(LocationPool pool);
+
+// ------------------ FUNCTIONS IMPLEMENTATION ---------------- //
+
+LocationPool locationPoolCreate(void)
+{
+    LocationPool pool = (LocationPool)malloc(sizeof(*pool));
+    if (pool == NULL)
+    {
+        return NULL;
+    }
+    pool->locations = (char**)malloc(sizeof(char*) * INITIAL_CAPACITY);
+    if (pool->locations == NULL)
+    {
+        free(pool);
+        return NULL;
+    }
+    pool->slots = (int*)calloc(2 * INITIAL_CAPACITY, sizeof(int));
+    if (pool->slots == NULL)
+    {
+        free(pool->locations);
+        free(pool);
+        return NULL;
+    }
+    pool->size = 0;
+    pool->capacity = INITIAL_CAPACITY;
+    return pool;
+}
+
+void locationPoolDestroy(LocationPool pool)
+{
+    if (pool == NULL)
+    {
+        return;
+    }
+    for (int i = 0; i < pool->size; i++)
+    {
+        free(pool->locations[i]);
+    }
+    free(pool->locations);
+    free(pool->slots);
+    free(pool);
+}
+
+int locationIntern(LocationPool pool, const char* location)
+{
+    int* slot = findSlot(pool, location);
+    if (*slot != EMPTY_SLOT)
+    {
+        return *slot - 1;
+    }
+
+    // first time we see that location
+    if (!isLocationValid(location))
+    {
+        return LOCATION_INVALID;
+    }
+    if (pool->size == pool->capacity)
+    {
+        if (!growPool(pool))
+        {
+            return LOCATION_OUT_OF_MEMORY;
+        }
+        slot = findSlot(pool, location);
+    }
+
+    char* new_location = (char*)malloc(strlen(location) + 1);
+    if (new_location == NULL)
+    {
+        return LOCATION_OUT_OF_MEMORY;
+    }
+    strcpy(new_location, location);
+
+    pool->locations[pool->size] = new_location;
+    *slot = ++pool->size;
+    return pool->size - 1;
+}
+
+const char* locationGet(LocationPool pool, int location_id)
+{
+    return pool->locations[location_id];
+}
+
+int locationPoolGetSize(LocationPool pool)
+{
+    return pool->size;
+}
+
+static bool isLocationValid(const char* location)
+{
+    if (location == NULL || strlen(location) < 1 || location[0] > 'Z' || location[0] < 'A')
+    {
+        return false;
+    }
+    int i = 0;
+    char c;
+    while ((c = location[++i]) != '\0')
+    {
+        if (!(c == ' ' || (c >= 'a' && c <= 'z')))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * FNV-1a hash of a string.
+ * */
+static unsigned int hashLocation(const char* location)
+{
+    unsigned int hash = 2166136261u;
+    while (*location != '\0')
+    {
+        hash ^= (unsigned char)*location++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * Return the slot that holds location, or the empty slot where it should be inserted.
+ * */
+static int* findSlot(LocationPool pool, const char* location)
+{
+    unsigned int mask = 2 * pool->capacity - 1;
+    unsigned int index = hashLocation(location) & mask;
+    while (pool->slots[index] != EMPTY_SLOT
+           && strcmp(pool->locations[pool->slots[index] - 1], location) != 0)
+    {
+        index = (index + 1) & mask;
+    }
+    return &pool->slots[index];
+}
+
+/**
+ * Double the capacity of the pool and rehash all of its locations.
+ * */
+static bool growPool(LocationPool pool)
+{
+    int new_capacity = 2 * pool->capacity;
+    char** new_locations = (char**)realloc(pool->locations, sizeof(char*) * new_capacity);
+    if (new_locations == NULL)
+    {
+        return false;
+    }
+    pool->locations = new_locations;
+
+    int* new_slots = (int*)calloc(2 * new_capacity, sizeof(int));
+    if (new_slots == NULL)
+    {
+        return false;
+    }
+    free(pool->slots);
+    pool->slots = new_slots;
+    pool->capacity = new_capacity;
+
+    for (int i = 0; i < pool->size; i++)
+    {
+        *findSlot(pool, pool->locations[i]) = i + 1;
+    }
+    return true;
+}
\ No newline at end of file
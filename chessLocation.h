@@ -0,0 +1,40 @@
+#ifndef _CHESSLOCATION_H_
+#define _CHESSLOCATION_H_
+
+#include <stdbool.h>
+
+#define LOCATION_INVALID -1       // returned by locationIntern if the location is not valid.
+#define LOCATION_OUT_OF_MEMORY -2 // returned by locationIntern if malloc failed.
+
+typedef struct chess_location_pool_t *LocationPool;
+
+/**
+ * Create an empty pool of locations.
+ * Every distinct location string is stored once and gets a small integer id (>= 0).
+ * */
+LocationPool locationPoolCreate(void);
+
+/**
+ * Destroy a pool and every location stored in it.
+ * */
+void locationPoolDestroy(LocationPool pool);
+
+/**
+ * Return the id of a location, adding it to the pool if it is not there yet.
+ * The location is validated only the first time it is seen.
+ * Return LOCATION_INVALID if the location is not valid, LOCATION_OUT_OF_MEMORY if malloc failed.
+ * */
+int locationIntern(LocationPool pool, const char* location);
+
+/**
+ * Return the string of an interned location.
+ * The string is owned by the pool and stays valid until the pool is destroyed.
+ * */
+const char* locationGet(LocationPool pool, int location_id);
+
+/**
+ * Return the number of locations in the pool. Their ids are 0 to size - 1.
+ * */
+int locationPoolGetSize(LocationPool pool);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,207 @@
+#define _POSIX_C_SOURCE 200809L // pthread rwlocks
+
+#include "chessLocks.h"
+
+#include <stdlib.h>
+#include <pthread.h>
+
+// ------------------ DEFINES ---------------- //
+
+#define NUM_OF_STRIPES 64 // a power of 2
+#define CACHE_LINE_SIZE 64
+
+/**
+ * A mutex alone on its cache line, so threads working on different stripes
+ * don't slow each other down.
+ * */
+typedef union chess_stripe_t {
+    pthread_mutex_t mutex;
+    char padding[CACHE_LINE_SIZE * ((sizeof(pthread_mutex_t) + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE)];
+} Stripe;
+
+struct chess_locks_t {
+    pthread_rwlock_t system;
+    pthread_rwlock_t players_map;
+    Stripe tournaments[NUM_OF_STRIPES];
+    Stripe players[NUM_OF_STRIPES];
+};
+
+// ------------------ FUNCTIONS DECLARATIONS ---------------- //
+
+static int stripeOf(int id);
+static bool initStripes(Stripe* stripes);
+static void destroyStripes(Stripe* stripes, int size);
+
+// ------------------ FUNCTIONS IMPLEMENTATION ---------------- //
+
+Locks locksCreate(void)
+{
+    Locks locks = (Locks)malloc(sizeof(*locks));
+    if (locks == NULL)
+    {
+        return NULL;
+    }
+    if (pthread_rwlock_init(&locks->system, NULL) != 0)
+    {
+        free(locks);
+        return NULL;
+    }
+    if (pthread_rwlock_init(&locks->players_map, NULL) != 0)
+    {
+        pthread_rwlock_destroy(&locks->system);
+        free(locks);
+        return NULL;
+    }
+    if (!initStripes(locks->tournaments))
+    {
+        pthread_rwlock_destroy(&locks->players_map);
+        pthread_rwlock_destroy(&locks->system);
+        free(locks);
+        return NULL;
+    }
+    if (!initStripes(locks->players))
+    {
+        destroyStripes(locks->tournaments, NUM_OF_STRIPES);
+        pthread_rwlock_destroy(&locks->players_map);
+        pthread_rwlock_destroy(&locks->system);
+        free(locks);
+        return NULL;
+    }
+    return locks;
+}
+
+void locksDestroy(Locks locks)
+{
+    if (locks == NULL)
+    {
+        return;
+    }
+    destroyStripes(locks->players, NUM_OF_STRIPES);
+    destroyStripes(locks->tournaments, NUM_OF_STRIPES);
+    pthread_rwlock_destroy(&locks->players_map);
+    pthread_rwlock_destroy(&locks->system);
+    free(locks);
+}
+
+void lockSystem(Locks locks, bool exclusive)
+{
+    if (locks == NULL)
+    {
+        return;
+    }
+    if (exclusive)
+    {
+        pthread_rwlock_wrlock(&locks->system);
+    }
+    else
+    {
+        pthread_rwlock_rdlock(&locks->system);
+    }
+}
+
+void unlockSystem(Locks locks)
+{
+    if (locks != NULL)
+    {
+        pthread_rwlock_unlock(&locks->system);
+    }
+}
+
+void lockTournament(Locks locks, int tournament_id)
+{
+    if (locks != NULL)
+    {
+        pthread_mutex_lock(&locks->tournaments[stripeOf(tournament_id)].mutex);
+    }
+}
+
+void unlockTournament(Locks locks, int tournament_id)
+{
+    if (locks != NULL)
+    {
+        pthread_mutex_unlock(&locks->tournaments[stripeOf(tournament_id)].mutex);
+    }
+}
+
+void lockPlayers(Locks locks, int first_player, int second_player)
+{
+    if (locks == NULL)
+    {
+        return;
+    }
+    int first_stripe = stripeOf(first_player);
+    int second_stripe = stripeOf(second_player);
+    pthread_mutex_lock(&locks->players[first_stripe < second_stripe ? first_stripe : second_stripe].mutex);
+    if (first_stripe != second_stripe)
+    {
+        pthread_mutex_lock(&locks->players[first_stripe < second_stripe ? second_stripe : first_stripe].mutex);
+    }
+}
+
+void unlockPlayers(Locks locks, int first_player, int second_player)
+{
+    if (locks == NULL)
+    {
+        return;
+    }
+    int first_stripe = stripeOf(first_player);
+    int second_stripe = stripeOf(second_player);
+    pthread_mutex_unlock(&locks->players[first_stripe].mutex);
+    if (first_stripe != second_stripe)
+    {
+        pthread_mutex_unlock(&locks->players[second_stripe].mutex);
+    }
+}
+
+void lockPlayersMap(Locks locks, bool exclusive)
+{
+    if (locks == NULL)
+    {
+        return;
+    }
+    if (exclusive)
+    {
+        pthread_rwlock_wrlock(&locks->players_map);
+    }
+    else
+    {
+        pthread_rwlock_rdlock(&locks->players_map);
+    }
+}
+
+void unlockPlayersMap(Locks locks)
+{
+    if (locks != NULL)
+    {
+        pthread_rwlock_unlock(&locks->players_map);
+    }
+}
+
+/**
+ * Consecutive ids (the common case) fall on different stripes.
+ * */
+static int stripeOf(int id)
+{
+    return (int)((unsigned int)id & (NUM_OF_STRIPES - 1));
+}
+
+static bool initStripes(Stripe* stripes)
+{
+    for (int i = 0; i < NUM_OF_STRIPES; i++)
+    {
+        if (pthread_mutex_init(&stripes[i].mutex, NULL) != 0)
+        {
+            destroyStripes(stripes, i);
+            return false;
+        }
+    }
+    return true;
+}
+
+static void destroyStripes(Stripe* stripes, int size)
+{
+    for (int i = 0; i < size; i++)
+    {
+        pthread_mutex_destroy(&stripes[i].mutex);
+    }
+}
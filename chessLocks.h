@@ -0,0 +1,45 @@
+#ifndef _CHESSLOCKS_H_
+#define _CHESSLOCKS_H_
+
+#include <stdbool.h>
+
+/**
+ * The locks of a ChessSystem shared by several threads (see chessEnableConcurrency).
+ * Every function does nothing when locks is NULL, so a system used by a single thread pays nothing.
+ *
+ * A call takes them in this order:
+ * the system - shared by the calls that only touch one tournament and the players they are given,
+ *              exclusive for every other call (those go over the maps with their single iterator),
+ * the stripe of its tournament, the stripes of its players, in increasing order,
+ * the players map - shared to look players up, exclusive to add or remove them.
+ * A player record is only touched under the stripe of its id.
+ * */
+typedef struct chess_locks_t *Locks;
+
+/**
+ * Create the locks. Return NULL if they could not be created.
+ * */
+Locks locksCreate(void);
+
+void locksDestroy(Locks locks);
+
+void lockSystem(Locks locks, bool exclusive);
+
+void unlockSystem(Locks locks);
+
+void lockTournament(Locks locks, int tournament_id);
+
+void unlockTournament(Locks locks, int tournament_id);
+
+/**
+ * Lock the stripes of two players. first_player may equal second_player.
+ * */
+void lockPlayers(Locks locks, int first_player, int second_player);
+
+void unlockPlayers(Locks locks, int first_player, int second_player);
+
+void lockPlayersMap(Locks locks, bool exclusive);
+
+void unlockPlayersMap(Locks locks);
+
+#endif
\ No newline at end of file
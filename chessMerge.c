@@ -0,0 +1,533 @@
+#include "chessSystemExt.h"
+#include "chessSystemPrivate.h"
+#include "chessTournament.h"
+#include "chessPlayer.h"
+#include "chessGame.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * A merge is checked as a whole before dst is changed, so a conflict leaves both systems as they were.
+ *
+ * A tournament of src is moved to dst if dst has no tournament with its id, or if the tournament of dst
+ * has the same location, no games, and ended the same way. The games of two tournaments can't be put
+ * together, since their averages and their winners were calculated over the games of each one.
+ * The players are sums of their games, so a player of both systems gets the statistics of both.
+ *
+ * Everything a merge keeps track of is allocated before dst is changed, and every change to dst can be
+ * taken back without allocating, so a merge that runs out of memory half way leaves dst as it was too
+ * (but for the locations it interned, which no tournament uses).
+ */
+
+// ------------------ DEFINES ---------------- //
+
+/**
+ * The max games per player of a tournament of dst, which the games of src in it must respect too.
+ * */
+typedef struct {
+    int tournament_id;
+    int max_games_per_player;
+} Limit;
+
+/**
+ * What a merge changes in dst, in the order it changes it.
+ * */
+typedef struct {
+    Tournament* moved;             // the tournaments of src moved to dst, by increasing id
+    bool* filled;                  // whether moved[i] filled a tournament of dst that had no games
+    TournamentGames* previous;     // what that tournament had before (see tournamentRestoreGames)
+    int num_of_moved;
+    int num_of_restored;           // the moved tournaments restored in dst so far, from the last one
+    Player* players;               // the players of src, by increasing id
+    int* offsets;                  // players[i] played in tournaments[offsets[i]] to tournaments[offsets[i + 1] - 1]
+    PlayerTournament* tournaments;
+    bool* added;                   // for every element of tournaments, see playerMerge
+    bool* merged;                  // whether players[i] was merged into a player of dst rather than added
+    bool* cleared;                 // whether players[i] was a former player of dst
+    int num_of_players;
+    int num_of_folded;             // the players folded into dst so far, from the last one
+    int* former;                   // the former players of src that became former players of dst
+    int num_of_former;
+} Merge;
+
+// ------------------ FUNCTIONS DECLARATIONS ---------------- //
+
+static ChessResult mergeSystems(ChessSystem dst, ChessSystem src);
+static bool createMerge(Merge* merge, ChessSystem src);
+static bool collectPlayers(Merge* merge, ChessSystem src);
+static void destroyMerge(Merge* merge);
+static ChessResult findMovedTournaments(ChessSystem dst, ChessSystem src, Merge* merge, Limit* limits);
+static ChessResult checkTournament(ChessSystem dst, ChessSystem src, Tournament tournament, bool* move,
+                                   Limit* limit, bool* limited);
+static bool exceedsMaxGames(const Merge* merge, const Limit* limits, int num_of_limits);
+static int compareLimits(const void* limit1, const void* limit2);
+static ChessResult moveTournaments(ChessSystem dst, ChessSystem src, Merge* merge);
+static ChessResult mergePlayers(ChessSystem dst, Merge* merge);
+static ChessResult mergeFormerPlayers(ChessSystem dst, ChessSystem src, Merge* merge);
+static void undoMerge(ChessSystem dst, Merge* merge);
+static void publishMoved(ChessSystem dst, Tournament* moved, int num_of_moved);
+
+// ------------------ FUNCTIONS IMPLEMENTATION ---------------- //
+
+ChessResult chessMerge(ChessSystem dst, ChessSystem src)
+{
+    if (dst == NULL || src == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    lockSystem(dst->locks, true);
+    ChessResult result;
+    if (dst == src)
+    {
+        // every tournament conflicts with itself, which is only allowed while it has no games
+        result = dst->num_of_games > 0 ? CHESS_TOURNAMENT_ALREADY_EXISTS : CHESS_SUCCESS;
+    }
+    else
+    {
+        lockSystem(src->locks, false);
+        // the statistics of the players are added up as they are once the removals are applied
+        removalsApplyAll(dst->removals, dst->players, dst->tournaments);
+        removalsApplyAll(src->removals, src->players, src->tournaments);
+        result = mergeSystems(dst, src);
+        unlockSystem(src->locks);
+    }
+    unlockSystem(dst->locks);
+    return result;
+}
+
+static ChessResult mergeSystems(ChessSystem dst, ChessSystem src)
+{
+    Merge merge;
+    int size = mapGetSize(src->tournaments);
+    Limit* limits = (Limit*)malloc(sizeof(Limit) * (size > 0 ? size : 1));
+    if (limits == NULL || !createMerge(&merge, src))
+    {
+        free(limits);
+        return CHESS_OUT_OF_MEMORY;
+    }
+    ChessResult result = findMovedTournaments(dst, src, &merge, limits);
+    free(limits);
+    if (result != CHESS_SUCCESS)
+    {
+        destroyMerge(&merge);
+        return result;
+    }
+
+    result = moveTournaments(dst, src, &merge);
+    if (result == CHESS_SUCCESS)
+    {
+        result = mergePlayers(dst, &merge);
+    }
+    if (result == CHESS_SUCCESS)
+    {
+        result = mergeFormerPlayers(dst, src, &merge);
+    }
+    if (result != CHESS_SUCCESS)
+    {
+        undoMerge(dst, &merge);
+        destroyMerge(&merge);
+        return result;
+    }
+
+    for (int i = 0; i < merge.num_of_moved; i++)
+    {
+        if (merge.filled[i])
+        {
+            gameListRelease(merge.previous[i].games);
+        }
+    }
+    dst->num_of_games += src->num_of_games;
+    publishMoved(dst, merge.moved, merge.num_of_moved);
+    versionsRebuild(dst->versions, dst->players, dst->tournaments, dst->locations);
+    destroyMerge(&merge);
+
+    // no record describes a merge, so the journal starts over from a snapshot of the merged system.
+    // dst is already merged by now, so any failure, even of an allocation, is a failure to save it
+    if (dst->journal != NULL)
+    {
+        journalWaitForCompaction(dst->journal);
+        if (chessJournalCompact(dst) != CHESS_SUCCESS)
+        {
+            return CHESS_SAVE_FAILURE;
+        }
+    }
+    return CHESS_SUCCESS;
+}
+
+/**
+ * Allocate everything a merge of src keeps track of, and collect the players of src.
+ * Return false if malloc failed.
+ * */
+static bool createMerge(Merge* merge, ChessSystem src)
+{
+    int num_of_tournaments = mapGetSize(src->tournaments);
+    int num_of_players = mapGetSize(src->players);
+    int num_of_former = 0;
+    for (int id = bitmapGetNext(src->former_players, 0); id >= 0; id = bitmapGetNext(src->former_players, id + 1))
+    {
+        num_of_former++;
+    }
+    memset(merge, 0, sizeof(*merge));
+    merge->moved = (Tournament*)malloc(sizeof(Tournament) * (num_of_tournaments > 0 ? num_of_tournaments : 1));
+    merge->filled = (bool*)malloc(sizeof(bool) * (num_of_tournaments > 0 ? num_of_tournaments : 1));
+    merge->previous = (TournamentGames*)malloc(sizeof(TournamentGames) * (num_of_tournaments > 0 ? num_of_tournaments : 1));
+    merge->players = (Player*)malloc(sizeof(Player) * (num_of_players > 0 ? num_of_players : 1));
+    merge->offsets = (int*)malloc(sizeof(int) * (num_of_players + 1));
+    merge->merged = (bool*)malloc(sizeof(bool) * (num_of_players > 0 ? num_of_players : 1));
+    merge->cleared = (bool*)malloc(sizeof(bool) * (num_of_players > 0 ? num_of_players : 1));
+    merge->former = (int*)malloc(sizeof(int) * (num_of_former > 0 ? num_of_former : 1));
+    if (merge->moved == NULL || merge->filled == NULL || merge->previous == NULL || merge->players == NULL
+        || merge->offsets == NULL || merge->merged == NULL || merge->cleared == NULL || merge->former == NULL
+        || !collectPlayers(merge, src))
+    {
+        destroyMerge(merge);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Collect the players of src with their statistics per tournament.
+ * Return false if malloc failed.
+ * */
+static bool collectPlayers(Merge* merge, ChessSystem src)
+{
+    MAP_FOREACH(int*, player_id, src->players)
+    {
+        merge->players[merge->num_of_players++] = mapGet(src->players, player_id);
+        free(player_id);
+    }
+    // the iteration stops early if a key could not be copied
+    if (merge->num_of_players < mapGetSize(src->players))
+    {
+        return false;
+    }
+
+    merge->offsets[0] = 0;
+    for (int i = 0; i < merge->num_of_players; i++)
+    {
+        merge->offsets[i + 1] = merge->offsets[i] + playerGetNumOfTournaments(merge->players[i]);
+    }
+    int size = merge->offsets[merge->num_of_players];
+    merge->tournaments = (PlayerTournament*)malloc(sizeof(PlayerTournament) * (size > 0 ? size : 1));
+    merge->added = (bool*)malloc(sizeof(bool) * (size > 0 ? size : 1));
+    if (merge->tournaments == NULL || merge->added == NULL)
+    {
+        return false;
+    }
+    for (int i = 0; i < merge->num_of_players; i++)
+    {
+        playerGetTournaments(merge->players[i], &merge->tournaments[merge->offsets[i]]);
+    }
+    return true;
+}
+
+static void destroyMerge(Merge* merge)
+{
+    free(merge->moved);
+    free(merge->filled);
+    free(merge->previous);
+    free(merge->players);
+    free(merge->offsets);
+    free(merge->tournaments);
+    free(merge->added);
+    free(merge->merged);
+    free(merge->cleared);
+    free(merge->former);
+}
+
+/**
+ * Collect the tournaments of src that are moved to dst, by increasing id.
+ * Return the conflict of the lowest id, or CHESS_SUCCESS.
+ * */
+static ChessResult findMovedTournaments(ChessSystem dst, ChessSystem src, Merge* merge, Limit* limits)
+{
+    ChessResult result = CHESS_SUCCESS;
+    int num_of_limits = 0;
+    MAP_FOREACH(int*, tournament_id, src->tournaments)
+    {
+        Tournament tournament = mapGet(src->tournaments, tournament_id);
+        bool move = false;
+        bool limited = false;
+        if (result == CHESS_SUCCESS)
+        {
+            result = checkTournament(dst, src, tournament, &move, &limits[num_of_limits], &limited);
+        }
+        if (move)
+        {
+            merge->moved[merge->num_of_moved++] = tournament;
+        }
+        // only the limits of tournaments before the first other conflict matter
+        if (limited && result == CHESS_SUCCESS)
+        {
+            num_of_limits++;
+        }
+        free(tournament_id);
+    }
+    if (exceedsMaxGames(merge, limits, num_of_limits))
+    {
+        return CHESS_EXCEEDED_GAMES;
+    }
+    return result;
+}
+
+/**
+ * Check a tournament of src against dst. move receives whether it is moved to dst, and limited whether
+ * its games must be checked against limit (see exceedsMaxGames).
+ * */
+static ChessResult checkTournament(ChessSystem dst, ChessSystem src, Tournament tournament, bool* move,
+                                   Limit* limit, bool* limited)
+{
+    TournamentSummary summary;
+    tournamentGetSummary(tournament, &summary);
+    Tournament existing = mapGet(dst->tournaments, &summary.id);
+    if (existing == NULL)
+    {
+        *move = true;
+        return CHESS_SUCCESS;
+    }
+
+    const char* location = locationGet(src->locations, summary.location_id);
+    const char* existing_location = locationGet(dst->locations, tournamentGetLocationID(existing));
+    if ((summary.num_of_games > 0 && tournamentGetNumOfGames(existing) > 0)
+        || strcmp(location, existing_location) != 0)
+    {
+        return CHESS_TOURNAMENT_ALREADY_EXISTS;
+    }
+    if (tournamentHasEnded(tournament) != tournamentHasEnded(existing))
+    {
+        return CHESS_TOURNAMENT_ENDED;
+    }
+    // dst keeps its own limit, which the games of src must respect too
+    int max_games_per_player = tournamentGetMaxGamesPerPlayer(existing);
+    if (summary.num_of_games > 0 && summary.max_games_per_player > max_games_per_player)
+    {
+        limit->tournament_id = summary.id;
+        limit->max_games_per_player = max_games_per_player;
+        *limited = true;
+    }
+    *move = summary.num_of_games > 0;
+    return CHESS_SUCCESS;
+}
+
+/**
+ * Return whether a player of src played more games in a tournament than its limit allows.
+ * limits are sorted by tournament id, and every player is looked at once for all of them.
+ * */
+static bool exceedsMaxGames(const Merge* merge, const Limit* limits, int num_of_limits)
+{
+    if (num_of_limits == 0)
+    {
+        return false;
+    }
+    int size = merge->offsets[merge->num_of_players];
+    for (int i = 0; i < size; i++)
+    {
+        const PlayerTournament* tournament = &merge->tournaments[i];
+        Limit key = { tournament->tournament_id, 0 };
+        const Limit* limit = (const Limit*)bsearch(&key, limits, num_of_limits, sizeof(Limit), compareLimits);
+        if (limit != NULL && tournament->num_of_games > limit->max_games_per_player)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static int compareLimits(const void* limit1, const void* limit2)
+{
+    int id1 = ((const Limit*)limit1)->tournament_id;
+    int id2 = ((const Limit*)limit2)->tournament_id;
+    return (id1 > id2) - (id1 < id2);
+}
+
+/**
+ * Copy the moved tournaments into dst, with their games.
+ * */
+static ChessResult moveTournaments(ChessSystem dst, ChessSystem src, Merge* merge)
+{
+    void* games = NULL;
+    int games_capacity = 0;
+    ChessResult result = CHESS_SUCCESS;
+    // insert from the highest id, like a snapshot is read
+    for (int i = merge->num_of_moved - 1; i >= 0 && result == CHESS_SUCCESS; i--)
+    {
+        TournamentSummary summary;
+        tournamentGetSummary(merge->moved[i], &summary);
+        GameList list = tournamentGetGames(merge->moved[i]);
+        int games_size = gameListGetDumpSize(list);
+        if (games_size > games_capacity)
+        {
+            void* new_games = realloc(games, games_size);
+            if (new_games == NULL)
+            {
+                result = CHESS_OUT_OF_MEMORY;
+                break;
+            }
+            games = new_games;
+            games_capacity = games_size;
+        }
+        gameListDump(list, games);
+
+        // a tournament of dst without games keeps its id, location and max games per player
+        Tournament existing = mapGet(dst->tournaments, &summary.id);
+        merge->filled[i] = existing != NULL;
+        if (existing != NULL)
+        {
+            if (!tournamentRestoreGames(existing, &summary, games, games_size, gameListIsFrozen(list),
+                                        &merge->previous[i]))
+            {
+                result = CHESS_OUT_OF_MEMORY;
+            }
+        }
+        else
+        {
+            summary.location_id = locationIntern(dst->locations, locationGet(src->locations, summary.location_id));
+            if (summary.location_id == LOCATION_OUT_OF_MEMORY
+                || !tournamentRestoreToMap(dst->tournaments, &summary, locationGet(dst->locations, summary.location_id),
+                                           games, games_size, gameListIsFrozen(list)))
+            {
+                result = CHESS_OUT_OF_MEMORY;
+            }
+        }
+        if (result == CHESS_SUCCESS)
+        {
+            merge->num_of_restored++;
+        }
+    }
+    free(games);
+    return result;
+}
+
+/**
+ * Add the statistics of every player of src to dst.
+ * */
+static ChessResult mergePlayers(ChessSystem dst, Merge* merge)
+{
+    for (int i = merge->num_of_players - 1; i >= 0; i--)
+    {
+        PlayerSummary summary;
+        playerGetSummary(merge->players[i], &summary);
+        int offset = merge->offsets[i];
+        int num_of_tournaments = merge->offsets[i + 1] - offset;
+
+        Player existing = mapGet(dst->players, &summary.id);
+        merge->merged[i] = existing != NULL;
+        bool folded = existing != NULL
+                      ? playerMerge(existing, &summary, &merge->tournaments[offset], num_of_tournaments,
+                                    &merge->added[offset])
+                      : playerRestoreToMap(dst->players, &summary, &merge->tournaments[offset], num_of_tournaments);
+        if (!folded)
+        {
+            return CHESS_OUT_OF_MEMORY;
+        }
+        merge->num_of_folded++;
+        merge->cleared[i] = playerExists(mapGet(dst->players, &summary.id)) && bitmapGet(dst->former_players, summary.id);
+        if (merge->cleared[i])
+        {
+            bitmapClear(dst->former_players, summary.id);
+        }
+    }
+    return CHESS_SUCCESS;
+}
+
+/**
+ * Add the players that once played in src to the former players of dst.
+ * */
+static ChessResult mergeFormerPlayers(ChessSystem dst, ChessSystem src, Merge* merge)
+{
+    for (int id = bitmapGetNext(src->former_players, 0); id >= 0; id = bitmapGetNext(src->former_players, id + 1))
+    {
+        if (!playerExists(mapGet(dst->players, &id)) && !bitmapGet(dst->former_players, id))
+        {
+            if (!bitmapSet(dst->former_players, id))
+            {
+                return CHESS_OUT_OF_MEMORY;
+            }
+            merge->former[merge->num_of_former++] = id;
+        }
+    }
+    return CHESS_SUCCESS;
+}
+
+/**
+ * Take back every change a merge made to dst. Doesn't allocate.
+ * */
+static void undoMerge(ChessSystem dst, Merge* merge)
+{
+    for (int i = 0; i < merge->num_of_former; i++)
+    {
+        bitmapClear(dst->former_players, merge->former[i]);
+    }
+
+    for (int i = merge->num_of_players - merge->num_of_folded; i < merge->num_of_players; i++)
+    {
+        PlayerSummary summary;
+        playerGetSummary(merge->players[i], &summary);
+        if (merge->cleared[i])
+        {
+            // the id was cleared, not removed, so its page is still there and this can't fail
+            bitmapSet(dst->former_players, summary.id);
+        }
+        int offset = merge->offsets[i];
+        if (merge->merged[i])
+        {
+            playerUnmerge(mapGet(dst->players, &summary.id), &summary, &merge->tournaments[offset],
+                          merge->offsets[i + 1] - offset, &merge->added[offset]);
+        }
+        else
+        {
+            mapRemove(dst->players, &summary.id);
+        }
+    }
+
+    for (int i = merge->num_of_moved - merge->num_of_restored; i < merge->num_of_moved; i++)
+    {
+        TournamentSummary summary;
+        tournamentGetSummary(merge->moved[i], &summary);
+        if (merge->filled[i])
+        {
+            tournamentUndoRestoreGames(mapGet(dst->tournaments, &summary.id), &merge->previous[i]);
+        }
+        else
+        {
+            mapRemove(dst->tournaments, &summary.id);
+        }
+    }
+}
+
+/**
+ * Tell the subscriptions of dst about the moved tournaments, as if their games were added
+ * (and the ended ones ended) one by one.
+ * */
+static void publishMoved(ChessSystem dst, Tournament* moved, int num_of_moved)
+{
+    if (dst->feed == NULL)
+    {
+        return;
+    }
+    for (int i = 0; i < num_of_moved; i++)
+    {
+        TournamentSummary summary;
+        tournamentGetSummary(moved[i], &summary);
+        int tournament_id = summary.id;
+        GameList list = tournamentGetGames(moved[i]);
+        GameIterator iterator;
+        gameIteratorInit(&iterator);
+        while (gameIteratorNext(list, &iterator))
+        {
+            const GameRecord* game = &iterator.game;
+            Winner winner = game->winners_id == GAME_DRAW       ? DRAW
+                            : game->winners_id == game->player1_id ? FIRST_PLAYER
+                            : SECOND_PLAYER;
+            int args[] = { tournament_id, game->player1_id, game->player2_id, winner, game->length };
+            feedPublish(dst->feed, CHESS_EVENT_GAME_ADDED, args, 5);
+        }
+        if (tournamentHasEnded(moved[i]))
+        {
+            int args[] = { tournament_id, summary.winners_id };
+            feedPublish(dst->feed, CHESS_EVENT_TOURNAMENT_ENDED, args, 2);
+        }
+    }
+}
@@ -0,0 +1,381 @@
+#define _POSIX_C_SOURCE 200809L // fileno
+
+#include "chessOutput.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h> // signbit
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// ------------------ DEFINES ---------------- //
+
+#define BUFFER_SIZE (1 << 16)
+#define MAX_NUMBER_LENGTH 32   // more than any int or fixed-2 number written by hand
+#define MAX_FIXED2_LENGTH 320  // more than "%.2lf" of any double (DBL_MAX has 309 digits)
+#define MAX_FAST_FIXED2 1e9    // bigger numbers are left to snprintf
+#define TIE_MARGIN 1e-4        // products closer than that to a rounding tie are left to snprintf
+#define NO_FILE -1
+#define ITEMS_PER_CHUNK 4096
+#define CHUNKS_PER_THREAD 4 // formatted into memory at a time
+
+struct chess_output_t {
+    int file;     // NO_FILE when writing through stream, or to memory if stream is NULL too
+    FILE* stream;
+    bool owns_file;
+    bool failed;
+    char* memory; // what an output of outputInMemory holds, but its buffer
+    size_t memory_size;
+    size_t memory_capacity;
+    size_t used;
+    char buffer[BUFFER_SIZE];
+};
+
+/**
+ * The items of one outputItems call, and the chunks being formatted into memory.
+ * */
+typedef struct chess_output_job_t {
+    OutputItem print;
+    void* context;
+    int size;
+    int first_chunk; // of the ones being formatted
+    Output* chunks;  // NULL for a chunk that could not be kept in memory
+} Job;
+
+// ------------------ FUNCTIONS DECLARATIONS ---------------- //
+
+static Output createOutput(int file, FILE* stream, bool owns_file);
+static void flushOutput(Output output);
+static char* reserve(Output output, size_t size);
+static char* formatUnsigned(char* end, unsigned long long value);
+static void writeBytes(Output output, const char* data, size_t size);
+static void writeFixed2Slowly(Output output, double value);
+static void formatChunks(void* job, int begin, int end);
+static void printChunk(Output output, Job* job, int chunk);
+
+// ------------------ FUNCTIONS IMPLEMENTATION ---------------- //
+
+Output outputOpen(const char* path)
+{
+    int file = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (file < 0)
+    {
+        return NULL;
+    }
+    Output output = createOutput(file, NULL, true);
+    if (output == NULL)
+    {
+        close(file);
+    }
+    return output;
+}
+
+Output outputForStream(FILE* stream)
+{
+    // what the caller already wrote is still in the stream's buffer, so it goes first
+    fflush(stream);
+    return createOutput(fileno(stream), stream, false);
+}
+
+Output outputInMemory(void)
+{
+    return createOutput(NO_FILE, NULL, false);
+}
+
+void outputInt(Output output, int value)
+{
+    char* destination = reserve(output, MAX_NUMBER_LENGTH);
+    char digits[MAX_NUMBER_LENGTH];
+    char* end = digits + MAX_NUMBER_LENGTH;
+    char* start = formatUnsigned(end, value < 0 ? 0ULL - (unsigned long long)value : (unsigned long long)value);
+    if (value < 0)
+    {
+        *--start = '-';
+    }
+    memcpy(destination, start, end - start);
+    output->used += end - start;
+}
+
+void outputFixed2(Output output, double value)
+{
+    double magnitude = signbit(value) ? -value : value;
+    double hundredths = magnitude * 100;
+    unsigned long long rounded = (unsigned long long)hundredths;
+    double fraction = hundredths - (double)rounded;
+
+    // printf rounds the exact binary value, which hundredths only approximates.
+    // the approximation is decisive unless it lands right next to a tie.
+    if (!(magnitude < MAX_FAST_FIXED2) || (fraction > 0.5 - TIE_MARGIN && fraction < 0.5 + TIE_MARGIN))
+    {
+        writeFixed2Slowly(output, value);
+        return;
+    }
+    if (fraction > 0.5)
+    {
+        rounded++;
+    }
+
+    char* destination = reserve(output, MAX_NUMBER_LENGTH);
+    char digits[MAX_NUMBER_LENGTH];
+    char* end = digits + MAX_NUMBER_LENGTH;
+    char* start = end;
+    *--start = (char)('0' + rounded % 10);
+    *--start = (char)('0' + rounded / 10 % 10);
+    *--start = '.';
+    start = formatUnsigned(start, rounded / 100);
+    if (signbit(value)) // also -0.00, like printf
+    {
+        *--start = '-';
+    }
+    memcpy(destination, start, end - start);
+    output->used += end - start;
+}
+
+void outputString(Output output, const char* string)
+{
+    writeBytes(output, string, strlen(string));
+}
+
+void outputChar(Output output, char c)
+{
+    *reserve(output, 1) = c;
+    output->used++;
+}
+
+bool outputClose(Output output)
+{
+    flushOutput(output);
+    bool result = !output->failed;
+    if (output->owns_file && close(output->file) != 0)
+    {
+        result = false;
+    }
+    free(output->memory);
+    free(output);
+    return result;
+}
+
+bool outputDrain(Output memory, Output destination)
+{
+    flushOutput(memory);
+    bool result = !memory->failed;
+    if (result)
+    {
+        writeBytes(destination, memory->memory, memory->memory_size);
+    }
+    free(memory->memory);
+    free(memory);
+    return result;
+}
+
+void outputItems(Output output, int size, OutputItem print, void* context, Pool pool)
+{
+    int num_of_chunks = (size + ITEMS_PER_CHUNK - 1) / ITEMS_PER_CHUNK;
+    int window = CHUNKS_PER_THREAD * (poolGetNumOfWorkers(pool) + 1);
+    Output* chunks = NULL;
+    if (pool != NULL && num_of_chunks > 1)
+    {
+        chunks = (Output*)malloc(sizeof(Output) * window);
+    }
+    if (chunks == NULL)
+    {
+        for (int i = 0; i < size; i++)
+        {
+            print(output, i, context);
+        }
+        return;
+    }
+
+    Job job = { print, context, size, 0, chunks };
+    for (; job.first_chunk < num_of_chunks; job.first_chunk += window)
+    {
+        int count = num_of_chunks - job.first_chunk < window ? num_of_chunks - job.first_chunk : window;
+        poolFor(pool, count, 1, formatChunks, &job);
+        for (int i = 0; i < count; i++)
+        {
+            if (chunks[i] == NULL || !outputDrain(chunks[i], output))
+            {
+                printChunk(output, &job, job.first_chunk + i);
+            }
+        }
+    }
+    free(chunks);
+}
+
+static Output createOutput(int file, FILE* stream, bool owns_file)
+{
+    Output output = (Output)malloc(sizeof(*output));
+    if (output == NULL)
+    {
+        return NULL;
+    }
+    output->file = file;
+    output->stream = stream;
+    output->owns_file = owns_file;
+    output->failed = false;
+    output->memory = NULL;
+    output->memory_size = 0;
+    output->memory_capacity = 0;
+    output->used = 0;
+    return output;
+}
+
+/**
+ * Write the buffer to the file, or through the stream if it has no file (a memory stream),
+ * or append it to the memory of an output of outputInMemory.
+ * */
+static void flushOutput(Output output)
+{
+    const char* data = output->buffer;
+    size_t size = output->used;
+    output->used = 0;
+    if (output->file == NO_FILE && output->stream == NULL)
+    {
+        if (output->memory_capacity - output->memory_size < size)
+        {
+            size_t capacity = output->memory_capacity == 0 ? BUFFER_SIZE : 2 * output->memory_capacity;
+            while (capacity - output->memory_size < size)
+            {
+                capacity *= 2;
+            }
+            char* memory = (char*)realloc(output->memory, capacity);
+            if (memory == NULL)
+            {
+                output->failed = true;
+                return;
+            }
+            output->memory = memory;
+            output->memory_capacity = capacity;
+        }
+        memcpy(output->memory + output->memory_size, data, size);
+        output->memory_size += size;
+        return;
+    }
+    if (output->file == NO_FILE)
+    {
+        if (fwrite(data, 1, size, output->stream) != size || fflush(output->stream) != 0)
+        {
+            output->failed = true;
+        }
+        return;
+    }
+    while (size > 0)
+    {
+        ssize_t written = write(output->file, data, size);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            output->failed = true;
+            return;
+        }
+        data += written;
+        size -= (size_t)written;
+    }
+}
+
+/**
+ * Return where the next size bytes (at most MAX_NUMBER_LENGTH) can be written.
+ * */
+static char* reserve(Output output, size_t size)
+{
+    if (BUFFER_SIZE - output->used < size)
+    {
+        flushOutput(output);
+    }
+    return output->buffer + output->used;
+}
+
+/**
+ * Write the decimal digits of value right before end. Return where they start.
+ * */
+static char* formatUnsigned(char* end, unsigned long long value)
+{
+    do
+    {
+        *--end = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    return end;
+}
+
+static void writeBytes(Output output, const char* data, size_t size)
+{
+    while (size > 0)
+    {
+        if (output->used == BUFFER_SIZE)
+        {
+            flushOutput(output);
+        }
+        size_t chunk = BUFFER_SIZE - output->used;
+        if (chunk > size)
+        {
+            chunk = size;
+        }
+        memcpy(output->buffer + output->used, data, chunk);
+        output->used += chunk;
+        data += chunk;
+        size -= chunk;
+    }
+}
+
+/**
+ * Write value with snprintf, for the numbers outputFixed2 can't round by hand.
+ * printf writes the decimal point of LC_NUMERIC, which is put back to '.' so the
+ * file looks the same whatever the locale is: "%.2lf" always ends with 2 digits,
+ * and the point is whatever lies between them and the integer digits.
+ * */
+static void writeFixed2Slowly(Output output, double value)
+{
+    char number[MAX_FIXED2_LENGTH];
+    int length = snprintf(number, MAX_FIXED2_LENGTH, "%.2lf", value);
+    if (length < 0 || length >= MAX_FIXED2_LENGTH)
+    {
+        output->failed = true;
+        return;
+    }
+    int integer_begin = (number[0] == '-') ? 1 : 0;
+    int integer_end = integer_begin;
+    while (integer_end < length - 2 && number[integer_end] >= '0' && number[integer_end] <= '9')
+    {
+        integer_end++;
+    }
+    bool has_fraction = (length - integer_end >= 2 && number[length - 2] >= '0' && number[length - 2] <= '9'
+                         && number[length - 1] >= '0' && number[length - 1] <= '9');
+    if (integer_end == integer_begin || !has_fraction) // inf or nan
+    {
+        writeBytes(output, number, length);
+        return;
+    }
+    writeBytes(output, number, integer_end);
+    writeBytes(output, ".", 1);
+    writeBytes(output, number + length - 2, 2);
+}
+
+/**
+ * Format chunks begin to end - 1 of the ones being formatted, each into memory of its own.
+ * */
+static void formatChunks(void* argument, int begin, int end)
+{
+    Job* job = (Job*)argument;
+    for (int i = begin; i < end; i++)
+    {
+        job->chunks[i] = outputInMemory();
+        if (job->chunks[i] != NULL)
+        {
+            printChunk(job->chunks[i], job, job->first_chunk + i);
+        }
+    }
+}
+
+static void printChunk(Output output, Job* job, int chunk)
+{
+    int end = (chunk + 1) * ITEMS_PER_CHUNK < job->size ? (chunk + 1) * ITEMS_PER_CHUNK : job->size;
+    for (int i = chunk * ITEMS_PER_CHUNK; i < end; i++)
+    {
+        job->print(output, i, job->context);
+    }
+}
@@ -0,0 +1,63 @@
+#ifndef _CHESSOUTPUT_H_
+#define _CHESSOUTPUT_H_
+
+#include "chessPool.h"
+#include <stdbool.h>
+#include <stdio.h>
+
+/**
+ * A buffered text output for the exports of the system.
+ * Numbers are formatted by hand instead of by printf, with the exact output of
+ * "%d" and "%.2lf", and the text is flushed in large write() chunks.
+ * */
+typedef struct chess_output_t *Output;
+
+/**
+ * Create (or truncate) the file at path and return an output to it.
+ * Return NULL if the file can't be opened or malloc failed.
+ * */
+Output outputOpen(const char* path);
+
+/**
+ * Return an output that appends to stream, after what was already written to it.
+ * Return NULL if malloc failed.
+ * */
+Output outputForStream(FILE* stream);
+
+/**
+ * Return an output that keeps what is written to it in memory, until outputDrain.
+ * Return NULL if malloc failed.
+ * */
+Output outputInMemory(void);
+
+void outputInt(Output output, int value);
+void outputFixed2(Output output, double value); // like "%.2lf" in the C locale, always with a '.'
+void outputString(Output output, const char* string);
+void outputChar(Output output, char c);
+
+/**
+ * Flush and destroy an output, closing its file if it was opened by outputOpen.
+ * Return false if anything could not be written.
+ * */
+bool outputClose(Output output);
+
+/**
+ * Write what an output of outputInMemory holds to destination, and destroy it.
+ * Return false (and write nothing) if it could not hold all of it, malloc failed.
+ * */
+bool outputDrain(Output memory, Output destination);
+
+/**
+ * Writes item index of the context to output.
+ * */
+typedef void (*OutputItem)(Output output, int index, void* context);
+
+/**
+ * Write items 0 to size - 1 to output, in this order, with print.
+ * With a pool, large outputs are cut into chunks of items, formatted into memory by its threads
+ * at once, and written in order: print must only read what it is given.
+ * The file is the same as from a single thread.
+ * */
+void outputItems(Output output, int size, OutputItem print, void* context, Pool pool);
+
+#endif
@@ -0,0 +1,514 @@
+#define _POSIX_C_SOURCE 200809L // mmap, posix_madvise, pthreads, sysconf
+
+#include "chessSystemExt.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// ------------------ DEFINES ---------------- //
+
+#define GAME_START "[Event "
+#define MIN_CHUNK_SIZE (1 << 20) // smaller files are split into fewer chunks
+#define INITIAL_CAPACITY 64
+#define NO_RESULT -1
+#define NO_TIME -1
+#define SECONDS_PER_DAY (24 * 60 * 60)
+
+/**
+ * A string inside the mapped file, still escaped the PGN way.
+ * */
+typedef struct chess_pgn_slice_t {
+    const char* start;
+    int length;       // 0 if the tag was not found
+} Slice;
+
+/**
+ * The tags of one game, as parsed by the worker threads.
+ * */
+typedef struct chess_pgn_game_t {
+    Slice event;
+    Slice site;
+    Slice white;
+    Slice black;
+    int winner;       // a Winner, or NO_RESULT
+    int play_time;    // in seconds, or NO_TIME
+    int start_time;   // StartTime and EndTime, until the end of the game
+    int end_time;
+} PgnGame;
+
+typedef struct chess_pgn_chunk_t {
+    const char* start;
+    const char* end;
+    PgnGame* games;
+    int size;
+    int capacity;
+    bool out_of_memory;
+    pthread_t thread;
+    bool threaded;    // false if the chunk was parsed by the calling thread
+} Chunk;
+
+/**
+ * What commitChunk keeps from one game to the next.
+ * */
+typedef struct chess_pgn_commit_t {
+    char* strings;              // the unescaped strings of a game
+    size_t capacity;
+    int last_tournament_id;     // of the last game, whose tournament is known to exist
+} CommitState;
+
+// ------------------ FUNCTIONS DECLARATIONS ---------------- //
+
+static int splitIntoChunks(const char* data, size_t size, int num_of_threads, Chunk* chunks);
+static void* parseChunk(void* argument);
+static bool addGame(Chunk* chunk);
+static void parseTag(PgnGame* game, const char* line, const char* end);
+static int parseResult(Slice value);
+static int parseClock(Slice value);
+static void finishGame(PgnGame* game);
+
+static ChessResult commitChunk(ChessSystem chess, const Chunk* chunk, long first_record,
+                               const ChessPgnOptions* options, CommitState* state);
+static bool copyStrings(CommitState* state, const PgnGame* game, char* strings[4]);
+static char* unescape(char* destination, Slice slice);
+static void report(const ChessPgnOptions* options, long record, bool malformed, ChessResult result);
+
+// ------------------ FUNCTIONS IMPLEMENTATION ---------------- //
+
+ChessResult chessImportPGN(ChessSystem chess, const char* path, const ChessPgnOptions* options)
+{
+    if (chess == NULL || path == NULL || options == NULL
+        || options->tournament_id == NULL || options->player_id == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    int file = open(path, O_RDONLY);
+    if (file < 0)
+    {
+        return CHESS_SAVE_FAILURE;
+    }
+    struct stat file_stat;
+    if (fstat(file, &file_stat) != 0)
+    {
+        close(file);
+        return CHESS_SAVE_FAILURE;
+    }
+    size_t size = (size_t)file_stat.st_size;
+    if (size == 0) // mmap can't map an empty file
+    {
+        close(file);
+        return CHESS_SUCCESS;
+    }
+    void* data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file); // the mapping keeps the file alive
+    if (data == MAP_FAILED)
+    {
+        return CHESS_SAVE_FAILURE;
+    }
+    posix_madvise(data, size, POSIX_MADV_SEQUENTIAL);
+
+    int num_of_threads = options->num_of_threads;
+    if (num_of_threads < 1)
+    {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        num_of_threads = online > 0 ? (int)online : 1;
+    }
+    Chunk* chunks = (Chunk*)calloc(num_of_threads, sizeof(Chunk));
+    if (chunks == NULL)
+    {
+        munmap(data, size);
+        return CHESS_OUT_OF_MEMORY;
+    }
+
+    // chunk 0 is parsed by the calling thread, the rest by threads of their own
+    int num_of_chunks = splitIntoChunks((const char*)data, size, num_of_threads, chunks);
+    for (int i = 1; i < num_of_chunks; i++)
+    {
+        chunks[i].threaded = (pthread_create(&chunks[i].thread, NULL, parseChunk, &chunks[i]) == 0);
+    }
+
+    // commit in file order, each chunk as soon as it is parsed
+    ChessResult result = CHESS_SUCCESS;
+    CommitState state = { NULL, 0, 0 };
+    long first_record = 0;
+    for (int i = 0; i < num_of_chunks; i++)
+    {
+        if (chunks[i].threaded)
+        {
+            pthread_join(chunks[i].thread, NULL);
+        }
+        else
+        {
+            parseChunk(&chunks[i]);
+        }
+        if (result == CHESS_SUCCESS)
+        {
+            result = chunks[i].out_of_memory ? CHESS_OUT_OF_MEMORY
+                                             : commitChunk(chess, &chunks[i], first_record, options, &state);
+        }
+        first_record += chunks[i].size;
+        free(chunks[i].games);
+    }
+
+    free(state.strings);
+    free(chunks);
+    munmap(data, size);
+    return result;
+}
+
+// ------------------ PARSING ---------------- //
+
+/**
+ * Split the file into up to num_of_threads chunks that start at the beginning of a game.
+ * Return the number of chunks.
+ * */
+static int splitIntoChunks(const char* data, size_t size, int num_of_threads, Chunk* chunks)
+{
+    size_t max_chunks = size / MIN_CHUNK_SIZE + 1;
+    if ((size_t)num_of_threads > max_chunks)
+    {
+        num_of_threads = (int)max_chunks;
+    }
+    const char* end = data + size;
+    const char* start = data;
+    int num_of_chunks = 0;
+    for (int i = 1; i <= num_of_threads && start < end; i++)
+    {
+        const char* chunk_end = end;
+        if (i < num_of_threads)
+        {
+            // the first game that starts after the even split point
+            const char* position = data + size / num_of_threads * i;
+            position = (position > start) ? position : start + 1;
+            chunk_end = NULL;
+            while (position < end && chunk_end == NULL)
+            {
+                const char* line = memchr(position, '\n', end - position);
+                if (line == NULL)
+                {
+                    break;
+                }
+                line++;
+                if ((size_t)(end - line) >= strlen(GAME_START) && memcmp(line, GAME_START, strlen(GAME_START)) == 0)
+                {
+                    chunk_end = line;
+                }
+                position = line;
+            }
+            chunk_end = (chunk_end == NULL) ? end : chunk_end;
+        }
+        chunks[num_of_chunks].start = start;
+        chunks[num_of_chunks].end = chunk_end;
+        num_of_chunks++;
+        start = chunk_end;
+    }
+    return num_of_chunks;
+}
+
+/**
+ * Parse the tags of every game of a chunk. Runs on a worker thread, and touches only the chunk.
+ * */
+static void* parseChunk(void* argument)
+{
+    Chunk* chunk = (Chunk*)argument;
+    const char* position = chunk->start;
+    PgnGame* game = NULL;
+    while (position < chunk->end)
+    {
+        const char* line_end = memchr(position, '\n', chunk->end - position);
+        if (line_end == NULL)
+        {
+            line_end = chunk->end;
+        }
+        const char* content_end = (line_end > position && line_end[-1] == '\r') ? line_end - 1 : line_end;
+
+        if (content_end - position >= (long)strlen(GAME_START) && memcmp(position, GAME_START, strlen(GAME_START)) == 0)
+        {
+            if (game != NULL)
+            {
+                finishGame(game);
+            }
+            if (!addGame(chunk))
+            {
+                return NULL;
+            }
+            game = &chunk->games[chunk->size - 1];
+        }
+        if (game != NULL && position < content_end && *position == '[')
+        {
+            parseTag(game, position + 1, content_end);
+        }
+        position = line_end + 1;
+    }
+    if (game != NULL)
+    {
+        finishGame(game);
+    }
+    return NULL;
+}
+
+/**
+ * Add an empty game to the chunk. Return false (and mark the chunk) if malloc failed.
+ * */
+static bool addGame(Chunk* chunk)
+{
+    if (chunk->size == chunk->capacity)
+    {
+        int new_capacity = chunk->capacity ? 2 * chunk->capacity : INITIAL_CAPACITY;
+        PgnGame* new_games = (PgnGame*)realloc(chunk->games, sizeof(PgnGame) * new_capacity);
+        if (new_games == NULL)
+        {
+            chunk->out_of_memory = true;
+            return false;
+        }
+        chunk->games = new_games;
+        chunk->capacity = new_capacity;
+    }
+    PgnGame* game = &chunk->games[chunk->size++];
+    memset(game, 0, sizeof(*game));
+    game->winner = NO_RESULT;
+    game->play_time = NO_TIME;
+    game->start_time = NO_TIME;
+    game->end_time = NO_TIME;
+    return true;
+}
+
+/**
+ * Parse a tag pair, the line that starts right after its '['.
+ * Unknown tags and lines that are not tag pairs are ignored.
+ * */
+static void parseTag(PgnGame* game, const char* line, const char* end)
+{
+    const char* name = line;
+    while (line < end && *line != ' ' && *line != '"')
+    {
+        line++;
+    }
+    int name_length = (int)(line - name);
+    while (line < end && *line == ' ')
+    {
+        line++;
+    }
+    if (line == end || *line != '"')
+    {
+        return;
+    }
+    Slice value = { ++line, 0 };
+    while (line < end && *line != '"')
+    {
+        line += (*line == '\\' && line + 1 < end) ? 2 : 1;
+    }
+    if (line == end)
+    {
+        return;
+    }
+    value.length = (int)(line - value.start);
+
+#define IS_TAG(tag) (name_length == (int)strlen(tag) && memcmp(name, tag, name_length) == 0)
+    if (IS_TAG("Event"))
+    {
+        game->event = value;
+    }
+    else if (IS_TAG("Site"))
+    {
+        game->site = value;
+    }
+    else if (IS_TAG("White"))
+    {
+        game->white = value;
+    }
+    else if (IS_TAG("Black"))
+    {
+        game->black = value;
+    }
+    else if (IS_TAG("Result"))
+    {
+        game->winner = parseResult(value);
+    }
+    else if (IS_TAG("GameDuration"))
+    {
+        game->play_time = parseClock(value);
+    }
+    else if (IS_TAG("StartTime"))
+    {
+        game->start_time = parseClock(value);
+    }
+    else if (IS_TAG("EndTime"))
+    {
+        game->end_time = parseClock(value);
+    }
+#undef IS_TAG
+}
+
+static int parseResult(Slice value)
+{
+    if (value.length == 3 && memcmp(value.start, "1-0", 3) == 0)
+    {
+        return FIRST_PLAYER;
+    }
+    if (value.length == 3 && memcmp(value.start, "0-1", 3) == 0)
+    {
+        return SECOND_PLAYER;
+    }
+    if (value.length == 7 && memcmp(value.start, "1/2-1/2", 7) == 0)
+    {
+        return DRAW;
+    }
+    return NO_RESULT; // "*", the game is not over
+}
+
+/**
+ * Parse a time of the form HH:MM:SS (also MM:SS or SS) into seconds. Return NO_TIME if it is not one.
+ * */
+static int parseClock(Slice value)
+{
+    long seconds = 0;
+    long field = 0;
+    int digits = 0;
+    int fields = 0;
+    for (int i = 0; i <= value.length; i++)
+    {
+        char c = (i < value.length) ? value.start[i] : ':';
+        if (c >= '0' && c <= '9' && digits < 9)
+        {
+            field = 10 * field + (c - '0');
+            digits++;
+        }
+        else if (c == ':' && digits > 0 && fields < 3)
+        {
+            seconds = 60 * seconds + field;
+            field = 0;
+            digits = 0;
+            fields++;
+        }
+        else
+        {
+            return NO_TIME;
+        }
+    }
+    return (seconds > 0x7FFFFFFFL) ? NO_TIME : (int)seconds;
+}
+
+/**
+ * Take the play time from StartTime and EndTime if there was no GameDuration.
+ * */
+static void finishGame(PgnGame* game)
+{
+    if (game->play_time == NO_TIME && game->start_time != NO_TIME && game->end_time != NO_TIME)
+    {
+        int play_time = game->end_time - game->start_time;
+        game->play_time = (play_time < 0) ? play_time + SECONDS_PER_DAY : play_time; // past midnight
+    }
+}
+
+// ------------------ COMMITTING ---------------- //
+
+/**
+ * Add the games of a chunk to the system, and their tournaments when they are new.
+ * Return CHESS_OUT_OF_MEMORY if malloc failed, otherwise CHESS_SUCCESS.
+ * */
+static ChessResult commitChunk(ChessSystem chess, const Chunk* chunk, long first_record,
+                               const ChessPgnOptions* options, CommitState* state)
+{
+    for (int i = 0; i < chunk->size; i++)
+    {
+        const PgnGame* game = &chunk->games[i];
+        long record = first_record + i;
+        if (game->site.length == 0 || game->white.length == 0 || game->black.length == 0
+            || game->winner == NO_RESULT || game->play_time == NO_TIME)
+        {
+            report(options, record, true, CHESS_SUCCESS);
+            continue;
+        }
+        char* strings[4]; // event, site, white, black
+        if (!copyStrings(state, game, strings))
+        {
+            return CHESS_OUT_OF_MEMORY;
+        }
+
+        // consecutive games usually belong to the same tournament
+        int tournament_id = options->tournament_id(strings[0], options->context);
+        ChessResult result = CHESS_SUCCESS;
+        if (tournament_id != state->last_tournament_id)
+        {
+            result = chessAddTournament(chess, tournament_id, options->max_games_per_player, strings[1]);
+        }
+        if (result == CHESS_SUCCESS || result == CHESS_TOURNAMENT_ALREADY_EXISTS)
+        {
+            state->last_tournament_id = tournament_id;
+            int white = options->player_id(strings[2], options->context);
+            int black = options->player_id(strings[3], options->context);
+            result = chessAddGame(chess, tournament_id, white, black, (Winner)game->winner, game->play_time);
+        }
+        if (result == CHESS_OUT_OF_MEMORY)
+        {
+            return CHESS_OUT_OF_MEMORY;
+        }
+        if (result != CHESS_SUCCESS)
+        {
+            report(options, record, false, result);
+        }
+    }
+    return CHESS_SUCCESS;
+}
+
+/**
+ * Unescape the strings of a game into the buffer of state. Return false if malloc failed.
+ * */
+static bool copyStrings(CommitState* state, const PgnGame* game, char* strings[4])
+{
+    const Slice* slices[4] = { &game->event, &game->site, &game->white, &game->black };
+    size_t size = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        size += slices[i]->length + 1;
+    }
+    if (size > state->capacity)
+    {
+        char* new_strings = (char*)realloc(state->strings, 2 * size);
+        if (new_strings == NULL)
+        {
+            return false;
+        }
+        state->strings = new_strings;
+        state->capacity = 2 * size;
+    }
+    char* destination = state->strings;
+    for (int i = 0; i < 4; i++)
+    {
+        strings[i] = destination;
+        destination = unescape(destination, *slices[i]);
+    }
+    return true;
+}
+
+/**
+ * Copy a slice without its escaping backslashes, and terminate it. Return the position after it.
+ * */
+static char* unescape(char* destination, Slice slice)
+{
+    for (int i = 0; i < slice.length; i++)
+    {
+        if (slice.start[i] == '\\' && i + 1 < slice.length)
+        {
+            i++;
+        }
+        *destination++ = slice.start[i];
+    }
+    *destination++ = '\0';
+    return destination;
+}
+
+static void report(const ChessPgnOptions* options, long record, bool malformed, ChessResult result)
+{
+    if (options->on_error == NULL)
+    {
+        return;
+    }
+    ChessLoadError error = { record, malformed, result };
+    options->on_error(&error, options->error_context);
+}
@@ -1,4 +1,5 @@
 #include "chessPlayer.h"
+#include "mapExt.h"
 
 #include <stdlib.h>
 
@@ -38,8 +39,11 @@ struct chess_player_t {
 
 // ------------------ FUNCTIONS DECLARATIONS ---------------- //
 
+static bool addToMap(Map map, int player_id, MapResult (*put)(Map, MapKeyElement, MapDataElement));
 static int playerGetTotalGames(Player player);
 static int playerGetScore(Player player, int tournament_id);
+static void removeAddedTournaments(Player player, const PlayerTournament* tournaments, const bool* added,
+                                   int num_of_tournaments);
 
 // ------------------ FUNCTIONS IMPLEMENTATIONS ---------------- //
 
@@ -49,6 +53,14 @@ Map playerCreateMap()
 }
 
 bool playerAddToMap(Map map, int player_id)
+{
+    return addToMap(map, player_id, mapPut);
+}
+
+/**
+ * Add a player with no games to map, with put.
+ * */
+static bool addToMap(Map map, int player_id, MapResult (*put)(Map, MapKeyElement, MapDataElement))
 {
     Player player = (Player)malloc(sizeof(*player));
     if (player == NULL)
@@ -75,7 +87,7 @@ bool playerAddToMap(Map map, int player_id)
     player->num_of_wins = 0;
     player->total_time = 0;
 
-    if (mapPut(map, &player_id, player) != MAP_SUCCESS)
+    if (put(map, &player_id, player) != MAP_SUCCESS)
     {
         freePlayer(player);
         return false;
@@ -85,6 +97,107 @@ bool playerAddToMap(Map map, int player_id)
     return true;
 }
 
+bool playerRestoreToMap(Map map, const PlayerSummary* summary,
+                        const PlayerTournament* tournaments, int num_of_tournaments)
+{
+    // restored from the highest id down, every player goes before the others, so mapGet finds it at once
+    if (!addToMap(map, summary->id, mapPutFirst))
+    {
+        return false;
+    }
+    int player_id = summary->id;
+    Player player = mapGet(map, &player_id);
+    player->num_of_wins = summary->num_of_wins;
+    player->num_of_loses = summary->num_of_loses;
+    player->num_of_draws = summary->num_of_draws;
+    player->total_time = summary->total_time;
+
+    // insert from the highest id, so every insertion is at the head of the map
+    for (int i = num_of_tournaments - 1; i >= 0; i--)
+    {
+        int tournament_id = tournaments[i].tournament_id;
+        if (mapPutFirst(player->score_per_tournament, &tournament_id,
+                        (MapDataElement)&tournaments[i].score) != MAP_SUCCESS
+         || mapPutFirst(player->games_per_tournament, &tournament_id,
+                        (MapDataElement)&tournaments[i].num_of_games) != MAP_SUCCESS)
+        {
+            mapRemove(map, &player_id);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool playerMerge(Player player, const PlayerSummary* summary,
+                 const PlayerTournament* tournaments, int num_of_tournaments, bool* added)
+{
+    // only the tournaments new to the player need memory, so they are added first
+    for (int i = 0; i < num_of_tournaments; i++)
+    {
+        int tournament_id = tournaments[i].tournament_id;
+        added[i] = mapGet(player->games_per_tournament, &tournament_id) == NULL;
+        if (added[i]
+            && (mapPut(player->score_per_tournament, &tournament_id, (MapDataElement)&tournaments[i].score) != MAP_SUCCESS
+             || mapPut(player->games_per_tournament, &tournament_id,
+                       (MapDataElement)&tournaments[i].num_of_games) != MAP_SUCCESS))
+        {
+            removeAddedTournaments(player, tournaments, added, i + 1);
+            return false;
+        }
+    }
+
+    for (int i = 0; i < num_of_tournaments; i++)
+    {
+        if (!added[i])
+        {
+            int tournament_id = tournaments[i].tournament_id;
+            *(int*)mapGet(player->score_per_tournament, &tournament_id) += tournaments[i].score;
+            *(int*)mapGet(player->games_per_tournament, &tournament_id) += tournaments[i].num_of_games;
+        }
+    }
+    player->num_of_wins += summary->num_of_wins;
+    player->num_of_loses += summary->num_of_loses;
+    player->num_of_draws += summary->num_of_draws;
+    player->total_time += summary->total_time;
+    return true;
+}
+
+void playerUnmerge(Player player, const PlayerSummary* summary,
+                   const PlayerTournament* tournaments, int num_of_tournaments, const bool* added)
+{
+    removeAddedTournaments(player, tournaments, added, num_of_tournaments);
+    for (int i = 0; i < num_of_tournaments; i++)
+    {
+        if (!added[i])
+        {
+            int tournament_id = tournaments[i].tournament_id;
+            *(int*)mapGet(player->score_per_tournament, &tournament_id) -= tournaments[i].score;
+            *(int*)mapGet(player->games_per_tournament, &tournament_id) -= tournaments[i].num_of_games;
+        }
+    }
+    player->num_of_wins -= summary->num_of_wins;
+    player->num_of_loses -= summary->num_of_loses;
+    player->num_of_draws -= summary->num_of_draws;
+    player->total_time -= summary->total_time;
+}
+
+/**
+ * Remove from a player the tournaments playerMerge added to it.
+ * */
+static void removeAddedTournaments(Player player, const PlayerTournament* tournaments, const bool* added,
+                                   int num_of_tournaments)
+{
+    for (int i = 0; i < num_of_tournaments; i++)
+    {
+        if (added[i])
+        {
+            int tournament_id = tournaments[i].tournament_id;
+            mapRemove(player->score_per_tournament, &tournament_id);
+            mapRemove(player->games_per_tournament, &tournament_id);
+        }
+    }
+}
+
 bool playerUpdate(Player player, int player_id, int tournament_id, PlayerStatus status, int play_time)
 {
     int* score = mapGet(player->score_per_tournament, &tournament_id);
@@ -221,36 +334,36 @@ static int playerGetScore(Player player, int tournament_id)
 
 int playerCompareLoses(Player player1, Player player2, int tournament_id, int* min_loses, int* max_wins)
 {
-    if (player1 != NULL && player1->num_of_loses < *min_loses)
+    if (player1 != NULL && (int)player1->num_of_loses < *min_loses)
     {
         *min_loses = player1->num_of_loses;
         *max_wins = player1->num_of_wins;
         return player1->id;
     }
-    if (player2 != NULL && player2->num_of_loses < *min_loses)
+    if (player2 != NULL && (int)player2->num_of_loses < *min_loses)
     {
         *min_loses = player2->num_of_loses;
         *max_wins = player2->num_of_wins;
         return player2->id;
     }
     return ((player1 != NULL && player2 != NULL &&
-            player1->num_of_loses == player2->num_of_loses && player1->num_of_loses == *min_loses) ? -1 : 0);
+            player1->num_of_loses == player2->num_of_loses && (int)player1->num_of_loses == *min_loses) ? -1 : 0);
 }
 
 int playerCompareWins(Player player1, Player player2, int tournament_id, int* max_wins)
 {
-    if (player1 != NULL && player1->num_of_wins > *max_wins)
+    if (player1 != NULL && (int)player1->num_of_wins > *max_wins)
     {
         *max_wins = player1->num_of_wins;
         return player1->id;
     }
-    if (player2 != NULL && player2->num_of_wins > *max_wins)
+    if (player2 != NULL && (int)player2->num_of_wins > *max_wins)
     {
         *max_wins = player2->num_of_wins;
         return player2->id;
     }
     return ((player1 != NULL && player2 != NULL && 
-            player1->num_of_wins == player2->num_of_wins && player2->num_of_wins == *max_wins) ? -1 : 0);
+            player1->num_of_wins == player2->num_of_wins && (int)player2->num_of_wins == *max_wins) ? -1 : 0);
 }
 
 void playerSwitchLoseToVictory(Player player, int tournament_id)
@@ -289,8 +402,12 @@ void playerRemoveFromGame(Player player, PlayerStatus status, int game_length, i
 
     player->total_time -= game_length;
 
-    mapRemove(player->score_per_tournament, &tournament_id);
-    mapRemove(player->games_per_tournament, &tournament_id);
+    int* games = mapGet(player->games_per_tournament, &tournament_id);
+    if (games != NULL && --(*games) == 0)
+    {
+        mapRemove(player->score_per_tournament, &tournament_id);
+        mapRemove(player->games_per_tournament, &tournament_id);
+    }
 }
 
 bool playerPlayedInTournament(Player player, int tournament_id)
@@ -308,14 +425,46 @@ int playerGetGamesInTournament(Player player, int tournament_id)
     return *games;
 }
 
-void playerResetStatistics(Player player)
+int playerGetNumOfWins(Player player)
 {
-    player->num_of_draws = 0;
-    player->num_of_loses = 0;
-    player->num_of_wins = 0;
-    player->total_time = 0;
-    mapClear(player->games_per_tournament);
-    mapClear(player->score_per_tournament);
+    return player->num_of_wins;
+}
+
+int playerGetNumOfLoses(Player player)
+{
+    return player->num_of_loses;
+}
+
+int playerGetNumOfDraws(Player player)
+{
+    return player->num_of_draws;
+}
+
+void playerGetSummary(Player player, PlayerSummary* summary)
+{
+    summary->id = player->id;
+    summary->num_of_wins = player->num_of_wins;
+    summary->num_of_loses = player->num_of_loses;
+    summary->num_of_draws = player->num_of_draws;
+    summary->total_time = player->total_time;
+}
+
+int playerGetNumOfTournaments(Player player)
+{
+    return mapGetSize(player->games_per_tournament);
+}
+
+void playerGetTournaments(Player player, PlayerTournament* tournaments)
+{
+    int i = 0;
+    MAP_FOREACH(int*, tournament_id, player->games_per_tournament)
+    {
+        tournaments[i].tournament_id = *tournament_id;
+        tournaments[i].score = *(int*)mapGet(player->score_per_tournament, tournament_id);
+        tournaments[i].num_of_games = *(int*)mapGet(player->games_per_tournament, tournament_id);
+        free(tournament_id);
+        i++;
+    }
 }
 
 // ------------------ POINTER FUNCTIONS IMPLEMENTATIONS ---------------- //
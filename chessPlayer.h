@@ -5,6 +5,26 @@
 
 typedef struct chess_player_t *Player;
 
+/**
+ * The statistics of a player, by value.
+ * */
+typedef struct chess_player_summary_t {
+    int id;
+    int num_of_wins;
+    int num_of_loses;
+    int num_of_draws;
+    unsigned int total_time;
+} PlayerSummary;
+
+/**
+ * The statistics of a player in one tournament.
+ * */
+typedef struct chess_player_tournament_t {
+    int tournament_id;
+    int score;
+    int num_of_games;
+} PlayerTournament;
+
 typedef enum chess_player_state_t {
     PLAYER_WINNER,
     PLAYER_LOSER,
@@ -23,6 +43,27 @@ Map playerCreateMap(void);
  * */
 bool playerAddToMap(Map map, int player_id);
 
+/**
+ * Create a player with the given statistics and add it to a map.
+ * Return false if an error occured (malloc failed), otherwise return true.
+ * */
+bool playerRestoreToMap(Map map, const PlayerSummary* summary,
+                        const PlayerTournament* tournaments, int num_of_tournaments);
+
+/**
+ * Add the statistics of the same player in another system to player (see chessMerge).
+ * added (num_of_tournaments elements) receives which of the tournaments were new to the player.
+ * Return false if an error occured (malloc failed), then the player is unchanged.
+ * */
+bool playerMerge(Player player, const PlayerSummary* summary,
+                 const PlayerTournament* tournaments, int num_of_tournaments, bool* added);
+
+/**
+ * Take back the statistics that playerMerge added to player, with the same arguments. Can't fail.
+ * */
+void playerUnmerge(Player player, const PlayerSummary* summary,
+                   const PlayerTournament* tournaments, int num_of_tournaments, const bool* added);
+
 /**
  * Update the statistics of a player when adding a new game.
  * Return false if an error occured (malloc failed), otherwise return true.
@@ -44,6 +85,17 @@ double playerGetLevel(Player player);
 double playerGetAveragePlayTime(Player player);
 bool playerPlayedInTournament(Player player, int tournament_id);
 int playerGetGamesInTournament(Player player, int tournament_id);
+int playerGetNumOfWins(Player player);
+int playerGetNumOfLoses(Player player);
+int playerGetNumOfDraws(Player player);
+void playerGetSummary(Player player, PlayerSummary* summary);
+int playerGetNumOfTournaments(Player player);
+
+/**
+ * Fill tournaments (playerGetNumOfTournaments elements) with the player's statistics
+ * per tournament, sorted by tournament id.
+ * */
+void playerGetTournaments(Player player, PlayerTournament* tournaments);
 
 // Functions that serve tournamentEnd
 
@@ -54,7 +106,8 @@ int playerCompareWins(Player player1, Player player2, int tournament_id, int* ma
 /**
  * Update player's statistics after removing a game from system.
  * Game removal only happens when a tournament is removed,
- * so the function also deletes the tournament from player->score_per_tournament map
+ * so once the player's last game in it is removed, the function also deletes
+ * the tournament from player->score_per_tournament map
  * */
 void playerRemoveFromGame(Player player, PlayerStatus status, int game_length, int tournament_id);
 
@@ -63,12 +116,4 @@ void playerRemoveFromGame(Player player, PlayerStatus status, int game_length, i
 void playerSwitchLoseToVictory(Player player, int tournament_id);
 void playerSwitchDrawToVictory(Player player, int tournament_id);
 
-/**
- * Reset the player's statistics to 0.
- * Is done instead of removing it from the system as a requirement of ex1-version3,
- * in order to track players that once played but were removed from the system.
- * NOTE: after playerResetStatistics is called, playerExists will return FALSE.
- * */
-void playerResetStatistics(Player player);
-
 #endif
\ No newline at end of file
@@ -0,0 +1,500 @@
+#define _POSIX_C_SOURCE 200809L // pthreads, sched_yield
+
+#include "chessPool.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+
+// ------------------ DEFINES ---------------- //
+
+#define QUEUE_CAPACITY 256 // a power of 2
+#define SORT_GRAIN 4096    // smaller parts are sorted by qsort alone
+#define CACHE_LINE_SIZE 64
+
+typedef struct chess_pool_task_t {
+    PoolTask run;
+    void* context;
+    PoolGroup* group;
+} Task;
+
+/**
+ * The queue of one worker (or of the threads outside the pool), and what its threads did.
+ * Its owner takes tasks from the bottom, the others steal from the top.
+ * */
+typedef struct chess_pool_queue_t {
+    pthread_mutex_t lock;
+    Task tasks[QUEUE_CAPACITY];
+    unsigned long top;    // of the oldest task
+    unsigned long bottom; // after the newest task
+    ChessWorkerCounters counters; // updated atomically, the outside queue has many threads
+    Pool pool;
+    char padding[CACHE_LINE_SIZE]; // keep the owner of the next queue off this cache line
+} Queue;
+
+struct chess_pool_t {
+    int num_of_workers;
+    Queue* queues;       // one per worker, then the one of the threads outside the pool
+    pthread_t* threads;
+    pthread_key_t current; // the Queue of the current thread, NULL outside the pool
+    pthread_mutex_t lock;  // guards stopping, and is what idle workers wait on
+    pthread_cond_t work;
+    int queued;   // tasks in all the queues (atomic)
+    int sleeping; // workers waiting for work (atomic)
+    bool stopping;
+};
+
+/**
+ * The state of one poolFor.
+ * */
+typedef struct chess_pool_for_t {
+    PoolRange body;
+    void* context;
+    int size;
+    int grain;
+    int next; // the first item no thread took yet (atomic)
+} ForJob;
+
+/**
+ * One part of a poolSort, sorted in place with the matching part of buffer to merge into.
+ * */
+typedef struct chess_pool_sort_t {
+    Pool pool;
+    char* base;
+    char* buffer;
+    int size;
+    size_t element_size;
+    int (*compare)(const void*, const void*);
+} SortJob;
+
+// ------------------ FUNCTIONS DECLARATIONS ---------------- //
+
+static bool initQueues(Pool pool);
+static void destroyQueues(Pool pool, int size);
+static void stopWorkers(Pool pool, int size);
+static void freePool(Pool pool);
+static void* runWorker(void* queue);
+static Queue* currentQueue(Pool pool);
+static bool pushTask(Queue* queue, const Task* task);
+static bool takeTask(Pool pool, Queue* queue, Task* task);
+static bool popTask(Queue* queue, Task* task, bool newest);
+static void runTask(Queue* queue, const Task* task);
+static void runRanges(void* job);
+static void sortPart(void* job);
+static void mergeParts(SortJob* job, int half);
+
+// ------------------ FUNCTIONS IMPLEMENTATION ---------------- //
+
+Pool poolCreate(int num_of_workers)
+{
+    if (num_of_workers < 1)
+    {
+        return NULL;
+    }
+    Pool pool = (Pool)malloc(sizeof(*pool));
+    if (pool == NULL)
+    {
+        return NULL;
+    }
+    pool->num_of_workers = num_of_workers;
+    pool->queued = 0;
+    pool->sleeping = 0;
+    pool->stopping = false;
+    pool->queues = (Queue*)malloc(sizeof(Queue) * (num_of_workers + 1));
+    pool->threads = (pthread_t*)malloc(sizeof(pthread_t) * num_of_workers);
+    if (pool->queues == NULL || pool->threads == NULL)
+    {
+        free(pool->queues);
+        free(pool->threads);
+        free(pool);
+        return NULL;
+    }
+    if (!initQueues(pool))
+    {
+        free(pool->queues);
+        free(pool->threads);
+        free(pool);
+        return NULL;
+    }
+    if (pthread_key_create(&pool->current, NULL) != 0)
+    {
+        destroyQueues(pool, num_of_workers + 1);
+        free(pool->queues);
+        free(pool->threads);
+        free(pool);
+        return NULL;
+    }
+    if (pthread_mutex_init(&pool->lock, NULL) != 0)
+    {
+        pthread_key_delete(pool->current);
+        destroyQueues(pool, num_of_workers + 1);
+        free(pool->queues);
+        free(pool->threads);
+        free(pool);
+        return NULL;
+    }
+    if (pthread_cond_init(&pool->work, NULL) != 0)
+    {
+        pthread_mutex_destroy(&pool->lock);
+        pthread_key_delete(pool->current);
+        destroyQueues(pool, num_of_workers + 1);
+        free(pool->queues);
+        free(pool->threads);
+        free(pool);
+        return NULL;
+    }
+    for (int i = 0; i < num_of_workers; i++)
+    {
+        if (pthread_create(&pool->threads[i], NULL, runWorker, &pool->queues[i]) != 0)
+        {
+            stopWorkers(pool, i);
+            freePool(pool);
+            return NULL;
+        }
+    }
+    return pool;
+}
+
+void poolDestroy(Pool pool)
+{
+    if (pool == NULL)
+    {
+        return;
+    }
+    stopWorkers(pool, pool->num_of_workers);
+    freePool(pool);
+}
+
+int poolGetNumOfWorkers(Pool pool)
+{
+    return pool == NULL ? 0 : pool->num_of_workers;
+}
+
+void poolGroupInit(PoolGroup* group, Pool pool)
+{
+    group->pool = pool;
+    group->pending = 0;
+}
+
+void poolSpawn(PoolGroup* group, PoolTask task, void* context)
+{
+    Pool pool = group->pool;
+    Task queued = { task, context, group };
+    if (pool == NULL)
+    {
+        task(context);
+        return;
+    }
+    Queue* queue = currentQueue(pool);
+    __atomic_add_fetch(&group->pending, 1, __ATOMIC_RELAXED);
+    if (!pushTask(queue, &queued))
+    {
+        runTask(queue, &queued);
+        return;
+    }
+    // pairs with the idle worker, which counts itself as sleeping before it checks queued
+    __atomic_add_fetch(&pool->queued, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&pool->sleeping, __ATOMIC_SEQ_CST) > 0)
+    {
+        pthread_mutex_lock(&pool->lock);
+        pthread_cond_signal(&pool->work);
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+void poolWait(PoolGroup* group)
+{
+    Pool pool = group->pool;
+    if (pool == NULL)
+    {
+        return;
+    }
+    Queue* queue = currentQueue(pool);
+    while (__atomic_load_n(&group->pending, __ATOMIC_ACQUIRE) > 0)
+    {
+        Task task;
+        if (takeTask(pool, queue, &task))
+        {
+            runTask(queue, &task);
+        }
+        else
+        {
+            sched_yield(); // what is left is running on other threads
+        }
+    }
+}
+
+void poolFor(Pool pool, int size, int grain, PoolRange body, void* context)
+{
+    grain = grain < 1 ? 1 : grain;
+    if (pool == NULL || size <= grain)
+    {
+        if (size > 0)
+        {
+            body(context, 0, size);
+        }
+        return;
+    }
+    ForJob job = { body, context, size, grain, 0 };
+    int num_of_ranges = (size + grain - 1) / grain;
+    int num_of_tasks = num_of_ranges - 1 < pool->num_of_workers ? num_of_ranges - 1 : pool->num_of_workers;
+    PoolGroup group;
+    poolGroupInit(&group, pool);
+    for (int i = 0; i < num_of_tasks; i++)
+    {
+        poolSpawn(&group, runRanges, &job);
+    }
+    runRanges(&job);
+    poolWait(&group);
+}
+
+void poolSort(Pool pool, void* base, int size, size_t element_size,
+              int (*compare)(const void*, const void*))
+{
+    char* buffer = NULL;
+    if (pool != NULL && size >= 2 * SORT_GRAIN)
+    {
+        buffer = (char*)malloc(element_size * size);
+    }
+    if (buffer == NULL)
+    {
+        qsort(base, size, element_size, compare);
+        return;
+    }
+    SortJob job = { pool, (char*)base, buffer, size, element_size, compare };
+    sortPart(&job);
+    free(buffer);
+}
+
+int poolGetCounters(Pool pool, ChessWorkerCounters* counters, int capacity)
+{
+    if (pool == NULL)
+    {
+        return 0;
+    }
+    for (int i = 0; i < capacity && i <= pool->num_of_workers; i++)
+    {
+        ChessWorkerCounters* queue_counters = &pool->queues[i].counters;
+        counters[i].tasks_run = __atomic_load_n(&queue_counters->tasks_run, __ATOMIC_RELAXED);
+        counters[i].tasks_stolen = __atomic_load_n(&queue_counters->tasks_stolen, __ATOMIC_RELAXED);
+        counters[i].sleeps = __atomic_load_n(&queue_counters->sleeps, __ATOMIC_RELAXED);
+    }
+    return pool->num_of_workers + 1;
+}
+
+static bool initQueues(Pool pool)
+{
+    for (int i = 0; i <= pool->num_of_workers; i++)
+    {
+        Queue* queue = &pool->queues[i];
+        if (pthread_mutex_init(&queue->lock, NULL) != 0)
+        {
+            destroyQueues(pool, i);
+            return false;
+        }
+        queue->top = 0;
+        queue->bottom = 0;
+        memset(&queue->counters, 0, sizeof(queue->counters));
+        queue->pool = pool;
+    }
+    return true;
+}
+
+static void destroyQueues(Pool pool, int size)
+{
+    for (int i = 0; i < size; i++)
+    {
+        pthread_mutex_destroy(&pool->queues[i].lock);
+    }
+}
+
+/**
+ * Wake the first size workers up to stop, and wait for them.
+ * */
+static void stopWorkers(Pool pool, int size)
+{
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = true;
+    pthread_cond_broadcast(&pool->work);
+    pthread_mutex_unlock(&pool->lock);
+    for (int i = 0; i < size; i++)
+    {
+        pthread_join(pool->threads[i], NULL);
+    }
+}
+
+/**
+ * Free a pool whose workers stopped.
+ * */
+static void freePool(Pool pool)
+{
+    pthread_cond_destroy(&pool->work);
+    pthread_mutex_destroy(&pool->lock);
+    pthread_key_delete(pool->current);
+    destroyQueues(pool, pool->num_of_workers + 1);
+    free(pool->queues);
+    free(pool->threads);
+    free(pool);
+}
+
+static void* runWorker(void* argument)
+{
+    Queue* queue = (Queue*)argument;
+    Pool pool = queue->pool;
+    pthread_setspecific(pool->current, queue);
+    while (true)
+    {
+        Task task;
+        if (takeTask(pool, queue, &task))
+        {
+            runTask(queue, &task);
+            continue;
+        }
+        pthread_mutex_lock(&pool->lock);
+        __atomic_add_fetch(&pool->sleeping, 1, __ATOMIC_SEQ_CST);
+        while (!pool->stopping && __atomic_load_n(&pool->queued, __ATOMIC_SEQ_CST) == 0)
+        {
+            __atomic_add_fetch(&queue->counters.sleeps, 1, __ATOMIC_RELAXED);
+            pthread_cond_wait(&pool->work, &pool->lock);
+        }
+        __atomic_sub_fetch(&pool->sleeping, 1, __ATOMIC_SEQ_CST);
+        bool stopping = pool->stopping;
+        pthread_mutex_unlock(&pool->lock);
+        if (stopping)
+        {
+            return NULL;
+        }
+    }
+}
+
+static Queue* currentQueue(Pool pool)
+{
+    Queue* queue = (Queue*)pthread_getspecific(pool->current);
+    return queue != NULL ? queue : &pool->queues[pool->num_of_workers];
+}
+
+/**
+ * Return false if the queue is full.
+ * */
+static bool pushTask(Queue* queue, const Task* task)
+{
+    pthread_mutex_lock(&queue->lock);
+    bool pushed = queue->bottom - queue->top < QUEUE_CAPACITY;
+    if (pushed)
+    {
+        queue->tasks[queue->bottom++ & (QUEUE_CAPACITY - 1)] = *task;
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return pushed;
+}
+
+/**
+ * Take the newest task of queue, or else steal the oldest task of the next queue that has one.
+ * */
+static bool takeTask(Pool pool, Queue* queue, Task* task)
+{
+    if (__atomic_load_n(&pool->queued, __ATOMIC_ACQUIRE) == 0)
+    {
+        return false;
+    }
+    if (popTask(queue, task, true))
+    {
+        return true;
+    }
+    int num_of_queues = pool->num_of_workers + 1;
+    int own = (int)(queue - pool->queues);
+    for (int i = 1; i < num_of_queues; i++)
+    {
+        if (popTask(&pool->queues[(own + i) % num_of_queues], task, false))
+        {
+            __atomic_add_fetch(&queue->counters.tasks_stolen, 1, __ATOMIC_RELAXED);
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool popTask(Queue* queue, Task* task, bool newest)
+{
+    pthread_mutex_lock(&queue->lock);
+    bool popped = queue->bottom != queue->top;
+    if (popped)
+    {
+        *task = queue->tasks[(newest ? --queue->bottom : queue->top++) & (QUEUE_CAPACITY - 1)];
+        __atomic_sub_fetch(&queue->pool->queued, 1, __ATOMIC_RELAXED);
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return popped;
+}
+
+static void runTask(Queue* queue, const Task* task)
+{
+    task->run(task->context);
+    __atomic_add_fetch(&queue->counters.tasks_run, 1, __ATOMIC_RELAXED);
+    // what the task did is visible to the thread that sees its group done
+    __atomic_sub_fetch(&task->group->pending, 1, __ATOMIC_RELEASE);
+}
+
+static void runRanges(void* argument)
+{
+    ForJob* job = (ForJob*)argument;
+    int begin;
+    while ((begin = __atomic_fetch_add(&job->next, job->grain, __ATOMIC_RELAXED)) < job->size)
+    {
+        int end = job->size - begin > job->grain ? begin + job->grain : job->size;
+        job->body(job->context, begin, end);
+    }
+}
+
+/**
+ * Sort the two halves of the part (one of them on another thread), then merge them.
+ * */
+static void sortPart(void* argument)
+{
+    SortJob* job = (SortJob*)argument;
+    if (job->size <= SORT_GRAIN)
+    {
+        qsort(job->base, job->size, job->element_size, job->compare);
+        return;
+    }
+    int half = job->size / 2;
+    size_t offset = job->element_size * half;
+    SortJob first = { job->pool, job->base, job->buffer, half, job->element_size, job->compare };
+    SortJob second = { job->pool, job->base + offset, job->buffer + offset, job->size - half,
+                       job->element_size, job->compare };
+    PoolGroup group;
+    poolGroupInit(&group, job->pool);
+    poolSpawn(&group, sortPart, &first);
+    sortPart(&second);
+    poolWait(&group);
+    mergeParts(job, half);
+}
+
+static void mergeParts(SortJob* job, int half)
+{
+    size_t element_size = job->element_size;
+    const char* first = job->base;
+    const char* first_end = job->base + element_size * half;
+    const char* second = first_end;
+    const char* second_end = job->base + element_size * job->size;
+    char* merged = job->buffer;
+    while (first < first_end && second < second_end)
+    {
+        if (job->compare(first, second) <= 0)
+        {
+            memcpy(merged, first, element_size);
+            first += element_size;
+        }
+        else
+        {
+            memcpy(merged, second, element_size);
+            second += element_size;
+        }
+        merged += element_size;
+    }
+    memcpy(merged, first, first_end - first);
+    merged += first_end - first;
+    memcpy(merged, second, second_end - second);
+    memcpy(job->base, job->buffer, element_size * job->size);
+}
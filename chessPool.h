@@ -0,0 +1,83 @@
+#ifndef _CHESSPOOL_H_
+#define _CHESSPOOL_H_
+
+#include "chessSystemExt.h"
+#include <stddef.h>
+
+/**
+ * The threads a ChessSystem runs its bulk operations on (see chessCreateWithOptions).
+ *
+ * Every worker has its own queue of tasks. It runs the newest task of its own queue first,
+ * and once that is empty steals the oldest task of another queue. Threads outside the pool
+ * queue their tasks on a queue of their own, which the workers steal from too.
+ * A thread waiting for its tasks (poolWait) runs queued tasks meanwhile, so tasks may spawn
+ * and wait for tasks of their own, but must not block on anything else.
+ *
+ * Every function also works when pool is NULL, running everything on the calling thread.
+ * */
+typedef struct chess_pool_t *Pool;
+
+typedef void (*PoolTask)(void* context);
+
+/**
+ * Does items begin to end - 1 of context.
+ * */
+typedef void (*PoolRange)(void* context, int begin, int end);
+
+/**
+ * Tasks that are waited for together. Lives on the stack of the thread that waits for them,
+ * and so do the contexts of its tasks.
+ * */
+typedef struct chess_pool_group_t {
+    Pool pool;
+    int pending; // spawned and not done yet (atomic)
+} PoolGroup;
+
+/**
+ * Create a pool of num_of_workers threads (at least 1).
+ * Return NULL if malloc failed or a thread could not be started.
+ * */
+Pool poolCreate(int num_of_workers);
+
+/**
+ * Stop the workers and destroy the pool. No task may be pending.
+ * */
+void poolDestroy(Pool pool);
+
+/**
+ * Return the number of workers, 0 if pool is NULL.
+ * */
+int poolGetNumOfWorkers(Pool pool);
+
+void poolGroupInit(PoolGroup* group, Pool pool);
+
+/**
+ * Queue task(context) in group. If the queue is full, or pool is NULL, the task runs at once.
+ * */
+void poolSpawn(PoolGroup* group, PoolTask task, void* context);
+
+/**
+ * Return once every task of group is done.
+ * */
+void poolWait(PoolGroup* group);
+
+/**
+ * Run body over 0 to size - 1 in ranges of grain items, on the calling thread and the workers.
+ * Return once all of them are done.
+ * */
+void poolFor(Pool pool, int size, int grain, PoolRange body, void* context);
+
+/**
+ * Sort like qsort: parts of the array are sorted on several threads, then merged.
+ * compare must be a total order, since the result is not stable.
+ * */
+void poolSort(Pool pool, void* base, int size, size_t element_size,
+              int (*compare)(const void*, const void*));
+
+/**
+ * Fill counters with what every worker did, then what the threads outside the pool did,
+ * up to capacity entries. Return the number of entries there are (0 if pool is NULL).
+ * */
+int poolGetCounters(Pool pool, ChessWorkerCounters* counters, int capacity);
+
+#endif
\ No newline at end of file
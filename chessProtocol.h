@@ -0,0 +1,37 @@
+#ifndef _CHESSPROTOCOL_H_
+#define _CHESSPROTOCOL_H_
+
+/**
+ * The protocol chessd serves over its Unix domain socket (see chessDaemon.c).
+ *
+ * A request is: its size (the number of bytes after it), an id chosen by the client,
+ * the command (1 byte), then the arguments of the command.
+ * A response is: its size, the id of its request, the ChessResult of the command (1 byte),
+ * then what the command returns.
+ * Every number is 4 bytes little endian, and every double 8 bytes: the little endian bits of the double.
+ * A text is the rest of the request, without a terminating 0.
+ *
+ * A client may send any number of requests without waiting for their responses. The requests of
+ * a client are run in the order they were sent, and their responses are sent in that order too.
+ * A request that can't be parsed (an unknown command, arguments of the wrong size, or a request
+ * larger than CHESS_PROTOCOL_MAX_REQUEST) closes the connection.
+ * */
+typedef enum chess_command_t {
+    CHESS_COMMAND_ADD_TOURNAMENT = 1,         // tournament id, max games per player, then the location
+    CHESS_COMMAND_ADD_GAME,                   // tournament id, first player, second player, winner, play time
+    CHESS_COMMAND_REMOVE_TOURNAMENT,          // tournament id
+    CHESS_COMMAND_REMOVE_PLAYER,              // player id
+    CHESS_COMMAND_END_TOURNAMENT,             // tournament id
+    CHESS_COMMAND_CALCULATE_AVERAGE_PLAY_TIME, // player id. Returns the average (a double)
+    CHESS_COMMAND_SAVE_PLAYERS_LEVELS,        // Returns the text chessSavePlayersLevels writes
+    CHESS_COMMAND_SAVE_TOURNAMENT_STATISTICS, // then the path of the file to write
+    CHESS_COMMAND_GET_PLAYERS_STATS,          // any number of player ids. Returns, for each of them, the fields
+                                              // of ChessPlayerStats in their order (the result is 1 byte)
+    CHESS_COMMAND_END_TOURNAMENTS,            // any number of tournament ids. Returns the result of each (1 byte)
+    CHESS_COMMAND_SAVE_SNAPSHOT               // then the path of the file to write
+} ChessCommand;
+
+#define CHESS_PROTOCOL_HEADER_SIZE 9 // the size, the id, then the command or the result
+#define CHESS_PROTOCOL_MAX_REQUEST (1 << 20)
+
+#endif
\ No newline at end of file
@@ -0,0 +1,271 @@
+#include "chessRemoval.h"
+#include "chessSystemExt.h"
+#include "chessSystemPrivate.h"
+#include "chessTournament.h"
+#include "chessBitmap.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+/*
+ * A removal updates the games of one tournament at a time, in the order the removals were made:
+ * once a removal is applied to a tournament, every earlier removal was applied to it.
+ * Removing a player right away updates the players it played against, except the ones removed after it
+ * (their statistics are thrown away with them). These are the players that are not in the system
+ * anymore, since a removed player can't come back before its removal is applied. The players removed
+ * before it were already taken out of the games of the tournament.
+ *
+ * The games of a tournament are all updated before they are read, and the statistics of the players
+ * before any of them is read. Ending a tournament reads the statistics of its players (its winner
+ * is decided by their wins and losses), so it waits for all the removals too.
+ * The average play time of a player doesn't change, since its games keep their length.
+ */
+
+// ------------------ DEFINES ---------------- //
+
+#define INITIAL_CAPACITY 16
+
+typedef struct chess_removal_t {
+    int player_id;
+    int* tournaments;       // the tournaments the player played in, by increasing id, negated once applied
+    int num_of_tournaments;
+    int num_left;           // tournaments not applied yet
+    int next;               // no tournament before it is left
+} Removal;
+
+struct chess_removals_t {
+    Removal* removals; // in the order they were made, the ones before first were applied
+    int first;
+    int size;
+    int capacity;
+    int num_left;      // removals not applied yet (some of them may be applied to some tournaments)
+    Bitmap player_ids; // of the removals not applied yet
+};
+
+// ------------------ FUNCTIONS DECLARATIONS ---------------- //
+
+static bool reserveRemoval(Removals removals);
+static int applyRemoval(Removals removals, int index, int position, Map players, Map tournaments);
+static int compareTournaments(const void* tournament1, const void* tournament2);
+
+// ------------------ FUNCTIONS IMPLEMENTATION ---------------- //
+
+ChessResult chessEnableLazyRemoval(ChessSystem chess)
+{
+    if (chess == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    if (chess->removals == NULL)
+    {
+        chess->removals = removalsCreate();
+    }
+    return chess->removals == NULL ? CHESS_OUT_OF_MEMORY : CHESS_SUCCESS;
+}
+
+int chessApplyRemovals(ChessSystem chess, int max_games)
+{
+    if (chess == NULL)
+    {
+        return 0;
+    }
+    lockSystem(chess->locks, true);
+    int num_left = removalsApply(chess->removals, chess->players, chess->tournaments, max_games);
+    unlockSystem(chess->locks);
+    return num_left;
+}
+
+Removals removalsCreate(void)
+{
+    Removals removals = (Removals)malloc(sizeof(*removals));
+    if (removals == NULL)
+    {
+        return NULL;
+    }
+    removals->player_ids = bitmapCreate();
+    if (removals->player_ids == NULL)
+    {
+        free(removals);
+        return NULL;
+    }
+    removals->removals = NULL;
+    removals->first = 0;
+    removals->size = 0;
+    removals->capacity = 0;
+    removals->num_left = 0;
+    return removals;
+}
+
+void removalsDestroy(Removals removals)
+{
+    if (removals == NULL)
+    {
+        return;
+    }
+    for (int i = removals->first; i < removals->size; i++)
+    {
+        free(removals->removals[i].tournaments);
+    }
+    free(removals->removals);
+    bitmapDestroy(removals->player_ids);
+    free(removals);
+}
+
+bool removalsAdd(Removals removals, int player_id, const PlayerTournament* played, int num_of_played)
+{
+    if (num_of_played == 0)
+    {
+        return true;
+    }
+    int* tournaments = (int*)malloc(sizeof(int) * num_of_played);
+    if (tournaments == NULL)
+    {
+        return false;
+    }
+    if (!reserveRemoval(removals) || !bitmapSet(removals->player_ids, player_id))
+    {
+        free(tournaments);
+        return false;
+    }
+    for (int i = 0; i < num_of_played; i++)
+    {
+        tournaments[i] = played[i].tournament_id;
+    }
+
+    Removal* removal = &removals->removals[removals->size++];
+    removal->player_id = player_id;
+    removal->tournaments = tournaments;
+    removal->num_of_tournaments = num_of_played;
+    removal->num_left = num_of_played;
+    removal->next = 0;
+    removals->num_left++;
+    return true;
+}
+
+bool removalsHasPlayer(Removals removals, int player_id)
+{
+    return removals != NULL && removals->num_left > 0 && bitmapGet(removals->player_ids, player_id);
+}
+
+void removalsApplyToTournament(Removals removals, Map players, Map tournaments, int tournament_id)
+{
+    if (removals == NULL)
+    {
+        return;
+    }
+    for (int i = removals->first; i < removals->size; i++)
+    {
+        Removal* removal = &removals->removals[i];
+        if (removal->num_left == 0)
+        {
+            continue;
+        }
+        int* found = (int*)bsearch(&tournament_id, removal->tournaments, removal->num_of_tournaments,
+                                   sizeof(int), compareTournaments);
+        if (found != NULL && *found > 0)
+        {
+            applyRemoval(removals, i, found - removal->tournaments, players, tournaments);
+        }
+    }
+}
+
+int removalsApply(Removals removals, Map players, Map tournaments, int max_games)
+{
+    if (removals == NULL)
+    {
+        return 0;
+    }
+    long long searched = 0;
+    while (removals->num_left > 0 && searched < max_games)
+    {
+        Removal* removal = &removals->removals[removals->first];
+        while (removal->tournaments[removal->next] < 0)
+        {
+            removal->next++;
+        }
+        // a tournament counts as one game at least, so every step makes progress
+        searched += 1 + applyRemoval(removals, removals->first, removal->next, players, tournaments);
+    }
+    return removals->num_left;
+}
+
+void removalsApplyAll(Removals removals, Map players, Map tournaments)
+{
+    removalsApply(removals, players, tournaments, INT_MAX);
+}
+
+/**
+ * Make room for one more removal. Return false if malloc failed.
+ * */
+static bool reserveRemoval(Removals removals)
+{
+    if (removals->size < removals->capacity)
+    {
+        return true;
+    }
+    if (removals->first > 0)
+    {
+        // the applied removals are at the start, their room is reused
+        removals->size -= removals->first;
+        memmove(removals->removals, removals->removals + removals->first, sizeof(Removal) * removals->size);
+        removals->first = 0;
+        return true;
+    }
+    int capacity = removals->capacity == 0 ? INITIAL_CAPACITY : 2 * removals->capacity;
+    Removal* new_removals = (Removal*)realloc(removals->removals, sizeof(Removal) * capacity);
+    if (new_removals == NULL)
+    {
+        return false;
+    }
+    removals->removals = new_removals;
+    removals->capacity = capacity;
+    return true;
+}
+
+/**
+ * Apply a removal to one of its tournaments. Return the number of games searched.
+ * */
+static int applyRemoval(Removals removals, int index, int position, Map players, Map tournaments)
+{
+    Removal* removal = &removals->removals[index];
+    int tournament_id = removal->tournaments[position];
+    removal->tournaments[position] = -tournament_id;
+
+    // a tournament that had ended before the removal keeps its games
+    int searched = 0;
+    Tournament tournament = mapGet(tournaments, &tournament_id);
+    if (tournament != NULL && !tournamentHasEnded(tournament))
+    {
+        searched = tournamentRemoveRemovedPlayer(tournament, removal->player_id, players);
+    }
+
+    if (--removal->num_left > 0)
+    {
+        return searched;
+    }
+    free(removal->tournaments);
+    removal->tournaments = NULL;
+    bitmapClear(removals->player_ids, removal->player_id);
+    removals->num_left--;
+    while (removals->first < removals->size && removals->removals[removals->first].num_left == 0)
+    {
+        removals->first++;
+    }
+    if (removals->first == removals->size)
+    {
+        removals->first = 0;
+        removals->size = 0;
+    }
+    return searched;
+}
+
+/**
+ * Compare tournament ids, whether they were applied (negated) or not.
+ * */
+static int compareTournaments(const void* tournament1, const void* tournament2)
+{
+    int id1 = abs(*(const int*)tournament1);
+    int id2 = abs(*(const int*)tournament2);
+    return (id1 > id2) - (id1 < id2);
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#ifndef _CHESSREMOVAL_H_
+#define _CHESSREMOVAL_H_
+
+#include "chessPlayer.h"
+#include "map.h"
+#include <stdbool.h>
+
+/**
+ * The players a ChessSystem removed without updating their games yet (see chessEnableLazyRemoval).
+ * Until a removal is applied, its games still hold the player, and the other players keep
+ * the losses and draws of these games. The removals are applied in the order they were made,
+ * so the statistics end up as if each of them was applied right away.
+ * It is enabled through chessSystemExt.h, this header is what the modules that read the system need.
+ * */
+typedef struct chess_removals_t *Removals;
+
+/**
+ * Create an empty list of removals. Return NULL if malloc failed.
+ * */
+Removals removalsCreate(void);
+
+void removalsDestroy(Removals removals);
+
+/**
+ * Remember the removal of a player that was taken out of the players map.
+ * played are its tournaments, as given by playerGetTournaments.
+ * Return false if malloc failed, then nothing was remembered.
+ * */
+bool removalsAdd(Removals removals, int player_id, const PlayerTournament* played, int num_of_played);
+
+/**
+ * Return whether the removal of a player is still waiting. Return false if removals is NULL.
+ * A player with this id can't be added before the removal is applied.
+ * */
+bool removalsHasPlayer(Removals removals, int player_id);
+
+/**
+ * Apply the waiting removals to the games of one tournament. Does nothing if removals is NULL.
+ * */
+void removalsApplyToTournament(Removals removals, Map players, Map tournaments, int tournament_id);
+
+/**
+ * Apply the waiting removals in order, until about max_games games were searched.
+ * Return the number of removals still waiting (0 if removals is NULL).
+ * */
+int removalsApply(Removals removals, Map players, Map tournaments, int max_games);
+
+/**
+ * Apply every waiting removal, before the statistics of the players are read.
+ * Does nothing if removals is NULL.
+ * */
+void removalsApplyAll(Removals removals, Map players, Map tournaments);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,273 @@
+#define _POSIX_C_SOURCE 200809L // clock_gettime
+
+/**
+ * chess_replay: replays a trace written by chessTraceOpen against a fresh system (or against its
+ * snapshot), and reports the latency of every kind of call, as recorded and as replayed,
+ * and every call whose result differs from the recorded one.
+ * The saves are written to /dev/null, so their replayed latency doesn't include the disk.
+ *
+ * usage: chess_replay trace [max divergences to print, 10 by default]
+ * Exits with 0 if every result matched, 1 if some differed, 2 if the trace could not be replayed.
+ * */
+
+#include "chessSystemExt.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// ------------------ DEFINES ---------------- //
+
+#define NUM_OF_CALLS (CHESS_TRACE_SAVE_TOURNAMENT_STATISTICS + 1)
+#define DEFAULT_MAX_PRINTED 10
+#define INITIAL_CAPACITY 64
+#define SNAPSHOT_SUFFIX ".snap"
+#define DISCARD "/dev/null"
+#define NANOSECONDS_PER_SECOND 1000000000LL
+#define NANOSECONDS_PER_MICROSECOND 1000.0
+#define STDOUT_STREAM 1 // see CHESS_TRACE_SAVE_PLAYERS_LEVELS
+#define STDERR_STREAM 2
+#define NULL_STREAM -1
+
+typedef struct latencies_t {
+    long long* values;
+    int size;
+    int capacity;
+} Latencies;
+
+typedef struct call_statistics_t {
+    Latencies recorded;
+    Latencies replayed;
+    int divergences;
+} CallStatistics;
+
+static const char* CALL_NAMES[NUM_OF_CALLS] = {
+    [CHESS_TRACE_ADD_TOURNAMENT] = "chessAddTournament",
+    [CHESS_TRACE_ADD_GAME] = "chessAddGame",
+    [CHESS_TRACE_REMOVE_TOURNAMENT] = "chessRemoveTournament",
+    [CHESS_TRACE_REMOVE_PLAYER] = "chessRemovePlayer",
+    [CHESS_TRACE_END_TOURNAMENT] = "chessEndTournament",
+    [CHESS_TRACE_CALCULATE_AVERAGE_PLAY_TIME] = "chessCalculateAveragePlayTime",
+    [CHESS_TRACE_SAVE_PLAYERS_LEVELS] = "chessSavePlayersLevels",
+    [CHESS_TRACE_SAVE_TOURNAMENT_STATISTICS] = "chessSaveTournamentStatistics"
+};
+
+// ------------------ FUNCTIONS DECLARATIONS ---------------- //
+
+static ChessSystem createSystem(const char* trace_path, ChessTraceReader reader);
+static ChessResult replayCall(ChessSystem chess, const ChessTraceRecord* record, FILE* discard, double* average);
+static long long now(void);
+static bool addLatency(Latencies* latencies, long long latency);
+static int compareLatencies(const void* latency1, const void* latency2);
+static void printPercentiles(Latencies* latencies);
+static void printDivergence(long index, const ChessTraceRecord* record, ChessResult result, double average);
+
+// ------------------ FUNCTIONS IMPLEMENTATION ---------------- //
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s trace [max divergences to print]\n", argv[0]);
+        return 2;
+    }
+    long max_printed = argc > 2 ? atol(argv[2]) : DEFAULT_MAX_PRINTED;
+    ChessResult result;
+    ChessTraceReader reader = chessTraceReaderOpen(argv[1], &result);
+    if (reader == NULL)
+    {
+        fprintf(stderr, "%s: can't read the trace (%d)\n", argv[1], result);
+        return 2;
+    }
+    ChessSystem chess = createSystem(argv[1], reader);
+    FILE* discard = fopen(DISCARD, "w");
+    CallStatistics* statistics = (CallStatistics*)calloc(NUM_OF_CALLS, sizeof(CallStatistics));
+    if (chess == NULL || discard == NULL || statistics == NULL)
+    {
+        fprintf(stderr, "%s: can't create the system to replay on\n", argv[1]);
+        free(statistics);
+        if (discard != NULL)
+        {
+            fclose(discard);
+        }
+        chessDestroy(chess);
+        chessTraceReaderClose(reader);
+        return 2;
+    }
+
+    long num_of_calls = 0;
+    long num_of_divergences = 0;
+    ChessTraceRecord record;
+    while (chessTraceReaderNext(reader, &record))
+    {
+        double average = 0.0;
+        long long start = now();
+        result = replayCall(chess, &record, discard, &average);
+        long long latency = now() - start;
+
+        CallStatistics* call = &statistics[record.call];
+        if (!addLatency(&call->recorded, record.latency) || !addLatency(&call->replayed, latency))
+        {
+            fprintf(stderr, "out of memory\n");
+            return 2;
+        }
+        if (result != record.result || average != record.average_play_time)
+        {
+            call->divergences++;
+            if (num_of_divergences++ < max_printed)
+            {
+                printDivergence(num_of_calls, &record, result, average);
+            }
+        }
+        num_of_calls++;
+    }
+
+    printf("%ld calls, %ld divergences\n", num_of_calls, num_of_divergences);
+    printf("%-30s %9s %11s | %-35s | %-35s\n", "", "calls", "divergences",
+           "recorded p50 p90 p99 max (us)", "replayed p50 p90 p99 max (us)");
+    for (int i = CHESS_TRACE_ADD_TOURNAMENT; i < NUM_OF_CALLS; i++)
+    {
+        CallStatistics* call = &statistics[i];
+        if (call->recorded.size == 0)
+        {
+            continue;
+        }
+        printf("%-30s %9d %11d |", CALL_NAMES[i], call->recorded.size, call->divergences);
+        printPercentiles(&call->recorded);
+        printf(" |");
+        printPercentiles(&call->replayed);
+        printf("\n");
+        free(call->recorded.values);
+        free(call->replayed.values);
+    }
+
+    free(statistics);
+    fclose(discard);
+    chessDestroy(chess);
+    chessTraceReaderClose(reader);
+    return num_of_divergences > 0 ? 1 : 0;
+}
+
+/**
+ * Create the system the trace starts from.
+ * */
+static ChessSystem createSystem(const char* trace_path, ChessTraceReader reader)
+{
+    if (!chessTraceReaderHasSnapshot(reader))
+    {
+        return chessCreate();
+    }
+    char* name = (char*)malloc(strlen(trace_path) + strlen(SNAPSHOT_SUFFIX) + 1);
+    if (name == NULL)
+    {
+        return NULL;
+    }
+    strcpy(name, trace_path);
+    strcat(name, SNAPSHOT_SUFFIX);
+    ChessResult result;
+    ChessSystem chess = chessLoadSnapshot(name, &result);
+    free(name);
+    return chess;
+}
+
+static ChessResult replayCall(ChessSystem chess, const ChessTraceRecord* record, FILE* discard, double* average)
+{
+    const int* args = record->args;
+    ChessResult result = CHESS_SUCCESS;
+    switch (record->call)
+    {
+    case CHESS_TRACE_ADD_TOURNAMENT:
+        return chessAddTournament(chess, args[0], args[1], record->text);
+    case CHESS_TRACE_ADD_GAME:
+        return chessAddGame(chess, args[0], args[1], args[2], (Winner)args[3], args[4]);
+    case CHESS_TRACE_REMOVE_TOURNAMENT:
+        return chessRemoveTournament(chess, args[0]);
+    case CHESS_TRACE_REMOVE_PLAYER:
+        return chessRemovePlayer(chess, args[0]);
+    case CHESS_TRACE_END_TOURNAMENT:
+        return chessEndTournament(chess, args[0]);
+    case CHESS_TRACE_CALCULATE_AVERAGE_PLAY_TIME:
+        *average = chessCalculateAveragePlayTime(chess, args[0], &result);
+        return result;
+    case CHESS_TRACE_SAVE_PLAYERS_LEVELS:
+        return chessSavePlayersLevels(chess, args[0] == NULL_STREAM ? NULL : discard);
+    case CHESS_TRACE_SAVE_TOURNAMENT_STATISTICS:
+        return chessSaveTournamentStatistics(chess, record->text == NULL ? NULL : DISCARD);
+    }
+    return result;
+}
+
+static long long now(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec * NANOSECONDS_PER_SECOND + time.tv_nsec;
+}
+
+static bool addLatency(Latencies* latencies, long long latency)
+{
+    if (latencies->size == latencies->capacity)
+    {
+        int capacity = latencies->capacity == 0 ? INITIAL_CAPACITY : 2 * latencies->capacity;
+        long long* values = (long long*)realloc(latencies->values, sizeof(long long) * capacity);
+        if (values == NULL)
+        {
+            return false;
+        }
+        latencies->values = values;
+        latencies->capacity = capacity;
+    }
+    latencies->values[latencies->size++] = latency;
+    return true;
+}
+
+static int compareLatencies(const void* latency1, const void* latency2)
+{
+    long long difference = *(const long long*)latency1 - *(const long long*)latency2;
+    return difference < 0 ? -1 : difference > 0;
+}
+
+static void printPercentiles(Latencies* latencies)
+{
+    static const int PERCENTILES[] = { 50, 90, 99, 100 };
+    qsort(latencies->values, latencies->size, sizeof(long long), compareLatencies);
+    for (int i = 0; i < (int)(sizeof(PERCENTILES) / sizeof(*PERCENTILES)); i++)
+    {
+        int index = (int)((long long)(latencies->size - 1) * PERCENTILES[i] / 100);
+        printf(" %8.1f", latencies->values[index] / NANOSECONDS_PER_MICROSECOND);
+    }
+}
+
+static void printDivergence(long index, const ChessTraceRecord* record, ChessResult result, double average)
+{
+    printf("call %ld %s(", index, CALL_NAMES[record->call]);
+    if (record->call == CHESS_TRACE_SAVE_PLAYERS_LEVELS)
+    {
+        printf("%s", record->args[0] == NULL_STREAM     ? "NULL"
+                     : record->args[0] == STDOUT_STREAM ? "stdout"
+                     : record->args[0] == STDERR_STREAM ? "stderr"
+                                                        : "file");
+    }
+    else
+    {
+        int num_of_args = record->call == CHESS_TRACE_ADD_GAME ? 5
+                          : record->call == CHESS_TRACE_ADD_TOURNAMENT ? 2
+                          : record->call == CHESS_TRACE_SAVE_TOURNAMENT_STATISTICS ? 0 : 1;
+        for (int i = 0; i < num_of_args; i++)
+        {
+            printf(i == 0 ? "%d" : ", %d", record->args[i]);
+        }
+    }
+    if (record->text != NULL)
+    {
+        printf("%s\"%s\"", record->call == CHESS_TRACE_ADD_TOURNAMENT ? ", " : "", record->text);
+    }
+    printf("): recorded %d", record->result);
+    if (record->call == CHESS_TRACE_CALCULATE_AVERAGE_PLAY_TIME)
+    {
+        printf(" (%f), replayed %d (%f)\n", record->average_play_time, result, average);
+        return;
+    }
+    printf(", replayed %d\n", result);
+}
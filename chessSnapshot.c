@@ -0,0 +1,780 @@
+#define _POSIX_C_SOURCE 200809L // mmap, posix_madvise
+
+#include "chessSystemExt.h"
+#include "chessSystemPrivate.h"
+#include "chessTournament.h"
+#include "chessPlayer.h"
+#include "chessGame.h"
+#include "mapExt.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/*
+ * Layout of a snapshot file. Every number is a 4 bytes little endian int,
+ * except for the 8 bytes fields of the header and the doubles.
+ *
+ * header:      "CHSS", version, byte order marker, body size (8), body checksum (8),
+ *              number of locations, tournaments, players and former players, number of games.
+ * locations:   by id: length, the characters, padding up to 4 bytes.
+ * tournaments: from the highest id down: TournamentSummary, frozen flag, size of the games,
+ *              the raw games (see gameListDump), padding up to 4 bytes.
+ * players:     from the highest id down: PlayerSummary, number of tournaments,
+ *              then a PlayerTournament for each of them.
+ * former:      the ids of the former players.
+ *
+ * Records are stored from the highest id down, so each of them is put at the head of the maps
+ * of the new system (see mapPutFirst), without searching them: loading is linear in the records.
+ */
+
+// ------------------ DEFINES ---------------- //
+
+#define SNAPSHOT_MAGIC "CHSS"
+#define SNAPSHOT_VERSION 1
+#define BYTE_ORDER_MARKER 0x01020304u
+#define HEADER_SIZE 48
+#define WORD_SIZE 4
+#define BUFFER_SIZE (1 << 16)
+#define FNV_OFFSET_BASIS 14695981039346656037ULL
+#define FNV_PRIME 1099511628211ULL
+#define TEMP_SUFFIX ".tmp"
+
+typedef struct chess_snapshot_writer_t {
+    FILE* file;
+    unsigned char buffer[BUFFER_SIZE];
+    size_t used;
+    unsigned long long size;     // bytes written so far, the buffer included
+    unsigned long long checksum; // of every byte written so far
+    bool failed;
+} *Writer;
+
+typedef struct chess_snapshot_reader_t {
+    const unsigned char* position;
+    const unsigned char* end;
+    bool failed; // set once a read goes past the end
+} Reader;
+
+typedef struct chess_snapshot_header_t {
+    unsigned long long body_size;
+    unsigned long long checksum;
+    int num_of_locations;
+    int num_of_tournaments;
+    int num_of_players;
+    int num_of_former_players;
+    int num_of_games;
+} Header;
+
+/**
+ * The tournaments or the players of a snapshot, read by one of the threads of the pool.
+ * */
+typedef struct chess_snapshot_section_t {
+    ChessSystem chess;
+    Reader reader;
+    int size;
+    ChessResult result;
+} Section;
+
+// ------------------ FUNCTIONS DECLARATIONS ---------------- //
+
+static void writeBody(ChessSystem chess, Writer writer, Header* header);
+static bool writeTournaments(ChessSystem chess, Writer writer, int* num_of_tournaments);
+static bool writePlayers(ChessSystem chess, Writer writer, int* num_of_players);
+static void writeBytes(Writer writer, const void* data, size_t size);
+static void writeInt(Writer writer, int value);
+static void writeDouble(Writer writer, double value);
+static void writePadding(Writer writer, size_t size);
+static void flushWriter(Writer writer);
+static void encodeHeader(const Header* header, unsigned char bytes[HEADER_SIZE]);
+static void putWord(unsigned char* bytes, unsigned long value);
+
+static ChessResult readBody(ChessSystem chess, Reader* reader, const Header* header);
+static ChessResult readTournaments(ChessSystem chess, Reader* reader, int num_of_tournaments);
+static ChessResult readPlayers(ChessSystem chess, Reader* reader, int num_of_players);
+static void readTournamentsSection(void* section);
+static void readPlayersSection(void* section);
+static bool readTournament(Reader* reader, TournamentSummary* summary, int* frozen,
+                           const unsigned char** games, int* games_size);
+static int readPlayer(Reader* reader, PlayerSummary* summary);
+static void skipTournaments(Reader* reader, int num_of_tournaments);
+static void skipPlayers(Reader* reader, int num_of_players);
+static bool decodeHeader(const unsigned char* bytes, size_t size, Header* header);
+static unsigned long getWord(const unsigned char* bytes);
+static const unsigned char* readBytes(Reader* reader, size_t size);
+static int readInt(Reader* reader);
+static double readDouble(Reader* reader);
+static void skipPadding(Reader* reader, size_t size);
+
+static unsigned long long updateChecksum(unsigned long long checksum, const unsigned char* data, size_t size);
+static size_t paddingOf(size_t size);
+
+// ------------------ FUNCTIONS IMPLEMENTATION ---------------- //
+
+ChessResult chessSaveSnapshot(ChessSystem chess, const char* path)
+{
+    if (chess == NULL || path == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    removalsApplyAll(chess->removals, chess->players, chess->tournaments);
+    char* temp_path = (char*)malloc(strlen(path) + strlen(TEMP_SUFFIX) + 1);
+    Writer writer = (Writer)malloc(sizeof(*writer));
+    if (temp_path == NULL || writer == NULL)
+    {
+        free(temp_path);
+        free(writer);
+        return CHESS_OUT_OF_MEMORY;
+    }
+    strcpy(temp_path, path);
+    strcat(temp_path, TEMP_SUFFIX);
+
+    ChessResult result = CHESS_SAVE_FAILURE;
+    writer->file = fopen(temp_path, "wb");
+    if (writer->file != NULL)
+    {
+        // the header depends on the body, so it is written last over a placeholder
+        unsigned char header_bytes[HEADER_SIZE] = { 0 };
+        Header header = { 0 };
+        writer->used = 0;
+        writer->size = 0;
+        writer->checksum = FNV_OFFSET_BASIS;
+        writer->failed = (fwrite(header_bytes, 1, HEADER_SIZE, writer->file) != HEADER_SIZE);
+        writeBody(chess, writer, &header);
+        flushWriter(writer);
+
+        if (writer->file == NULL) // writeBody ran out of memory
+        {
+            result = CHESS_OUT_OF_MEMORY;
+        }
+        else
+        {
+            header.body_size = writer->size;
+            header.checksum = writer->checksum;
+            encodeHeader(&header, header_bytes);
+            bool failed = writer->failed || fseek(writer->file, 0, SEEK_SET) != 0
+                          || fwrite(header_bytes, 1, HEADER_SIZE, writer->file) != HEADER_SIZE;
+            failed = (fclose(writer->file) != 0) || failed;
+            if (!failed && rename(temp_path, path) == 0)
+            {
+                result = CHESS_SUCCESS;
+            }
+        }
+        if (result != CHESS_SUCCESS)
+        {
+            remove(temp_path);
+        }
+    }
+    free(writer);
+    free(temp_path);
+    return result;
+}
+
+ChessSystem chessLoadSnapshot(const char* path, ChessResult* result)
+{
+    return chessLoadSnapshotWithOptions(path, NULL, result);
+}
+
+ChessSystem chessLoadSnapshotWithOptions(const char* path, const ChessSystemOptions* options, ChessResult* result)
+{
+    if (path == NULL)
+    {
+        *result = CHESS_NULL_ARGUMENT;
+        return NULL;
+    }
+    *result = CHESS_SAVE_FAILURE;
+    int file = open(path, O_RDONLY);
+    if (file < 0)
+    {
+        return NULL;
+    }
+    struct stat file_stat;
+    if (fstat(file, &file_stat) != 0 || file_stat.st_size < HEADER_SIZE)
+    {
+        close(file);
+        return NULL;
+    }
+    size_t size = (size_t)file_stat.st_size;
+    void* data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file); // the mapping keeps the file alive
+    if (data == MAP_FAILED)
+    {
+        return NULL;
+    }
+    posix_madvise(data, size, POSIX_MADV_SEQUENTIAL);
+
+    const unsigned char* bytes = (const unsigned char*)data;
+    Header header;
+    ChessSystem chess = NULL;
+    if (decodeHeader(bytes, size, &header)
+        && updateChecksum(FNV_OFFSET_BASIS, bytes + HEADER_SIZE, size - HEADER_SIZE) == header.checksum)
+    {
+        chess = chessCreateWithOptions(options);
+        if (chess == NULL)
+        {
+            *result = CHESS_OUT_OF_MEMORY;
+        }
+        else
+        {
+            Reader reader = { bytes + HEADER_SIZE, bytes + size, false };
+            *result = readBody(chess, &reader, &header);
+            if (*result == CHESS_SUCCESS && (reader.failed || reader.position != reader.end))
+            {
+                *result = CHESS_SAVE_FAILURE;
+            }
+            if (*result != CHESS_SUCCESS)
+            {
+                chessDestroy(chess);
+                chess = NULL;
+            }
+        }
+    }
+    munmap(data, size);
+    return chess;
+}
+
+// ------------------ WRITING ---------------- //
+
+/**
+ * Write every section of the body, and fill the counts of the header.
+ * If malloc fails, close the file and set writer->file to NULL.
+ * */
+static void writeBody(ChessSystem chess, Writer writer, Header* header)
+{
+    header->num_of_locations = locationPoolGetSize(chess->locations);
+    for (int i = 0; i < header->num_of_locations; i++)
+    {
+        const char* location = locationGet(chess->locations, i);
+        size_t length = strlen(location);
+        writeInt(writer, (int)length);
+        writeBytes(writer, location, length);
+        writePadding(writer, length);
+    }
+
+    if (!writeTournaments(chess, writer, &header->num_of_tournaments)
+        || !writePlayers(chess, writer, &header->num_of_players))
+    {
+        fclose(writer->file);
+        writer->file = NULL;
+        return;
+    }
+
+    header->num_of_former_players = 0;
+    for (int id = bitmapGetNext(chess->former_players, 0); id >= 0; id = bitmapGetNext(chess->former_players, id + 1))
+    {
+        writeInt(writer, id);
+        header->num_of_former_players++;
+    }
+    header->num_of_games = chess->num_of_games;
+}
+
+/**
+ * Write the tournaments section. Return false if malloc failed.
+ * */
+static bool writeTournaments(ChessSystem chess, Writer writer, int* num_of_tournaments)
+{
+    int size = mapGetSize(chess->tournaments);
+    Tournament* tournaments = (Tournament*)malloc(sizeof(Tournament) * (size > 0 ? size : 1));
+    if (tournaments == NULL)
+    {
+        return false;
+    }
+    int count = 0;
+    MAP_FOREACH_AFTER(int*, tournament_id, chess->tournaments, NULL)
+    {
+        tournaments[count++] = mapGetCurrentData(chess->tournaments);
+    }
+
+    void* games = NULL;
+    int games_capacity = 0;
+    bool result = true;
+    for (int i = count - 1; i >= 0 && result; i--)
+    {
+        TournamentSummary summary;
+        tournamentGetSummary(tournaments[i], &summary);
+        GameList list = tournamentGetGames(tournaments[i]);
+        int games_size = gameListGetDumpSize(list);
+        if (games_size > games_capacity)
+        {
+            void* new_games = realloc(games, games_size);
+            if (new_games == NULL)
+            {
+                result = false;
+                break;
+            }
+            games = new_games;
+            games_capacity = games_size;
+        }
+        gameListDump(list, games);
+
+        writeInt(writer, summary.id);
+        writeInt(writer, summary.winners_id);
+        writeInt(writer, summary.max_games_per_player);
+        writeInt(writer, summary.location_id);
+        writeInt(writer, summary.num_of_players);
+        writeInt(writer, summary.longest_game_time);
+        writeDouble(writer, summary.average_game_time);
+        writeInt(writer, summary.num_of_games);
+        writeInt(writer, gameListIsFrozen(list));
+        writeInt(writer, games_size);
+        writeBytes(writer, games, games_size);
+        writePadding(writer, games_size);
+    }
+    free(games);
+    free(tournaments);
+    *num_of_tournaments = count;
+    return result;
+}
+
+/**
+ * Write the players section. Return false if malloc failed.
+ * */
+static bool writePlayers(ChessSystem chess, Writer writer, int* num_of_players)
+{
+    int size = mapGetSize(chess->players);
+    Player* players = (Player*)malloc(sizeof(Player) * (size > 0 ? size : 1));
+    if (players == NULL)
+    {
+        return false;
+    }
+    int count = 0;
+    MAP_FOREACH_AFTER(int*, player_id, chess->players, NULL)
+    {
+        players[count++] = mapGetCurrentData(chess->players);
+    }
+
+    PlayerTournament* tournaments = NULL;
+    int tournaments_capacity = 0;
+    bool result = true;
+    for (int i = count - 1; i >= 0; i--)
+    {
+        int num_of_tournaments = playerGetNumOfTournaments(players[i]);
+        if (num_of_tournaments > tournaments_capacity)
+        {
+            PlayerTournament* new_tournaments = (PlayerTournament*)realloc(tournaments,
+                                                    sizeof(PlayerTournament) * num_of_tournaments);
+            if (new_tournaments == NULL)
+            {
+                result = false;
+                break;
+            }
+            tournaments = new_tournaments;
+            tournaments_capacity = num_of_tournaments;
+        }
+        PlayerSummary summary;
+        playerGetSummary(players[i], &summary);
+        playerGetTournaments(players[i], tournaments);
+
+        writeInt(writer, summary.id);
+        writeInt(writer, summary.num_of_wins);
+        writeInt(writer, summary.num_of_loses);
+        writeInt(writer, summary.num_of_draws);
+        writeInt(writer, (int)summary.total_time);
+        writeInt(writer, num_of_tournaments);
+        for (int j = 0; j < num_of_tournaments; j++)
+        {
+            writeInt(writer, tournaments[j].tournament_id);
+            writeInt(writer, tournaments[j].score);
+            writeInt(writer, tournaments[j].num_of_games);
+        }
+    }
+    free(tournaments);
+    free(players);
+    *num_of_players = count;
+    return result;
+}
+
+static void writeBytes(Writer writer, const void* data, size_t size)
+{
+    const unsigned char* bytes = (const unsigned char*)data;
+    while (size > 0)
+    {
+        if (writer->used == BUFFER_SIZE)
+        {
+            flushWriter(writer);
+        }
+        size_t chunk = BUFFER_SIZE - writer->used;
+        if (chunk > size)
+        {
+            chunk = size;
+        }
+        memcpy(writer->buffer + writer->used, bytes, chunk);
+        writer->used += chunk;
+        bytes += chunk;
+        size -= chunk;
+    }
+}
+
+static void writeInt(Writer writer, int value)
+{
+    unsigned char bytes[WORD_SIZE];
+    putWord(bytes, (unsigned long)(unsigned int)value);
+    writeBytes(writer, bytes, WORD_SIZE);
+}
+
+static void writeDouble(Writer writer, double value)
+{
+    unsigned long long bits;
+    memcpy(&bits, &value, sizeof(bits));
+    writeInt(writer, (int)(unsigned int)(bits & 0xFFFFFFFFu));
+    writeInt(writer, (int)(unsigned int)(bits >> 32));
+}
+
+/**
+ * Write the padding that follows a field of size bytes.
+ * */
+static void writePadding(Writer writer, size_t size)
+{
+    static const unsigned char zeros[WORD_SIZE] = { 0 };
+    writeBytes(writer, zeros, paddingOf(size));
+}
+
+static void flushWriter(Writer writer)
+{
+    if (writer->used == 0)
+    {
+        return;
+    }
+    writer->checksum = updateChecksum(writer->checksum, writer->buffer, writer->used);
+    writer->size += writer->used;
+    if (writer->file != NULL && fwrite(writer->buffer, 1, writer->used, writer->file) != writer->used)
+    {
+        writer->failed = true;
+    }
+    writer->used = 0;
+}
+
+static void encodeHeader(const Header* header, unsigned char bytes[HEADER_SIZE])
+{
+    memcpy(bytes, SNAPSHOT_MAGIC, WORD_SIZE);
+    putWord(bytes + 4, SNAPSHOT_VERSION);
+    putWord(bytes + 8, BYTE_ORDER_MARKER);
+    putWord(bytes + 12, (unsigned long)(header->body_size & 0xFFFFFFFFu));
+    putWord(bytes + 16, (unsigned long)(header->body_size >> 32));
+    putWord(bytes + 20, (unsigned long)(header->checksum & 0xFFFFFFFFu));
+    putWord(bytes + 24, (unsigned long)(header->checksum >> 32));
+    putWord(bytes + 28, (unsigned long)header->num_of_locations);
+    putWord(bytes + 32, (unsigned long)header->num_of_tournaments);
+    putWord(bytes + 36, (unsigned long)header->num_of_players);
+    putWord(bytes + 40, (unsigned long)header->num_of_former_players);
+    putWord(bytes + 44, (unsigned long)header->num_of_games);
+}
+
+static void putWord(unsigned char* bytes, unsigned long value)
+{
+    bytes[0] = (unsigned char)value;
+    bytes[1] = (unsigned char)(value >> 8);
+    bytes[2] = (unsigned char)(value >> 16);
+    bytes[3] = (unsigned char)(value >> 24);
+}
+
+// ------------------ READING ---------------- //
+
+static ChessResult readBody(ChessSystem chess, Reader* reader, const Header* header)
+{
+    for (int i = 0; i < header->num_of_locations; i++)
+    {
+        int length = readInt(reader);
+        const unsigned char* bytes = readBytes(reader, length < 0 ? 0 : (size_t)length);
+        if (reader->failed || length <= 0)
+        {
+            return CHESS_SAVE_FAILURE;
+        }
+        char* location = (char*)malloc(length + 1);
+        if (location == NULL)
+        {
+            return CHESS_OUT_OF_MEMORY;
+        }
+        memcpy(location, bytes, length);
+        location[length] = '\0';
+        int location_id = locationIntern(chess->locations, location);
+        free(location);
+        if (location_id == LOCATION_OUT_OF_MEMORY)
+        {
+            return CHESS_OUT_OF_MEMORY;
+        }
+        if (location_id != i) // invalid or repeated
+        {
+            return CHESS_SAVE_FAILURE;
+        }
+        skipPadding(reader, length);
+    }
+
+    // the tournaments and the players go to maps of their own, so they are read at once
+    Section tournaments = { chess, *reader, header->num_of_tournaments, CHESS_SUCCESS };
+    skipTournaments(reader, header->num_of_tournaments);
+    Section players = { chess, *reader, header->num_of_players, CHESS_SUCCESS };
+    skipPlayers(reader, header->num_of_players);
+    if (reader->failed)
+    {
+        return CHESS_SAVE_FAILURE;
+    }
+    PoolGroup group;
+    poolGroupInit(&group, chess->pool);
+    poolSpawn(&group, readTournamentsSection, &tournaments);
+    readPlayersSection(&players);
+    poolWait(&group);
+    if (tournaments.result != CHESS_SUCCESS)
+    {
+        return tournaments.result;
+    }
+    if (players.result != CHESS_SUCCESS)
+    {
+        return players.result;
+    }
+
+    for (int i = 0; i < header->num_of_former_players; i++)
+    {
+        int id = readInt(reader);
+        if (reader->failed || id <= 0)
+        {
+            return CHESS_SAVE_FAILURE;
+        }
+        if (!bitmapSet(chess->former_players, id))
+        {
+            return CHESS_OUT_OF_MEMORY;
+        }
+    }
+    chess->num_of_games = header->num_of_games;
+    return CHESS_SUCCESS;
+}
+
+static ChessResult readTournaments(ChessSystem chess, Reader* reader, int num_of_tournaments)
+{
+    int num_of_locations = locationPoolGetSize(chess->locations);
+    for (int i = 0; i < num_of_tournaments; i++)
+    {
+        TournamentSummary summary;
+        int frozen;
+        const unsigned char* games;
+        int games_size;
+        if (!readTournament(reader, &summary, &frozen, &games, &games_size)
+            || summary.location_id < 0 || summary.location_id >= num_of_locations)
+        {
+            return CHESS_SAVE_FAILURE;
+        }
+        // the checksum already ruled out damaged games, so a failure here is malloc's
+        if (!tournamentRestoreToMap(chess->tournaments, &summary, locationGet(chess->locations, summary.location_id),
+                                    games, games_size, frozen != 0))
+        {
+            return CHESS_OUT_OF_MEMORY;
+        }
+    }
+    return CHESS_SUCCESS;
+}
+
+static ChessResult readPlayers(ChessSystem chess, Reader* reader, int num_of_players)
+{
+    PlayerTournament* tournaments = NULL;
+    int tournaments_capacity = 0;
+    ChessResult result = CHESS_SUCCESS;
+    for (int i = 0; i < num_of_players && result == CHESS_SUCCESS; i++)
+    {
+        PlayerSummary summary;
+        int num_of_tournaments = readPlayer(reader, &summary);
+        if (num_of_tournaments < 0)
+        {
+            result = CHESS_SAVE_FAILURE;
+            break;
+        }
+        if (num_of_tournaments > tournaments_capacity)
+        {
+            PlayerTournament* new_tournaments = (PlayerTournament*)realloc(tournaments,
+                                                    sizeof(PlayerTournament) * num_of_tournaments);
+            if (new_tournaments == NULL)
+            {
+                result = CHESS_OUT_OF_MEMORY;
+                break;
+            }
+            tournaments = new_tournaments;
+            tournaments_capacity = num_of_tournaments;
+        }
+        for (int j = 0; j < num_of_tournaments; j++)
+        {
+            tournaments[j].tournament_id = readInt(reader);
+            tournaments[j].score = readInt(reader);
+            tournaments[j].num_of_games = readInt(reader);
+        }
+        if (!playerRestoreToMap(chess->players, &summary, tournaments, num_of_tournaments))
+        {
+            result = CHESS_OUT_OF_MEMORY;
+        }
+    }
+    free(tournaments);
+    return result;
+}
+
+static void readTournamentsSection(void* section)
+{
+    Section* tournaments = (Section*)section;
+    tournaments->result = readTournaments(tournaments->chess, &tournaments->reader, tournaments->size);
+}
+
+static void readPlayersSection(void* section)
+{
+    Section* players = (Section*)section;
+    players->result = readPlayers(players->chess, &players->reader, players->size);
+}
+
+/**
+ * Read a tournament record, whose games are left in the snapshot. Return false if it is damaged.
+ * */
+static bool readTournament(Reader* reader, TournamentSummary* summary, int* frozen,
+                           const unsigned char** games, int* games_size)
+{
+    summary->id = readInt(reader);
+    summary->winners_id = readInt(reader);
+    summary->max_games_per_player = readInt(reader);
+    summary->location_id = readInt(reader);
+    summary->num_of_players = readInt(reader);
+    summary->longest_game_time = readInt(reader);
+    summary->average_game_time = readDouble(reader);
+    summary->num_of_games = readInt(reader);
+    *frozen = readInt(reader);
+    *games_size = readInt(reader);
+    *games = readBytes(reader, *games_size < 0 ? 0 : (size_t)*games_size);
+    skipPadding(reader, *games_size < 0 ? 0 : (size_t)*games_size);
+    return !reader->failed && *games_size >= 0;
+}
+
+/**
+ * Read the fixed part of a player record, and return the number of tournaments that follow it,
+ * or -1 if it is damaged.
+ * */
+static int readPlayer(Reader* reader, PlayerSummary* summary)
+{
+    summary->id = readInt(reader);
+    summary->num_of_wins = readInt(reader);
+    summary->num_of_loses = readInt(reader);
+    summary->num_of_draws = readInt(reader);
+    summary->total_time = (unsigned int)readInt(reader);
+    int num_of_tournaments = readInt(reader);
+    // each tournament takes 3 words, which also bounds a damaged count
+    if (reader->failed || num_of_tournaments < 0
+        || (size_t)num_of_tournaments > (size_t)(reader->end - reader->position) / (3 * WORD_SIZE))
+    {
+        return -1;
+    }
+    return num_of_tournaments;
+}
+
+static void skipTournaments(Reader* reader, int num_of_tournaments)
+{
+    for (int i = 0; i < num_of_tournaments && !reader->failed; i++)
+    {
+        TournamentSummary summary;
+        int frozen;
+        const unsigned char* games;
+        int games_size;
+        if (!readTournament(reader, &summary, &frozen, &games, &games_size))
+        {
+            reader->failed = true;
+        }
+    }
+}
+
+static void skipPlayers(Reader* reader, int num_of_players)
+{
+    for (int i = 0; i < num_of_players && !reader->failed; i++)
+    {
+        PlayerSummary summary;
+        int num_of_tournaments = readPlayer(reader, &summary);
+        if (num_of_tournaments < 0)
+        {
+            reader->failed = true;
+            return;
+        }
+        readBytes(reader, (size_t)num_of_tournaments * 3 * WORD_SIZE);
+    }
+}
+
+/**
+ * Check the header of a snapshot of size bytes, and decode its fields.
+ * Return false if it is not a snapshot this version can read.
+ * */
+static bool decodeHeader(const unsigned char* bytes, size_t size, Header* header)
+{
+    if (memcmp(bytes, SNAPSHOT_MAGIC, WORD_SIZE) != 0 || getWord(bytes + 4) != SNAPSHOT_VERSION
+        || getWord(bytes + 8) != BYTE_ORDER_MARKER)
+    {
+        return false;
+    }
+    header->body_size = (unsigned long long)getWord(bytes + 16) << 32 | getWord(bytes + 12);
+    header->checksum = (unsigned long long)getWord(bytes + 24) << 32 | getWord(bytes + 20);
+    header->num_of_locations = (int)getWord(bytes + 28);
+    header->num_of_tournaments = (int)getWord(bytes + 32);
+    header->num_of_players = (int)getWord(bytes + 36);
+    header->num_of_former_players = (int)getWord(bytes + 40);
+    header->num_of_games = (int)getWord(bytes + 44);
+    return header->body_size == size - HEADER_SIZE && header->num_of_locations >= 0
+           && header->num_of_tournaments >= 0 && header->num_of_players >= 0
+           && header->num_of_former_players >= 0 && header->num_of_games >= 0;
+}
+
+static unsigned long getWord(const unsigned char* bytes)
+{
+    return (unsigned long)bytes[0] | (unsigned long)bytes[1] << 8
+           | (unsigned long)bytes[2] << 16 | (unsigned long)bytes[3] << 24;
+}
+
+/**
+ * Return a pointer to the next size bytes, or NULL (and set reader->failed) if there aren't enough.
+ * */
+static const unsigned char* readBytes(Reader* reader, size_t size)
+{
+    if (reader->failed || (size_t)(reader->end - reader->position) < size)
+    {
+        reader->failed = true;
+        return NULL;
+    }
+    const unsigned char* bytes = reader->position;
+    reader->position += size;
+    return bytes;
+}
+
+static int readInt(Reader* reader)
+{
+    const unsigned char* bytes = readBytes(reader, WORD_SIZE);
+    return bytes == NULL ? 0 : (int)(unsigned int)getWord(bytes);
+}
+
+static double readDouble(Reader* reader)
+{
+    unsigned long long low = (unsigned int)readInt(reader);
+    unsigned long long high = (unsigned int)readInt(reader);
+    unsigned long long bits = high << 32 | low;
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static void skipPadding(Reader* reader, size_t size)
+{
+    readBytes(reader, paddingOf(size));
+}
+
+// ------------------ HELPERS ---------------- //
+
+/**
+ * FNV-1a 64 bit hash, continued from checksum.
+ * */
+static unsigned long long updateChecksum(unsigned long long checksum, const unsigned char* data, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        checksum ^= data[i];
+        checksum *= FNV_PRIME;
+    }
+    return checksum;
+}
+
+/**
+ * Return the number of bytes needed after size bytes to get back to a multiple of 4.
+ * */
+static size_t paddingOf(size_t size)
+{
+    return (WORD_SIZE - size % WORD_SIZE) % WORD_SIZE;
+}
@@ -1,53 +1,125 @@
+#define _POSIX_C_SOURCE 200809L // access
+
 #include "chessSystem.h"
+#include "chessSystemExt.h"
+#include "chessSystemPrivate.h"
 
 #include "chessTournament.h"
 #include "chessPlayer.h"
 #include "chessGame.h"
+#include "chessLocation.h"
+#include "chessBitmap.h"
+#include "chessJournal.h"
+#include "chessTrace.h"
+#include "chessLocks.h"
+#include "chessVersion.h"
+#include "chessPool.h"
+#include "chessFeed.h"
+#include "chessRemoval.h"
+#include "chessOutput.h"
 #include "utils.h"
 #include "map.h"
+#include "mapExt.h"
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 // ------------------ DEFINES ---------------- //
 
 #define FAULT_AVERAGE_TIME 0.0
 #define MIN_ID_VALUE 1
-
-struct chess_system_t {
-    Map tournaments;  // <(int)id, (Tournament)tournament>
-    Map players;      // <(int)id, <(Player) player>
-    int num_of_games; // number of games in the system.
-};
+#define STDOUT_STREAM 1 // how chessSavePlayersLevels records its stream in a trace
+#define STDERR_STREAM 2
+#define OTHER_STREAM 0
+#define NULL_STREAM -1
+#define TOURNAMENTS_PER_RANGE 16 // ended by one thread at a time
+
+/**
+ * One pass of chessEndTournaments over the tournaments it ends, split between the threads of the pool.
+ * */
+typedef struct chess_end_job_t {
+    Tournament* tournaments;
+    int* winners; // filled by the pass that finds the winners, NULL on the pass that freezes the games
+    Map players;
+} EndJob;
+
+/**
+ * The games of the removed player in one of its tournaments, found by one of the threads of the pool.
+ * */
+typedef struct chess_player_games_t {
+    Tournament tournament;
+    int* games;   // indexes in the tournament
+    int capacity; // the games of the player in the tournament
+    int size;     // found
+} PlayerGames;
+
+typedef struct chess_removal_job_t {
+    int player_id;
+    PlayerGames* tournaments;
+} RemovalJob;
+
+typedef struct chess_players_removal_job_t {
+    Bitmap player_ids;
+    PlayerGames* tournaments;
+} PlayersRemovalJob;
+
+/**
+ * A ranked player, as written by chessSavePlayersLevels.
+ * */
+typedef struct chess_player_level_t {
+    int player_id;
+    double level;
+} PlayerLevel;
 
 // ------------------ FUNCTIONS DECLARATIONS ---------------- //
 
-static void freeMapFunction(MapDataElement data);
-static MapDataElement copyMapFunction(MapDataElement data);
-static int compareDecending(MapKeyElement key1, MapKeyElement key2);
-static MapKeyElement copyDoubleKey(MapKeyElement key);
-
-static MapKeyElement (*copyIntKey)(MapKeyElement) = copyInt;
-static MapKeyElement (*copyDouKey)(MapKeyElement) = copyDoubleKey;
-static MapDataElement (*copyMap)(MapDataElement) = copyMapFunction;
-static void (*freeIntKey)(MapKeyElement) = freeSimple;
-static void (*freeMap)(MapDataElement) = freeMapFunction;
-static int (*compareIntsAscending)(MapKeyElement, MapKeyElement) = compare;
-static int (*compareDoublesDecending)(MapKeyElement, MapKeyElement) = compareDecending;
-
-static bool isLocationValid(const char* location);
+static ChessResult addTournament(ChessSystem chess, int tournament_id, int max_games_per_player,
+                                 const char* tournament_location);
+static ChessResult addGame(ChessSystem chess, int tournament_id, int first_player,
+                           int second_player, Winner winner, int play_time);
+static ChessResult addLockedGame(ChessSystem chess, int tournament_id, int first_player,
+                                 int second_player, Winner winner, int play_time);
+static ChessResult removeTournament(ChessSystem chess, int tournament_id);
+static ChessResult removePlayer(ChessSystem chess, int player_id);
+static ChessResult endTournament(ChessSystem chess, int tournament_id);
+static double calculateAveragePlayTime(ChessSystem chess, int player_id, ChessResult* chess_result);
+static ChessResult savePlayersLevels(ChessSystem chess, FILE* file);
+static ChessResult saveTournamentStatistics(ChessSystem chess, char* path_file);
+static Trace getTrace(ChessSystem chess);
+static Locks getLocks(ChessSystem chess);
 static bool addPlayersToMap(Map players, Player* player1, Player* player2, int first_player, int second_player);
-static bool exceededMaxGames(Map players, Player player1, Player player2, Tournament tournament, int tournament_id);
-static bool updatePlayersStatistics(Map players, Player* player1, Player* player2,
+static bool exceededMaxGames(ChessSystem chess, Player player1, Player player2, Tournament tournament, int tournament_id);
+static bool updatePlayersStatistics(ChessSystem chess, Player* player1, Player* player2,
                                     Tournament tournament, int tournament_id, Winner winner, int play_time);
-static bool printLevelsToFile(Map levels_map, FILE* file);
-static bool addPlayersWithLevelToMap(Map all_players, Map players_map, double level);
-static bool fillLevelsMap(Map players, Map levels_map);
-static bool printTournamentStatistics(Map tournaments, Map players, FILE* stream, int* ended_tournaments);
+static void removeNewPlayers(ChessSystem chess, Player player1, Player player2);
+static bool removeLazily(ChessSystem chess, Player player);
+static bool removeFromPlayedTournaments(ChessSystem chess, Player player);
+static void findPlayerGamesRange(void* job, int begin, int end);
+static ChessResult removePlayers(ChessSystem chess, const int* ids, int n, ChessResult* results);
+static int findRemovedPlayers(ChessSystem chess, Bitmap player_ids, Player* removed);
+static bool findPlayedTournaments(ChessSystem chess, Player* removed, int num_of_removed,
+                                  PlayerGames** tournaments, int** games, int* num_of_tournaments);
+static void findPlayersGamesRange(void* job, int begin, int end);
+static void endTournamentsRange(void* job, int begin, int end);
+static int fillLevels(Map players, PlayerLevel* levels);
+static int compareLevels(const void* level1, const void* level2);
+static void printLevel(Output output, int index, void* levels);
+static void printTournamentStatistics(Map tournaments, Output output, int* ended_tournaments, Pool pool);
+static void printEndedTournament(Output output, int index, void* ended);
+static int compareRequests(const void* request1, const void* request2);
+static int compareEndRequests(const void* request1, const void* request2);
+static void fillPlayerStats(ChessPlayerStats* stats, Player player);
 
 // ------------------ FUNCTIONS IMPLEMENTATIONS ---------------- //
 
 ChessSystem chessCreate()
 {
+    return chessCreateWithOptions(NULL);
+}
+
+ChessSystem chessCreateWithOptions(const ChessSystemOptions* options)
+{
+    int num_of_workers = options == NULL ? 0 : options->num_of_workers;
     ChessSystem system = (ChessSystem)malloc(sizeof(*system));
     if (system == NULL)
     {
@@ -66,10 +138,48 @@ ChessSystem chessCreate()
         free(system);
         return NULL;
     }
+    LocationPool locations = locationPoolCreate();
+    if (locations == NULL)
+    {
+        mapDestroy(players);
+        mapDestroy(tournaments);
+        free(system);
+        return NULL;
+    }
+    Bitmap former_players = bitmapCreate();
+    if (former_players == NULL)
+    {
+        locationPoolDestroy(locations);
+        mapDestroy(players);
+        mapDestroy(tournaments);
+        free(system);
+        return NULL;
+    }
+    Pool pool = poolCreate(num_of_workers);
+    if (pool == NULL && num_of_workers > 0)
+    {
+        bitmapDestroy(former_players);
+        locationPoolDestroy(locations);
+        mapDestroy(players);
+        mapDestroy(tournaments);
+        free(system);
+        return NULL;
+    }
 
     system->tournaments = tournaments;
     system->players = players;
+    system->locations = locations;
+    system->former_players = former_players;
     system->num_of_games = 0;
+    system->journal = NULL;
+    system->games_directory = NULL;
+    system->games_in_files = false;
+    system->trace = NULL;
+    system->locks = NULL;
+    system->versions = NULL;
+    system->pool = pool;
+    system->feed = NULL;
+    system->removals = NULL;
     return system;
 }
 
@@ -79,13 +189,120 @@ void chessDestroy(ChessSystem system)
     {
         return;
     }
+    journalDestroy(system->journal);
+    traceDestroy(system->trace);
+    versionsDestroy(system->versions);
     mapDestroy(system->tournaments);
+    free(system->games_directory);
     mapDestroy(system->players);
+    locationPoolDestroy(system->locations);
+    bitmapDestroy(system->former_players);
+    locksDestroy(system->locks);
+    poolDestroy(system->pool);
+    feedDestroy(system->feed);
+    removalsDestroy(system->removals);
     free(system);
 }
 
-ChessResult chessAddTournament(ChessSystem chess, int tournament_id, 
+// the calls of chessSystem.h are recorded in the trace of the system (if any), then made by the functions below,
+// under the lock of the system (if it is shared by several threads, see chessLocks.h).
+// the queries lock it only if they can't read a version of the system instead (see chessVersion.h).
+
+ChessResult chessAddTournament(ChessSystem chess, int tournament_id,
                                 int max_games_per_player, const char* tournament_location)
+{
+    long long start = traceStart(getTrace(chess));
+    lockSystem(getLocks(chess), true);
+    ChessResult result = addTournament(chess, tournament_id, max_games_per_player, tournament_location);
+    unlockSystem(getLocks(chess));
+    int args[] = { tournament_id, max_games_per_player };
+    traceCall(getTrace(chess), CHESS_TRACE_ADD_TOURNAMENT, args, 2, tournament_location, result, 0.0, start);
+    return result;
+}
+
+ChessResult chessAddGame(ChessSystem chess, int tournament_id, int first_player,
+                        int second_player, Winner winner, int play_time)
+{
+    long long start = traceStart(getTrace(chess));
+    lockSystem(getLocks(chess), false);
+    ChessResult result = addGame(chess, tournament_id, first_player, second_player, winner, play_time);
+    unlockSystem(getLocks(chess));
+    int args[] = { tournament_id, first_player, second_player, winner, play_time };
+    traceCall(getTrace(chess), CHESS_TRACE_ADD_GAME, args, 5, NULL, result, 0.0, start);
+    return result;
+}
+
+ChessResult chessRemoveTournament(ChessSystem chess, int tournament_id)
+{
+    long long start = traceStart(getTrace(chess));
+    lockSystem(getLocks(chess), true);
+    ChessResult result = removeTournament(chess, tournament_id);
+    unlockSystem(getLocks(chess));
+    traceCall(getTrace(chess), CHESS_TRACE_REMOVE_TOURNAMENT, &tournament_id, 1, NULL, result, 0.0, start);
+    return result;
+}
+
+ChessResult chessRemovePlayer(ChessSystem chess, int player_id)
+{
+    long long start = traceStart(getTrace(chess));
+    lockSystem(getLocks(chess), true);
+    ChessResult result = removePlayer(chess, player_id);
+    unlockSystem(getLocks(chess));
+    traceCall(getTrace(chess), CHESS_TRACE_REMOVE_PLAYER, &player_id, 1, NULL, result, 0.0, start);
+    return result;
+}
+
+ChessResult chessEndTournament(ChessSystem chess, int tournament_id)
+{
+    long long start = traceStart(getTrace(chess));
+    lockSystem(getLocks(chess), true);
+    ChessResult result = endTournament(chess, tournament_id);
+    unlockSystem(getLocks(chess));
+    traceCall(getTrace(chess), CHESS_TRACE_END_TOURNAMENT, &tournament_id, 1, NULL, result, 0.0, start);
+    return result;
+}
+
+double chessCalculateAveragePlayTime(ChessSystem chess, int player_id, ChessResult* chess_result)
+{
+    long long start = traceStart(getTrace(chess));
+    double average = calculateAveragePlayTime(chess, player_id, chess_result);
+    traceCall(getTrace(chess), CHESS_TRACE_CALCULATE_AVERAGE_PLAY_TIME, &player_id, 1, NULL,
+              *chess_result, average, start);
+    return average;
+}
+
+ChessResult chessSavePlayersLevels(ChessSystem chess, FILE* file)
+{
+    long long start = traceStart(getTrace(chess));
+    ChessResult result = savePlayersLevels(chess, file);
+    int stream = file == NULL     ? NULL_STREAM
+                 : file == stdout ? STDOUT_STREAM
+                 : file == stderr ? STDERR_STREAM
+                                  : OTHER_STREAM;
+    traceCall(getTrace(chess), CHESS_TRACE_SAVE_PLAYERS_LEVELS, &stream, 1, NULL, result, 0.0, start);
+    return result;
+}
+
+ChessResult chessSaveTournamentStatistics(ChessSystem chess, char* path_file)
+{
+    long long start = traceStart(getTrace(chess));
+    ChessResult result = saveTournamentStatistics(chess, path_file);
+    traceCall(getTrace(chess), CHESS_TRACE_SAVE_TOURNAMENT_STATISTICS, NULL, 0, path_file, result, 0.0, start);
+    return result;
+}
+
+static Trace getTrace(ChessSystem chess)
+{
+    return chess == NULL ? NULL : chess->trace;
+}
+
+static Locks getLocks(ChessSystem chess)
+{
+    return chess == NULL ? NULL : chess->locks;
+}
+
+static ChessResult addTournament(ChessSystem chess, int tournament_id, int max_games_per_player,
+                                 const char* tournament_location)
 {
     // check for errors
     if (chess == NULL || tournament_location == NULL)
@@ -100,44 +317,43 @@ ChessResult chessAddTournament(ChessSystem chess, int tournament_id,
     {
         return CHESS_TOURNAMENT_ALREADY_EXISTS;
     }
-    if (!isLocationValid(tournament_location))
+    // the location is validated only the first time the system sees it
+    int location_id = locationIntern(chess->locations, tournament_location);
+    if (location_id == LOCATION_INVALID)
     {
         return CHESS_INVALID_LOCATION;
     }
+    if (location_id == LOCATION_OUT_OF_MEMORY)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
     if (max_games_per_player < MIN_ID_VALUE)
     {
         return CHESS_INVALID_MAX_GAMES;
     }
 
     // add the tournament
-    if (!tournamentAddToMap(chess->tournaments, tournament_id, max_games_per_player, tournament_location))
+    if (!tournamentAddToMap(chess->tournaments, tournament_id, max_games_per_player,
+                            location_id, locationGet(chess->locations, location_id)))
     {
         return CHESS_OUT_OF_MEMORY;
     }
-
-    return CHESS_SUCCESS;
-}
-
-static bool isLocationValid(const char* location)
-{
-    if (location == NULL || strlen(location) < 1 || location[0] > 'Z' || location[0] < 'A')
-    {
-        return false;
-    }
-    int i = 0;
-    char c;
-    while ((c = location[++i]) != '\0')
+    if (chess->games_directory != NULL)
     {
-        if (!(c == ' ' || (c >= 'a' && c <= 'z')))
+        // if the file can't be created, the games of this tournament simply stay in memory
+        if (tournamentStoreGamesInFile(mapGet(chess->tournaments, &tournament_id), chess->games_directory))
         {
-            return false;
+            chess->games_in_files = true;
         }
     }
-    return true;
+
+    int record[] = { tournament_id, max_games_per_player };
+    journalRecord(chess->journal, JOURNAL_ADD_TOURNAMENT, record, 2, tournament_location);
+    return CHESS_SUCCESS;
 }
 
-ChessResult chessAddGame(ChessSystem chess, int tournament_id, int first_player, 
-                        int second_player, Winner winner, int play_time)
+static ChessResult addGame(ChessSystem chess, int tournament_id, int first_player,
+                           int second_player, Winner winner, int play_time)
 {
     // basic validations
     if (chess == NULL)
@@ -149,7 +365,27 @@ ChessResult chessAddGame(ChessSystem chess, int tournament_id, int first_player,
     {
         return CHESS_INVALID_ID;
     }
-    
+    // a player whose removal is waiting can't come back before it is applied
+    if (removalsHasPlayer(chess->removals, first_player) || removalsHasPlayer(chess->removals, second_player))
+    {
+        removalsApplyAll(chess->removals, chess->players, chess->tournaments);
+    }
+    removalsApplyToTournament(chess->removals, chess->players, chess->tournaments, tournament_id);
+
+    lockTournament(chess->locks, tournament_id);
+    lockPlayers(chess->locks, first_player, second_player);
+    ChessResult result = addLockedGame(chess, tournament_id, first_player, second_player, winner, play_time);
+    unlockPlayers(chess->locks, first_player, second_player);
+    unlockTournament(chess->locks, tournament_id);
+    return result;
+}
+
+/**
+ * The rest of addGame, once no other thread can touch the tournament and the two players.
+ * */
+static ChessResult addLockedGame(ChessSystem chess, int tournament_id, int first_player,
+                                 int second_player, Winner winner, int play_time)
+{
     Tournament tournament = (Tournament)mapGet(chess->tournaments, &tournament_id);
     if (tournament == NULL)
     {
@@ -169,15 +405,23 @@ ChessResult chessAddGame(ChessSystem chess, int tournament_id, int first_player,
     }
 
     // adding the players to chess->players if needed
+    lockPlayersMap(chess->locks, false);
     Player player1 = (Player)mapGet(chess->players, &first_player);
-    Player player2 = (Player)mapGet(chess->players, &second_player);;
-    if (!addPlayersToMap(chess->players, &player1, &player2, first_player, second_player))
+    Player player2 = (Player)mapGet(chess->players, &second_player);
+    unlockPlayersMap(chess->locks);
+    if (player1 == NULL || player2 == NULL)
     {
-        return CHESS_OUT_OF_MEMORY;
+        lockPlayersMap(chess->locks, true);
+        bool added = addPlayersToMap(chess->players, &player1, &player2, first_player, second_player);
+        unlockPlayersMap(chess->locks);
+        if (!added)
+        {
+            return CHESS_OUT_OF_MEMORY;
+        }
     }
 
     // check one more validaiton
-    if (exceededMaxGames(chess->players, player1, player2, tournament, tournament_id))
+    if (exceededMaxGames(chess, player1, player2, tournament, tournament_id))
     {
         return CHESS_EXCEEDED_GAMES;
     }
@@ -186,25 +430,25 @@ ChessResult chessAddGame(ChessSystem chess, int tournament_id, int first_player,
     int winners_id = (winner == FIRST_PLAYER ? first_player : (winner == SECOND_PLAYER ? second_player : GAME_DRAW));
     if (!tournamentAddGame(tournament, player1, player2, winners_id, play_time))
     {
-        if (!playerExists(player1))
-        {
-            mapRemove(chess->players, &first_player);
-        }
-        if (!playerExists(player2))
-        {
-            mapRemove(chess->players, &second_player);
-        }
+        removeNewPlayers(chess, player1, player2);
         return CHESS_OUT_OF_MEMORY;
     }
 
     // update statistics for both players
-    if (!updatePlayersStatistics(chess->players, &player1, &player2, tournament, tournament_id, winner, play_time))
+    if (!updatePlayersStatistics(chess, &player1, &player2, tournament, tournament_id, winner, play_time))
     {
         return CHESS_OUT_OF_MEMORY;
     }
 
-    chess->num_of_games++;
+    // games of other tournaments may be added at the same time
+    __atomic_fetch_add(&chess->num_of_games, 1, __ATOMIC_RELAXED);
+    bitmapClear(chess->former_players, first_player);
+    bitmapClear(chess->former_players, second_player);
+    versionsUpdatePlayers(chess->versions, player1, player2);
 
+    int record[] = { tournament_id, first_player, second_player, winner, play_time };
+    journalRecord(chess->journal, JOURNAL_ADD_GAME, record, 5, NULL);
+    feedPublish(chess->feed, CHESS_EVENT_GAME_ADDED, record, 5);
     return CHESS_SUCCESS;
 }
 
@@ -235,32 +479,22 @@ static bool addPlayersToMap(Map players, Player* player1, Player* player2, int f
     return true;
 }
 
-static bool exceededMaxGames(Map players, Player player1, Player player2, Tournament tournament, int tournament_id)
+static bool exceededMaxGames(ChessSystem chess, Player player1, Player player2, Tournament tournament, int tournament_id)
 {
-    if(player1 == NULL || player2 == NULL || players == NULL || tournament == NULL)
+    if(player1 == NULL || player2 == NULL || chess == NULL || tournament == NULL)
     {
         return false;
     }
-    int first_player  = playerGetID(player1);
-    int second_player = playerGetID(player2);
     if (playerGetGamesInTournament(player1, tournament_id) >= tournamentGetMaxGamesPerPlayer(tournament)
      || playerGetGamesInTournament(player2, tournament_id) >= tournamentGetMaxGamesPerPlayer(tournament)) 
     {
-        if (!playerExists(player1))
-        { 
-            mapRemove(players, &first_player);
-        }
-        if (!playerExists(player2))
-        { 
-            mapRemove(players, &second_player);
-        }
+        removeNewPlayers(chess, player1, player2);
         return true;
     }
 
     return false;
 }
-
-static bool updatePlayersStatistics(Map players, Player* player1, Player* player2,
+static bool updatePlayersStatistics(ChessSystem chess, Player* player1, Player* player2,
                                     Tournament tournament, int tournament_id, Winner winner, int play_time)
 {
     int first_player = playerGetID(*player1);
@@ -269,14 +503,7 @@ static bool updatePlayersStatistics(Map players, Player* player1, Player* player
     if (!playerUpdate(*player1, first_player, tournament_id, winner, play_time))
     {
         tournamentRemoveGame(tournament, first_player, second_player);
-        if (!playerExists(*player1))
-        {
-            mapRemove(players, &first_player);
-        }
-        if (!playerExists(*player2))
-        {
-            mapRemove(players, &second_player);
-        }
+        removeNewPlayers(chess, *player1, *player2);
         return false;
     }
 
@@ -284,21 +511,34 @@ static bool updatePlayersStatistics(Map players, Player* player1, Player* player
     {
         playerDowndate(*player1, first_player, tournament_id, winner, play_time);
         tournamentRemoveGame(tournament, first_player, second_player);
-        if (!playerExists(*player1))
-        {
-            mapRemove(players, &first_player);
-        }
-        if (!playerExists(*player2))
-        {
-            mapRemove(players, &second_player);
-        }
+        removeNewPlayers(chess, *player1, *player2);
         return false;
     }
 
     return true;
 }
 
-ChessResult chessRemoveTournament(ChessSystem chess, int tournament_id)
+/**
+ * Remove the players of a game that could not be added, if they have no other games
+ * (they were added to the map for this game).
+ * */
+static void removeNewPlayers(ChessSystem chess, Player player1, Player player2)
+{
+    int first_player = playerGetID(player1);
+    int second_player = playerGetID(player2);
+    lockPlayersMap(chess->locks, true);
+    if (!playerExists(player1))
+    {
+        mapRemove(chess->players, &first_player);
+    }
+    if (!playerExists(player2))
+    {
+        mapRemove(chess->players, &second_player);
+    }
+    unlockPlayersMap(chess->locks);
+}
+
+static ChessResult removeTournament(ChessSystem chess, int tournament_id)
 {
     if(chess == NULL)
     {
@@ -314,16 +554,20 @@ ChessResult chessRemoveTournament(ChessSystem chess, int tournament_id)
     {
         return CHESS_TOURNAMENT_NOT_EXIST;
     }
+    removalsApplyToTournament(chess->removals, chess->players, chess->tournaments, tournament_id);
 
     chess->num_of_games -= tournamentGetNumOfGames(tournament);
-    tournamentUpdateStatisticsBeforeRemove(tournament, chess->players);
+    tournamentUpdateStatisticsBeforeRemove(tournament, chess->players, chess->former_players);
 
     mapRemove(chess->tournaments, &tournament_id);
-    
+    versionsRebuild(chess->versions, chess->players, chess->tournaments, chess->locations);
+
+    journalRecord(chess->journal, JOURNAL_REMOVE_TOURNAMENT, &tournament_id, 1, NULL);
+    feedPublish(chess->feed, CHESS_EVENT_TOURNAMENT_REMOVED, &tournament_id, 1);
     return CHESS_SUCCESS;
 }
 
-ChessResult chessRemovePlayer(ChessSystem chess, int player_id)
+static ChessResult removePlayer(ChessSystem chess, int player_id)
 {
     if (chess == NULL)
     {
@@ -340,25 +584,146 @@ ChessResult chessRemovePlayer(ChessSystem chess, int player_id)
         return CHESS_PLAYER_NOT_EXIST;
     }
 
-    // reset all statistics of that player
-    // ex1-version3 says not to delete from chess->players
-    playerResetStatistics(player);
+    // ex1-version3 requires tracking players that once played,
+    // so the id is remembered before the player itself is released.
+    if (!bitmapSet(chess->former_players, player_id))
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
+
+    // remove the player from the games themselfs (and update statistics), now or later
+    if (!removeLazily(chess, player))
+    {
+        // the removals that wait were made before this one
+        removalsApplyAll(chess->removals, chess->players, chess->tournaments);
+        if (!removeFromPlayedTournaments(chess, player))
+        {
+            // without the memory to collect the tournaments of the player, every tournament is searched here
+            MAP_FOREACH(int*, tournament_id, chess->tournaments)
+            {
+                Tournament tournament = mapGet(chess->tournaments, tournament_id);
+                if (!tournamentHasEnded(tournament))
+                {
+                    tournamentRemovePlayer(tournament, player, chess->players);
+                }
+                free(tournament_id);
+            }
+        }
+    }
+
+    mapRemove(chess->players, &player_id);
+    versionsRebuild(chess->versions, chess->players, chess->tournaments, chess->locations);
+
+    journalRecord(chess->journal, JOURNAL_REMOVE_PLAYER, &player_id, 1, NULL);
+    feedPublish(chess->feed, CHESS_EVENT_PLAYER_REMOVED, &player_id, 1);
+    return CHESS_SUCCESS;
+}
+
+/**
+ * Remember the removal of a player instead of updating its games, if the system removes players
+ * lazily (see chessRemoval.h). Return false if the games must be updated now.
+ * */
+static bool removeLazily(ChessSystem chess, Player player)
+{
+    // a shared system adds games under a shared lock, and versions copy the statistics of the players,
+    // so the removals never wait in these
+    if (chess->removals == NULL || chess->locks != NULL || chess->versions != NULL)
+    {
+        return false;
+    }
+    int num_of_played = playerGetNumOfTournaments(player);
+    PlayerTournament* played = (PlayerTournament*)malloc(sizeof(PlayerTournament) * (num_of_played + 1));
+    if (played == NULL)
+    {
+        return false;
+    }
+    playerGetTournaments(player, played);
+    bool added = removalsAdd(chess->removals, playerGetID(player), played, num_of_played);
+    free(played);
+    return added;
+}
 
-    // remove the player from the games themselfs (and update statistics)
+/**
+ * Remove a player from the games of the open tournaments it played in. Their games are searched
+ * on the pool, then the statistics of the other players are updated on this thread, in the order
+ * of a serial removal. Return false if malloc failed, before anything was removed.
+ * */
+static bool removeFromPlayedTournaments(ChessSystem chess, Player player)
+{
+    int num_of_played = playerGetNumOfTournaments(player);
+    PlayerTournament* played = (PlayerTournament*)malloc(sizeof(PlayerTournament) * (num_of_played + 1));
+    PlayerGames* tournaments = (PlayerGames*)malloc(sizeof(PlayerGames) * (num_of_played + 1));
+    if (played == NULL || tournaments == NULL)
+    {
+        free(played);
+        free(tournaments);
+        return false;
+    }
+    playerGetTournaments(player, played);
+    int num_of_games = 0;
+    for (int i = 0; i < num_of_played; i++)
+    {
+        num_of_games += played[i].num_of_games;
+    }
+    int* games = (int*)malloc(sizeof(int) * (num_of_games + 1));
+    if (games == NULL)
+    {
+        free(played);
+        free(tournaments);
+        return false;
+    }
+
+    // both are sorted by id, so one merge pass finds the tournaments
+    int size = 0;
+    int next = 0;
+    int* free_games = games;
     MAP_FOREACH(int*, tournament_id, chess->tournaments)
     {
+        while (next < num_of_played && played[next].tournament_id < *tournament_id)
+        {
+            next++;
+        }
         Tournament tournament = mapGet(chess->tournaments, tournament_id);
-        if (!tournamentHasEnded(tournament))
+        if (next < num_of_played && played[next].tournament_id == *tournament_id && !tournamentHasEnded(tournament))
         {
-            tournamentRemovePlayer(tournament, player, chess->players);
+            tournaments[size].tournament = tournament;
+            tournaments[size].games = free_games;
+            tournaments[size].capacity = played[next].num_of_games;
+            free_games += played[next].num_of_games;
+            size++;
         }
         free(tournament_id);
+        if (next == num_of_played)
+        {
+            break;
+        }
     }
 
-    return CHESS_SUCCESS;
+    RemovalJob job = { playerGetID(player), tournaments };
+    poolFor(chess->pool, size, 1, findPlayerGamesRange, &job);
+    for (int i = 0; i < size; i++)
+    {
+        tournamentRemovePlayerFromGames(tournaments[i].tournament, player, chess->players,
+                                        tournaments[i].games, tournaments[i].size);
+    }
+    free(played);
+    free(tournaments);
+    free(games);
+    return true;
 }
 
-ChessResult chessEndTournament(ChessSystem chess, int tournament_id)
+static void findPlayerGamesRange(void* argument, int begin, int end)
+{
+    RemovalJob* job = (RemovalJob*)argument;
+    for (int i = begin; i < end; i++)
+    {
+        PlayerGames* tournament = &job->tournaments[i];
+        tournament->size = tournamentFindPlayerGames(tournament->tournament, job->player_id,
+                                                     tournament->games, tournament->capacity);
+    }
+}
+
+static ChessResult endTournament(ChessSystem chess, int tournament_id)
 {
     if (chess == NULL)
     {
@@ -382,252 +747,816 @@ ChessResult chessEndTournament(ChessSystem chess, int tournament_id)
         return CHESS_NO_GAMES;
     }
 
+    // the winner is decided by the statistics of the players
+    removalsApplyAll(chess->removals, chess->players, chess->tournaments);
     tournamentEnd(tournament, chess->players);
+    versionsUpdateTournaments(chess->versions, &tournament, 1, chess->locations);
 
+    journalRecord(chess->journal, JOURNAL_END_TOURNAMENT, &tournament_id, 1, NULL);
+    int event[] = { tournament_id, tournamentGetWinner(tournament) };
+    feedPublish(chess->feed, CHESS_EVENT_TOURNAMENT_ENDED, event, 2);
     return CHESS_SUCCESS;
 }
 
-double chessCalculateAveragePlayTime(ChessSystem chess, int player_id, ChessResult* chess_result)
+/**
+ * One requested id of chessEndTournaments.
+ * */
+typedef struct chess_end_request_t {
+    int tournament_id;
+    int index;             // in the caller's arrays
+    Tournament tournament; // set if it is to be ended
+    bool duplicate;        // of an earlier index that is to be ended
+} EndRequest;
+
+ChessResult chessEndTournaments(ChessSystem chess, const int* ids, int n, ChessResult* results)
 {
-    if(chess == NULL)
+    if (n <= 0)
     {
-        *chess_result = CHESS_NULL_ARGUMENT;
-        return FAULT_AVERAGE_TIME;
+        return chess == NULL ? CHESS_NULL_ARGUMENT : CHESS_SUCCESS;
     }
-    if (player_id < MIN_ID_VALUE)
+    if (chess == NULL || ids == NULL || results == NULL)
     {
-        *chess_result = CHESS_INVALID_ID;
-        return FAULT_AVERAGE_TIME;
+        return CHESS_NULL_ARGUMENT;
     }
-    
-    // search for a player with that id, and return its average
-    MAP_FOREACH(int*, id, chess->players)
+
+    long long start = traceStart(chess->trace);
+    EndRequest* requests = (EndRequest*)malloc(sizeof(EndRequest) * n);
+    Tournament* ending = (Tournament*)malloc(sizeof(Tournament) * n);
+    int* winners = (int*)malloc(sizeof(int) * n);
+    if (requests == NULL || ending == NULL || winners == NULL)
     {
-        Player player = mapGet(chess->players, id);
-        if (!playerExists(player))
+        free(requests);
+        free(ending);
+        free(winners);
+        return CHESS_OUT_OF_MEMORY;
+    }
+    int num_of_requests = 0;
+    for (int i = 0; i < n; i++)
+    {
+        results[i] = ids[i] < MIN_ID_VALUE ? CHESS_INVALID_ID : CHESS_TOURNAMENT_NOT_EXIST;
+        if (ids[i] >= MIN_ID_VALUE)
         {
-            free(id);
-            continue;
+            requests[num_of_requests].tournament_id = ids[i];
+            requests[num_of_requests].index = i;
+            requests[num_of_requests].tournament = NULL;
+            requests[num_of_requests].duplicate = false;
+            num_of_requests++;
+        }
+    }
+    // by id, then by index, so the first of equal ids is the one a serial caller would end
+    qsort(requests, num_of_requests, sizeof(EndRequest), compareEndRequests);
+
+    lockSystem(chess->locks, true);
+    removalsApplyAll(chess->removals, chess->players, chess->tournaments);
+    int num_of_ending = 0;
+    int next = 0;
+    MAP_FOREACH_AFTER(int*, tournament_id, chess->tournaments, NULL)
+    {
+        while (next < num_of_requests && requests[next].tournament_id < *tournament_id)
+        {
+            next++; // not in the system, already marked as CHESS_TOURNAMENT_NOT_EXIST
+        }
+        Tournament tournament = mapGetCurrentData(chess->tournaments);
+        for (int first = next; next < num_of_requests && requests[next].tournament_id == *tournament_id; next++)
+        {
+            EndRequest* request = &requests[next];
+            if (tournamentHasEnded(tournament))
+            {
+                results[request->index] = CHESS_TOURNAMENT_ENDED;
+            }
+            else if (tournamentGetNumOfGames(tournament) < 1)
+            {
+                results[request->index] = CHESS_NO_GAMES;
+            }
+            else
+            {
+                request->tournament = tournament;
+                request->duplicate = next > first;
+                if (!request->duplicate)
+                {
+                    ending[num_of_ending++] = tournament;
+                }
+            }
         }
-        if(playerGetID(player) == player_id)
+        if (next == num_of_requests)
         {
-            *chess_result = CHESS_SUCCESS;
-            free(id);
-            return playerGetAveragePlayTime((Player)mapGet(chess->players, &player_id));
+            break;
         }
-        free(id);
     }
 
-    *chess_result = CHESS_PLAYER_NOT_EXIST;
-    return FAULT_AVERAGE_TIME;
+    // the winners only depend on the players, which ending a tournament doesn't change
+    EndJob job = { ending, winners, chess->players };
+    poolFor(chess->pool, num_of_ending, TOURNAMENTS_PER_RANGE, endTournamentsRange, &job);
+    for (int i = 0; i < num_of_ending; i++)
+    {
+        tournamentSetWinner(ending[i], winners[i]);
+    }
+    versionsUpdateTournaments(chess->versions, ending, num_of_ending, chess->locations);
+    for (int i = 0; i < num_of_requests; i++)
+    {
+        if (requests[i].tournament != NULL)
+        {
+            // a tournament whose players were all removed stays open, and ending it again succeeds again
+            bool ended = requests[i].duplicate && tournamentHasEnded(requests[i].tournament);
+            results[requests[i].index] = ended ? CHESS_TOURNAMENT_ENDED : CHESS_SUCCESS;
+            // the winners were all saved, from now on winners[i] is the winner of ids[i]
+            winners[requests[i].index] = tournamentGetWinner(requests[i].tournament);
+        }
+    }
+    for (int i = 0; i < n; i++)
+    {
+        if (results[i] == CHESS_SUCCESS)
+        {
+            journalRecord(chess->journal, JOURNAL_END_TOURNAMENT, &ids[i], 1, NULL);
+            int event[] = { ids[i], winners[i] };
+            feedPublish(chess->feed, CHESS_EVENT_TOURNAMENT_ENDED, event, 2);
+        }
+    }
+
+    // the games can't change anymore, keep them in the compact form.
+    job.winners = NULL;
+    poolFor(chess->pool, num_of_ending, TOURNAMENTS_PER_RANGE, endTournamentsRange, &job);
+    unlockSystem(chess->locks);
+
+    // a trace records calls it can replay one by one
+    for (int i = 0; i < n; i++)
+    {
+        traceCall(chess->trace, CHESS_TRACE_END_TOURNAMENT, &ids[i], 1, NULL, results[i], 0.0, start);
+    }
+    free(requests);
+    free(ending);
+    free(winners);
+    return CHESS_SUCCESS;
 }
 
-ChessResult chessSavePlayersLevels(ChessSystem chess, FILE* file)
+static void endTournamentsRange(void* argument, int begin, int end)
 {
-    if(chess == NULL || file == NULL)
+    EndJob* job = (EndJob*)argument;
+    for (int i = begin; i < end; i++)
     {
-        return CHESS_NULL_ARGUMENT;
+        if (job->winners != NULL)
+        {
+            job->winners[i] = tournamentFindWinner(job->tournaments[i], job->players);
+        }
+        else
+        {
+            tournamentFreeze(job->tournaments[i]);
+        }
     }
+}
 
-    /**
-     * levels_map is a map of maps: <(double)level, (Map)all_players_with_that_level>
-     * levels_map is in descending order, while all_players_with_that_level is ascending.
-     * */
-    Map levels_map = mapCreate(copyMap, copyDouKey, freeMap, freeIntKey, compareDoublesDecending);
-    if (levels_map == NULL)
+ChessResult chessRemovePlayers(ChessSystem chess, const int* ids, int n, ChessResult* results)
+{
+    if (n <= 0)
     {
-        return CHESS_SAVE_FAILURE;
+        return chess == NULL ? CHESS_NULL_ARGUMENT : CHESS_SUCCESS;
+    }
+    if (chess == NULL || ids == NULL || results == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
     }
 
-    if (!fillLevelsMap(chess->players, levels_map))
+    long long start = traceStart(chess->trace);
+    lockSystem(chess->locks, true);
+    ChessResult result = removePlayers(chess, ids, n, results);
+    unlockSystem(chess->locks);
+    if (result != CHESS_SUCCESS)
     {
-        mapDestroy(levels_map);
-        return CHESS_SAVE_FAILURE;
+        return result;
     }
 
+    // a trace records calls it can replay one by one
+    for (int i = 0; i < n; i++)
+    {
+        traceCall(chess->trace, CHESS_TRACE_REMOVE_PLAYER, &ids[i], 1, NULL, results[i], 0.0, start);
+    }
+    return CHESS_SUCCESS;
+}
 
-    if (!printLevelsToFile(levels_map, file))
+/**
+ * The rest of chessRemovePlayers, under the lock of the system.
+ * Everything that may fail is done first, so nothing is removed if malloc failed.
+ * */
+static ChessResult removePlayers(ChessSystem chess, const int* ids, int n, ChessResult* results)
+{
+    removalsApplyAll(chess->removals, chess->players, chess->tournaments);
+    Bitmap player_ids = bitmapCreate();
+    Player* removed = (Player*)malloc(sizeof(Player) * n);
+    bool allocated = player_ids != NULL && removed != NULL;
+    for (int i = 0; i < n && allocated; i++)
     {
-        mapDestroy(levels_map);
-        return CHESS_SAVE_FAILURE;
+        allocated = ids[i] < MIN_ID_VALUE || bitmapSet(player_ids, ids[i]);
+    }
+    int num_of_removed = 0;
+    PlayerGames* tournaments = NULL;
+    int* games = NULL;
+    int num_of_tournaments = 0;
+    if (allocated)
+    {
+        num_of_removed = findRemovedPlayers(chess, player_ids, removed);
+        allocated = findPlayedTournaments(chess, removed, num_of_removed, &tournaments, &games, &num_of_tournaments);
+    }
+    // ex1-version3 requires tracking players that once played, as in removePlayer
+    for (int i = 0; i < num_of_removed && allocated; i++)
+    {
+        if (!bitmapSet(chess->former_players, playerGetID(removed[i])))
+        {
+            for (int j = 0; j < i; j++)
+            {
+                bitmapClear(chess->former_players, playerGetID(removed[j]));
+            }
+            allocated = false;
+        }
+    }
+    if (!allocated)
+    {
+        bitmapDestroy(player_ids);
+        free(removed);
+        free(tournaments);
+        free(games);
+        return CHESS_OUT_OF_MEMORY;
     }
 
-    mapDestroy(levels_map);
+    // every game of the removed players is found in one pass over their open tournaments,
+    // then the other players are updated on this thread, like a serial removal would
+    PlayersRemovalJob job = { player_ids, tournaments };
+    poolFor(chess->pool, num_of_tournaments, 1, findPlayersGamesRange, &job);
+    for (int i = 0; i < num_of_tournaments; i++)
+    {
+        tournamentRemovePlayersFromGames(tournaments[i].tournament, player_ids, chess->players,
+                                         tournaments[i].games, tournaments[i].size);
+    }
+    for (int i = 0; i < num_of_removed; i++)
+    {
+        int player_id = playerGetID(removed[i]);
+        mapRemove(chess->players, &player_id);
+    }
+    if (num_of_removed > 0)
+    {
+        versionsRebuild(chess->versions, chess->players, chess->tournaments, chess->locations);
+    }
 
+    for (int i = 0; i < n; i++)
+    {
+        if (ids[i] < MIN_ID_VALUE)
+        {
+            results[i] = CHESS_INVALID_ID;
+        }
+        else if (bitmapGet(player_ids, ids[i]))
+        {
+            // only the first of equal ids removes the player
+            bitmapClear(player_ids, ids[i]);
+            results[i] = CHESS_SUCCESS;
+            journalRecord(chess->journal, JOURNAL_REMOVE_PLAYER, &ids[i], 1, NULL);
+            feedPublish(chess->feed, CHESS_EVENT_PLAYER_REMOVED, &ids[i], 1);
+        }
+        else
+        {
+            results[i] = CHESS_PLAYER_NOT_EXIST;
+        }
+    }
+    bitmapDestroy(player_ids);
+    free(removed);
+    free(tournaments);
+    free(games);
     return CHESS_SUCCESS;
 }
 
-static bool fillLevelsMap(Map players, Map levels_map)
+/**
+ * Fill removed with the players whose ids are in player_ids and that have games, by increasing id,
+ * and clear the other ids from player_ids. Return the number of players found.
+ * */
+static int findRemovedPlayers(ChessSystem chess, Bitmap player_ids, Player* removed)
 {
-    MAP_FOREACH(int*, player_id, players)
+    // chess->players is sorted by id too, so one merge pass finds all of them
+    int num_of_removed = 0;
+    int next = bitmapGetNext(player_ids, 0);
+    MAP_FOREACH(int*, player_id, chess->players)
     {
-        Player player = mapGet(players, player_id);
-        double level = playerGetLevel(player);
-        if (level == 0.0 || mapGet(levels_map, &level) != NULL)
+        while (next >= 0 && next < *player_id)
         {
-            free(player_id);
-            continue;
+            bitmapClear(player_ids, next);
+            next = bitmapGetNext(player_ids, next + 1);
         }
-
-        /**
-         * players_map (aka all_players_with_that_level) is just a list of players.
-         * We don't have a LinkedList ADT, so it's just <(int)player_id, (int)player_id>
-         * */
-        Map players_map = mapCreate(copyIntKey, copyIntKey, freeIntKey, freeIntKey, compareIntsAscending);
-        if (players_map == NULL)
+        if (next == *player_id)
         {
-	        free(player_id);
-            return false;
+            Player player = mapGet(chess->players, player_id);
+            if (playerExists(player))
+            {
+                removed[num_of_removed++] = player;
+            }
+            else
+            {
+                bitmapClear(player_ids, next);
+            }
+            next = bitmapGetNext(player_ids, next + 1);
+        }
+        free(player_id);
+        if (next < 0)
+        {
+            break;
         }
+    }
+    for (; next >= 0; next = bitmapGetNext(player_ids, next + 1))
+    {
+        bitmapClear(player_ids, next);
+    }
+    return num_of_removed;
+}
 
-        if (!addPlayersWithLevelToMap(players, players_map, level))
+/**
+ * Collect the open tournaments that any of the removed players played in, with room for all their games.
+ * Return false if malloc failed.
+ * */
+static bool findPlayedTournaments(ChessSystem chess, Player* removed, int num_of_removed,
+                                  PlayerGames** tournaments, int** games, int* num_of_tournaments)
+{
+    Bitmap played = bitmapCreate();
+    *tournaments = (PlayerGames*)malloc(sizeof(PlayerGames) * (mapGetSize(chess->tournaments) + 1));
+    PlayerTournament* played_by_player = NULL;
+    int capacity = 0;
+    bool result = played != NULL && *tournaments != NULL;
+    for (int i = 0; i < num_of_removed && result; i++)
+    {
+        int num_of_played = playerGetNumOfTournaments(removed[i]);
+        if (num_of_played > capacity)
         {
-            free(player_id);
-            mapDestroy(players_map);
-            return false;
+            PlayerTournament* new_played = (PlayerTournament*)realloc(played_by_player,
+                                                sizeof(PlayerTournament) * num_of_played);
+            if (new_played == NULL)
+            {
+                result = false;
+                break;
+            }
+            played_by_player = new_played;
+            capacity = num_of_played;
         }
+        playerGetTournaments(removed[i], played_by_player);
+        for (int j = 0; j < num_of_played && result; j++)
+        {
+            result = bitmapSet(played, played_by_player[j].tournament_id);
+        }
+    }
+    free(played_by_player);
 
-        if (mapPut(levels_map, &level, players_map) != MAP_SUCCESS)
+    int num_of_games = 0;
+    *num_of_tournaments = 0;
+    if (result)
+    {
+        MAP_FOREACH(int*, tournament_id, chess->tournaments)
         {
-            free(player_id);
-            mapDestroy(players_map);
-            return false;
+            Tournament tournament = mapGet(chess->tournaments, tournament_id);
+            if (bitmapGet(played, *tournament_id) && !tournamentHasEnded(tournament))
+            {
+                PlayerGames* played_tournament = &(*tournaments)[(*num_of_tournaments)++];
+                played_tournament->tournament = tournament;
+                played_tournament->capacity = tournamentGetNumOfGames(tournament);
+                num_of_games += played_tournament->capacity;
+            }
+            free(tournament_id);
         }
+        *games = (int*)malloc(sizeof(int) * (num_of_games + 1));
+        result = *games != NULL;
+    }
+    bitmapDestroy(played);
 
-        free(player_id);
-        mapDestroy(players_map); 
-        free(mapGetFirst(players));
+    int* free_games = *games;
+    for (int i = 0; i < *num_of_tournaments && result; i++)
+    {
+        (*tournaments)[i].games = free_games;
+        free_games += (*tournaments)[i].capacity;
     }
+    return result;
+}
 
-    return true;
+static void findPlayersGamesRange(void* argument, int begin, int end)
+{
+    PlayersRemovalJob* job = (PlayersRemovalJob*)argument;
+    for (int i = begin; i < end; i++)
+    {
+        PlayerGames* tournament = &job->tournaments[i];
+        tournament->size = tournamentFindPlayersGames(tournament->tournament, job->player_ids,
+                                                      tournament->games, tournament->capacity);
+    }
+}
+
+static double calculateAveragePlayTime(ChessSystem chess, int player_id, ChessResult* chess_result)
+{
+    if(chess == NULL)
+    {
+        *chess_result = CHESS_NULL_ARGUMENT;
+        return FAULT_AVERAGE_TIME;
+    }
+    if (player_id < MIN_ID_VALUE)
+    {
+        *chess_result = CHESS_INVALID_ID;
+        return FAULT_AVERAGE_TIME;
+    }
+
+    double average = FAULT_AVERAGE_TIME;
+    Version version = versionsPin(chess->versions);
+    if (version != NULL)
+    {
+        bool found = versionGetAveragePlayTime(version, player_id, &average);
+        versionsRelease(chess->versions, version);
+        *chess_result = found ? CHESS_SUCCESS : CHESS_PLAYER_NOT_EXIST;
+        return average;
+    }
+
+    lockSystem(chess->locks, false);
+    lockPlayers(chess->locks, player_id, player_id);
+    lockPlayersMap(chess->locks, false);
+    Player player = mapGet(chess->players, &player_id);
+    unlockPlayersMap(chess->locks);
+    *chess_result = CHESS_PLAYER_NOT_EXIST;
+    if (playerExists(player))
+    {
+        *chess_result = CHESS_SUCCESS;
+        average = playerGetAveragePlayTime(player);
+    }
+    unlockPlayers(chess->locks, player_id, player_id);
+    unlockSystem(chess->locks);
+    return average;
 }
 
-static bool addPlayersWithLevelToMap(Map all_players, Map players_map, double level)
+/**
+ * One requested id of chessGetPlayersStats, and where its answer goes.
+ * */
+typedef struct chess_stats_request_t {
+    int player_id;
+    int index; // in the caller's arrays
+} StatsRequest;
+
+ChessResult chessGetPlayersStats(ChessSystem chess, const int* ids, int n, ChessPlayerStats* out)
 {
-    MAP_FOREACH(int*, other_player_id, all_players)
+    if (n <= 0)
     {
-        Player other_player = mapGet(all_players, other_player_id);
-        if (playerGetLevel(other_player) == level)
+        return chess == NULL ? CHESS_NULL_ARGUMENT : CHESS_SUCCESS;
+    }
+    if (chess == NULL || ids == NULL || out == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+
+    StatsRequest* requests = (StatsRequest*)malloc(sizeof(StatsRequest) * n);
+    if (requests == NULL)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
+    int num_of_requests = 0;
+    for (int i = 0; i < n; i++)
+    {
+        fillPlayerStats(&out[i], NULL);
+        out[i].player_id = ids[i];
+        if (ids[i] < MIN_ID_VALUE)
         {
-            if (mapPut(players_map, other_player_id, other_player_id) != MAP_SUCCESS)
-            {
-                free(other_player_id);
-                return false;
-            }
+            out[i].result = CHESS_INVALID_ID;
+            continue;
         }
-        free(other_player_id);
+        requests[num_of_requests].player_id = ids[i];
+        requests[num_of_requests].index = i;
+        num_of_requests++;
     }
-    return true;
+    qsort(requests, num_of_requests, sizeof(StatsRequest), compareRequests);
+
+    // chess->players is sorted by id too, so one merge pass resolves all the requests
+    lockSystem(chess->locks, true);
+    removalsApplyAll(chess->removals, chess->players, chess->tournaments);
+    int next = 0;
+    MAP_FOREACH_AFTER(int*, player_id, chess->players, NULL)
+    {
+        while (next < num_of_requests && requests[next].player_id < *player_id)
+        {
+            next++; // not in the system, already marked as CHESS_PLAYER_NOT_EXIST
+        }
+        while (next < num_of_requests && requests[next].player_id == *player_id)
+        {
+            fillPlayerStats(&out[requests[next].index], mapGetCurrentData(chess->players));
+            next++;
+        }
+        if (next == num_of_requests)
+        {
+            break;
+        }
+    }
+    unlockSystem(chess->locks);
+
+    free(requests);
+    return CHESS_SUCCESS;
 }
 
-static bool printLevelsToFile(Map levels_map, FILE* file)
+static ChessResult savePlayersLevels(ChessSystem chess, FILE* file)
 {
-    MAP_FOREACH(double*, level, levels_map)
+    if(chess == NULL || file == NULL)
     {
-        Map players_map = mapGet(levels_map, level);
-        MAP_FOREACH(int*, id, players_map)
+        return CHESS_NULL_ARGUMENT;
+    }
+    Version version = versionsPin(chess->versions);
+    if (version != NULL)
+    {
+        ChessResult result = versionSavePlayersLevels(version, file, chess->pool);
+        versionsRelease(chess->versions, version);
+        return result;
+    }
+
+    lockSystem(chess->locks, true);
+    removalsApplyAll(chess->removals, chess->players, chess->tournaments);
+    int size = mapGetSize(chess->players);
+    PlayerLevel* levels = (PlayerLevel*)malloc(sizeof(PlayerLevel) * (size > 0 ? size : 1));
+    if (levels == NULL)
+    {
+        unlockSystem(chess->locks);
+        return CHESS_SAVE_FAILURE;
+    }
+    size = fillLevels(chess->players, levels);
+    unlockSystem(chess->locks);
+    // by level from the highest, then by id
+    poolSort(chess->pool, levels, size, sizeof(PlayerLevel), compareLevels);
+
+    Output output = outputForStream(file);
+    if (output == NULL)
+    {
+        free(levels);
+        return CHESS_SAVE_FAILURE;
+    }
+    outputItems(output, size, printLevel, levels, chess->pool);
+    free(levels);
+    if (!outputClose(output))
+    {
+        return CHESS_SAVE_FAILURE;
+    }
+
+    return CHESS_SUCCESS;
+}
+
+/**
+ * Fill levels with the players whose level is not 0, and return how many there are.
+ * */
+static int fillLevels(Map players, PlayerLevel* levels)
+{
+    int size = 0;
+    MAP_FOREACH(int*, player_id, players)
+    {
+        double level = playerGetLevel(mapGet(players, player_id));
+        if (level != 0.0)
         {
-            if (fprintf(file, "%d %.2lf\n", *id, *level) < 0)
-            {
-                free(id);
-                free(level);
-                return false;
-            }
-            free(id);
+            levels[size].player_id = *player_id;
+            levels[size].level = level;
+            size++;
         }
-        free(level);
+        free(player_id);
     }
-    return true;
+    return size;
 }
 
-ChessResult chessSaveTournamentStatistics(ChessSystem chess, char* path_file)
+static int compareLevels(const void* level1, const void* level2)
+{
+    const PlayerLevel* player1 = (const PlayerLevel*)level1;
+    const PlayerLevel* player2 = (const PlayerLevel*)level2;
+    if (player1->level != player2->level)
+    {
+        return player1->level > player2->level ? -1 : 1;
+    }
+    return (player1->player_id > player2->player_id) - (player1->player_id < player2->player_id);
+}
+
+static void printLevel(Output output, int index, void* levels)
+{
+    const PlayerLevel* player = &((const PlayerLevel*)levels)[index];
+    outputInt(output, player->player_id);
+    outputChar(output, ' ');
+    outputFixed2(output, player->level);
+    outputChar(output, '\n');
+}
+
+static ChessResult saveTournamentStatistics(ChessSystem chess, char* path_file)
 {
     if (chess == NULL)
     {
         return CHESS_NULL_ARGUMENT;
     }
-    FILE* stream = fopen(path_file, "w+");
-    if (stream == NULL)
+    Version version = versionsPin(chess->versions);
+    if (version != NULL)
+    {
+        ChessResult result = versionSaveTournamentStatistics(version, path_file, chess->pool);
+        versionsRelease(chess->versions, version);
+        return result;
+    }
+    Output output = outputOpen(path_file);
+    if (output == NULL)
     {
         return CHESS_SAVE_FAILURE;
     }
     int ended_tournaments = 0;
-    if (!printTournamentStatistics(chess->tournaments, chess->players, stream, &ended_tournaments))
+    lockSystem(chess->locks, true);
+    printTournamentStatistics(chess->tournaments, output, &ended_tournaments, chess->pool);
+    unlockSystem(chess->locks);
+    if (!outputClose(output))
     {
-        fclose(stream);
         return CHESS_SAVE_FAILURE;
     }
 
     if (ended_tournaments < 1)
     {
-        fclose(stream);
         return CHESS_NO_TOURNAMENTS_ENDED;
     }
-    fclose(stream);
     return CHESS_SUCCESS;
 }
 
-static bool printTournamentStatistics(Map tournaments, Map players, FILE* stream, int* ended_tournaments)
+/**
+ * Collect the ended tournaments in id order, and let outputItems format them on the pool.
+ * Without the memory to collect them they are written one by one.
+ * */
+static void printTournamentStatistics(Map tournaments, Output output, int* ended_tournaments, Pool pool)
 {
+    int size = mapGetSize(tournaments);
+    Tournament* ended = (Tournament*)malloc(sizeof(Tournament) * (size > 0 ? size : 1));
     MAP_FOREACH(int*, tournament_id, tournaments)
     {
         Tournament tournament = mapGet(tournaments, tournament_id);
         if (tournamentHasEnded(tournament))
         {
-            (*ended_tournaments)++;
-            
-            if (!tournamentPrintStatistics(tournament, stream, players))
+            if (ended != NULL)
             {
-                free(tournament_id);
-                return false;
+                ended[*ended_tournaments] = tournament;
+            }
+            else
+            {
+                tournamentPrintStatistics(tournament, output);
             }
+            (*ended_tournaments)++;
         }
         free(tournament_id);
     }
-    return true;
+    if (ended != NULL)
+    {
+        outputItems(output, *ended_tournaments, printEndedTournament, ended, pool);
+        free(ended);
+    }
+}
+
+static void printEndedTournament(Output output, int index, void* ended)
+{
+    tournamentPrintStatistics(((Tournament*)ended)[index], output);
+}
+
+bool chessPlayerOncePlayed(ChessSystem chess, int player_id)
+{
+    if (chess == NULL || player_id < MIN_ID_VALUE)
+    {
+        return false;
+    }
+    lockSystem(chess->locks, false);
+    lockPlayers(chess->locks, player_id, player_id);
+    lockPlayersMap(chess->locks, false);
+    bool once_played = playerExists(mapGet(chess->players, &player_id)) || bitmapGet(chess->former_players, player_id);
+    unlockPlayersMap(chess->locks);
+    unlockPlayers(chess->locks, player_id, player_id);
+    unlockSystem(chess->locks);
+    return once_played;
+}
+
+ChessResult chessEnableSnapshotReads(ChessSystem chess)
+{
+    if (chess == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    if (chess->versions == NULL)
+    {
+        removalsApplyAll(chess->removals, chess->players, chess->tournaments);
+        chess->versions = versionsCreate(chess->players, chess->tournaments, chess->locations);
+    }
+    return chess->versions == NULL ? CHESS_OUT_OF_MEMORY : CHESS_SUCCESS;
 }
 
-// ------------------ POINTER FUNCTIONS IMPLEMENTATIONS ---------------- //
+ChessResult chessEnableConcurrency(ChessSystem chess)
+{
+    if (chess == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    if (chess->locks == NULL)
+    {
+        removalsApplyAll(chess->removals, chess->players, chess->tournaments);
+        chess->locks = locksCreate();
+    }
+    return chess->locks == NULL ? CHESS_OUT_OF_MEMORY : CHESS_SUCCESS;
+}
 
-static MapDataElement copyMapFunction(MapDataElement data)
+int chessGetWorkerCounters(ChessSystem chess, ChessWorkerCounters* counters, int capacity)
 {
-    return mapCopy((Map)data);
+    return chess == NULL ? 0 : poolGetCounters(chess->pool, counters, capacity);
 }
 
-static void freeMapFunction(MapDataElement data)
+ChessResult chessSetGameStorage(ChessSystem chess, const char* dir)
 {
-    mapDestroy((Map)data);
+    if (chess == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    char* directory = NULL;
+    if (dir != NULL)
+    {
+        if (access(dir, W_OK | X_OK) != 0)
+        {
+            return CHESS_SAVE_FAILURE;
+        }
+        directory = (char*)malloc(strlen(dir) + 1);
+        if (directory == NULL)
+        {
+            return CHESS_OUT_OF_MEMORY;
+        }
+        strcpy(directory, dir);
+    }
+    free(chess->games_directory);
+    chess->games_directory = directory;
+    return CHESS_SUCCESS;
 }
 
-static int compareDecending(MapKeyElement key1, MapKeyElement key2)
+void chessCompact(ChessSystem chess)
 {
-    if (key1 == NULL && key2 == NULL) 
+    if (chess == NULL)
     {
-        return 0;
+        return;
     }
-    if (key1 == NULL) 
+
+    // players without games are normally released right away, these are leftovers of failed mallocs
+    int num_of_empty = 0;
+    int* empty_ids = (int*)malloc(sizeof(int) * mapGetSize(chess->players));
+    if (empty_ids != NULL)
     {
-        return (int)(*((double*)key2));
+        MAP_FOREACH(int*, player_id, chess->players)
+        {
+            if (!playerExists(mapGet(chess->players, player_id)))
+            {
+                empty_ids[num_of_empty++] = *player_id;
+            }
+            free(player_id);
+        }
+        for (int i = 0; i < num_of_empty; i++)
+        {
+            if (bitmapSet(chess->former_players, empty_ids[i]))
+            {
+                mapRemove(chess->players, &empty_ids[i]);
+            }
+        }
+        free(empty_ids);
     }
-    if (key2 == NULL)
+
+    MAP_FOREACH(int*, tournament_id, chess->tournaments)
     {
-        return (int)(*((double*)key1));
+        Tournament tournament = mapGet(chess->tournaments, tournament_id);
+        if (tournamentHasEnded(tournament))
+        {
+            tournamentFreeze(tournament);
+        }
+        free(tournament_id);
     }
 
-    return (*((double*)key2) > *((double*)key1)) ? 1 : ((*((double*)key2) == *((double*)key1)) ? 0 : -1);
+    bitmapCompact(chess->former_players);
 }
 
-static MapKeyElement copyDoubleKey(MapKeyElement key)
+static int compareEndRequests(const void* request1, const void* request2)
 {
-    if (key == NULL)
+    const EndRequest* end_request1 = (const EndRequest*)request1;
+    const EndRequest* end_request2 = (const EndRequest*)request2;
+    int id1 = end_request1->tournament_id;
+    int id2 = end_request2->tournament_id;
+    if (id1 != id2)
     {
-        return NULL;
+        return (id1 > id2) - (id1 < id2);
     }
-    MapKeyElement new_key = (MapKeyElement)malloc(sizeof(double));
-    if (new_key == NULL)
+    return end_request1->index - end_request2->index;
+}
+
+static int compareRequests(const void* request1, const void* request2)
+{
+    int id1 = ((const StatsRequest*)request1)->player_id;
+    int id2 = ((const StatsRequest*)request2)->player_id;
+    return (id1 > id2) - (id1 < id2);
+}
+
+/**
+ * Fill stats with the statistics of player, or mark it as not existing if player is NULL or has no games.
+ * player_id is left as is.
+ * */
+static void fillPlayerStats(ChessPlayerStats* stats, Player player)
+{
+    if (!playerExists(player))
     {
-        return NULL;
+        stats->result = CHESS_PLAYER_NOT_EXIST;
+        stats->average_play_time = FAULT_AVERAGE_TIME;
+        stats->level = 0.0;
+        stats->wins = 0;
+        stats->losses = 0;
+        stats->draws = 0;
+        return;
     }
-    *((double*)new_key) = *((double*)key);
-    return new_key;
-}
\ No newline at end of file
+    stats->result = CHESS_SUCCESS;
+    stats->average_play_time = playerGetAveragePlayTime(player);
+    stats->level = playerGetLevel(player);
+    stats->wins = playerGetNumOfWins(player);
+    stats->losses = playerGetNumOfLoses(player);
+    stats->draws = playerGetNumOfDraws(player);
+}
@@ -0,0 +1,835 @@
+#ifndef _CHESSSYSTEMEXT_H_
+#define _CHESSSYSTEMEXT_H_
+
+#include "chessSystem.h"
+#include <stdbool.h>
+
+/**
+ * Additions to the interface of chessSystem.h.
+ * */
+
+/**
+ * chessPlayerOncePlayed: checks whether a player has ever played in the system.
+ * Removed players, and players whose games were all removed with their tournaments,
+ * are not kept in the system, only their ids are remembered.
+ *
+ * @param chess - chess system to check. Must be non-NULL.
+ * @param player_id - the player id.
+ *
+ * @return
+ *     true if the player currently has games, or had games in the past, false otherwise.
+ */
+bool chessPlayerOncePlayed(ChessSystem chess, int player_id);
+
+/**
+ * The statistics of one player, as returned by chessGetPlayersStats.
+ * */
+typedef struct chess_player_stats_t {
+    int player_id;
+    ChessResult result;       // CHESS_SUCCESS, CHESS_INVALID_ID or CHESS_PLAYER_NOT_EXIST
+    double average_play_time; // the rest of the fields are 0 unless result is CHESS_SUCCESS
+    double level;
+    int wins;
+    int losses;
+    int draws;
+} ChessPlayerStats;
+
+/**
+ * chessGetPlayersStats: returns the statistics of many players at once.
+ * The ids are sorted and resolved together in one pass over the players,
+ * which is much cheaper than calling chessCalculateAveragePlayTime once per id.
+ *
+ * @param chess - chess system that contains the players. Must be non-NULL.
+ * @param ids - the ids of the players, in any order (duplicates are allowed).
+ * @param n - the number of ids.
+ * @param out - array of n elements, out[i] is filled with the statistics of ids[i].
+ *
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess, ids or out are NULL (and n > 0).
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SUCCESS - otherwise, the result of each id is in out[i].result.
+ */
+ChessResult chessGetPlayersStats(ChessSystem chess, const int* ids, int n, ChessPlayerStats* out);
+
+/**
+ * Formats of files read by chessLoadGamesFromFile.
+ *     CHESS_FORMAT_CSV - one game per line: "tournament_id,first_player,second_player,winner,play_time",
+ *         where winner is the value of the Winner enum (0 - FIRST_PLAYER, 1 - SECOND_PLAYER, 2 - DRAW).
+ *         Empty lines are skipped.
+ *     CHESS_FORMAT_BINARY - one game per 20 bytes record: the same 5 fields as 32 bit little endian integers.
+ * */
+typedef enum {
+    CHESS_FORMAT_CSV,
+    CHESS_FORMAT_BINARY
+} ChessFileFormat;
+
+/**
+ * A record of the file that was not added, as reported by chessLoadGamesFromFile.
+ * */
+typedef struct chess_load_error_t {
+    long record;        // the line number (from 1) in CSV, the record index (from 0) in binary
+    bool malformed;     // true if the record could not be parsed
+    ChessResult result; // otherwise, what chessAddGame returned for it
+} ChessLoadError;
+
+typedef void (*ChessLoadErrorHandler)(const ChessLoadError* error, void* context);
+
+/**
+ * chessLoadGamesFromFile: adds all the games of a file to the system, in file order.
+ * The file is memory mapped and parsed in place, every game goes through chessAddGame.
+ * With workers (see chessCreateWithOptions), the games of the tournaments that are open and have no games
+ * yet are added on all the threads, each tournament to a system of one thread, and these systems are merged
+ * into chess (see chessMerge); the other games are added after them. The system ends up the same, and every
+ * record is reported the same, once all of them were added. This is not done while the system is shared,
+ * traced, journaled, subscribed to, or stores its games in files.
+ *
+ * @param chess - chess system to add the games to. Must be non-NULL.
+ * @param path - the file to read. Must be non-NULL.
+ * @param format - the format of the file.
+ * @param on_error - called for every record that was not added. May be NULL.
+ * @param context - passed as is to on_error.
+ *
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess or path are NULL.
+ *     CHESS_SAVE_FAILURE - if the file could not be read (used for any I/O failure).
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed. The games before the failing record were added
+ *         (with workers, some of the games were added, and no record was reported).
+ *     CHESS_SUCCESS - otherwise, even if some of the records were reported to on_error.
+ */
+ChessResult chessLoadGamesFromFile(ChessSystem chess, const char* path, ChessFileFormat format,
+                                   ChessLoadErrorHandler on_error, void* context);
+
+/**
+ * chessSaveSnapshot: saves the whole state of the system to a binary file,
+ * so it can be restored by chessLoadSnapshot without replaying every game.
+ * The file is versioned and checksummed. It is written next to path and renamed over it
+ * at the end, so an existing snapshot is never left half written.
+ *
+ * @param chess - chess system to save. Must be non-NULL.
+ * @param path - the file to write. Must be non-NULL.
+ *
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess or path are NULL.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SAVE_FAILURE - if the file could not be written.
+ *     CHESS_SUCCESS - otherwise.
+ */
+ChessResult chessSaveSnapshot(ChessSystem chess, const char* path);
+
+/**
+ * chessLoadSnapshot: creates a new chess system from a file written by chessSaveSnapshot.
+ *
+ * @param path - the file to read. Must be non-NULL.
+ * @param result - set to the result of the operation. Must be non-NULL.
+ *     CHESS_NULL_ARGUMENT - if path is NULL.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SAVE_FAILURE - if the file could not be read, or is not a valid snapshot
+ *         (wrong version, wrong checksum, ...).
+ *     CHESS_SUCCESS - otherwise.
+ *
+ * @return
+ *     The new system, or NULL if result is not CHESS_SUCCESS.
+ */
+ChessSystem chessLoadSnapshot(const char* path, ChessResult* result);
+
+/**
+ * Group commit bounds of a journal. A 0 field takes its default.
+ * */
+typedef struct chess_journal_options_t {
+    int max_batch_records; // fsync once that many records are waiting (default 64)
+    int max_delay_ms;      // or once the oldest waiting record is that old (default 10)
+} ChessJournalOptions;
+
+/**
+ * chessJournalOpen: starts journaling the system. From now on every successful
+ * chessAddTournament, chessAddGame, chessRemoveTournament, chessRemovePlayer and
+ * chessEndTournament appends a record to a log. Records are written and fsync'd in batches by
+ * a background thread, so these calls don't wait for the disk; a record is durable within the
+ * bounds of options, or once chessJournalSync returns.
+ *
+ * The journal is kept in files named path.<n>.log and path.<n>.snap. If there are none,
+ * and the system is not empty, a snapshot of it is written first. If there are, the system
+ * must be the one chessRecoverFromJournal(path) returned.
+ * A journal that is already open is closed first. chessDestroy closes the journal.
+ *
+ * @param chess - chess system to journal. Must be non-NULL.
+ * @param path - the base name of the journal files. Must be non-NULL.
+ * @param options - group commit bounds, or NULL for the defaults.
+ *
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess or path are NULL.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SAVE_FAILURE - if the journal files could not be written.
+ *     CHESS_SUCCESS - otherwise.
+ */
+ChessResult chessJournalOpen(ChessSystem chess, const char* path, const ChessJournalOptions* options);
+
+/**
+ * chessJournalSync: waits until every record appended so far is fsync'd.
+ *
+ * @param chess - chess system. Must be non-NULL.
+ *
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess is NULL.
+ *     CHESS_SAVE_FAILURE - if any record of the journal could not be kept or written,
+ *         so it can't be trusted to restore the system anymore.
+ *     CHESS_SUCCESS - otherwise (also if no journal is open).
+ */
+ChessResult chessJournalSync(ChessSystem chess);
+
+/**
+ * chessJournalCompact: folds the journal into a fresh snapshot, so recovery doesn't
+ * replay it anymore. New records go to a new log right away, and the snapshot is written
+ * by a forked process from a copy-on-write image of the system, so the caller doesn't
+ * wait for it. The old files are deleted once the snapshot is complete, which is noticed
+ * by the next call to chessJournalSync or chessJournalCompact.
+ * Does nothing if a compaction is still running.
+ * Once games were stored in files (see chessSetGameStorage), which a forked process shares instead
+ * of copying, the call waits for the snapshot.
+ *
+ * @param chess - chess system. Must be non-NULL.
+ *
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess is NULL.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SAVE_FAILURE - if no journal is open, or the compaction could not be started.
+ *     CHESS_SUCCESS - otherwise.
+ */
+ChessResult chessJournalCompact(ChessSystem chess);
+
+/**
+ * chessRecoverFromJournal: rebuilds a system from the files of a journal: its latest
+ * snapshot, then every record logged after it. A torn record at the end of a log
+ * (the process died while writing it) ends that log.
+ * If there are no journal files, returns a new empty system.
+ * The journal is not reopened, call chessJournalOpen with the same path to continue it.
+ *
+ * @param path - the base name of the journal files. Must be non-NULL.
+ * @param result - set to the result of the operation. Must be non-NULL.
+ *     CHESS_NULL_ARGUMENT - if path is NULL.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SAVE_FAILURE - if the files could not be read, or are not valid.
+ *     CHESS_SUCCESS - otherwise.
+ *
+ * @return
+ *     The recovered system, or NULL if result is not CHESS_SUCCESS.
+ */
+ChessSystem chessRecoverFromJournal(const char* path, ChessResult* result);
+
+/**
+ * chessExportColumnar: exports every game and the statistics of every player, one file per column,
+ * so analytics can load only the columns they need.
+ * Games (by tournament, in the order they were added): tournament_id, player1, player2, winner
+ * (a Winner; a removed player's id is 0), length. Players (by id): id, wins, losses, draws, total_time.
+ * Columns are written in independent blocks, bit-packed from the smallest value of the block;
+ * sorted columns pack the differences between values instead. The file "schema" lists the tables,
+ * their number of rows, and the type, encoding and file of every column.
+ *
+ * @param chess - chess system to export. Must be non-NULL.
+ * @param dir - the directory to write to. Created if it does not exist. Must be non-NULL.
+ *
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess or dir are NULL.
+ *     CHESS_SAVE_FAILURE - if any file could not be written.
+ *     CHESS_SUCCESS - otherwise.
+ */
+ChessResult chessExportColumnar(ChessSystem chess, const char* dir);
+
+/**
+ * Maps a name found in a PGN file (an Event, or a White/Black player) to an id of the system.
+ * */
+typedef int (*ChessPgnNameMapper)(const char* name, void* context);
+
+typedef struct chess_pgn_options_t {
+    ChessPgnNameMapper tournament_id; // Event -> tournament id. Must be non-NULL.
+    ChessPgnNameMapper player_id;     // White, Black -> player id. Must be non-NULL.
+    void* context;                    // passed to both mappers
+    int max_games_per_player;         // of the tournaments created by the import
+    int num_of_threads;               // parsing threads, 0 for one per online CPU
+    ChessLoadErrorHandler on_error;   // may be NULL
+    void* error_context;
+} ChessPgnOptions;
+
+/**
+ * chessImportPGN: adds the games of a PGN file to the system.
+ * The file is memory mapped, split into chunks at game boundaries, and the tag pairs of the
+ * chunks are parsed in parallel. The games are then added in file order through
+ * chessAddTournament (with Site as the location, when the Event is new) and chessAddGame, so the
+ * result does not depend on the number of threads. The mappers are called in that order too,
+ * from the calling thread only.
+ * Every game starts with its Event tag, as in the Seven Tag Roster. The play time is taken from
+ * GameDuration, or from EndTime - StartTime (HH:MM:SS).
+ * Games without a Site, a White, a Black, a final Result or a play time are reported as malformed;
+ * games the system rejects are reported with the result of the call that rejected them.
+ * Records are game indexes in the file, from 0.
+ *
+ * @param chess - chess system to add the games to. Must be non-NULL.
+ * @param path - the PGN file. Must be non-NULL.
+ * @param options - the mappers and the rest of the options. Must be non-NULL.
+ *
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess, path, options or one of the mappers are NULL.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed. Games before the failure were added.
+ *     CHESS_SAVE_FAILURE - if the file could not be read.
+ *     CHESS_SUCCESS - otherwise, even if some games were reported.
+ */
+ChessResult chessImportPGN(ChessSystem chess, const char* path, const ChessPgnOptions* options);
+
+/**
+ * chessCompact: reclaims memory that the system no longer needs:
+ *     - pages of the once-played ids that became empty,
+ *     - players left without games, that could not be released earlier (for lack of memory),
+ *     - games of ended tournaments that could not be frozen earlier (for lack of memory).
+ * Never changes the result of any query.
+ *
+ * @param chess - chess system to compact. If NULL, nothing happens.
+ */
+void chessCompact(ChessSystem chess);
+
+/**
+ * chessSetGameStorage: chooses where the games of the tournaments added from now on are stored.
+ * By default games are kept in memory. With a directory, the games of every new tournament are kept
+ * in files of that directory, mapped into memory a segment at a time, so the system can page them
+ * out: only the statistics of the tournaments and players, and an index of the segments, stay in RAM.
+ * Ending a tournament moves its games to a compact file of their own. Every query works as before,
+ * reading the games from the files when it needs them. The files are removed (unlinked) as soon as
+ * they are created, so nothing is left in the directory after the system is destroyed, or if the
+ * process dies. A tournament whose file can't be created keeps its games in memory.
+ * Tournaments that already exist, and tournaments loaded from a snapshot, keep their games in memory.
+ *
+ * @param chess - chess system to configure. Must be non-NULL.
+ * @param dir - a writable directory, or NULL to keep the games of new tournaments in memory again.
+ *
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess is NULL.
+ *     CHESS_SAVE_FAILURE - if dir is not a writable directory.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SUCCESS - otherwise.
+ */
+ChessResult chessSetGameStorage(ChessSystem chess, const char* dir);
+
+/**
+ * Cursors stream the state of the system into buffers of the caller, a batch at a time,
+ * in constant memory: rows are copied by value, and a cursor holds nothing but its position.
+ * A cursor may stay open while the system changes. Rows removed or added meanwhile may or may not
+ * be returned, but the rest are returned exactly once, in order.
+ * A cursor must be closed before the system it reads is destroyed.
+ * */
+typedef struct chess_games_cursor_t *ChessGamesCursor;
+typedef struct chess_players_cursor_t *ChessPlayersCursor;
+typedef struct chess_tournaments_cursor_t *ChessTournamentsCursor;
+
+typedef struct chess_game_row_t {
+    int tournament_id;
+    int first_player;  // 0 if the player was removed
+    int second_player; // 0 if the player was removed
+    Winner winner;
+    int play_time;
+} ChessGameRow;
+
+typedef struct chess_tournament_row_t {
+    int tournament_id;
+    const char* location; // owned by the system, valid until the tournament is removed
+    int max_games_per_player;
+    bool ended;
+    int winner_id;        // 0 if the tournament has not ended
+    int num_of_games;
+    int num_of_players;
+    int longest_game_time;
+    double average_game_time;
+} ChessTournamentRow;
+
+/**
+ * chessGamesCursorOpen: opens a cursor over the games of a tournament, in the order they were added.
+ *
+ * @param chess - chess system that contains the tournament. Must be non-NULL.
+ * @param tournament_id - the tournament id.
+ * @param result - if non-NULL, receives the result of the call.
+ *
+ * @return
+ *     The new cursor, or NULL if an error occurred. The result is:
+ *     CHESS_NULL_ARGUMENT - if chess is NULL.
+ *     CHESS_INVALID_ID - if tournament_id is not positive.
+ *     CHESS_TOURNAMENT_NOT_EXIST - if the tournament does not exist.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SUCCESS - otherwise.
+ */
+ChessGamesCursor chessGamesCursorOpen(ChessSystem chess, int tournament_id, ChessResult* result);
+
+/**
+ * chessGamesCursorNext: copies the next games of a cursor into rows.
+ * Once the tournament is removed, the cursor returns no more games.
+ *
+ * @param cursor - the cursor. Must be non-NULL.
+ * @param rows - buffer of capacity rows.
+ * @param capacity - the maximal number of rows to return.
+ *
+ * @return
+ *     The number of rows written, 0 once every game was returned (or if cursor or rows are NULL).
+ */
+int chessGamesCursorNext(ChessGamesCursor cursor, ChessGameRow* rows, int capacity);
+
+void chessGamesCursorClose(ChessGamesCursor cursor);
+
+/**
+ * chessPlayersCursorOpen: opens a cursor over the statistics of the players of the system,
+ * by increasing id. Rows are as returned by chessGetPlayersStats, result is always CHESS_SUCCESS.
+ * NOTE: the Map of players can only be read from its first element, so every batch starts with
+ * a walk to where the previous one ended. Prefer large batches over many small ones.
+ *
+ * @param chess - chess system to read. Must be non-NULL.
+ * @param result - if non-NULL, receives the result of the call.
+ *
+ * @return
+ *     The new cursor, or NULL if an error occurred. The result is:
+ *     CHESS_NULL_ARGUMENT - if chess is NULL.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SUCCESS - otherwise.
+ */
+ChessPlayersCursor chessPlayersCursorOpen(ChessSystem chess, ChessResult* result);
+
+/**
+ * chessPlayersCursorNext: like chessGamesCursorNext, for the players.
+ */
+int chessPlayersCursorNext(ChessPlayersCursor cursor, ChessPlayerStats* rows, int capacity);
+
+void chessPlayersCursorClose(ChessPlayersCursor cursor);
+
+/**
+ * chessTournamentsCursorOpen: opens a cursor over the tournaments of the system, by increasing id.
+ * Batches are read like the players' (see chessPlayersCursorOpen).
+ *
+ * @param chess - chess system to read. Must be non-NULL.
+ * @param result - if non-NULL, receives the result of the call.
+ *
+ * @return
+ *     The new cursor, or NULL if an error occurred. The result is:
+ *     CHESS_NULL_ARGUMENT - if chess is NULL.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SUCCESS - otherwise.
+ */
+ChessTournamentsCursor chessTournamentsCursorOpen(ChessSystem chess, ChessResult* result);
+
+/**
+ * chessTournamentsCursorNext: like chessGamesCursorNext, for the tournaments.
+ */
+int chessTournamentsCursorNext(ChessTournamentsCursor cursor, ChessTournamentRow* rows, int capacity);
+
+void chessTournamentsCursorClose(ChessTournamentsCursor cursor);
+
+
+/**
+ * A save running in the background, see chessSaveTournamentStatisticsAsync.
+ * */
+typedef struct chess_save_t *ChessSave;
+
+/**
+ * chessSaveTournamentStatisticsAsync: like chessSaveTournamentStatistics, but returns at once.
+ * The file is written by a child process, which sees the system as it was when the call was made
+ * (the pages of memory are shared copy-on-write), so the system can go on changing meanwhile.
+ * If a process can't be started, the file is written before returning.
+ *
+ * @param chess - chess system to save. Must be non-NULL.
+ * @param path_file - the file to write.
+ * @param result - if non-NULL, receives the result of the call.
+ *
+ * @return
+ *     The running save, to be given to chessSaveWait, or NULL if an error occurred. The result is:
+ *     CHESS_NULL_ARGUMENT - if chess is NULL.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SUCCESS - otherwise. The result of the save itself is returned by chessSaveWait.
+ */
+ChessSave chessSaveTournamentStatisticsAsync(ChessSystem chess, char* path_file, ChessResult* result);
+
+/**
+ * chessSavePlayersLevelsAsync: like chessSavePlayersLevels, but returns at once,
+ * see chessSaveTournamentStatisticsAsync.
+ * The stream must not be used until chessSaveWait returns. A stream that has no file descriptor
+ * (such as a memory stream) is written before returning.
+ *
+ * @param chess - chess system to save. Must be non-NULL.
+ * @param file - the stream to write to. Must be non-NULL.
+ * @param result - if non-NULL, receives the result of the call.
+ *
+ * @return
+ *     As chessSaveTournamentStatisticsAsync, with CHESS_NULL_ARGUMENT if chess or file are NULL.
+ */
+ChessSave chessSavePlayersLevelsAsync(ChessSystem chess, FILE* file, ChessResult* result);
+
+/**
+ * chessSavePoll: checks whether a save is over, without waiting.
+ *
+ * @param save - the save. If NULL, true is returned.
+ *
+ * @return
+ *     true if chessSaveWait would return at once, false otherwise.
+ */
+bool chessSavePoll(ChessSave save);
+
+/**
+ * chessSaveWait: waits for a save to be over and releases it.
+ *
+ * @param save - the save. Must be non-NULL.
+ *
+ * @return
+ *     CHESS_NULL_ARGUMENT - if save is NULL.
+ *     Otherwise the result of the synchronous save (CHESS_SAVE_FAILURE also if its process was killed).
+ */
+ChessResult chessSaveWait(ChessSave save);
+
+/**
+ * The calls of chessSystem.h recorded in a trace.
+ * */
+typedef enum {
+    CHESS_TRACE_ADD_TOURNAMENT = 1,          // tournament id, max games per player, then the location
+    CHESS_TRACE_ADD_GAME,                    // tournament id, first player, second player, winner, play time
+    CHESS_TRACE_REMOVE_TOURNAMENT,           // tournament id
+    CHESS_TRACE_REMOVE_PLAYER,               // player id
+    CHESS_TRACE_END_TOURNAMENT,              // tournament id
+    CHESS_TRACE_CALCULATE_AVERAGE_PLAY_TIME, // player id
+    CHESS_TRACE_SAVE_PLAYERS_LEVELS,         // the stream: 1 for stdout, 2 for stderr, 0 for another, -1 for NULL
+    CHESS_TRACE_SAVE_TOURNAMENT_STATISTICS   // then the path
+} ChessTraceCall;
+
+#define CHESS_TRACE_MAX_ARGS 5
+
+/**
+ * One call read from a trace.
+ * */
+typedef struct chess_trace_record_t {
+    ChessTraceCall call;
+    int args[CHESS_TRACE_MAX_ARGS]; // as listed in ChessTraceCall, the rest are 0
+    const char* text;               // the location or the path (NULL if it was NULL), valid until the next read
+    ChessResult result;
+    double average_play_time;       // the value returned by chessCalculateAveragePlayTime, 0 for other calls
+    long long latency;              // in nanoseconds
+} ChessTraceRecord;
+
+typedef struct chess_trace_reader_t *ChessTraceReader;
+
+/**
+ * chessTraceOpen: starts recording every call of chessSystem.h made on the system (after chessCreate and
+ * before chessDestroy, which closes the trace) into a compact binary file: its arguments, its result and
+ * how long it took. Calls that fail are recorded too.
+ * If the system is not empty, it is saved first to the snapshot "<path>.snap" (see chessSaveSnapshot),
+ * so the trace can be replayed from the same state. An open trace is closed first.
+ *
+ * @param chess - chess system to trace. Must be non-NULL.
+ * @param path - the trace file. Must be non-NULL.
+ *
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess or path are NULL.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SAVE_FAILURE - if the trace or the snapshot could not be written.
+ *     CHESS_SUCCESS - otherwise.
+ */
+ChessResult chessTraceOpen(ChessSystem chess, const char* path);
+
+/**
+ * chessTraceClose: stops recording and writes what is left of the trace.
+ *
+ * @param chess - chess system. Must be non-NULL.
+ *
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess is NULL.
+ *     CHESS_SAVE_FAILURE - if no trace is open, or some of it could not be written.
+ *     CHESS_SUCCESS - otherwise.
+ */
+ChessResult chessTraceClose(ChessSystem chess);
+
+/**
+ * chessTraceReaderOpen: opens a trace written by chessTraceOpen.
+ *
+ * @param path - the trace file. Must be non-NULL.
+ * @param result - if non-NULL, receives the result of the call.
+ *
+ * @return
+ *     The reader, or NULL if an error occurred. The result is:
+ *     CHESS_NULL_ARGUMENT - if path is NULL.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SAVE_FAILURE - if the file could not be read, or is not a trace.
+ *     CHESS_SUCCESS - otherwise.
+ */
+ChessTraceReader chessTraceReaderOpen(const char* path, ChessResult* result);
+
+/**
+ * chessTraceReaderHasSnapshot: returns whether the trace starts from the snapshot "<path>.snap",
+ * rather than from an empty system.
+ */
+bool chessTraceReaderHasSnapshot(ChessTraceReader reader);
+
+/**
+ * chessTraceReaderNext: reads the next call of a trace.
+ * A record cut at the end of the file (the process died while writing it) ends the trace.
+ *
+ * @return
+ *     false if there are no more calls (or if reader or record are NULL), true otherwise.
+ */
+bool chessTraceReaderNext(ChessTraceReader reader, ChessTraceRecord* record);
+
+void chessTraceReaderClose(ChessTraceReader reader);
+
+/**
+ * chessEnableConcurrency: lets several threads share the system.
+ * From then on the calls of chessSystem.h, chessPlayerOncePlayed, chessGetPlayersStats and the
+ * asynchronous saves may be made from any thread at the same time. chessAddGame and
+ * chessCalculateAveragePlayTime only lock their tournament and their players (by stripes of ids),
+ * so games added to different tournaments are added in parallel. Every other call of chessSystem.h
+ * has the system to itself for as long as it runs, since the maps of the system are walked by a
+ * single iterator. The rest of this header still needs the system to itself: no other thread may
+ * use it meanwhile.
+ * Must be called before the system is shared. Calling it again does nothing.
+ *
+ * @param chess - chess system. Must be non-NULL.
+ *
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess is NULL.
+ *     CHESS_OUT_OF_MEMORY - if the locks could not be created.
+ *     CHESS_SUCCESS - otherwise.
+ */
+ChessResult chessEnableConcurrency(ChessSystem chess);
+
+/**
+ * chessEnableSnapshotReads: makes chessCalculateAveragePlayTime, chessSavePlayersLevels and
+ * chessSaveTournamentStatistics read an immutable version of the system instead of the system itself.
+ * Every change publishes a new version, copying only the few entries it changed. A query pins the
+ * latest version and never waits for the changes made meanwhile, even on a system shared by several
+ * threads (see chessEnableConcurrency), and what it reads is the system as it was between two changes.
+ * A version is released once no query reads it, or any version older than it.
+ * The results are the same as without it. If a version can't be published (out of memory), the
+ * queries read the system itself until a later removal publishes a complete version again.
+ * Must be called before the system is shared. Calling it again does nothing.
+ *
+ * @param chess - chess system. Must be non-NULL.
+ *
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess is NULL.
+ *     CHESS_OUT_OF_MEMORY - if the first version could not be built.
+ *     CHESS_SUCCESS - otherwise.
+ */
+ChessResult chessEnableSnapshotReads(ChessSystem chess);
+
+/**
+ * chessEndTournaments: ends many tournaments at once.
+ * The ids are resolved together in one pass over the tournaments, the winners are calculated
+ * on several threads, and all of them are saved before any other call can see the system.
+ * results[i] is what chessEndTournament(chess, ids[i]) would return if the ids were ended
+ * one by one in this order: an id that appears again after it was ended gets CHESS_TOURNAMENT_ENDED.
+ *
+ * @param chess - chess system that contains the tournaments. Must be non-NULL.
+ * @param ids - the ids of the tournaments, in any order.
+ * @param n - the number of ids.
+ * @param results - array of n elements, results[i] is set to the result of ids[i].
+ *
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess, ids or results are NULL (and n > 0).
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed, no tournament is ended.
+ *     CHESS_SUCCESS - otherwise, the result of each id is in results[i].
+ */
+ChessResult chessEndTournaments(ChessSystem chess, const int* ids, int n, ChessResult* results);
+
+/**
+ * chessRemovePlayers: removes many players at once.
+ * The ids are put in a set, and the games of all the players are found in one pass over the open tournaments
+ * they played in (on several threads), instead of one pass per player. A game of two removed players is left
+ * without players. The system ends up as if the ids were removed one by one by chessRemovePlayer in this order,
+ * and results[i] is what that call would return: an id that appears again gets CHESS_PLAYER_NOT_EXIST.
+ *
+ * @param chess - chess system that contains the players. Must be non-NULL.
+ * @param ids - the ids of the players, in any order.
+ * @param n - the number of ids.
+ * @param results - array of n elements, results[i] is set to the result of ids[i].
+ *
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess, ids or results are NULL (and n > 0).
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed, no player is removed.
+ *     CHESS_SUCCESS - otherwise, the result of each id is in results[i].
+ */
+ChessResult chessRemovePlayers(ChessSystem chess, const int* ids, int n, ChessResult* results);
+
+/**
+ * How a system is created. A 0 field takes its default.
+ * */
+typedef struct chess_system_options_t {
+    int num_of_workers; // threads of the bulk operations besides the calling one (default none)
+} ChessSystemOptions;
+
+/**
+ * chessCreateWithOptions: creates an empty chess system, like chessCreate.
+ * With workers, the bulk operations (chessSavePlayersLevels, chessSaveTournamentStatistics,
+ * chessRemovePlayer, chessRemovePlayers, chessEndTournaments) split their work between the calling
+ * thread and a pool of worker threads owned by the system, which chessDestroy stops. Their results are the same.
+ *
+ * @param options - the options, or NULL for the defaults.
+ *
+ * @return
+ *     The new system, or NULL if an allocation failed or the workers could not be started.
+ */
+ChessSystem chessCreateWithOptions(const ChessSystemOptions* options);
+
+/**
+ * chessLoadSnapshotWithOptions: like chessLoadSnapshot, but the new system is created with options,
+ * and its workers already load the tournaments and the players at once.
+ */
+ChessSystem chessLoadSnapshotWithOptions(const char* path, const ChessSystemOptions* options, ChessResult* result);
+
+/**
+ * What one thread did for the bulk operations of a system.
+ * */
+typedef struct chess_worker_counters_t {
+    long tasks_run;
+    long tasks_stolen; // of tasks_run, taken from the queue of another thread
+    long sleeps;       // times it found nothing to do and waited
+} ChessWorkerCounters;
+
+/**
+ * chessGetWorkerCounters: returns what the workers of a system did since it was created.
+ * Entry i is worker i, and the last entry is every thread outside the pool that ran tasks
+ * while it waited for them.
+ *
+ * @param chess - chess system. Must be non-NULL.
+ * @param counters - array of capacity entries to fill. May be NULL if capacity is 0.
+ * @param capacity - the number of entries of counters.
+ *
+ * @return
+ *     The number of entries there are (the number of workers + 1), which may be more than capacity.
+ *     0 if chess is NULL or has no workers.
+ */
+int chessGetWorkerCounters(ChessSystem chess, ChessWorkerCounters* counters, int capacity);
+
+/**
+ * The changes a subscription receives (see chessSubscribe), as bits of its mask.
+ * */
+typedef enum chess_event_type_t {
+    CHESS_EVENT_GAME_ADDED = 1,         // tournament id, first player, second player, winner, play time
+    CHESS_EVENT_PLAYER_REMOVED = 2,     // player id
+    CHESS_EVENT_TOURNAMENT_ENDED = 4,   // tournament id, winner id (0 if all its players were removed)
+    CHESS_EVENT_TOURNAMENT_REMOVED = 8, // tournament id
+    CHESS_EVENT_OVERFLOW = 16           // the number of events missed (up to INT_MAX), always received
+} ChessEventType;
+
+#define CHESS_EVENT_ALL (CHESS_EVENT_GAME_ADDED | CHESS_EVENT_PLAYER_REMOVED \
+                         | CHESS_EVENT_TOURNAMENT_ENDED | CHESS_EVENT_TOURNAMENT_REMOVED)
+#define CHESS_EVENT_MAX_ARGS 5
+
+/**
+ * One change read from a subscription.
+ * */
+typedef struct chess_event_t {
+    ChessEventType type;
+    unsigned long long sequence;    // of the event in the subscription, from 0. For an overflow, of the first missed
+    int args[CHESS_EVENT_MAX_ARGS]; // as listed in ChessEventType, the rest are 0
+} ChessEvent;
+
+typedef struct chess_subscription_t *ChessSubscription;
+
+/**
+ * chessSubscribe: starts sending the successful changes of the system whose type is in mask
+ * to a ring of ring_capacity events, in the order they were made.
+ * The system writes the ring without waiting for anyone, and any number of threads read it
+ * (chessSubscriptionRead) without locks, each from its own position. A reader that falls more than
+ * ring_capacity events behind loses the oldest ones, and reads an overflow event in their place.
+ * Changes made by several threads at once (see chessEnableConcurrency) are written one at a time.
+ * May be called while the system is shared.
+ *
+ * @param chess - chess system to follow. Must be non-NULL.
+ * @param mask - the types of events to receive, e.g. CHESS_EVENT_ALL.
+ * @param ring_capacity - the number of events the ring keeps, rounded up to a power of 2.
+ *     0 or less takes the default of 4096.
+ * @param result - if non-NULL, receives the result of the call.
+ *
+ * @return
+ *     The new subscription, or NULL if an error occurred. The result is:
+ *     CHESS_NULL_ARGUMENT - if chess is NULL.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SUCCESS - otherwise.
+ */
+ChessSubscription chessSubscribe(ChessSystem chess, unsigned int mask, int ring_capacity, ChessResult* result);
+
+/**
+ * chessSubscriptionRead: copies the events from position on into events, and moves position past them.
+ * Never waits: returns 0 if no event was written since.
+ * A reader starts from position 0 (the first event of the subscription), and if that is not in the ring
+ * anymore reads an overflow event first.
+ *
+ * @param subscription - the subscription. Must be non-NULL.
+ * @param position - the position of this reader, updated by the call. Must be non-NULL.
+ * @param events - buffer of capacity events.
+ * @param capacity - the maximal number of events to return.
+ *
+ * @return
+ *     The number of events written (0 if subscription, position or events are NULL).
+ */
+int chessSubscriptionRead(ChessSubscription subscription, unsigned long long* position, ChessEvent* events, int capacity);
+
+/**
+ * chessUnsubscribe: stops sending events to a subscription and destroys it. No thread may still read it.
+ * chessDestroy destroys the subscriptions left.
+ * May be called while the system is shared.
+ */
+void chessUnsubscribe(ChessSystem chess, ChessSubscription subscription);
+
+/**
+ * chessMerge: folds the tournaments, games and players of src into dst, e.g. systems that were
+ * filled with the games of different tournaments on several threads. src is not changed.
+ * A tournament of src whose id is new to dst is copied with its games. A tournament of both systems
+ * is taken from the one that has games, as long as the other one has none, has the same location and
+ * ended the same way; dst keeps its own max games per player. Every conflict is found before dst is
+ * changed, so on a conflict neither system changes. The statistics of a player of both
+ * systems are added up. Subscriptions of dst receive the games moved to it, and its journal is compacted
+ * (see chessJournalCompact), but a trace of dst does not record the merge.
+ * Two systems must not be merged into each other at the same time.
+ *
+ * @param dst - chess system to merge into. Must be non-NULL.
+ * @param src - chess system to merge from. Must be non-NULL.
+ *
+ * @return
+ *     CHESS_NULL_ARGUMENT - if dst or src are NULL.
+ *     CHESS_TOURNAMENT_ALREADY_EXISTS - if a tournament of both systems has games in both,
+ *         or two different locations.
+ *     CHESS_TOURNAMENT_ENDED - if a tournament of both systems ended in only one of them.
+ *     CHESS_EXCEEDED_GAMES - if a player played more games in a tournament of src
+ *         than the same tournament of dst allows.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed. Neither system is changed then.
+ *     CHESS_SAVE_FAILURE - if the journal of dst could not be compacted, for lack of memory too.
+ *         dst is merged then, but its journal may not hold the merge until it is compacted again.
+ *     CHESS_SUCCESS - otherwise.
+ */
+ChessResult chessMerge(ChessSystem dst, ChessSystem src);
+
+/**
+ * chessEnableLazyRemoval: makes chessRemovePlayer take the player out of the system without
+ * updating its games. The removal is remembered, and the games against the player (with the players
+ * that lose their losses and draws to it) are updated later: by chessApplyRemovals, before the games
+ * of a tournament are read or changed, and before the statistics of the players are read. Ending a
+ * tournament reads them, so it applies every removal first. A removal costs the search of the
+ * player and of its tournaments, instead of the search of all their games. The results are the same
+ * as without it, except the time the calls take.
+ * chessCalculateAveragePlayTime and chessPlayerOncePlayed never wait for the removals.
+ * chessRemovePlayers, and chessRemovePlayer of a system that is shared (see chessEnableConcurrency) or
+ * has snapshot reads (see chessEnableSnapshotReads), still update the games right away.
+ * Calling it again does nothing.
+ *
+ * @param chess - chess system. Must be non-NULL.
+ *
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess is NULL.
+ *     CHESS_OUT_OF_MEMORY - if the removals could not be created.
+ *     CHESS_SUCCESS - otherwise.
+ */
+ChessResult chessEnableLazyRemoval(ChessSystem chess);
+
+/**
+ * chessApplyRemovals: applies the removals waiting since chessEnableLazyRemoval, in the order they
+ * were made, until about max_games games were searched, e.g. a bounded slice of work between calls.
+ * A slice applies a removal to whole tournaments, so it may search more than max_games games.
+ *
+ * @param chess - chess system. Must be non-NULL.
+ * @param max_games - how many games to search. 0 or less applies nothing.
+ *
+ * @return
+ *     The number of removals still waiting (0 if chess is NULL).
+ */
+int chessApplyRemovals(ChessSystem chess, int max_games);
+
+#endif
\ No newline at end of file
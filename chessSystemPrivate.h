@@ -0,0 +1,38 @@
+#ifndef _CHESSSYSTEMPRIVATE_H_
+#define _CHESSSYSTEMPRIVATE_H_
+
+#include "chessSystem.h"
+#include "chessLocation.h"
+#include "chessBitmap.h"
+#include "chessJournal.h"
+#include "chessTrace.h"
+#include "chessLocks.h"
+#include "chessVersion.h"
+#include "chessPool.h"
+#include "chessFeed.h"
+#include "chessRemoval.h"
+#include "map.h"
+#include <stdbool.h>
+
+/**
+ * The layout of a ChessSystem, shared by the modules that implement chessSystem.h
+ * and chessSystemExt.h. Not part of the interface.
+ * */
+struct chess_system_t {
+    Map tournaments;  // <(int)id, (Tournament)tournament>
+    Map players;      // <(int)id, <(Player) player>
+    LocationPool locations; // every distinct tournament location, stored once.
+    Bitmap former_players;  // ids of players that once played, but have no games anymore.
+    int num_of_games; // number of games in the system.
+    Journal journal;  // NULL unless chessJournalOpen was called.
+    char* games_directory; // where new tournaments store their games, NULL to keep them in memory.
+    bool games_in_files;   // whether any games were stored in files (forked children share them).
+    Trace trace;      // NULL unless chessTraceOpen was called.
+    Locks locks;      // NULL unless chessEnableConcurrency was called.
+    Versions versions; // NULL unless chessEnableSnapshotReads was called.
+    Pool pool;        // NULL when the bulk operations run on the calling thread alone.
+    Feed feed;        // NULL until chessSubscribe is called.
+    Removals removals; // NULL unless chessEnableLazyRemoval was called.
+};
+
+#endif
@@ -1,18 +1,23 @@
 #include "chessTournament.h"
 
 #include "chessGame.h"
+#include "chessArena.h"
+#include "mapExt.h"
 #include <stdlib.h>
-#include <string.h>
 #include <limits.h>
 
 // ------------------ DEFINES ---------------- //
 
 struct chess_tournament_t {
+    Arena arena;             // owns the tournament itself and all of its games.
+    ArenaMark games_mark;    // everything after that mark belongs to games
     unsigned int id;
     unsigned int winners_id; // NOTE: players_id > 0, therefore (winners_id = 0) means tournament unfinished.
     unsigned int max_games_per_player;
-    char* location;
-    Map games;               // <(int)id, <(Game) game>
+    int location_id;         // id of the location in the system's LocationPool
+    const char* location;    // interned, owned by the LocationPool
+    GameList games;          // frozen once the tournament ends
+    unsigned long serial;    // tells it from a tournament created later with the same id
 
     int num_of_players;      // number of players ever participated in tournament
     double average_game_time;
@@ -21,6 +26,11 @@ struct chess_tournament_t {
 
 // ------------------ FUNCTIONS DECLARATIONS ---------------- //
 
+static Tournament createTournament(Arena arena);
+static unsigned long newSerial(void);
+static void setStatistics(Tournament tournament, const TournamentSummary* summary);
+static Player getTournamentPlayer(Map players, int player_id, int tournament_id);
+static void releasePlayerIfEmpty(Map players, Player player, Bitmap former_players);
 static void freeTournament(MapDataElement tournament);
 static MapDataElement copyTournament(MapDataElement tournament);
 // the next functions are implemented in utils.h
@@ -34,6 +44,8 @@ static MapKeyElement (*copyTournamentKey)(MapKeyElement) = copyInt;
 static int (*compareTournamentKeys)(MapKeyElement, MapKeyElement) = compare;
 static MapDataElement (*copyTournamentData)(MapDataElement) = copyTournament;
 
+static unsigned long last_serial = 0; // of every system, hence taken atomically
+
 // ------------------ FUNCTIONS IMPLEMENTATION ---------------- //
 
 Map tournamentCreateMap()
@@ -41,30 +53,16 @@ Map tournamentCreateMap()
     return mapCreate(copyTournamentData, copyTournamentKey, freeTournamentData, freeTournamentKey, compareTournamentKeys);
 }
 
-bool tournamentAddToMap(Map map, int tournament_id, int max_games_per_player, const char* location)
+bool tournamentAddToMap(Map map, int tournament_id, int max_games_per_player, int location_id, const char* location)
 {
-    Tournament tournament = (Tournament)malloc(sizeof(*tournament));
+    Tournament tournament = createTournament(arenaCreate());
     if (tournament == NULL)
     {
         return false;
     }
 
-    tournament->games = gameCreateMap();
-    if (tournament->games == NULL)
-    {
-        free(tournament);
-        return false;
-    }
-
-    tournament->location = (char*)malloc(strlen(location) + 1);
-    if (tournament->location == NULL)
-    {
-        mapDestroy(tournament->games);
-        free(tournament);
-        return false;
-    }
-    strcpy(tournament->location, location);
-
+    tournament->location_id = location_id;
+    tournament->location = location;
     tournament->id = tournament_id;
     tournament->max_games_per_player = max_games_per_player;
     tournament->winners_id = 0; // NOTE: players_id > 0, therefore (winners_id = 0) means tournament unfinished.
@@ -84,9 +82,90 @@ bool tournamentAddToMap(Map map, int tournament_id, int max_games_per_player, co
     return true;
 }
 
+bool tournamentRestoreToMap(Map map, const TournamentSummary* summary, const char* location,
+                            const void* games, int games_size, bool frozen)
+{
+    Arena arena = arenaCreate();
+    if (arena == NULL)
+    {
+        return false;
+    }
+    Tournament tournament = (Tournament)arenaAlloc(arena, sizeof(*tournament));
+    if (tournament == NULL)
+    {
+        arenaDestroy(arena);
+        return false;
+    }
+    tournament->arena = arena;
+    tournament->games_mark = arenaGetMark(arena);
+    tournament->games = gameListRestore(arena, games, games_size, summary->num_of_games, frozen);
+    if (tournament->games == NULL)
+    {
+        arenaDestroy(arena);
+        return false;
+    }
+
+    tournament->id = summary->id;
+    tournament->serial = newSerial();
+    tournament->max_games_per_player = summary->max_games_per_player;
+    tournament->location_id = summary->location_id;
+    tournament->location = location;
+    setStatistics(tournament, summary);
+
+    // restored from the highest id down, every tournament goes before the others
+    bool result = (mapPutFirst(map, &tournament->id, tournament) == MAP_SUCCESS);
+    freeTournament(tournament);
+    return result;
+}
+
+bool tournamentRestoreGames(Tournament tournament, const TournamentSummary* summary,
+                            const void* games, int games_size, bool frozen, TournamentGames* previous)
+{
+    // the games it had stay in the arena, until the tournament is destroyed or frozen
+    GameList new_games = gameListRestore(tournament->arena, games, games_size, summary->num_of_games, frozen);
+    if (new_games == NULL)
+    {
+        return false;
+    }
+    previous->games = tournament->games;
+    tournamentGetSummary(tournament, &previous->summary);
+    tournament->games = new_games;
+    setStatistics(tournament, summary);
+    return true;
+}
+
+void tournamentUndoRestoreGames(Tournament tournament, const TournamentGames* previous)
+{
+    gameListRelease(tournament->games);
+    tournament->games = previous->games;
+    setStatistics(tournament, &previous->summary);
+}
+
+bool tournamentStoreGamesInFile(Tournament tournament, const char* directory)
+{
+    return gameListMoveToFile(tournament->games, directory);
+}
+
+void tournamentGetSummary(Tournament tournament, TournamentSummary* summary)
+{
+    summary->id = tournament->id;
+    summary->winners_id = tournament->winners_id;
+    summary->max_games_per_player = tournament->max_games_per_player;
+    summary->location_id = tournament->location_id;
+    summary->num_of_players = tournament->num_of_players;
+    summary->longest_game_time = tournament->longest_game_time;
+    summary->average_game_time = tournament->average_game_time;
+    summary->num_of_games = tournamentGetNumOfGames(tournament);
+}
+
+GameList tournamentGetGames(Tournament tournament)
+{
+    return tournament->games;
+}
+
 int tournamentGetNumOfGames(Tournament tournament)
 {
-    return mapGetSize(tournament->games);
+    return gameListGetSize(tournament->games);
 }
 
 int tournamentGetMaxGamesPerPlayer(Tournament tournament)
@@ -94,19 +173,34 @@ int tournamentGetMaxGamesPerPlayer(Tournament tournament)
     return tournament->max_games_per_player;
 }
 
+int tournamentGetLocationID(Tournament tournament)
+{
+    return tournament->location_id;
+}
+
+unsigned long tournamentGetSerial(Tournament tournament)
+{
+    return tournament->serial;
+}
+
+int tournamentGetWinner(Tournament tournament)
+{
+    return (int)tournament->winners_id;
+}
+
 bool tournamentAddGame(Tournament tournament, Player first_player,
                         Player second_player, int winners_id, int play_time)
 {
     int game_id = tournamentGetNumOfGames(tournament) + 1;
     int player1_id = playerGetID(first_player);
     int player2_id = playerGetID(second_player);
-    if (!gameAddToMap(tournament->games, game_id, play_time, player1_id, player2_id, winners_id))
+    if (!gameListAdd(tournament->games, play_time, player1_id, player2_id, winners_id))
     {
         return false;
     }
 
     tournament->average_game_time = (tournament->average_game_time * (game_id - 1) + play_time) / (game_id);
-    if (play_time > tournament->longest_game_time)
+    if ((unsigned int)play_time > tournament->longest_game_time)
     {
         tournament->longest_game_time = play_time;
     }
@@ -125,12 +219,20 @@ bool tournamentAddGame(Tournament tournament, Player first_player,
 
 void tournamentEnd(Tournament tournament, Map players)
 {
+    tournamentSetWinner(tournament, tournamentFindWinner(tournament, players));
+    // the games can't change anymore, keep them in the compact form.
+    tournamentFreeze(tournament);
+}
+
+int tournamentFindWinner(Tournament tournament, Map players)
+{
+    int winners_id = tournament->winners_id;
     int max_score = 0;
     int min_loses = INT_MAX;
     int max_wins = 0;
-    MAP_FOREACH(int*, game_id, tournament->games)
+    for (int i = 0; i < gameListGetSize(tournament->games); i++)
     {
-        Game game = mapGet(tournament->games, game_id);
+        Game game = gameListGet(tournament->games, i);
         int player1_id = gameGetPlayer1ID(game);
         int player2_id = gameGetPlayer2ID(game);
         Player player1 = mapGet(players, &player1_id);
@@ -141,8 +243,7 @@ void tournamentEnd(Tournament tournament, Map players)
         compare_result = playerCompareScores(player1, player2, tournament->id, &max_score, &min_loses, &max_wins);
         if (compare_result >= 0)
         {
-            tournament->winners_id = compare_result ? compare_result : tournament->winners_id;
-            free(game_id);
+            winners_id = compare_result ? compare_result : winners_id;
             continue;
         }
         // else compare_result == -1, search for minimum loses
@@ -150,8 +251,7 @@ void tournamentEnd(Tournament tournament, Map players)
         compare_result = playerCompareLoses(player1, player2, tournament->id, &min_loses, &max_wins);
         if (compare_result >= 0)
         {
-            tournament->winners_id = compare_result ? compare_result : tournament->winners_id;
-            free(game_id);
+            winners_id = compare_result ? compare_result : winners_id;
             continue;
         }
         // else compare_result == -1, search for maximux wins
@@ -159,22 +259,40 @@ void tournamentEnd(Tournament tournament, Map players)
         compare_result = playerCompareWins(player1, player2, tournament->id, &max_wins);
         if (compare_result >= 0)
         {
-            tournament->winners_id = compare_result ? compare_result : tournament->winners_id;
-            free(game_id);
+            winners_id = compare_result ? compare_result : winners_id;
             continue;
         }
         // else compare_result == -1, search for lowest id
 
-        if (player2 != NULL && player1_id < tournament->winners_id)
+        if (player2 != NULL && player1_id < winners_id)
         {
-            tournament->winners_id = player1_id;
+            winners_id = player1_id;
         }
-        if (player2 != NULL && player2_id < tournament->winners_id)
+        if (player2 != NULL && player2_id < winners_id)
         {
-            tournament->winners_id = player2_id;
+            winners_id = player2_id;
         }
+    }
+    return winners_id;
+}
+
+void tournamentSetWinner(Tournament tournament, int winners_id)
+{
+    tournament->winners_id = winners_id;
+}
 
-        free(game_id);
+void tournamentFreeze(Tournament tournament)
+{
+    // a tournament whose players were all removed has no winner, and stays open for new games
+    if (!tournamentHasEnded(tournament))
+    {
+        return;
+    }
+    // if there is no memory for that, the games simply stay as they are.
+    GameList frozen = gameListFreeze(tournament->games, tournament->arena, tournament->games_mark);
+    if (frozen != NULL)
+    {
+        tournament->games = frozen;
     }
 }
 
@@ -188,23 +306,34 @@ bool tournamentGameExists(Tournament tournament, int player1_id, int player2_id)
     return gameExists(tournament->games, player1_id, player2_id);
 }
 
-bool tournamentPrintStatistics(Tournament tournament, FILE* stream, Map players)
+void tournamentPrintStatistics(Tournament tournament, Output output)
 {
-    return (fprintf(stream, "%d\n%d\n%.2lf\n%s\n%d\n%d\n",
-                            tournament->winners_id,
-                            tournament->longest_game_time,
-                            tournament->average_game_time,
-                            tournament->location,
-                            tournamentGetNumOfGames(tournament),
-                            tournament->num_of_players)
-            >= 0);
+    TournamentSummary summary;
+    tournamentGetSummary(tournament, &summary);
+    tournamentPrintSummary(&summary, tournament->location, output);
+}
+
+void tournamentPrintSummary(const TournamentSummary* summary, const char* location, Output output)
+{
+    outputInt(output, summary->winners_id);
+    outputChar(output, '\n');
+    outputInt(output, summary->longest_game_time);
+    outputChar(output, '\n');
+    outputFixed2(output, summary->average_game_time);
+    outputChar(output, '\n');
+    outputString(output, location);
+    outputChar(output, '\n');
+    outputInt(output, summary->num_of_games);
+    outputChar(output, '\n');
+    outputInt(output, summary->num_of_players);
+    outputChar(output, '\n');
 }
 
 void tournamentRemovePlayer(Tournament tournament, Player player, Map players)
 {
-    MAP_FOREACH(int*, game_id, tournament->games)
+    for (int i = 0; i < gameListGetSize(tournament->games); i++)
     {
-        Game game = mapGet(tournament->games, game_id);
+        Game game = gameListGet(tournament->games, i);
         int player_id = playerGetID(player);
         if (gameHasPlayer(game, player_id))
         {
@@ -212,32 +341,185 @@ void tournamentRemovePlayer(Tournament tournament, Player player, Map players)
             Player player2 = (Player)mapGet(players, &other_player_id);
             gameRemovePlayer(game, player, player2, tournament->id);
         }
-        free(game_id);
     }
 }
 
-void tournamentRemoveGame(Tournament tournament, int first_player, int second_player)
+int tournamentFindPlayerGames(Tournament tournament, int player_id, int* games, int capacity)
 {
-    int key = gameExists(tournament->games, first_player, second_player);
-    mapRemove(tournament->games, &key);
+    int size = 0;
+    for (int i = 0; i < gameListGetSize(tournament->games) && size < capacity; i++)
+    {
+        if (gameHasPlayer(gameListGet(tournament->games, i), player_id))
+        {
+            games[size++] = i;
+        }
+    }
+    return size;
 }
 
-void tournamentUpdateStatisticsBeforeRemove(Tournament tournament, Map players)
+void tournamentRemovePlayerFromGames(Tournament tournament, Player player, Map players, const int* games, int size)
 {
-    MAP_FOREACH(int*, game_id, tournament->games)
+    int player_id = playerGetID(player);
+    for (int i = 0; i < size; i++)
     {
-        Game game = mapGet(tournament->games, game_id);
+        Game game = gameListGet(tournament->games, games[i]);
+        int other_player_id = (player_id == gameGetPlayer1ID(game) ? gameGetPlayer2ID(game) : gameGetPlayer1ID(game));
+        Player player2 = (Player)mapGet(players, &other_player_id);
+        gameRemovePlayer(game, player, player2, tournament->id);
+    }
+}
+
+int tournamentFindPlayersGames(Tournament tournament, Bitmap player_ids, int* games, int capacity)
+{
+    int size = 0;
+    for (int i = 0; i < gameListGetSize(tournament->games) && size < capacity; i++)
+    {
+        Game game = gameListGet(tournament->games, i);
+        if (bitmapGet(player_ids, gameGetPlayer1ID(game)) || bitmapGet(player_ids, gameGetPlayer2ID(game)))
+        {
+            games[size++] = i;
+        }
+    }
+    return size;
+}
+
+void tournamentRemovePlayersFromGames(Tournament tournament, Bitmap player_ids, Map players, const int* games, int size)
+{
+    for (int i = 0; i < size; i++)
+    {
+        Game game = gameListGet(tournament->games, games[i]);
         int player1_id = gameGetPlayer1ID(game);
         int player2_id = gameGetPlayer2ID(game);
-        Player player1 = mapGet(players, &player1_id);
-        Player player2 = mapGet(players, &player2_id);
-        gameRemove(game, player1, player2, tournament->id);
-        free(game_id);
+        // once both were removed, the game has no players and changes no one
+        if (bitmapGet(player_ids, player1_id))
+        {
+            gameRemovePlayer(game, mapGet(players, &player1_id), mapGet(players, &player2_id), tournament->id);
+            player1_id = 0;
+        }
+        if (bitmapGet(player_ids, player2_id))
+        {
+            gameRemovePlayer(game, mapGet(players, &player2_id), mapGet(players, &player1_id), tournament->id);
+        }
+    }
+}
+
+int tournamentRemoveRemovedPlayer(Tournament tournament, int player_id, Map players)
+{
+    int size = gameListGetSize(tournament->games);
+    for (int i = 0; i < size; i++)
+    {
+        Game game = gameListGet(tournament->games, i);
+        if (gameHasPlayer(game, player_id))
+        {
+            int other_player_id = (player_id == gameGetPlayer1ID(game) ? gameGetPlayer2ID(game) : gameGetPlayer1ID(game));
+            Player player2 = (Player)mapGet(players, &other_player_id);
+            gameRemovePlayerID(game, player_id, player2, tournament->id);
+        }
+    }
+    return size;
+}
+
+void tournamentRemoveGame(Tournament tournament, int first_player, int second_player)
+{
+    int key = gameExists(tournament->games, first_player, second_player);
+    if (key)
+    {
+        gameListRemove(tournament->games, key - 1);
+    }
+}
+
+void tournamentUpdateStatisticsBeforeRemove(Tournament tournament, Map players, Bitmap former_players)
+{
+    GameIterator iterator;
+    gameIteratorInit(&iterator);
+    while (gameIteratorNext(tournament->games, &iterator))
+    {
+        Player player1 = getTournamentPlayer(players, iterator.game.player1_id, tournament->id);
+        Player player2 = getTournamentPlayer(players, iterator.game.player2_id, tournament->id);
+        gameRemove(iterator.game, player1, player2, tournament->id);
+        releasePlayerIfEmpty(players, player1, former_players);
+        releasePlayerIfEmpty(players, player2, former_players);
+    }
+}
+
+/**
+ * Return the player with that id, if it played in the tournament.
+ * A player that was removed and came back is a new player, the games of
+ * ended tournaments with its old id are not counted for it.
+ * */
+static Player getTournamentPlayer(Map players, int player_id, int tournament_id)
+{
+    Player player = mapGet(players, &player_id);
+    if (player == NULL || !playerPlayedInTournament(player, tournament_id))
+    {
+        return NULL;
+    }
+    return player;
+}
+
+/**
+ * Release a player that has no games left, remembering that it once played.
+ * If the id can't be remembered (malloc failed), the empty player is kept instead.
+ * */
+static void releasePlayerIfEmpty(Map players, Player player, Bitmap former_players)
+{
+    if (player == NULL || playerExists(player))
+    {
+        return;
+    }
+    int player_id = playerGetID(player);
+    if (bitmapSet(former_players, player_id))
+    {
+        mapRemove(players, &player_id);
     }
 }
 
 // ------------------ STRUCT FUNCTIONS IMPLEMENTATION ---------------- //
 
+/**
+ * Create a tournament with no games inside arena.
+ * On failure the arena is destroyed and NULL is returned, so a NULL arena can be passed directly.
+ * */
+static Tournament createTournament(Arena arena)
+{
+    if (arena == NULL)
+    {
+        return NULL;
+    }
+    Tournament tournament = (Tournament)arenaAlloc(arena, sizeof(*tournament));
+    if (tournament == NULL)
+    {
+        arenaDestroy(arena);
+        return NULL;
+    }
+    tournament->arena = arena;
+    tournament->games_mark = arenaGetMark(arena);
+    tournament->games = gameListCreate(arena);
+    if (tournament->games == NULL)
+    {
+        arenaDestroy(arena);
+        return NULL;
+    }
+    tournament->serial = newSerial();
+    return tournament;
+}
+
+static unsigned long newSerial(void)
+{
+    return __atomic_add_fetch(&last_serial, 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * Set everything in a tournament that is calculated from its games.
+ * */
+static void setStatistics(Tournament tournament, const TournamentSummary* summary)
+{
+    tournament->winners_id = summary->winners_id;
+    tournament->num_of_players = summary->num_of_players;
+    tournament->longest_game_time = summary->longest_game_time;
+    tournament->average_game_time = summary->average_game_time;
+}
+
 static MapDataElement copyTournament(MapDataElement tournament)
 {
     if (tournament == NULL)
@@ -245,28 +527,32 @@ static MapDataElement copyTournament(MapDataElement tournament)
         return NULL;
     }
     
-    Tournament new_tournament = (Tournament)malloc(sizeof(*new_tournament));
-    if (new_tournament == NULL)
+    Arena arena = arenaCreate();
+    if (arena == NULL)
     {
         return NULL;
     }
-    Map new_games = mapCopy(((Tournament)tournament)->games);
-    if (new_games == NULL)
+    Tournament new_tournament = (Tournament)arenaAlloc(arena, sizeof(*new_tournament));
+    if (new_tournament == NULL)
     {
-        free(new_tournament);
+        arenaDestroy(arena);
         return NULL;
     }
-
-    new_tournament->location = (char*)malloc(strlen(((Tournament)tournament)->location) + 1);
-    if (new_tournament->location == NULL)
+    ArenaMark games_mark = arenaGetMark(arena);
+    GameList new_games = gameListCopy(((Tournament)tournament)->games, arena);
+    if (new_games == NULL)
     {
-        mapDestroy(new_games);
+        arenaDestroy(arena);
         return NULL;
     }
-    strcpy(new_tournament->location, ((Tournament)tournament)->location);
 
+    new_tournament->arena = arena;
+    new_tournament->games_mark = games_mark;
+    new_tournament->location_id = ((Tournament)tournament)->location_id;
+    new_tournament->location = ((Tournament)tournament)->location;
     new_tournament->games = new_games;
     new_tournament->id = ((Tournament)tournament)->id;
+    new_tournament->serial = ((Tournament)tournament)->serial;
     new_tournament->winners_id = ((Tournament)tournament)->winners_id;
     new_tournament->max_games_per_player= ((Tournament)tournament)->max_games_per_player;
 
@@ -277,9 +563,11 @@ static MapDataElement copyTournament(MapDataElement tournament)
     return (MapDataElement)new_tournament;
 }
 
+/**
+ * Release the tournament with everything it owns in one shot.
+ * */
 static void freeTournament(MapDataElement tournament)
 {
-    mapDestroy(((Tournament)tournament)->games);
-    free(((Tournament)tournament)->location);
-    free(tournament);
+    gameListRelease(((Tournament)tournament)->games);
+    arenaDestroy(((Tournament)tournament)->arena);
 }
\ No newline at end of file
@@ -2,10 +2,26 @@
 #define _CHESSTOURNAMENT_H_
 
 #include "chessPlayer.h"
-#include <stdio.h>
+#include "chessGame.h"
+#include "chessBitmap.h"
+#include "chessOutput.h"
 
 typedef struct chess_tournament_t *Tournament;
 
+/**
+ * Everything about a tournament except its games, by value.
+ * */
+typedef struct chess_tournament_summary_t {
+    int id;
+    int winners_id;          // 0 if the tournament has not ended
+    int max_games_per_player;
+    int location_id;
+    int num_of_players;
+    int longest_game_time;
+    double average_game_time;
+    int num_of_games;
+} TournamentSummary;
+
 /**
  * Create and return an empty map of tournaments
  * */
@@ -13,9 +29,45 @@ Map tournamentCreateMap(void);
 
 /**
  * Create a new tournament and add it to a map.
+ * location is an interned string (see chessLocation.h), the tournament does not own it.
  * Return false if an error occured (can only happen if malloc fails).
  * */
-bool tournamentAddToMap(Map map, int tournament_id, int max_games_per_player, const char* location);
+bool tournamentAddToMap(Map map, int tournament_id, int max_games_per_player, int location_id, const char* location);
+
+/**
+ * Create a tournament from a summary and the raw form of its games (see gameListDump),
+ * and add it to a map.
+ * Return false if an error occured (malloc failed, or the games don't fit the summary).
+ * */
+bool tournamentRestoreToMap(Map map, const TournamentSummary* summary, const char* location,
+                            const void* games, int games_size, bool frozen);
+
+/**
+ * The games and statistics a tournament had before tournamentRestoreGames.
+ * */
+typedef struct chess_tournament_games_t {
+    GameList games;
+    TournamentSummary summary;
+} TournamentGames;
+
+/**
+ * Give a tournament without games the games and statistics of summary (see chessMerge), keeping its id,
+ * location and max games per player. previous receives what it had, for tournamentUndoRestoreGames.
+ * Return false if an error occured (malloc failed), then the tournament is unchanged.
+ * */
+bool tournamentRestoreGames(Tournament tournament, const TournamentSummary* summary,
+                            const void* games, int games_size, bool frozen, TournamentGames* previous);
+
+/**
+ * Give a tournament back what it had before tournamentRestoreGames. Can't fail.
+ * */
+void tournamentUndoRestoreGames(Tournament tournament, const TournamentGames* previous);
+
+/**
+ * Store the games of a tournament without games in a file of directory (see gameListMoveToFile).
+ * Return false if an error occured, and then the games stay in memory.
+ * */
+bool tournamentStoreGamesInFile(Tournament tournament, const char* directory);
 
 /**
  * Add a new game to a tournament.
@@ -28,22 +80,78 @@ bool tournamentAddGame(Tournament tournament, Player first_player, Player second
  * */
 void tournamentEnd(Tournament tournament, Map players);
 
+/**
+ * Calculate the winner of a tournament without saving it (0 if all its players were removed).
+ * Only reads the tournament and the players, so several threads may calculate the winners
+ * of different tournaments at once.
+ * */
+int tournamentFindWinner(Tournament tournament, Map players);
+
+/**
+ * Save the winner calculated by tournamentFindWinner. The games are not frozen.
+ * */
+void tournamentSetWinner(Tournament tournament, int winners_id);
+
+/**
+ * Freeze the games of an ended tournament (tournamentEnd already does that).
+ * Does nothing if the tournament has not ended, if the games are already frozen
+ * or if there is no memory to do it.
+ * */
+void tournamentFreeze(Tournament tournament);
+
 /**
  * Update the players' statistics when removing a tournament.
+ * Players left without games are released, and their ids are added to former_players.
  * */
-void tournamentUpdateStatisticsBeforeRemove(Tournament tournament, Map players);
+void tournamentUpdateStatisticsBeforeRemove(Tournament tournament, Map players, Bitmap former_players);
 
 // Getters
 
+void tournamentGetSummary(Tournament tournament, TournamentSummary* summary);
+GameList tournamentGetGames(Tournament tournament); // read only
+
 int tournamentGetNumOfGames(Tournament tournament);
 int tournamentGetMaxGamesPerPlayer(Tournament tournament);
+int tournamentGetLocationID(Tournament tournament); // equal locations have equal ids
+int tournamentGetWinner(Tournament tournament); // 0 if the tournament has not ended
+unsigned long tournamentGetSerial(Tournament tournament); // unique to the tournament, kept by its copies
 
 // Functions whose names' explain their purposes
 
 bool tournamentHasEnded(Tournament tournament);
 bool tournamentGameExists(Tournament tournament, int player1_id, int player2_id);
-bool tournamentPrintStatistics(Tournament tournament, FILE* stream, Map players);
+void tournamentPrintStatistics(Tournament tournament, Output output);
+void tournamentPrintSummary(const TournamentSummary* summary, const char* location, Output output); // same output
 void tournamentRemovePlayer(Tournament tournament, Player player, Map players);
 void tournamentRemoveGame(Tournament tournament, int first_player, int second_player);
 
+/**
+ * Fill games with the indexes of the games of a player, up to capacity of them, and return how many were found.
+ * Only reads the tournament, so several threads may search different tournaments at once.
+ * */
+int tournamentFindPlayerGames(Tournament tournament, int player_id, int* games, int capacity);
+
+/**
+ * Like tournamentRemovePlayer, for the games found by tournamentFindPlayerGames.
+ * */
+void tournamentRemovePlayerFromGames(Tournament tournament, Player player, Map players, const int* games, int size);
+
+/**
+ * Like tournamentFindPlayerGames, for the games of any player in player_ids.
+ * */
+int tournamentFindPlayersGames(Tournament tournament, Bitmap player_ids, int* games, int capacity);
+
+/**
+ * Remove every player in player_ids from the games found by tournamentFindPlayersGames,
+ * like tournamentRemovePlayerFromGames for each of them.
+ * */
+void tournamentRemovePlayersFromGames(Tournament tournament, Bitmap player_ids, Map players, const int* games, int size);
+
+/**
+ * Like tournamentRemovePlayer, for a player already taken out of players (see chessRemoval.h).
+ * The other players that are not in players anymore are not updated.
+ * Return the number of games searched.
+ * */
+int tournamentRemoveRemovedPlayer(Tournament tournament, int player_id, Map players);
+
 #endif
@@ -0,0 +1,479 @@
+#define _POSIX_C_SOURCE 200809L // clock_gettime, pthreads
+
+#include "chessTrace.h"
+#include "chessSystemExt.h"
+#include "chessSystemPrivate.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+
+/*
+ * Layout of a trace: "CHST", version, flags (4 bytes little endian each), then one record per call:
+ * the call (1 byte), the result (1 byte), the latency in nanoseconds, then its arguments (zigzag),
+ * the length of its text plus 1 (0 for NULL) and the text, or the average play time
+ * (8 bytes, the little endian bits of the double).
+ * Every number but the header and the average play time is a varint: 7 bits a byte, lowest bits first.
+ */
+
+// ------------------ DEFINES ---------------- //
+
+#define TRACE_MAGIC "CHST"
+#define TRACE_VERSION 1
+#define WORD_SIZE 4
+#define TRACE_HEADER_SIZE (3 * WORD_SIZE)
+#define FLAG_SNAPSHOT 1 // the trace starts from the snapshot of the system
+#define SNAPSHOT_SUFFIX ".snap"
+#define BUFFER_SIZE (1 << 16)
+#define MAX_VARINT_SIZE 10
+#define MAX_RECORD_SIZE (2 + (2 + CHESS_TRACE_MAX_ARGS) * MAX_VARINT_SIZE + sizeof(double)) // without the text
+#define DOUBLE_SIZE 8
+#define NANOSECONDS_PER_SECOND 1000000000LL
+
+struct chess_trace_t {
+    pthread_mutex_t lock; // calls of a shared system are recorded by several threads
+    int file;
+    bool failed;
+    size_t used;
+    unsigned char buffer[BUFFER_SIZE];
+};
+
+struct chess_trace_reader_t {
+    FILE* file;
+    bool snapshot;
+    char* text;
+    size_t text_capacity;
+};
+
+static const int NUM_OF_ARGS[] = {
+    [CHESS_TRACE_ADD_TOURNAMENT] = 2,
+    [CHESS_TRACE_ADD_GAME] = 5,
+    [CHESS_TRACE_REMOVE_TOURNAMENT] = 1,
+    [CHESS_TRACE_REMOVE_PLAYER] = 1,
+    [CHESS_TRACE_END_TOURNAMENT] = 1,
+    [CHESS_TRACE_CALCULATE_AVERAGE_PLAY_TIME] = 1,
+    [CHESS_TRACE_SAVE_PLAYERS_LEVELS] = 1,
+    [CHESS_TRACE_SAVE_TOURNAMENT_STATISTICS] = 0
+};
+
+// ------------------ FUNCTIONS DECLARATIONS ---------------- //
+
+static Trace traceCreate(const char* path, bool snapshot, ChessResult* result);
+static void flushTrace(Trace trace);
+static bool hasText(ChessTraceCall call);
+static char* snapshotName(const char* path);
+
+static bool readVarint(FILE* file, unsigned long long* value);
+static bool readText(ChessTraceReader reader, const char** text);
+
+static int writeVarint(unsigned char* buffer, unsigned long long value);
+static unsigned long long zigzagEncode(long long value);
+static long long zigzagDecode(unsigned long long value);
+static void putWord(unsigned char* bytes, unsigned long value);
+static unsigned long getWord(const unsigned char* bytes);
+
+// ------------------ FUNCTIONS IMPLEMENTATION ---------------- //
+
+ChessResult chessTraceOpen(ChessSystem chess, const char* path)
+{
+    if (chess == NULL || path == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    traceDestroy(chess->trace);
+    chess->trace = NULL;
+
+    bool snapshot = mapGetSize(chess->tournaments) > 0 || mapGetSize(chess->players) > 0
+                    || bitmapGetNext(chess->former_players, 0) >= 0;
+    if (snapshot)
+    {
+        // the calls alone won't bring back what the system already holds
+        char* name = snapshotName(path);
+        if (name == NULL)
+        {
+            return CHESS_OUT_OF_MEMORY;
+        }
+        ChessResult result = chessSaveSnapshot(chess, name);
+        free(name);
+        if (result != CHESS_SUCCESS)
+        {
+            return result;
+        }
+    }
+    ChessResult result;
+    chess->trace = traceCreate(path, snapshot, &result);
+    return result;
+}
+
+ChessResult chessTraceClose(ChessSystem chess)
+{
+    if (chess == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    if (chess->trace == NULL)
+    {
+        return CHESS_SAVE_FAILURE;
+    }
+    bool result = traceDestroy(chess->trace);
+    chess->trace = NULL;
+    return result ? CHESS_SUCCESS : CHESS_SAVE_FAILURE;
+}
+
+long long traceStart(Trace trace)
+{
+    if (trace == NULL)
+    {
+        return 0;
+    }
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * NANOSECONDS_PER_SECOND + now.tv_nsec;
+}
+
+void traceCall(Trace trace, ChessTraceCall call, const int* args, int num_of_args, const char* text,
+               ChessResult result, double average_play_time, long long start)
+{
+    if (trace == NULL)
+    {
+        return;
+    }
+    long long latency = traceStart(trace) - start;
+    pthread_mutex_lock(&trace->lock);
+    if (BUFFER_SIZE - trace->used < MAX_RECORD_SIZE)
+    {
+        flushTrace(trace);
+    }
+    unsigned char* record = trace->buffer + trace->used;
+    int size = 0;
+    record[size++] = (unsigned char)call;
+    record[size++] = (unsigned char)result;
+    size += writeVarint(record + size, latency < 0 ? 0 : (unsigned long long)latency);
+    for (int i = 0; i < num_of_args; i++)
+    {
+        size += writeVarint(record + size, zigzagEncode(args[i]));
+    }
+    if (call == CHESS_TRACE_CALCULATE_AVERAGE_PLAY_TIME)
+    {
+        unsigned long long bits;
+        memcpy(&bits, &average_play_time, sizeof(bits));
+        for (int i = 0; i < DOUBLE_SIZE; i++)
+        {
+            record[size++] = (unsigned char)(bits >> (8 * i));
+        }
+    }
+    if (!hasText(call))
+    {
+        trace->used += size;
+        pthread_mutex_unlock(&trace->lock);
+        return;
+    }
+
+    size_t length = text == NULL ? 0 : strlen(text);
+    size += writeVarint(record + size, text == NULL ? 0 : length + 1);
+    trace->used += size;
+    while (length > 0)
+    {
+        if (trace->used == BUFFER_SIZE)
+        {
+            flushTrace(trace);
+        }
+        size_t chunk = BUFFER_SIZE - trace->used < length ? BUFFER_SIZE - trace->used : length;
+        memcpy(trace->buffer + trace->used, text, chunk);
+        trace->used += chunk;
+        text += chunk;
+        length -= chunk;
+    }
+    pthread_mutex_unlock(&trace->lock);
+}
+
+bool traceDestroy(Trace trace)
+{
+    if (trace == NULL)
+    {
+        return true;
+    }
+    flushTrace(trace);
+    bool result = !trace->failed;
+    if (close(trace->file) != 0)
+    {
+        result = false;
+    }
+    pthread_mutex_destroy(&trace->lock);
+    free(trace);
+    return result;
+}
+
+ChessTraceReader chessTraceReaderOpen(const char* path, ChessResult* result)
+{
+    ChessResult ignored;
+    result = result == NULL ? &ignored : result;
+    if (path == NULL)
+    {
+        *result = CHESS_NULL_ARGUMENT;
+        return NULL;
+    }
+    ChessTraceReader reader = (ChessTraceReader)malloc(sizeof(*reader));
+    if (reader == NULL)
+    {
+        *result = CHESS_OUT_OF_MEMORY;
+        return NULL;
+    }
+    reader->file = fopen(path, "rb");
+    unsigned char header[TRACE_HEADER_SIZE];
+    if (reader->file == NULL || fread(header, 1, TRACE_HEADER_SIZE, reader->file) != TRACE_HEADER_SIZE
+        || memcmp(header, TRACE_MAGIC, WORD_SIZE) != 0 || getWord(header + WORD_SIZE) != TRACE_VERSION)
+    {
+        if (reader->file != NULL)
+        {
+            fclose(reader->file);
+        }
+        free(reader);
+        *result = CHESS_SAVE_FAILURE;
+        return NULL;
+    }
+    reader->snapshot = (getWord(header + 2 * WORD_SIZE) & FLAG_SNAPSHOT) != 0;
+    reader->text = NULL;
+    reader->text_capacity = 0;
+    *result = CHESS_SUCCESS;
+    return reader;
+}
+
+bool chessTraceReaderHasSnapshot(ChessTraceReader reader)
+{
+    return reader != NULL && reader->snapshot;
+}
+
+bool chessTraceReaderNext(ChessTraceReader reader, ChessTraceRecord* record)
+{
+    if (reader == NULL || record == NULL)
+    {
+        return false;
+    }
+    int call = getc(reader->file);
+    int result = getc(reader->file);
+    unsigned long long latency;
+    if (call == EOF || result == EOF || call < CHESS_TRACE_ADD_TOURNAMENT
+        || call > CHESS_TRACE_SAVE_TOURNAMENT_STATISTICS || !readVarint(reader->file, &latency))
+    {
+        return false;
+    }
+    memset(record, 0, sizeof(*record));
+    record->call = (ChessTraceCall)call;
+    record->result = (ChessResult)result;
+    record->latency = (long long)latency;
+    for (int i = 0; i < NUM_OF_ARGS[call]; i++)
+    {
+        unsigned long long value;
+        if (!readVarint(reader->file, &value))
+        {
+            return false;
+        }
+        record->args[i] = (int)zigzagDecode(value);
+    }
+    if (call == CHESS_TRACE_CALCULATE_AVERAGE_PLAY_TIME)
+    {
+        unsigned char bytes[DOUBLE_SIZE];
+        if (fread(bytes, 1, DOUBLE_SIZE, reader->file) != DOUBLE_SIZE)
+        {
+            return false;
+        }
+        unsigned long long bits = 0;
+        for (int i = 0; i < DOUBLE_SIZE; i++)
+        {
+            bits |= (unsigned long long)bytes[i] << (8 * i);
+        }
+        memcpy(&record->average_play_time, &bits, sizeof(bits));
+    }
+    return !hasText(record->call) || readText(reader, &record->text);
+}
+
+void chessTraceReaderClose(ChessTraceReader reader)
+{
+    if (reader == NULL)
+    {
+        return;
+    }
+    fclose(reader->file);
+    free(reader->text);
+    free(reader);
+}
+
+// ------------------ WRITING ---------------- //
+
+/**
+ * Create the trace file and write its header into the buffer. Return NULL if that failed.
+ * */
+static Trace traceCreate(const char* path, bool snapshot, ChessResult* result)
+{
+    Trace trace = (Trace)malloc(sizeof(*trace));
+    if (trace == NULL)
+    {
+        *result = CHESS_OUT_OF_MEMORY;
+        return NULL;
+    }
+    if (pthread_mutex_init(&trace->lock, NULL) != 0)
+    {
+        free(trace);
+        *result = CHESS_OUT_OF_MEMORY;
+        return NULL;
+    }
+    trace->file = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (trace->file < 0)
+    {
+        pthread_mutex_destroy(&trace->lock);
+        free(trace);
+        *result = CHESS_SAVE_FAILURE;
+        return NULL;
+    }
+    memcpy(trace->buffer, TRACE_MAGIC, WORD_SIZE);
+    putWord(trace->buffer + WORD_SIZE, TRACE_VERSION);
+    putWord(trace->buffer + 2 * WORD_SIZE, snapshot ? FLAG_SNAPSHOT : 0);
+    trace->used = TRACE_HEADER_SIZE;
+    trace->failed = false;
+    *result = CHESS_SUCCESS;
+    return trace;
+}
+
+static void flushTrace(Trace trace)
+{
+    const unsigned char* data = trace->buffer;
+    size_t size = trace->used;
+    trace->used = 0;
+    while (size > 0)
+    {
+        ssize_t written = write(trace->file, data, size);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            trace->failed = true;
+            return;
+        }
+        data += written;
+        size -= (size_t)written;
+    }
+}
+
+static bool hasText(ChessTraceCall call)
+{
+    return call == CHESS_TRACE_ADD_TOURNAMENT || call == CHESS_TRACE_SAVE_TOURNAMENT_STATISTICS;
+}
+
+static char* snapshotName(const char* path)
+{
+    char* name = (char*)malloc(strlen(path) + strlen(SNAPSHOT_SUFFIX) + 1);
+    if (name != NULL)
+    {
+        strcpy(name, path);
+        strcat(name, SNAPSHOT_SUFFIX);
+    }
+    return name;
+}
+
+// ------------------ READING ---------------- //
+
+static bool readVarint(FILE* file, unsigned long long* value)
+{
+    *value = 0;
+    for (int shift = 0; shift < 7 * MAX_VARINT_SIZE; shift += 7)
+    {
+        int byte = getc(file);
+        if (byte == EOF)
+        {
+            return false;
+        }
+        *value |= (unsigned long long)(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Read a text into the buffer of the reader. A NULL text is read as NULL.
+ * */
+static bool readText(ChessTraceReader reader, const char** text)
+{
+    unsigned long long length;
+    if (!readVarint(reader->file, &length))
+    {
+        return false;
+    }
+    if (length == 0)
+    {
+        *text = NULL;
+        return true;
+    }
+    if (length > reader->text_capacity)
+    {
+        char* new_text = (char*)realloc(reader->text, length);
+        if (new_text == NULL)
+        {
+            return false;
+        }
+        reader->text = new_text;
+        reader->text_capacity = length;
+    }
+    if (fread(reader->text, 1, length - 1, reader->file) != length - 1)
+    {
+        return false;
+    }
+    reader->text[length - 1] = '\0';
+    *text = reader->text;
+    return true;
+}
+
+// ------------------ ENCODING ---------------- //
+
+/**
+ * Write value 7 bits at a time, lowest bits first. Return the number of bytes written.
+ * */
+static int writeVarint(unsigned char* buffer, unsigned long long value)
+{
+    int size = 0;
+    while (value >= 0x80)
+    {
+        buffer[size++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    buffer[size++] = (unsigned char)value;
+    return size;
+}
+
+static unsigned long long zigzagEncode(long long value)
+{
+    return value < 0 ? ((unsigned long long)(-(value + 1)) << 1) | 1 : (unsigned long long)value << 1;
+}
+
+static long long zigzagDecode(unsigned long long value)
+{
+    return (value & 1) ? -(long long)(value >> 1) - 1 : (long long)(value >> 1);
+}
+
+static void putWord(unsigned char* bytes, unsigned long value)
+{
+    for (int i = 0; i < WORD_SIZE; i++)
+    {
+        bytes[i] = (unsigned char)(value >> (8 * i));
+    }
+}
+
+static unsigned long getWord(const unsigned char* bytes)
+{
+    unsigned long value = 0;
+    for (int i = 0; i < WORD_SIZE; i++)
+    {
+        value |= (unsigned long)bytes[i] << (8 * i);
+    }
+    return value;
+}
@@ -0,0 +1,32 @@
+#ifndef _CHESSTRACE_H_
+#define _CHESSTRACE_H_
+
+#include "chessSystemExt.h"
+
+/**
+ * The trace of a ChessSystem: every call of chessSystem.h, with its result and latency.
+ * It is opened and read through chessSystemExt.h, this header is what chessSystem.c
+ * needs to feed it.
+ * */
+typedef struct chess_trace_t *Trace;
+
+/**
+ * Return the time a call starts at, to be given to traceCall. Return 0 if trace is NULL.
+ * */
+long long traceStart(Trace trace);
+
+/**
+ * Append a call to the trace. Does nothing if trace is NULL.
+ * text may be NULL. average_play_time is only kept for CHESS_TRACE_CALCULATE_AVERAGE_PLAY_TIME.
+ * If the trace can't be written, it remembers it failed and chessTraceClose reports it.
+ * Several threads may append at once, each call is kept whole.
+ * */
+void traceCall(Trace trace, ChessTraceCall call, const int* args, int num_of_args, const char* text,
+               ChessResult result, double average_play_time, long long start);
+
+/**
+ * Write what is left of the trace and close it. Return false if any of it could not be written.
+ * */
+bool traceDestroy(Trace trace);
+
+#endif
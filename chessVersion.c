@@ -0,0 +1,631 @@
+#define _POSIX_C_SOURCE 200809L // pthreads
+
+#include "chessVersion.h"
+#include "chessOutput.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+// ------------------ DEFINES ---------------- //
+
+#define RADIX_BITS 4
+#define FANOUT (1 << RADIX_BITS)
+#define LEVELS 8 // LEVELS * RADIX_BITS bits of an id
+#define INITIAL_CAPACITY 16
+#define UNRANKED_LEVEL 0.0 // players of this level are not written by chessSavePlayersLevels
+
+typedef struct chess_version_node_t *Node;
+
+struct chess_version_node_t {
+    unsigned long owner;    // the number of the version that allocated it, the only one that may change it
+    void* children[FANOUT]; // nodes, records in the last level
+};
+
+typedef struct chess_player_record_t {
+    int id;
+    double level;
+    double average_play_time;
+} PlayerRecord;
+
+typedef struct chess_tournament_record_t {
+    TournamentSummary summary;
+    const char* location; // owned by the LocationPool of the system
+} TournamentRecord;
+
+typedef enum {
+    GARBAGE_NODE,
+    GARBAGE_RECORD,
+    GARBAGE_TREE   // a node and everything under it
+} GarbageType;
+
+typedef struct chess_garbage_t {
+    void* item;
+    GarbageType type;
+} Garbage;
+
+typedef struct chess_garbage_list_t {
+    Garbage* items;
+    int size;
+    int capacity;
+} GarbageList;
+
+struct chess_version_t {
+    void* players;        // the root of <id, PlayerRecord*>, of the players that have games
+    void* tournaments;    // the root of <id, TournamentRecord*>, of the ended tournaments
+    unsigned long number; // versions are numbered in the order they are built
+    int pins;
+    bool failed;          // an allocation failed while it was built
+    GarbageList retired;  // what the version before it held and it doesn't
+    GarbageList created;  // what it allocated, until it is published
+    Version newer;
+};
+
+struct chess_versions_t {
+    pthread_mutex_t lock; // guards every field below and every pin, and lets one writer at a time in
+    Version oldest;
+    Version current;      // the last version published
+    bool valid;           // whether current holds the last change
+    unsigned long next_number;
+};
+
+// ------------------ FUNCTIONS DECLARATIONS ---------------- //
+
+static Version beginVersion(Versions versions, bool empty);
+static void publishVersion(Versions versions, Version pending);
+static void reclaimVersions(Versions versions);
+static void setEntry(Version pending, void** root, int id, void* record);
+static void* getEntry(void* root, int id);
+static void setPlayer(Version pending, Player player);
+static void setTournament(Version pending, Tournament tournament, LocationPool locations);
+
+static bool reserveGarbage(GarbageList* list, int size);
+static void addGarbage(GarbageList* list, void* item, GarbageType type);
+static void freeGarbage(GarbageList* list, bool items);
+static void freeTree(Node node, int level);
+
+static int countRecords(Node node, int level);
+static void collectRecords(Node node, int level, void** records, int* size);
+static int compareLevels(const void* record1, const void* record2);
+static void printPlayerRecord(Output output, int index, void* records);
+static void printTournamentRecord(Output output, int index, void* records);
+
+// ------------------ FUNCTIONS IMPLEMENTATION ---------------- //
+
+Versions versionsCreate(Map players, Map tournaments, LocationPool locations)
+{
+    Versions versions = (Versions)malloc(sizeof(*versions));
+    if (versions == NULL)
+    {
+        return NULL;
+    }
+    versions->current = (Version)calloc(1, sizeof(struct chess_version_t));
+    if (versions->current == NULL)
+    {
+        free(versions);
+        return NULL;
+    }
+    if (pthread_mutex_init(&versions->lock, NULL) != 0)
+    {
+        free(versions->current);
+        free(versions);
+        return NULL;
+    }
+    versions->oldest = versions->current;
+    versions->valid = true;
+    versions->next_number = 1;
+
+    versionsRebuild(versions, players, tournaments, locations);
+    if (!versions->valid)
+    {
+        versionsDestroy(versions);
+        return NULL;
+    }
+    return versions;
+}
+
+void versionsDestroy(Versions versions)
+{
+    if (versions == NULL)
+    {
+        return;
+    }
+    // every entry is either in the current trees, or in the retired list of exactly one version
+    Version version = versions->oldest;
+    while (version != NULL)
+    {
+        Version newer = version->newer;
+        freeGarbage(&version->retired, true);
+        if (newer == NULL)
+        {
+            freeTree(version->players, 0);
+            freeTree(version->tournaments, 0);
+        }
+        free(version);
+        version = newer;
+    }
+    pthread_mutex_destroy(&versions->lock);
+    free(versions);
+}
+
+void versionsUpdatePlayers(Versions versions, Player player1, Player player2)
+{
+    if (versions == NULL)
+    {
+        return;
+    }
+    pthread_mutex_lock(&versions->lock);
+    if (versions->valid)
+    {
+        Version pending = beginVersion(versions, false);
+        setPlayer(pending, player1);
+        setPlayer(pending, player2);
+        publishVersion(versions, pending);
+    }
+    pthread_mutex_unlock(&versions->lock);
+}
+
+void versionsUpdateTournaments(Versions versions, Tournament* tournaments, int size, LocationPool locations)
+{
+    if (versions == NULL)
+    {
+        return;
+    }
+    pthread_mutex_lock(&versions->lock);
+    if (versions->valid)
+    {
+        Version pending = beginVersion(versions, false);
+        for (int i = 0; i < size; i++)
+        {
+            setTournament(pending, tournaments[i], locations);
+        }
+        publishVersion(versions, pending);
+    }
+    pthread_mutex_unlock(&versions->lock);
+}
+
+void versionsRebuild(Versions versions, Map players, Map tournaments, LocationPool locations)
+{
+    if (versions == NULL)
+    {
+        return;
+    }
+    pthread_mutex_lock(&versions->lock);
+    Version pending = beginVersion(versions, true);
+    if (pending != NULL)
+    {
+        MAP_FOREACH(int*, player_id, players)
+        {
+            setPlayer(pending, mapGet(players, player_id));
+            free(player_id);
+        }
+        MAP_FOREACH(int*, tournament_id, tournaments)
+        {
+            setTournament(pending, mapGet(tournaments, tournament_id), locations);
+            free(tournament_id);
+        }
+    }
+    publishVersion(versions, pending);
+    pthread_mutex_unlock(&versions->lock);
+}
+
+Version versionsPin(Versions versions)
+{
+    if (versions == NULL)
+    {
+        return NULL;
+    }
+    pthread_mutex_lock(&versions->lock);
+    Version version = versions->valid ? versions->current : NULL;
+    if (version != NULL)
+    {
+        version->pins++;
+    }
+    pthread_mutex_unlock(&versions->lock);
+    return version;
+}
+
+void versionsRelease(Versions versions, Version version)
+{
+    if (versions == NULL || version == NULL)
+    {
+        return;
+    }
+    pthread_mutex_lock(&versions->lock);
+    version->pins--;
+    reclaimVersions(versions);
+    pthread_mutex_unlock(&versions->lock);
+}
+
+bool versionGetAveragePlayTime(Version version, int player_id, double* average)
+{
+    PlayerRecord* record = (PlayerRecord*)getEntry(version->players, player_id);
+    if (record == NULL)
+    {
+        return false;
+    }
+    *average = record->average_play_time;
+    return true;
+}
+
+ChessResult versionSavePlayersLevels(Version version, FILE* file, Pool pool)
+{
+    int size = countRecords(version->players, 0);
+    void** records = (void**)malloc(sizeof(void*) * (size > 0 ? size : 1));
+    if (records == NULL)
+    {
+        return CHESS_SAVE_FAILURE;
+    }
+    size = 0;
+    collectRecords(version->players, 0, records, &size);
+    int ranked = 0;
+    for (int i = 0; i < size; i++)
+    {
+        if (((const PlayerRecord*)records[i])->level != UNRANKED_LEVEL)
+        {
+            records[ranked++] = records[i];
+        }
+    }
+    // by level from the highest, then by id
+    poolSort(pool, records, ranked, sizeof(void*), compareLevels);
+
+    Output output = outputForStream(file);
+    if (output == NULL)
+    {
+        free(records);
+        return CHESS_SAVE_FAILURE;
+    }
+    outputItems(output, ranked, printPlayerRecord, records, pool);
+    free(records);
+    return outputClose(output) ? CHESS_SUCCESS : CHESS_SAVE_FAILURE;
+}
+
+ChessResult versionSaveTournamentStatistics(Version version, const char* path_file, Pool pool)
+{
+    Output output = outputOpen(path_file);
+    if (output == NULL)
+    {
+        return CHESS_SAVE_FAILURE;
+    }
+    int size = countRecords(version->tournaments, 0);
+    void** records = (void**)malloc(sizeof(void*) * (size > 0 ? size : 1));
+    if (records == NULL)
+    {
+        outputClose(output);
+        return CHESS_SAVE_FAILURE;
+    }
+    size = 0;
+    collectRecords(version->tournaments, 0, records, &size);
+    outputItems(output, size, printTournamentRecord, records, pool);
+    free(records);
+    if (!outputClose(output))
+    {
+        return CHESS_SAVE_FAILURE;
+    }
+    return size < 1 ? CHESS_NO_TOURNAMENTS_ENDED : CHESS_SUCCESS;
+}
+
+/**
+ * Start the version that follows the current one, sharing its trees (or starting from empty trees).
+ * Return NULL if malloc failed. Called with the lock held.
+ * */
+static Version beginVersion(Versions versions, bool empty)
+{
+    Version pending = (Version)calloc(1, sizeof(struct chess_version_t));
+    if (pending == NULL)
+    {
+        return NULL;
+    }
+    // not its address, which may be the address of a released version whose nodes are still shared
+    pending->number = versions->next_number++;
+    Version current = versions->current;
+    if (!empty)
+    {
+        pending->players = current->players;
+        pending->tournaments = current->tournaments;
+        return pending;
+    }
+    if (!reserveGarbage(&pending->retired, 2))
+    {
+        free(pending);
+        return NULL;
+    }
+    addGarbage(&pending->retired, current->players, GARBAGE_TREE);
+    addGarbage(&pending->retired, current->tournaments, GARBAGE_TREE);
+    return pending;
+}
+
+/**
+ * Make pending the current version, or drop it if it failed. Called with the lock held.
+ * */
+static void publishVersion(Versions versions, Version pending)
+{
+    if (pending == NULL || pending->failed)
+    {
+        if (pending != NULL)
+        {
+            // what it retired is still held by the current version
+            freeGarbage(&pending->created, true);
+            freeGarbage(&pending->retired, false);
+            free(pending);
+        }
+        versions->valid = false;
+        return;
+    }
+    freeGarbage(&pending->created, false);
+    versions->current->newer = pending;
+    versions->current = pending;
+    versions->valid = true;
+    reclaimVersions(versions);
+}
+
+/**
+ * Release the oldest versions while they are not pinned.
+ * What a version retired may still be held by any version before it, so versions are
+ * released in order: the entries a version retired go once the version before it goes.
+ * */
+static void reclaimVersions(Versions versions)
+{
+    while (versions->oldest != versions->current && versions->oldest->pins == 0)
+    {
+        Version newer = versions->oldest->newer;
+        freeGarbage(&newer->retired, true);
+        free(versions->oldest);
+        versions->oldest = newer;
+    }
+}
+
+/**
+ * Set the record of id in a tree of pending (NULL to remove it), copying the nodes on its path
+ * that an older version may still read.
+ * */
+static void setEntry(Version pending, void** root, int id, void* record)
+{
+    if (pending->failed || !reserveGarbage(&pending->created, LEVELS)
+        || !reserveGarbage(&pending->retired, LEVELS + 1))
+    {
+        pending->failed = true;
+        return;
+    }
+    unsigned int key = (unsigned int)id;
+    void** slot = root;
+    for (int level = 0; level < LEVELS; level++)
+    {
+        Node node = (Node)*slot;
+        if (node == NULL && record == NULL)
+        {
+            return;
+        }
+        if (node == NULL || node->owner != pending->number)
+        {
+            Node copy = (Node)malloc(sizeof(*copy));
+            if (copy == NULL)
+            {
+                pending->failed = true;
+                return;
+            }
+            if (node == NULL)
+            {
+                memset(copy->children, 0, sizeof(copy->children));
+            }
+            else
+            {
+                memcpy(copy->children, node->children, sizeof(copy->children));
+                addGarbage(&pending->retired, node, GARBAGE_NODE);
+            }
+            copy->owner = pending->number;
+            addGarbage(&pending->created, copy, GARBAGE_NODE);
+            *slot = copy;
+            node = copy;
+        }
+        int index = (key >> (RADIX_BITS * (LEVELS - 1 - level))) & (FANOUT - 1);
+        slot = &node->children[index];
+    }
+    if (*slot != NULL)
+    {
+        addGarbage(&pending->retired, *slot, GARBAGE_RECORD);
+    }
+    *slot = record;
+}
+
+static void* getEntry(void* root, int id)
+{
+    unsigned int key = (unsigned int)id;
+    Node node = (Node)root;
+    for (int level = 0; level < LEVELS && node != NULL; level++)
+    {
+        node = (Node)node->children[(key >> (RADIX_BITS * (LEVELS - 1 - level))) & (FANOUT - 1)];
+    }
+    return node;
+}
+
+static void setPlayer(Version pending, Player player)
+{
+    if (pending == NULL || pending->failed)
+    {
+        return;
+    }
+    int player_id = playerGetID(player);
+    if (!playerExists(player))
+    {
+        setEntry(pending, &pending->players, player_id, NULL);
+        return;
+    }
+    PlayerRecord* record = (PlayerRecord*)malloc(sizeof(*record));
+    if (record == NULL || !reserveGarbage(&pending->created, 1))
+    {
+        free(record);
+        pending->failed = true;
+        return;
+    }
+    record->id = player_id;
+    record->level = playerGetLevel(player);
+    record->average_play_time = playerGetAveragePlayTime(player);
+    addGarbage(&pending->created, record, GARBAGE_RECORD);
+    setEntry(pending, &pending->players, player_id, record);
+}
+
+static void setTournament(Version pending, Tournament tournament, LocationPool locations)
+{
+    if (pending == NULL || pending->failed || !tournamentHasEnded(tournament))
+    {
+        return;
+    }
+    TournamentRecord* record = (TournamentRecord*)malloc(sizeof(*record));
+    if (record == NULL || !reserveGarbage(&pending->created, 1))
+    {
+        free(record);
+        pending->failed = true;
+        return;
+    }
+    tournamentGetSummary(tournament, &record->summary);
+    record->location = locationGet(locations, record->summary.location_id);
+    addGarbage(&pending->created, record, GARBAGE_RECORD);
+    setEntry(pending, &pending->tournaments, record->summary.id, record);
+}
+
+/**
+ * Make room for size more items, so adding them can't fail.
+ * */
+static bool reserveGarbage(GarbageList* list, int size)
+{
+    if (list->size + size <= list->capacity)
+    {
+        return true;
+    }
+    int capacity = list->capacity == 0 ? INITIAL_CAPACITY : 2 * list->capacity;
+    while (capacity < list->size + size)
+    {
+        capacity *= 2;
+    }
+    Garbage* items = (Garbage*)realloc(list->items, sizeof(Garbage) * capacity);
+    if (items == NULL)
+    {
+        return false;
+    }
+    list->items = items;
+    list->capacity = capacity;
+    return true;
+}
+
+static void addGarbage(GarbageList* list, void* item, GarbageType type)
+{
+    if (item == NULL)
+    {
+        return;
+    }
+    list->items[list->size].item = item;
+    list->items[list->size].type = type;
+    list->size++;
+}
+
+/**
+ * Empty a list, releasing its items too if items is true.
+ * */
+static void freeGarbage(GarbageList* list, bool items)
+{
+    for (int i = 0; items && i < list->size; i++)
+    {
+        if (list->items[i].type == GARBAGE_TREE)
+        {
+            freeTree((Node)list->items[i].item, 0);
+        }
+        else
+        {
+            free(list->items[i].item);
+        }
+    }
+    free(list->items);
+    list->items = NULL;
+    list->size = 0;
+    list->capacity = 0;
+}
+
+static void freeTree(Node node, int level)
+{
+    if (node == NULL)
+    {
+        return;
+    }
+    for (int i = 0; i < FANOUT; i++)
+    {
+        if (level == LEVELS - 1)
+        {
+            free(node->children[i]);
+        }
+        else
+        {
+            freeTree((Node)node->children[i], level + 1);
+        }
+    }
+    free(node);
+}
+
+static int countRecords(Node node, int level)
+{
+    if (node == NULL)
+    {
+        return 0;
+    }
+    int count = 0;
+    for (int i = 0; i < FANOUT; i++)
+    {
+        if (level == LEVELS - 1)
+        {
+            count += node->children[i] != NULL;
+        }
+        else
+        {
+            count += countRecords((Node)node->children[i], level + 1);
+        }
+    }
+    return count;
+}
+
+/**
+ * Append the records of a tree to records, by id.
+ * */
+static void collectRecords(Node node, int level, void** records, int* size)
+{
+    if (node == NULL)
+    {
+        return;
+    }
+    for (int i = 0; i < FANOUT; i++)
+    {
+        if (level < LEVELS - 1)
+        {
+            collectRecords((Node)node->children[i], level + 1, records, size);
+        }
+        else if (node->children[i] != NULL)
+        {
+            records[(*size)++] = node->children[i];
+        }
+    }
+}
+
+static int compareLevels(const void* record1, const void* record2)
+{
+    const PlayerRecord* player1 = (const PlayerRecord*)*(void* const*)record1;
+    const PlayerRecord* player2 = (const PlayerRecord*)*(void* const*)record2;
+    if (player1->level != player2->level)
+    {
+        return player1->level > player2->level ? -1 : 1;
+    }
+    return (player1->id > player2->id) - (player1->id < player2->id);
+}
+
+static void printPlayerRecord(Output output, int index, void* records)
+{
+    const PlayerRecord* record = (const PlayerRecord*)((void**)records)[index];
+    outputInt(output, record->id);
+    outputChar(output, ' ');
+    outputFixed2(output, record->level);
+    outputChar(output, '\n');
+}
+
+static void printTournamentRecord(Output output, int index, void* records)
+{
+    const TournamentRecord* record = (const TournamentRecord*)((void**)records)[index];
+    tournamentPrintSummary(&record->summary, record->location, output);
+}
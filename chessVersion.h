@@ -0,0 +1,79 @@
+#ifndef _CHESSVERSION_H_
+#define _CHESSVERSION_H_
+
+#include "chessSystem.h"
+#include "chessTournament.h"
+#include "chessPlayer.h"
+#include "chessLocation.h"
+#include "chessPool.h"
+#include "map.h"
+#include <stdio.h>
+#include <stdbool.h>
+
+/**
+ * Immutable versions of what the queries of a ChessSystem read (see chessEnableSnapshotReads):
+ * the level and average play time of every player, and the statistics of every ended tournament.
+ *
+ * Every change of the system publishes a new version. A version is a pair of radix trees,
+ * and a change copies only the paths to the entries it changed, sharing the rest with the
+ * version before it. A query pins the current version and reads it without any lock on the system,
+ * while the writers go on publishing. The entries a version stopped sharing are released
+ * once it, and every version before it, is no longer pinned.
+ * */
+typedef struct chess_versions_t *Versions;
+typedef struct chess_version_t *Version;
+
+/**
+ * Create the versions of a system, starting from what its maps hold.
+ * Return NULL if malloc failed.
+ * */
+Versions versionsCreate(Map players, Map tournaments, LocationPool locations);
+
+/**
+ * Destroy every version. None may be pinned.
+ * */
+void versionsDestroy(Versions versions);
+
+/**
+ * Publish the current records of two players (a player without games has none).
+ * The functions that publish do nothing if versions is NULL. If one fails (malloc failed),
+ * no version is pinned until versionsRebuild succeeds, and the queries read the system itself.
+ * */
+void versionsUpdatePlayers(Versions versions, Player player1, Player player2);
+
+/**
+ * Publish the statistics of tournaments that just ended, all in one version.
+ * */
+void versionsUpdateTournaments(Versions versions, Tournament* tournaments, int size, LocationPool locations);
+
+/**
+ * Publish a version built again from the maps, after a change that touched an unknown set of entries.
+ * */
+void versionsRebuild(Versions versions, Map players, Map tournaments, LocationPool locations);
+
+/**
+ * Pin the current version. Return NULL if versions is NULL, or if the last change could not be published.
+ * */
+Version versionsPin(Versions versions);
+
+/**
+ * Release a version pinned by versionsPin.
+ * */
+void versionsRelease(Versions versions, Version version);
+
+/**
+ * Set average to the average play time of a player. Return false if the player has no games.
+ * */
+bool versionGetAveragePlayTime(Version version, int player_id, double* average);
+
+/**
+ * Write the levels of the players, like chessSavePlayersLevels, sorting and formatting them on pool.
+ * */
+ChessResult versionSavePlayersLevels(Version version, FILE* file, Pool pool);
+
+/**
+ * Write the statistics of the ended tournaments, like chessSaveTournamentStatistics, formatting them on pool.
+ * */
+ChessResult versionSaveTournamentStatistics(Version version, const char* path_file, Pool pool);
+
+#endif
\ No newline at end of file
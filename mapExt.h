@@ -0,0 +1,48 @@
+#ifndef _MAPEXT_H_
+#define _MAPEXT_H_
+
+#include "map.h"
+
+/**
+ * More of the Map of map.h, implemented in mtm_map/map.c.
+ * */
+
+/**
+ * Like mapPut, but a key smaller than every key of the map is added at its head, without searching
+ * the map for it. Adding keys from the highest down costs O(1) each, instead of a walk of the map.
+ * */
+MapResult mapPutFirst(Map map, MapKeyElement keyElement, MapDataElement dataElement);
+
+/**
+ * Walking a Map without copying its keys.
+ * The keys returned here belong to the map: they must not be freed, and are only valid until
+ * the map changes. They move the same iterator as mapGetFirst and mapGetNext.
+ * */
+
+/**
+ * Move the iterator to the first element whose key is greater than keyElement,
+ * or to the first element of the map if keyElement is NULL.
+ * Return its key, or NULL if there is no such element.
+ * */
+MapKeyElement mapGetAfter(Map map, MapKeyElement keyElement);
+
+/**
+ * Move the iterator to the next element. Return its key, or NULL at the end of the map.
+ * */
+MapKeyElement mapAdvance(Map map);
+
+/**
+ * Return the data of the element of the iterator, NULL if the iterator is not on an element.
+ * */
+MapDataElement mapGetCurrentData(Map map);
+
+/**
+ * Like MAP_FOREACH, over the elements whose keys are greater than after (all of them if it is NULL),
+ * without a copy, and so without a free, of every key.
+ * */
+#define MAP_FOREACH_AFTER(type, iterator, map, after) \
+    for(type iterator = (type) mapGetAfter(map, after) ; \
+        iterator ;\
+        iterator = (type) mapAdvance(map))
+
+#endif
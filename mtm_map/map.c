@@ -1,4 +1,5 @@
 #include "map.h"
+#include "mapExt.h"
 
 #include <stdlib.h>
 #include <stdbool.h>
@@ -151,6 +152,25 @@ MapResult mapPut(Map map, MapKeyElement keyElement, MapDataElement dataElement)
     return MAP_SUCCESS;
 }
 
+MapResult mapPutFirst(Map map, MapKeyElement keyElement, MapDataElement dataElement)
+{
+    if (map == NULL || keyElement == NULL || dataElement == NULL)
+    {
+        return MAP_NULL_ARGUMENT;
+    }
+    if (map->head != NULL && map->compareKeyElements(keyElement, map->head->key) >= 0)
+    {
+        return mapPut(map, keyElement, dataElement);
+    }
+
+    // smaller than the head, so addNewElement stops right there
+    if (!addNewElement(map, keyElement, dataElement))
+    {
+        return MAP_OUT_OF_MEMORY;
+    }
+    return MAP_SUCCESS;
+}
+
 static bool addNewElement(Map map, MapKeyElement keyElement, MapDataElement dataElement)
 {
     Node* new_node = (Node*)malloc(sizeof(*new_node));
@@ -263,6 +283,44 @@ MapKeyElement mapGetNext(Map map)
     return map->copyKeyElement(map->iterator->key);
 }
 
+MapKeyElement mapGetAfter(Map map, MapKeyElement keyElement)
+{
+    if (map == NULL)
+    {
+        return NULL;
+    }
+
+    map->iterator = map->head;
+    // the list is sorted, so every key before the iterator is smaller or equal
+    while (keyElement != NULL && map->iterator != NULL
+           && map->compareKeyElements(map->iterator->key, keyElement) <= 0)
+    {
+        map->iterator = map->iterator->next;
+    }
+    return map->iterator == NULL ? NULL : map->iterator->key;
+}
+
+MapKeyElement mapAdvance(Map map)
+{
+    if (map == NULL || map->iterator == NULL)
+    {
+        return NULL;
+    }
+
+    map->iterator = map->iterator->next;
+    return map->iterator == NULL ? NULL : map->iterator->key;
+}
+
+MapDataElement mapGetCurrentData(Map map)
+{
+    if (map == NULL || map->iterator == NULL)
+    {
+        return NULL;
+    }
+
+    return map->iterator->data;
+}
+
 MapResult mapClear(Map map)
 {
     if (map == NULL)
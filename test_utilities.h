@@ -0,0 +1,98 @@
+#ifndef TEST_UTILITIES_H_
+#define TEST_UTILITIES_H_
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * These macros are here to help you create tests more easily and keep them clear.
+ *
+ * Every test is a function returning bool, that creates what it needs,
+ * checks the results with ASSERT_TEST and returns true.
+ * The main function of a test file runs them with RUN_TEST, and returns
+ * TEST_EXIT_STATUS so a failed test fails the whole program.
+ */
+
+static int tests_failed = 0;
+
+/**
+ * Evaluates expr and continues if expr is true.
+ * If expr is false, runs destroy, ends the test by returning false
+ * and prints a detailed message about the failure.
+ */
+#define ASSERT_TEST(expr, destroy)                                                  \
+    do {                                                                            \
+        if (!(expr)) {                                                              \
+            printf("\nAssertion failed at %s:%d %s ", __FILE__, __LINE__, #expr);   \
+            destroy;                                                                \
+            return false;                                                           \
+        }                                                                           \
+    } while (0)
+
+/**
+ * Macro used for running a test from the main function
+ */
+#define RUN_TEST(test, name)                    \
+    do {                                        \
+        if (test()) {                           \
+            printf("[OK] %s\n", name);          \
+        } else {                                \
+            printf("[Failed] %s\n", name);      \
+            tests_failed++;                     \
+        }                                       \
+    } while (0)
+
+#define TEST_EXIT_STATUS (tests_failed == 0 ? 0 : 1)
+
+/**
+ * Return true if both files exist and have the same content.
+ */
+static inline bool testFilesEqual(const char* path1, const char* path2)
+{
+    FILE* file1 = fopen(path1, "rb");
+    FILE* file2 = fopen(path2, "rb");
+    bool equal = file1 != NULL && file2 != NULL;
+    while (equal)
+    {
+        int c1 = fgetc(file1);
+        int c2 = fgetc(file2);
+        equal = (c1 == c2);
+        if (c1 == EOF || c2 == EOF)
+        {
+            break;
+        }
+    }
+    if (file1 != NULL)
+    {
+        fclose(file1);
+    }
+    if (file2 != NULL)
+    {
+        fclose(file2);
+    }
+    return equal;
+}
+
+/**
+ * Return true if the file exists and its content is exactly expected.
+ */
+static inline bool testFileContains(const char* path, const char* expected)
+{
+    FILE* file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        return false;
+    }
+    size_t length = strlen(expected);
+    bool equal = true;
+    for (size_t i = 0; i < length && equal; i++)
+    {
+        equal = (fgetc(file) == (unsigned char)expected[i]);
+    }
+    equal = equal && fgetc(file) == EOF;
+    fclose(file);
+    return equal;
+}
+
+#endif /* TEST_UTILITIES_H_ */
\ No newline at end of file
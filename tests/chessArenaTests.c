@@ -0,0 +1,124 @@
+#include <stdint.h>
+#include <string.h>
+#include "../chessSystem.h"
+#include "../chessArena.h"
+#include "../test_utilities.h"
+
+#define NUM_OF_ALLOCATIONS 1000
+
+bool testArenaAllocAligned()
+{
+    Arena arena = arenaCreate();
+    ASSERT_TEST(arena != NULL, );
+    for (size_t size = 1; size < 100; size += 7)
+    {
+        void* memory = arenaAlloc(arena, size);
+        ASSERT_TEST(memory != NULL, arenaDestroy(arena));
+        ASSERT_TEST((uintptr_t)memory % sizeof(double) == 0, arenaDestroy(arena));
+        ASSERT_TEST((uintptr_t)memory % sizeof(void*) == 0, arenaDestroy(arena));
+    }
+
+    arenaDestroy(arena);
+    return true;
+}
+
+bool testArenaAllocationsDontOverlap()
+{
+    Arena arena = arenaCreate();
+    ASSERT_TEST(arena != NULL, );
+    int* allocations[NUM_OF_ALLOCATIONS];
+    for (int i = 0; i < NUM_OF_ALLOCATIONS; i++)
+    {
+        // sizes from one int up to bigger than a whole chunk
+        int length = 1 + (i * 37) % 20000;
+        allocations[i] = (int*)arenaAlloc(arena, sizeof(int) * length);
+        ASSERT_TEST(allocations[i] != NULL, arenaDestroy(arena));
+        allocations[i][0] = i;
+        allocations[i][length - 1] = i;
+    }
+    for (int i = 0; i < NUM_OF_ALLOCATIONS; i++)
+    {
+        int length = 1 + (i * 37) % 20000;
+        ASSERT_TEST(allocations[i][0] == i && allocations[i][length - 1] == i, arenaDestroy(arena));
+    }
+
+    arenaDestroy(arena);
+    return true;
+}
+
+bool testArenaRewind()
+{
+    Arena arena = arenaCreate();
+    ASSERT_TEST(arena != NULL, );
+    char* kept = (char*)arenaAlloc(arena, 16);
+    ASSERT_TEST(kept != NULL, arenaDestroy(arena));
+    strcpy(kept, "kept");
+    ArenaMark mark = arenaGetMark(arena);
+
+    // rewind after filling several chunks, to something that fits in the first one
+    for (int i = 0; i < 100; i++)
+    {
+        ASSERT_TEST(arenaAlloc(arena, 1000) != NULL, arenaDestroy(arena));
+    }
+    char* small = (char*)arenaRewind(arena, mark, 8);
+    ASSERT_TEST(small != NULL, arenaDestroy(arena));
+    strcpy(small, "small");
+
+    // and to something bigger than what is left in it
+    for (int i = 0; i < 100; i++)
+    {
+        ASSERT_TEST(arenaAlloc(arena, 1000) != NULL, arenaDestroy(arena));
+    }
+    char* big = (char*)arenaRewind(arena, mark, 100000);
+    ASSERT_TEST(big != NULL, arenaDestroy(arena));
+    memset(big, 'x', 100000);
+    ASSERT_TEST(strcmp(kept, "kept") == 0, arenaDestroy(arena));
+
+    // the arena keeps working after a rewind
+    char* after = (char*)arenaAlloc(arena, 16);
+    ASSERT_TEST(after != NULL, arenaDestroy(arena));
+    strcpy(after, "after");
+    ASSERT_TEST(strcmp(kept, "kept") == 0 && big[99999] == 'x', arenaDestroy(arena));
+
+    arenaDestroy(arena);
+    return true;
+}
+
+bool testManyTournamentsLifecycle()
+{
+    ChessSystem chess = chessCreate();
+    for (int id = 1; id <= 200; id++)
+    {
+        ASSERT_TEST(chessAddTournament(chess, id, 100, "London") == CHESS_SUCCESS, chessDestroy(chess));
+        // from empty tournaments to tournaments that span several chunks
+        for (int player = 1; player < id % 50; player++)
+        {
+            ASSERT_TEST(chessAddGame(chess, id, player, player + 1, player % 3, player) == CHESS_SUCCESS,
+                        chessDestroy(chess));
+        }
+    }
+    for (int id = 2; id <= 200; id += 2)
+    {
+        ChessResult result = chessEndTournament(chess, id);
+        ASSERT_TEST(result == CHESS_SUCCESS || (id % 50 <= 1 && result == CHESS_NO_GAMES), chessDestroy(chess));
+    }
+    for (int id = 1; id <= 200; id += 3)
+    {
+        ASSERT_TEST(chessRemoveTournament(chess, id) == CHESS_SUCCESS, chessDestroy(chess));
+    }
+    ChessResult result;
+    chessCalculateAveragePlayTime(chess, 1, &result);
+    ASSERT_TEST(result == CHESS_SUCCESS, chessDestroy(chess));
+
+    chessDestroy(chess);
+    return true;
+}
+
+int main()
+{
+    RUN_TEST(testArenaAllocAligned, "testArenaAllocAligned");
+    RUN_TEST(testArenaAllocationsDontOverlap, "testArenaAllocationsDontOverlap");
+    RUN_TEST(testArenaRewind, "testArenaRewind");
+    RUN_TEST(testManyTournamentsLifecycle, "testManyTournamentsLifecycle");
+    return TEST_EXIT_STATUS;
+}
\ No newline at end of file
@@ -0,0 +1,167 @@
+#define _POSIX_C_SOURCE 200809L // open_memstream
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../chessSystem.h"
+#include "../chessSystemExt.h"
+#include "chessTestUtilities.h"
+
+#define EXPECTED_FILE "async_expected.txt"
+#define ASYNC_FILE "async_saved.txt"
+
+/**
+ * Save the levels of the system to path, the synchronous way. Return the result of the save.
+ * */
+static ChessResult saveLevels(ChessSystem chess, const char* path)
+{
+    FILE* file = fopen(path, "w");
+    if (file == NULL)
+    {
+        return CHESS_SAVE_FAILURE;
+    }
+    ChessResult result = chessSavePlayersLevels(chess, file);
+    fclose(file);
+    return result;
+}
+
+/**
+ * The file is the one the synchronous call writes, of the system as it was when the save
+ * started, even though the system changes while the file is written.
+ * */
+bool testAsyncStatisticsLikeSync()
+{
+    for (unsigned int seed = 1; seed <= 5; seed++)
+    {
+        ChessSystem chess = chessCreate();
+        ASSERT_TEST(testRunOperations(chess, seed, 3000), chessDestroy(chess));
+        ChessResult expected = chessSaveTournamentStatistics(chess, EXPECTED_FILE);
+        ChessResult result;
+        ChessSave save = chessSaveTournamentStatisticsAsync(chess, ASYNC_FILE, &result);
+        ASSERT_TEST(save != NULL && result == CHESS_SUCCESS, chessDestroy(chess));
+        ASSERT_TEST(testRunOperations(chess, seed + 100, 3000), chessSaveWait(save); chessDestroy(chess));
+        ASSERT_TEST(chessSaveWait(save) == expected, chessDestroy(chess));
+        if (expected == CHESS_SUCCESS)
+        {
+            ASSERT_TEST(testFilesEqual(ASYNC_FILE, EXPECTED_FILE), chessDestroy(chess));
+        }
+        chessDestroy(chess);
+    }
+    return true;
+}
+
+bool testAsyncLevelsLikeSync()
+{
+    for (unsigned int seed = 1; seed <= 5; seed++)
+    {
+        ChessSystem chess = chessCreate();
+        ASSERT_TEST(testRunOperations(chess, seed, 3000), chessDestroy(chess));
+        ChessResult expected = saveLevels(chess, EXPECTED_FILE);
+        FILE* file = fopen(ASYNC_FILE, "w");
+        ASSERT_TEST(file != NULL, chessDestroy(chess));
+        ChessResult result;
+        ChessSave save = chessSavePlayersLevelsAsync(chess, file, &result);
+        ASSERT_TEST(save != NULL && result == CHESS_SUCCESS, fclose(file); chessDestroy(chess));
+        ASSERT_TEST(testRunOperations(chess, seed + 100, 3000), chessSaveWait(save); fclose(file); chessDestroy(chess));
+        while (!chessSavePoll(save))
+        {
+        }
+        ASSERT_TEST(chessSaveWait(save) == expected, fclose(file); chessDestroy(chess));
+        fclose(file);
+        ASSERT_TEST(testFilesEqual(ASYNC_FILE, EXPECTED_FILE), chessDestroy(chess));
+        chessDestroy(chess);
+    }
+    return true;
+}
+
+/**
+ * What was written to the stream before the save stays before it, and is written once.
+ * */
+bool testAsyncLevelsAfterBufferedOutput()
+{
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(testRunOperations(chess, 9, 2000), chessDestroy(chess));
+    FILE* file = fopen(EXPECTED_FILE, "w");
+    ASSERT_TEST(file != NULL, chessDestroy(chess));
+    fprintf(file, "levels:\n");
+    ASSERT_TEST(chessSavePlayersLevels(chess, file) == CHESS_SUCCESS, fclose(file); chessDestroy(chess));
+    fprintf(file, "end\n");
+    fclose(file);
+
+    file = fopen(ASYNC_FILE, "w");
+    ASSERT_TEST(file != NULL, chessDestroy(chess));
+    fprintf(file, "levels:\n");
+    ChessSave save = chessSavePlayersLevelsAsync(chess, file, NULL);
+    ASSERT_TEST(save != NULL, fclose(file); chessDestroy(chess));
+    ASSERT_TEST(chessSaveWait(save) == CHESS_SUCCESS, fclose(file); chessDestroy(chess));
+    fprintf(file, "end\n");
+    fclose(file);
+    ASSERT_TEST(testFilesEqual(ASYNC_FILE, EXPECTED_FILE), chessDestroy(chess));
+
+    chessDestroy(chess);
+    return true;
+}
+
+/**
+ * A memory stream has no file descriptor, so it is written before the call returns.
+ * */
+bool testAsyncLevelsToMemory()
+{
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(testRunOperations(chess, 10, 2000), chessDestroy(chess));
+    ASSERT_TEST(saveLevels(chess, EXPECTED_FILE) == CHESS_SUCCESS, chessDestroy(chess));
+    char* buffer = NULL;
+    size_t size = 0;
+    FILE* stream = open_memstream(&buffer, &size);
+    ASSERT_TEST(stream != NULL, chessDestroy(chess));
+    ChessSave save = chessSavePlayersLevelsAsync(chess, stream, NULL);
+    ASSERT_TEST(save != NULL && chessSavePoll(save), chessSaveWait(save); fclose(stream); free(buffer); chessDestroy(chess));
+    ASSERT_TEST(chessSaveWait(save) == CHESS_SUCCESS, fclose(stream); free(buffer); chessDestroy(chess));
+    fclose(stream);
+    FILE* file = fopen(ASYNC_FILE, "w");
+    ASSERT_TEST(file != NULL && fwrite(buffer, 1, size, file) == size, free(buffer); chessDestroy(chess));
+    fclose(file);
+    free(buffer);
+    ASSERT_TEST(testFilesEqual(ASYNC_FILE, EXPECTED_FILE), chessDestroy(chess));
+
+    chessDestroy(chess);
+    return true;
+}
+
+bool testAsyncErrors()
+{
+    ChessSystem chess = chessCreate();
+    ChessResult result;
+    // the errors of the save are returned by the wait, as the synchronous call returns them
+    ChessSave save = chessSaveTournamentStatisticsAsync(chess, ASYNC_FILE, &result);
+    ASSERT_TEST(save != NULL && result == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessSaveWait(save) == CHESS_NO_TOURNAMENTS_ENDED, chessDestroy(chess));
+
+    ASSERT_TEST(chessAddTournament(chess, 1, 1, "London") == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddGame(chess, 1, 1, 2, FIRST_PLAYER, 10) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessEndTournament(chess, 1) == CHESS_SUCCESS, chessDestroy(chess));
+    save = chessSaveTournamentStatisticsAsync(chess, "no_such_dir/statistics.txt", &result);
+    ASSERT_TEST(save != NULL && result == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessSaveWait(save) == CHESS_SAVE_FAILURE, chessDestroy(chess));
+
+    ASSERT_TEST(chessSaveTournamentStatisticsAsync(NULL, ASYNC_FILE, &result) == NULL && result == CHESS_NULL_ARGUMENT,
+                chessDestroy(chess));
+    ASSERT_TEST(chessSavePlayersLevelsAsync(chess, NULL, &result) == NULL && result == CHESS_NULL_ARGUMENT,
+                chessDestroy(chess));
+    ASSERT_TEST(chessSavePlayersLevelsAsync(NULL, stdout, &result) == NULL && result == CHESS_NULL_ARGUMENT,
+                chessDestroy(chess));
+    ASSERT_TEST(chessSaveWait(NULL) == CHESS_NULL_ARGUMENT, chessDestroy(chess));
+    ASSERT_TEST(chessSavePoll(NULL), chessDestroy(chess));
+
+    chessDestroy(chess);
+    return true;
+}
+
+int main()
+{
+    RUN_TEST(testAsyncStatisticsLikeSync, "testAsyncStatisticsLikeSync");
+    RUN_TEST(testAsyncLevelsLikeSync, "testAsyncLevelsLikeSync");
+    RUN_TEST(testAsyncLevelsAfterBufferedOutput, "testAsyncLevelsAfterBufferedOutput");
+    RUN_TEST(testAsyncLevelsToMemory, "testAsyncLevelsToMemory");
+    RUN_TEST(testAsyncErrors, "testAsyncErrors");
+    return TEST_EXIT_STATUS;
+}
\ No newline at end of file
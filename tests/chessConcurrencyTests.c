@@ -0,0 +1,228 @@
+#include <stdio.h>
+#include <pthread.h>
+#include "../chessSystem.h"
+#include "../chessSystemExt.h"
+#include "chessTestUtilities.h"
+
+#define NUM_OF_THREADS 8
+#define NUM_OF_PLAYERS 150
+#define ROUNDS_PER_THREAD 9 // the distances between the players of a game stay under NUM_OF_PLAYERS / 2
+#define GAMES_PER_THREAD (ROUNDS_PER_THREAD * NUM_OF_PLAYERS)
+#define NUM_OF_READS 300
+
+typedef struct {
+    ChessSystem chess;
+    int thread;
+    int tournament_id;
+    bool failed;
+} Writer;
+
+typedef struct {
+    ChessSystem chess;
+    bool failed;
+} Reader;
+
+/**
+ * Game i of a thread: the players of every thread are the same, so the threads share their stripes,
+ * but every pair of players is a distance apart that no other game has, so every game is added
+ * whatever the order of the threads.
+ * */
+static ChessResult addGame(ChessSystem chess, int tournament_id, int thread, int i)
+{
+    int distance = 1 + thread + NUM_OF_THREADS * (i / NUM_OF_PLAYERS);
+    int player1 = 1 + i % NUM_OF_PLAYERS;
+    int player2 = 1 + (player1 - 1 + distance) % NUM_OF_PLAYERS;
+    return chessAddGame(chess, tournament_id, player1, player2, (Winner)((i + thread) % 3), 1 + (i * 7 + thread) % 500);
+}
+
+static void* writeGames(void* argument)
+{
+    Writer* writer = (Writer*)argument;
+    for (int i = 0; i < GAMES_PER_THREAD; i++)
+    {
+        ChessResult result = addGame(writer->chess, writer->tournament_id, writer->thread, i);
+        writer->failed = writer->failed || result != CHESS_SUCCESS;
+    }
+    return NULL;
+}
+
+/**
+ * Query the system while it changes. Every answer must be one the system could give.
+ * */
+static void* readSystem(void* argument)
+{
+    Reader* reader = (Reader*)argument;
+    FILE* file = fopen("/dev/null", "w");
+    reader->failed = file == NULL;
+    int ids[NUM_OF_PLAYERS];
+    ChessPlayerStats stats[NUM_OF_PLAYERS];
+    for (int i = 0; i < NUM_OF_PLAYERS; i++)
+    {
+        ids[i] = i + 1;
+    }
+    for (int i = 0; i < NUM_OF_READS && !reader->failed; i++)
+    {
+        ChessResult result;
+        double average = chessCalculateAveragePlayTime(reader->chess, 1 + i % NUM_OF_PLAYERS, &result);
+        reader->failed = (result != CHESS_SUCCESS && result != CHESS_PLAYER_NOT_EXIST)
+                         || (result == CHESS_SUCCESS && (average < 1 || average > 500));
+        ChessResult levels = chessSavePlayersLevels(reader->chess, file);
+        reader->failed = reader->failed || levels != CHESS_SUCCESS;
+        if (i % 10 == 0)
+        {
+            reader->failed = reader->failed
+                             || chessGetPlayersStats(reader->chess, ids, NUM_OF_PLAYERS, stats) != CHESS_SUCCESS;
+        }
+    }
+    if (file != NULL)
+    {
+        fclose(file);
+    }
+    return NULL;
+}
+
+/**
+ * Add the games of every thread on its own thread, with readers running meanwhile, and check the
+ * system ends up as if the games were added one thread after the other.
+ * same_tournament makes all the threads add to one tournament, otherwise each has its own.
+ * */
+static bool writeInParallel(bool same_tournament, int num_of_readers)
+{
+    ChessSystem chess = chessCreate();
+    ChessSystem expected = chessCreate();
+    bool same = chess != NULL && expected != NULL && chessEnableConcurrency(chess) == CHESS_SUCCESS;
+    Writer writers[NUM_OF_THREADS];
+    for (int thread = 0; thread < NUM_OF_THREADS && same; thread++)
+    {
+        int tournament_id = same_tournament ? 1 : thread + 1;
+        writers[thread] = (Writer){ chess, thread, tournament_id, false };
+        if (thread == 0 || !same_tournament)
+        {
+            const char* location = thread % 2 ? "London" : "Paris";
+            same = chessAddTournament(chess, tournament_id, GAMES_PER_THREAD * NUM_OF_THREADS, location) == CHESS_SUCCESS
+                   && chessAddTournament(expected, tournament_id, GAMES_PER_THREAD * NUM_OF_THREADS, location)
+                          == CHESS_SUCCESS;
+        }
+        for (int i = 0; i < GAMES_PER_THREAD && same; i++)
+        {
+            same = addGame(expected, tournament_id, thread, i) == CHESS_SUCCESS;
+        }
+    }
+    if (!same)
+    {
+        chessDestroy(chess);
+        chessDestroy(expected);
+        return false;
+    }
+
+    pthread_t writer_threads[NUM_OF_THREADS];
+    pthread_t reader_threads[NUM_OF_THREADS];
+    Reader readers[NUM_OF_THREADS];
+    for (int i = 0; i < num_of_readers; i++)
+    {
+        readers[i] = (Reader){ chess, false };
+        pthread_create(&reader_threads[i], NULL, readSystem, &readers[i]);
+    }
+    for (int thread = 0; thread < NUM_OF_THREADS; thread++)
+    {
+        pthread_create(&writer_threads[thread], NULL, writeGames, &writers[thread]);
+    }
+    for (int thread = 0; thread < NUM_OF_THREADS; thread++)
+    {
+        pthread_join(writer_threads[thread], NULL);
+        same = same && !writers[thread].failed;
+    }
+    for (int i = 0; i < num_of_readers; i++)
+    {
+        pthread_join(reader_threads[i], NULL);
+        same = same && !readers[i].failed;
+    }
+
+    same = same && testSameSystems(chess, expected, NUM_OF_PLAYERS);
+    for (int tournament_id = 1; tournament_id <= NUM_OF_THREADS && same; tournament_id++)
+    {
+        ChessResult result = chessEndTournament(chess, tournament_id);
+        same = result == chessEndTournament(expected, tournament_id);
+    }
+    same = same && testSameSystems(chess, expected, NUM_OF_PLAYERS);
+    chessDestroy(chess);
+    chessDestroy(expected);
+    return same;
+}
+
+bool testConcurrentWritersOwnTournaments()
+{
+    ASSERT_TEST(writeInParallel(false, 0), );
+    return true;
+}
+
+bool testConcurrentWritersSameTournament()
+{
+    ASSERT_TEST(writeInParallel(true, 0), );
+    return true;
+}
+
+bool testConcurrentWritersAndReaders()
+{
+    ASSERT_TEST(writeInParallel(false, 3), );
+    ASSERT_TEST(writeInParallel(true, 3), );
+    return true;
+}
+
+/**
+ * Calls that have the system to themselves, made while games are added.
+ * */
+bool testConcurrentWritersAndRemovals()
+{
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(chessEnableConcurrency(chess) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessEnableConcurrency(chess) == CHESS_SUCCESS, chessDestroy(chess));
+    Writer writers[NUM_OF_THREADS];
+    pthread_t threads[NUM_OF_THREADS];
+    for (int thread = 0; thread < NUM_OF_THREADS; thread++)
+    {
+        ASSERT_TEST(chessAddTournament(chess, thread + 1, GAMES_PER_THREAD, "London") == CHESS_SUCCESS,
+                    chessDestroy(chess));
+        writers[thread] = (Writer){ chess, thread, thread + 1, false };
+    }
+    for (int thread = 0; thread < NUM_OF_THREADS; thread++)
+    {
+        pthread_create(&threads[thread], NULL, writeGames, &writers[thread]);
+    }
+    // players and tournaments go away under the writers, which then get errors of their own
+    for (int i = 0; i < 200; i++)
+    {
+        chessRemovePlayer(chess, 1 + i % NUM_OF_PLAYERS);
+        if (i % 50 == 49)
+        {
+            chessEndTournament(chess, 1 + i / 50);
+        }
+    }
+    ChessResult removed = chessRemoveTournament(chess, NUM_OF_THREADS);
+    for (int thread = 0; thread < NUM_OF_THREADS; thread++)
+    {
+        pthread_join(threads[thread], NULL);
+    }
+    ASSERT_TEST(removed == CHESS_SUCCESS, chessDestroy(chess));
+
+    // the system is still whole: a snapshot of it loads into the same system
+    ASSERT_TEST(chessSaveSnapshot(chess, "concurrency.snap") == CHESS_SUCCESS, chessDestroy(chess));
+    ChessResult result;
+    ChessSystem loaded = chessLoadSnapshot("concurrency.snap", &result);
+    ASSERT_TEST(loaded != NULL && result == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(testSameSystems(chess, loaded, NUM_OF_PLAYERS), chessDestroy(chess); chessDestroy(loaded));
+
+    chessDestroy(loaded);
+    chessDestroy(chess);
+    ASSERT_TEST(chessEnableConcurrency(NULL) == CHESS_NULL_ARGUMENT, );
+    return true;
+}
+
+int main()
+{
+    RUN_TEST(testConcurrentWritersOwnTournaments, "testConcurrentWritersOwnTournaments");
+    RUN_TEST(testConcurrentWritersSameTournament, "testConcurrentWritersSameTournament");
+    RUN_TEST(testConcurrentWritersAndReaders, "testConcurrentWritersAndReaders");
+    RUN_TEST(testConcurrentWritersAndRemovals, "testConcurrentWritersAndRemovals");
+    return TEST_EXIT_STATUS;
+}
\ No newline at end of file
@@ -0,0 +1,319 @@
+#include <stdio.h>
+#include <string.h>
+#include "../chessSystem.h"
+#include "../chessSystemExt.h"
+#include "chessTestUtilities.h"
+
+#define NUM_OF_GAMES 500
+#define MAX_ROWS 1000
+
+static bool sameStats(const ChessPlayerStats* stats1, const ChessPlayerStats* stats2)
+{
+    return stats1->player_id == stats2->player_id && stats1->result == stats2->result
+           && stats1->average_play_time == stats2->average_play_time && stats1->level == stats2->level
+           && stats1->wins == stats2->wins && stats1->losses == stats2->losses && stats1->draws == stats2->draws;
+}
+
+/**
+ * Read all the games of a tournament in batches of batch_size rows.
+ * Return the number of rows, or -1 if a batch was larger than asked.
+ * */
+static int readGames(ChessSystem chess, int tournament_id, int batch_size, ChessGameRow* rows)
+{
+    ChessResult result;
+    ChessGamesCursor cursor = chessGamesCursorOpen(chess, tournament_id, &result);
+    if (cursor == NULL || result != CHESS_SUCCESS)
+    {
+        return -1;
+    }
+    int size = 0;
+    int count;
+    while ((count = chessGamesCursorNext(cursor, rows + size, batch_size)) > 0)
+    {
+        if (count > batch_size || size + count > MAX_ROWS - batch_size)
+        {
+            chessGamesCursorClose(cursor);
+            return -1;
+        }
+        size += count;
+    }
+    chessGamesCursorClose(cursor);
+    return size;
+}
+
+static bool addGames(ChessSystem chess, int tournament_id, int first, int last)
+{
+    for (int i = first; i < last; i++)
+    {
+        if (chessAddGame(chess, tournament_id, 1 + i, 1000 + i, (Winner)(i % 3), i) != CHESS_SUCCESS)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool isGame(const ChessGameRow* row, int tournament_id, int i)
+{
+    return row->tournament_id == tournament_id && row->first_player == 1 + i && row->second_player == 1000 + i
+           && row->winner == (Winner)(i % 3) && row->play_time == i;
+}
+
+bool testGamesCursorInOrder()
+{
+    static ChessGameRow rows[MAX_ROWS];
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(chessAddTournament(chess, 1, 1, "London") == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(addGames(chess, 1, 0, NUM_OF_GAMES), chessDestroy(chess));
+    int batch_sizes[] = { 1, 7, NUM_OF_GAMES, MAX_ROWS / 2 };
+    for (int j = 0; j < (int)(sizeof(batch_sizes) / sizeof(batch_sizes[0])); j++)
+    {
+        ASSERT_TEST(readGames(chess, 1, batch_sizes[j], rows) == NUM_OF_GAMES, chessDestroy(chess));
+        for (int i = 0; i < NUM_OF_GAMES; i++)
+        {
+            ASSERT_TEST(isGame(&rows[i], 1, i), chessDestroy(chess));
+        }
+    }
+
+    // a removed player is 0, and the game is won by the other one
+    ASSERT_TEST(chessRemovePlayer(chess, 1003) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(readGames(chess, 1, 10, rows) == NUM_OF_GAMES, chessDestroy(chess));
+    ASSERT_TEST(rows[3].first_player == 4 && rows[3].second_player == 0 && rows[3].winner == FIRST_PLAYER,
+                chessDestroy(chess));
+
+    // the games of an ended tournament are read the same
+    ASSERT_TEST(chessEndTournament(chess, 1) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(readGames(chess, 1, 13, rows) == NUM_OF_GAMES, chessDestroy(chess));
+    ASSERT_TEST(rows[3].first_player == 4 && rows[3].second_player == 0, chessDestroy(chess));
+    for (int i = 4; i < NUM_OF_GAMES; i++)
+    {
+        ASSERT_TEST(isGame(&rows[i], 1, i), chessDestroy(chess));
+    }
+
+    chessDestroy(chess);
+    return true;
+}
+
+/**
+ * Games added while the cursor is open are returned, every game once, also when the tournament
+ * ends (and its games are frozen) between two batches.
+ * */
+bool testGamesCursorWhileChanging()
+{
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(chessAddTournament(chess, 1, 1, "London") == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(addGames(chess, 1, 0, 100), chessDestroy(chess));
+    ChessGamesCursor cursor = chessGamesCursorOpen(chess, 1, NULL);
+    ASSERT_TEST(cursor != NULL, chessDestroy(chess));
+    ChessGameRow rows[40];
+    ASSERT_TEST(chessGamesCursorNext(cursor, rows, 40) == 40, chessGamesCursorClose(cursor); chessDestroy(chess));
+    ASSERT_TEST(isGame(&rows[39], 1, 39), chessGamesCursorClose(cursor); chessDestroy(chess));
+    ASSERT_TEST(addGames(chess, 1, 100, 130), chessGamesCursorClose(cursor); chessDestroy(chess));
+    ASSERT_TEST(chessGamesCursorNext(cursor, rows, 40) == 40, chessGamesCursorClose(cursor); chessDestroy(chess));
+    ASSERT_TEST(isGame(&rows[0], 1, 40) && isGame(&rows[39], 1, 79), chessGamesCursorClose(cursor); chessDestroy(chess));
+    ASSERT_TEST(chessEndTournament(chess, 1) == CHESS_SUCCESS, chessGamesCursorClose(cursor); chessDestroy(chess));
+    ASSERT_TEST(chessGamesCursorNext(cursor, rows, 40) == 40, chessGamesCursorClose(cursor); chessDestroy(chess));
+    ASSERT_TEST(isGame(&rows[0], 1, 80) && isGame(&rows[39], 1, 119), chessGamesCursorClose(cursor); chessDestroy(chess));
+    ASSERT_TEST(chessGamesCursorNext(cursor, rows, 40) == 10, chessGamesCursorClose(cursor); chessDestroy(chess));
+    ASSERT_TEST(isGame(&rows[9], 1, 129), chessGamesCursorClose(cursor); chessDestroy(chess));
+    ASSERT_TEST(chessGamesCursorNext(cursor, rows, 40) == 0, chessGamesCursorClose(cursor); chessDestroy(chess));
+
+    // once the tournament is removed, no more games
+    chessGamesCursorClose(cursor);
+    cursor = chessGamesCursorOpen(chess, 1, NULL);
+    ASSERT_TEST(cursor != NULL, chessDestroy(chess));
+    ASSERT_TEST(chessGamesCursorNext(cursor, rows, 1) == 1, chessGamesCursorClose(cursor); chessDestroy(chess));
+    ASSERT_TEST(chessRemoveTournament(chess, 1) == CHESS_SUCCESS, chessGamesCursorClose(cursor); chessDestroy(chess));
+    ASSERT_TEST(chessGamesCursorNext(cursor, rows, 40) == 0, chessGamesCursorClose(cursor); chessDestroy(chess));
+
+    chessGamesCursorClose(cursor);
+    chessDestroy(chess);
+    return true;
+}
+
+/**
+ * A tournament removed and added again with the same id is another tournament: a cursor opened on the
+ * first one reads none of its games, whether the games of either were frozen or not.
+ * */
+static bool readRecreated(bool end_first, bool end_second)
+{
+    ChessSystem chess = chessCreate();
+    bool succeeded = chessAddTournament(chess, 1, 1, "London") == CHESS_SUCCESS && addGames(chess, 1, 0, 50)
+                     && (!end_first || chessEndTournament(chess, 1) == CHESS_SUCCESS);
+    ChessGamesCursor cursor = chessGamesCursorOpen(chess, 1, NULL);
+    ChessGameRow rows[10];
+    succeeded = succeeded && cursor != NULL && chessGamesCursorNext(cursor, rows, 10) == 10;
+    succeeded = succeeded && chessRemoveTournament(chess, 1) == CHESS_SUCCESS
+                && chessAddTournament(chess, 1, 1, "Paris") == CHESS_SUCCESS && addGames(chess, 1, 100, 150)
+                && (!end_second || chessEndTournament(chess, 1) == CHESS_SUCCESS);
+    succeeded = succeeded && chessGamesCursorNext(cursor, rows, 10) == 0;
+    chessGamesCursorClose(cursor);
+    chessDestroy(chess);
+    return succeeded;
+}
+
+bool testGamesCursorOfRecreatedTournament()
+{
+    ASSERT_TEST(readRecreated(false, false), );
+    ASSERT_TEST(readRecreated(true, false), );
+    ASSERT_TEST(readRecreated(false, true), );
+    ASSERT_TEST(readRecreated(true, true), );
+    return true;
+}
+
+/**
+ * The players cursor returns what chessGetPlayersStats returns for every player, by increasing id.
+ * */
+bool testPlayersCursorLikeStats()
+{
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(testRunOperations(chess, 21, 4000), chessDestroy(chess));
+    int ids[TEST_NUM_OF_PLAYERS];
+    ChessPlayerStats expected[TEST_NUM_OF_PLAYERS];
+    for (int i = 0; i < TEST_NUM_OF_PLAYERS; i++)
+    {
+        ids[i] = i + 1;
+    }
+    ASSERT_TEST(chessGetPlayersStats(chess, ids, TEST_NUM_OF_PLAYERS, expected) == CHESS_SUCCESS, chessDestroy(chess));
+
+    for (int batch_size = 1; batch_size <= TEST_NUM_OF_PLAYERS + 1; batch_size += 4)
+    {
+        ChessPlayersCursor cursor = chessPlayersCursorOpen(chess, NULL);
+        ASSERT_TEST(cursor != NULL, chessDestroy(chess));
+        ChessPlayerStats rows[TEST_NUM_OF_PLAYERS + 1];
+        int size = 0;
+        int count;
+        while ((count = chessPlayersCursorNext(cursor, rows, batch_size)) > 0)
+        {
+            for (int i = 0; i < count; i++)
+            {
+                // skip the players that are not in the system
+                while (size < TEST_NUM_OF_PLAYERS && expected[size].result != CHESS_SUCCESS)
+                {
+                    size++;
+                }
+                ASSERT_TEST(size < TEST_NUM_OF_PLAYERS && sameStats(&rows[i], &expected[size]),
+                            chessPlayersCursorClose(cursor); chessDestroy(chess));
+                size++;
+            }
+        }
+        chessPlayersCursorClose(cursor);
+        while (size < TEST_NUM_OF_PLAYERS && expected[size].result != CHESS_SUCCESS)
+        {
+            size++;
+        }
+        ASSERT_TEST(size == TEST_NUM_OF_PLAYERS, chessDestroy(chess));
+    }
+
+    chessDestroy(chess);
+    return true;
+}
+
+bool testPlayersCursorWhileChanging()
+{
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(chessAddTournament(chess, 1, 10, "London") == CHESS_SUCCESS, chessDestroy(chess));
+    for (int i = 1; i <= 20; i += 2)
+    {
+        ASSERT_TEST(chessAddGame(chess, 1, i, i + 1, FIRST_PLAYER, 5) == CHESS_SUCCESS, chessDestroy(chess));
+    }
+    ChessPlayersCursor cursor = chessPlayersCursorOpen(chess, NULL);
+    ASSERT_TEST(cursor != NULL, chessDestroy(chess));
+    ChessPlayerStats rows[5];
+    ASSERT_TEST(chessPlayersCursorNext(cursor, rows, 5) == 5 && rows[4].player_id == 5,
+                chessPlayersCursorClose(cursor); chessDestroy(chess));
+    // removed before they were returned, so they are not
+    ASSERT_TEST(chessRemovePlayer(chess, 6) == CHESS_SUCCESS && chessRemovePlayer(chess, 9) == CHESS_SUCCESS,
+                chessPlayersCursorClose(cursor); chessDestroy(chess));
+    int expected_ids[] = { 7, 8, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20 };
+    int size = 0;
+    int count;
+    while ((count = chessPlayersCursorNext(cursor, rows, 5)) > 0)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            ASSERT_TEST(size < 13 && rows[i].player_id == expected_ids[size++],
+                        chessPlayersCursorClose(cursor); chessDestroy(chess));
+        }
+    }
+    ASSERT_TEST(size == 13, chessPlayersCursorClose(cursor); chessDestroy(chess));
+
+    chessPlayersCursorClose(cursor);
+    chessDestroy(chess);
+    return true;
+}
+
+bool testTournamentsCursor()
+{
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(chessAddTournament(chess, 7, 3, "Tel aviv") == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddTournament(chess, 2, 4, "London") == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddTournament(chess, 5, 5, "Paris") == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddGame(chess, 7, 1, 2, SECOND_PLAYER, 10) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddGame(chess, 7, 1, 3, FIRST_PLAYER, 30) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddGame(chess, 7, 2, 3, SECOND_PLAYER, 5) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessEndTournament(chess, 7) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddGame(chess, 2, 1, 2, DRAW, 8) == CHESS_SUCCESS, chessDestroy(chess));
+
+    ChessTournamentsCursor cursor = chessTournamentsCursorOpen(chess, NULL);
+    ASSERT_TEST(cursor != NULL, chessDestroy(chess));
+    ChessTournamentRow rows[2];
+    ASSERT_TEST(chessTournamentsCursorNext(cursor, rows, 2) == 2, chessTournamentsCursorClose(cursor); chessDestroy(chess));
+    ASSERT_TEST(rows[0].tournament_id == 2 && strcmp(rows[0].location, "London") == 0
+                    && rows[0].max_games_per_player == 4 && !rows[0].ended && rows[0].winner_id == 0
+                    && rows[0].num_of_games == 1 && rows[0].num_of_players == 2 && rows[0].longest_game_time == 8,
+                chessTournamentsCursorClose(cursor); chessDestroy(chess));
+    ASSERT_TEST(rows[1].tournament_id == 5 && rows[1].num_of_games == 0,
+                chessTournamentsCursorClose(cursor); chessDestroy(chess));
+    ASSERT_TEST(chessTournamentsCursorNext(cursor, rows, 2) == 1, chessTournamentsCursorClose(cursor); chessDestroy(chess));
+    // players 1, 2 and 3 have one win and one loss each, so the lowest id wins
+    ASSERT_TEST(rows[0].tournament_id == 7 && strcmp(rows[0].location, "Tel aviv") == 0 && rows[0].ended
+                    && rows[0].num_of_games == 3 && rows[0].num_of_players == 3 && rows[0].longest_game_time == 30
+                    && rows[0].average_game_time == 15.0,
+                chessTournamentsCursorClose(cursor); chessDestroy(chess));
+    ASSERT_TEST(rows[0].winner_id == 1, chessTournamentsCursorClose(cursor); chessDestroy(chess));
+    ASSERT_TEST(chessTournamentsCursorNext(cursor, rows, 2) == 0, chessTournamentsCursorClose(cursor); chessDestroy(chess));
+
+    chessTournamentsCursorClose(cursor);
+    chessDestroy(chess);
+    return true;
+}
+
+bool testCursorArguments()
+{
+    ChessSystem chess = chessCreate();
+    ChessResult result;
+    ASSERT_TEST(chessGamesCursorOpen(NULL, 1, &result) == NULL && result == CHESS_NULL_ARGUMENT, chessDestroy(chess));
+    ASSERT_TEST(chessGamesCursorOpen(chess, 0, &result) == NULL && result == CHESS_INVALID_ID, chessDestroy(chess));
+    ASSERT_TEST(chessGamesCursorOpen(chess, 1, &result) == NULL && result == CHESS_TOURNAMENT_NOT_EXIST,
+                chessDestroy(chess));
+    ASSERT_TEST(chessPlayersCursorOpen(NULL, &result) == NULL && result == CHESS_NULL_ARGUMENT, chessDestroy(chess));
+    ASSERT_TEST(chessTournamentsCursorOpen(NULL, &result) == NULL && result == CHESS_NULL_ARGUMENT, chessDestroy(chess));
+
+    ChessPlayersCursor players = chessPlayersCursorOpen(chess, &result);
+    ASSERT_TEST(players != NULL && result == CHESS_SUCCESS, chessDestroy(chess));
+    ChessPlayerStats stats[1];
+    ASSERT_TEST(chessPlayersCursorNext(players, stats, 1) == 0, chessPlayersCursorClose(players); chessDestroy(chess));
+    ASSERT_TEST(chessPlayersCursorNext(players, NULL, 1) == 0, chessPlayersCursorClose(players); chessDestroy(chess));
+    ASSERT_TEST(chessPlayersCursorNext(NULL, stats, 1) == 0, chessPlayersCursorClose(players); chessDestroy(chess));
+    ASSERT_TEST(chessGamesCursorNext(NULL, NULL, 1) == 0, chessPlayersCursorClose(players); chessDestroy(chess));
+    ASSERT_TEST(chessTournamentsCursorNext(NULL, NULL, 1) == 0, chessPlayersCursorClose(players); chessDestroy(chess));
+    chessPlayersCursorClose(players);
+    chessGamesCursorClose(NULL);
+    chessTournamentsCursorClose(NULL);
+
+    chessDestroy(chess);
+    return true;
+}
+
+int main()
+{
+    RUN_TEST(testGamesCursorInOrder, "testGamesCursorInOrder");
+    RUN_TEST(testGamesCursorWhileChanging, "testGamesCursorWhileChanging");
+    RUN_TEST(testGamesCursorOfRecreatedTournament, "testGamesCursorOfRecreatedTournament");
+    RUN_TEST(testPlayersCursorLikeStats, "testPlayersCursorLikeStats");
+    RUN_TEST(testPlayersCursorWhileChanging, "testPlayersCursorWhileChanging");
+    RUN_TEST(testTournamentsCursor, "testTournamentsCursor");
+    RUN_TEST(testCursorArguments, "testCursorArguments");
+    return TEST_EXIT_STATUS;
+}
\ No newline at end of file
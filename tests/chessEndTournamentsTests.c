@@ -0,0 +1,116 @@
+#include <stdio.h>
+#include <time.h>
+#include "../chessSystem.h"
+#include "../chessSystemExt.h"
+#include "chessTestUtilities.h"
+
+#define NUM_OF_MANY_TOURNAMENTS 10000
+#define NUM_OF_SPREAD_IDS 100
+#define NUM_OF_REPEATS 10
+
+bool testEndTournamentsLikeOneByOne()
+{
+    ChessSystem chess = chessCreate();
+    ChessSystem expected = chessCreate();
+    ASSERT_TEST(testBatchOnSystems(chessEndTournaments, chessEndTournament, chess, expected, TEST_NUM_OF_TOURNAMENTS),
+                chessDestroy(chess); chessDestroy(expected));
+    chessDestroy(chess);
+    chessDestroy(expected);
+    return true;
+}
+
+bool testEndTournamentsOnWorkers()
+{
+    ChessSystemOptions options = { 3 };
+    ChessSystem chess = chessCreateWithOptions(&options);
+    ChessSystem expected = chessCreate();
+    ASSERT_TEST(chess != NULL, chessDestroy(expected));
+    ASSERT_TEST(testBatchOnSystems(chessEndTournaments, chessEndTournament, chess, expected, TEST_NUM_OF_TOURNAMENTS),
+                chessDestroy(chess); chessDestroy(expected));
+    chessDestroy(chess);
+    chessDestroy(expected);
+    return true;
+}
+
+bool testEndTournamentsRepeatedId()
+{
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(chessAddTournament(chess, 1, 2, "London") == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddTournament(chess, 2, 2, "London") == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddGame(chess, 1, 1, 2, FIRST_PLAYER, 10) == CHESS_SUCCESS, chessDestroy(chess));
+    int ids[] = { 1, 0, 3, 2, 1 };
+    ChessResult results[5];
+    ASSERT_TEST(chessEndTournaments(chess, ids, 5, results) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(results[0] == CHESS_SUCCESS && results[1] == CHESS_INVALID_ID
+                    && results[2] == CHESS_TOURNAMENT_NOT_EXIST && results[3] == CHESS_NO_GAMES
+                    && results[4] == CHESS_TOURNAMENT_ENDED,
+                chessDestroy(chess));
+    ASSERT_TEST(chessAddGame(chess, 1, 3, 4, FIRST_PLAYER, 10) == CHESS_TOURNAMENT_ENDED, chessDestroy(chess));
+
+    chessDestroy(chess);
+    return true;
+}
+
+/**
+ * One pass over the tournaments costs less than a lookup per id, even for ids spread over many tournaments.
+ * The tournaments have no games, so ending them changes nothing and can be repeated.
+ * */
+bool testEndTournamentsScales()
+{
+    ChessSystem chess = chessCreate();
+    for (int tournament_id = 1; tournament_id <= NUM_OF_MANY_TOURNAMENTS; tournament_id++)
+    {
+        ASSERT_TEST(chessAddTournament(chess, tournament_id, 1, "London") == CHESS_SUCCESS, chessDestroy(chess));
+    }
+    int ids[NUM_OF_SPREAD_IDS];
+    ChessResult results[NUM_OF_SPREAD_IDS];
+    for (int i = 0; i < NUM_OF_SPREAD_IDS; i++)
+    {
+        ids[i] = (i + 1) * (NUM_OF_MANY_TOURNAMENTS / NUM_OF_SPREAD_IDS);
+    }
+
+    clock_t start = clock();
+    for (int repeat = 0; repeat < NUM_OF_REPEATS; repeat++)
+    {
+        ASSERT_TEST(chessEndTournaments(chess, ids, NUM_OF_SPREAD_IDS, results) == CHESS_SUCCESS, chessDestroy(chess));
+    }
+    clock_t batch_time = clock() - start;
+    start = clock();
+    for (int repeat = 0; repeat < NUM_OF_REPEATS; repeat++)
+    {
+        for (int i = 0; i < NUM_OF_SPREAD_IDS; i++)
+        {
+            ASSERT_TEST(chessEndTournament(chess, ids[i]) == CHESS_NO_GAMES && results[i] == CHESS_NO_GAMES,
+                        chessDestroy(chess));
+        }
+    }
+    clock_t loop_time = clock() - start;
+    ASSERT_TEST(batch_time < loop_time, chessDestroy(chess));
+
+    chessDestroy(chess);
+    return true;
+}
+
+bool testEndTournamentsArguments()
+{
+    ChessSystem chess = chessCreate();
+    int ids[] = { 1 };
+    ChessResult results[1];
+    ASSERT_TEST(chessEndTournaments(NULL, ids, 1, results) == CHESS_NULL_ARGUMENT, chessDestroy(chess));
+    ASSERT_TEST(chessEndTournaments(chess, NULL, 1, results) == CHESS_NULL_ARGUMENT, chessDestroy(chess));
+    ASSERT_TEST(chessEndTournaments(chess, ids, 1, NULL) == CHESS_NULL_ARGUMENT, chessDestroy(chess));
+    ASSERT_TEST(chessEndTournaments(chess, NULL, 0, NULL) == CHESS_SUCCESS, chessDestroy(chess));
+
+    chessDestroy(chess);
+    return true;
+}
+
+int main()
+{
+    RUN_TEST(testEndTournamentsLikeOneByOne, "testEndTournamentsLikeOneByOne");
+    RUN_TEST(testEndTournamentsOnWorkers, "testEndTournamentsOnWorkers");
+    RUN_TEST(testEndTournamentsRepeatedId, "testEndTournamentsRepeatedId");
+    RUN_TEST(testEndTournamentsScales, "testEndTournamentsScales");
+    RUN_TEST(testEndTournamentsArguments, "testEndTournamentsArguments");
+    return TEST_EXIT_STATUS;
+}
\ No newline at end of file
@@ -0,0 +1,210 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "../chessSystem.h"
+#include "../chessSystemExt.h"
+#include "chessTestUtilities.h"
+
+#define EXPORT_DIR "export_test"
+#define MAX_VALUES 20000
+#define HEADER_SIZE 24
+
+static long long column[MAX_VALUES];
+
+static unsigned long long readNumber(const unsigned char* bytes, int size)
+{
+    unsigned long long value = 0;
+    for (int i = size - 1; i >= 0; i--)
+    {
+        value = (value << 8) | bytes[i];
+    }
+    return value;
+}
+
+/**
+ * Decode a column file, as described in chessExport.c, into column.
+ * Return the number of values, or -1 if the file is not valid.
+ * */
+static int readColumn(const char* name)
+{
+    char path[256];
+    sprintf(path, "%s/%s.col", EXPORT_DIR, name);
+    FILE* file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        return -1;
+    }
+    unsigned char header[HEADER_SIZE];
+    if (fread(header, 1, HEADER_SIZE, file) != HEADER_SIZE || header[0] != 'C' || header[3] != 'C')
+    {
+        fclose(file);
+        return -1;
+    }
+    bool delta = readNumber(header + 8, 4) == 1;
+    int block_size = (int)readNumber(header + 12, 4);
+    long long size = (long long)readNumber(header + 16, 8);
+    if (size > MAX_VALUES || block_size <= 0)
+    {
+        fclose(file);
+        return -1;
+    }
+    for (long long begin = 0; begin < size; begin += block_size)
+    {
+        int count = (int)(size - begin < block_size ? size - begin : block_size);
+        unsigned char reference_bytes[9];
+        if (fread(reference_bytes, 1, 9, file) != 9)
+        {
+            fclose(file);
+            return -1;
+        }
+        long long reference = (long long)readNumber(reference_bytes, 8);
+        int width = reference_bytes[8];
+        unsigned long long pending = 0;
+        int num_of_pending = 0;
+        for (int i = 0; i < count; i++)
+        {
+            while (num_of_pending < width)
+            {
+                int byte = fgetc(file);
+                if (byte == EOF)
+                {
+                    fclose(file);
+                    return -1;
+                }
+                pending |= (unsigned long long)byte << num_of_pending;
+                num_of_pending += 8;
+            }
+            unsigned long long mask = width == 64 ? ~0ULL : (1ULL << width) - 1;
+            long long value = reference + (long long)(pending & mask);
+            pending = width == 64 ? 0 : pending >> width;
+            num_of_pending -= width;
+            column[begin + i] = (delta && i > 0) ? column[begin + i - 1] + value : value;
+        }
+    }
+    fclose(file);
+    return (int)size;
+}
+
+bool testExportGames()
+{
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(chessAddTournament(chess, 3, 500, "London") == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddTournament(chess, 1, 500, "Paris") == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddTournament(chess, 2, 500, "Paris") == CHESS_SUCCESS, chessDestroy(chess));
+    // tournament 1 gets enough games for several blocks, the others a few
+    for (int i = 0; i < 300; i++)
+    {
+        ASSERT_TEST(chessAddGame(chess, 1, 100 + i, 1000000 + i * i, (Winner)(i % 3), i * 17) == CHESS_SUCCESS,
+                    chessDestroy(chess));
+    }
+    ASSERT_TEST(chessAddGame(chess, 3, 5, 6, SECOND_PLAYER, 9) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddGame(chess, 2, 7, 8, FIRST_PLAYER, 4) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessEndTournament(chess, 2) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessRemovePlayer(chess, 6) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessExportColumnar(chess, EXPORT_DIR) == CHESS_SUCCESS, chessDestroy(chess));
+
+    // by tournament, in the order they were added
+    ASSERT_TEST(readColumn("games.tournament_id") == 302, chessDestroy(chess));
+    ASSERT_TEST(column[0] == 1 && column[299] == 1 && column[300] == 2 && column[301] == 3, chessDestroy(chess));
+    ASSERT_TEST(readColumn("games.player1") == 302, chessDestroy(chess));
+    for (int i = 0; i < 300; i++)
+    {
+        ASSERT_TEST(column[i] == 100 + i, chessDestroy(chess));
+    }
+    ASSERT_TEST(column[300] == 7 && column[301] == 5, chessDestroy(chess));
+    ASSERT_TEST(readColumn("games.player2") == 302, chessDestroy(chess));
+    for (int i = 0; i < 300; i++)
+    {
+        ASSERT_TEST(column[i] == 1000000 + i * i, chessDestroy(chess));
+    }
+    // player 6 was removed from the open tournament 3, which player 5 then won
+    ASSERT_TEST(column[300] == 8 && column[301] == 0, chessDestroy(chess));
+    ASSERT_TEST(readColumn("games.winner") == 302, chessDestroy(chess));
+    for (int i = 0; i < 300; i++)
+    {
+        ASSERT_TEST(column[i] == i % 3, chessDestroy(chess));
+    }
+    ASSERT_TEST(column[300] == FIRST_PLAYER && column[301] == FIRST_PLAYER, chessDestroy(chess));
+    ASSERT_TEST(readColumn("games.length") == 302, chessDestroy(chess));
+    ASSERT_TEST(column[0] == 0 && column[299] == 299 * 17 && column[301] == 9, chessDestroy(chess));
+
+    chessDestroy(chess);
+    return true;
+}
+
+bool testExportPlayers()
+{
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(testRunOperations(chess, 11, 3000), chessDestroy(chess));
+    ASSERT_TEST(chessExportColumnar(chess, EXPORT_DIR) == CHESS_SUCCESS, chessDestroy(chess));
+
+    int size = readColumn("players.id");
+    ASSERT_TEST(size > 0 && size <= TEST_NUM_OF_PLAYERS, chessDestroy(chess));
+    int ids[TEST_NUM_OF_PLAYERS];
+    ChessPlayerStats stats[TEST_NUM_OF_PLAYERS];
+    for (int i = 0; i < size; i++)
+    {
+        ids[i] = (int)column[i];
+        ASSERT_TEST(i == 0 || ids[i] > ids[i - 1], chessDestroy(chess));
+    }
+    ASSERT_TEST(chessGetPlayersStats(chess, ids, size, stats) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(readColumn("players.wins") == size, chessDestroy(chess));
+    for (int i = 0; i < size; i++)
+    {
+        ASSERT_TEST(stats[i].result == CHESS_SUCCESS && column[i] == stats[i].wins, chessDestroy(chess));
+    }
+    ASSERT_TEST(readColumn("players.losses") == size, chessDestroy(chess));
+    for (int i = 0; i < size; i++)
+    {
+        ASSERT_TEST(column[i] == stats[i].losses, chessDestroy(chess));
+    }
+    ASSERT_TEST(readColumn("players.draws") == size, chessDestroy(chess));
+    for (int i = 0; i < size; i++)
+    {
+        ASSERT_TEST(column[i] == stats[i].draws, chessDestroy(chess));
+    }
+    ASSERT_TEST(readColumn("players.total_time") == size, chessDestroy(chess));
+    for (int i = 0; i < size; i++)
+    {
+        int games = stats[i].wins + stats[i].losses + stats[i].draws;
+        ASSERT_TEST(column[i] == (long long)(stats[i].average_play_time * games + 0.5), chessDestroy(chess));
+    }
+
+    chessDestroy(chess);
+    return true;
+}
+
+bool testExportSchema()
+{
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(chessExportColumnar(chess, EXPORT_DIR) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(readColumn("games.length") == 0 && readColumn("players.id") == 0, chessDestroy(chess));
+    ASSERT_TEST(testFileContains(EXPORT_DIR "/schema",
+                                 "chess-columnar 1\n"
+                                 "table games 0\n"
+                                 "column tournament_id int32 delta games.tournament_id.col\n"
+                                 "column player1 int32 packed games.player1.col\n"
+                                 "column player2 int32 packed games.player2.col\n"
+                                 "column winner int32 packed games.winner.col\n"
+                                 "column length int32 packed games.length.col\n"
+                                 "table players 0\n"
+                                 "column id int32 delta players.id.col\n"
+                                 "column wins int32 packed players.wins.col\n"
+                                 "column losses int32 packed players.losses.col\n"
+                                 "column draws int32 packed players.draws.col\n"
+                                 "column total_time uint32 packed players.total_time.col\n"),
+                chessDestroy(chess));
+    ASSERT_TEST(chessExportColumnar(NULL, EXPORT_DIR) == CHESS_NULL_ARGUMENT, chessDestroy(chess));
+    ASSERT_TEST(chessExportColumnar(chess, NULL) == CHESS_NULL_ARGUMENT, chessDestroy(chess));
+    ASSERT_TEST(chessExportColumnar(chess, EXPORT_DIR "/schema/x") == CHESS_SAVE_FAILURE, chessDestroy(chess));
+
+    chessDestroy(chess);
+    return true;
+}
+
+int main()
+{
+    RUN_TEST(testExportGames, "testExportGames");
+    RUN_TEST(testExportPlayers, "testExportPlayers");
+    RUN_TEST(testExportSchema, "testExportSchema");
+    return TEST_EXIT_STATUS;
+}
\ No newline at end of file
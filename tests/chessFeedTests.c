@@ -0,0 +1,259 @@
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include "../chessSystem.h"
+#include "../chessSystemExt.h"
+#include "chessTestUtilities.h"
+
+#define MAX_EVENTS 20000
+#define NUM_OF_READERS 3
+#define NUM_OF_GAMES 4000 // the distances between the players of a game stay under NUM_OF_PLAYERS / 2
+#define NUM_OF_PLAYERS 100
+
+/**
+ * Read every event written since position, a few at a time. Return the number read.
+ * */
+static int readAll(ChessSubscription subscription, unsigned long long* position, ChessEvent* events, int capacity)
+{
+    int size = 0;
+    int read;
+    do
+    {
+        int chunk = capacity - size < 3 ? capacity - size : 3;
+        read = chessSubscriptionRead(subscription, position, events + size, chunk);
+        size += read;
+    } while (read > 0);
+    return size;
+}
+
+static bool isEvent(const ChessEvent* event, ChessEventType type, unsigned long long sequence,
+                    int arg0, int arg1, int arg2, int arg3, int arg4)
+{
+    int args[] = { arg0, arg1, arg2, arg3, arg4 };
+    return event->type == type && event->sequence == sequence && memcmp(event->args, args, sizeof(args)) == 0;
+}
+
+bool testFeedEventsOfChanges()
+{
+    ChessSystem chess = chessCreate();
+    ChessResult result = CHESS_NULL_ARGUMENT;
+    ChessSubscription all = chessSubscribe(chess, CHESS_EVENT_ALL, 0, &result);
+    ASSERT_TEST(all != NULL && result == CHESS_SUCCESS, chessDestroy(chess));
+    ChessSubscription removals = chessSubscribe(chess, CHESS_EVENT_PLAYER_REMOVED, 16, NULL);
+    ASSERT_TEST(removals != NULL, chessDestroy(chess));
+
+    ASSERT_TEST(chessAddTournament(chess, 1, 5, "London") == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddGame(chess, 1, 1, 2, FIRST_PLAYER, 10) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddGame(chess, 1, 1, 3, DRAW, 20) == CHESS_SUCCESS, chessDestroy(chess));
+    // changes that fail send nothing
+    ASSERT_TEST(chessAddGame(chess, 2, 1, 3, DRAW, 20) == CHESS_TOURNAMENT_NOT_EXIST, chessDestroy(chess));
+    ASSERT_TEST(chessRemovePlayer(chess, 7) == CHESS_PLAYER_NOT_EXIST, chessDestroy(chess));
+    ASSERT_TEST(chessRemovePlayer(chess, 3) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessEndTournament(chess, 1) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessEndTournament(chess, 1) == CHESS_TOURNAMENT_ENDED, chessDestroy(chess));
+    ASSERT_TEST(chessRemovePlayer(chess, 2) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessRemoveTournament(chess, 1) == CHESS_SUCCESS, chessDestroy(chess));
+
+    ChessEvent events[10];
+    unsigned long long position = 0;
+    ASSERT_TEST(readAll(all, &position, events, 10) == 6 && position == 6, chessDestroy(chess));
+    ASSERT_TEST(isEvent(&events[0], CHESS_EVENT_GAME_ADDED, 0, 1, 1, 2, FIRST_PLAYER, 10), chessDestroy(chess));
+    ASSERT_TEST(isEvent(&events[1], CHESS_EVENT_GAME_ADDED, 1, 1, 1, 3, DRAW, 20), chessDestroy(chess));
+    ASSERT_TEST(isEvent(&events[2], CHESS_EVENT_PLAYER_REMOVED, 2, 3, 0, 0, 0, 0), chessDestroy(chess));
+    ASSERT_TEST(isEvent(&events[3], CHESS_EVENT_TOURNAMENT_ENDED, 3, 1, 1, 0, 0, 0), chessDestroy(chess));
+    ASSERT_TEST(isEvent(&events[4], CHESS_EVENT_PLAYER_REMOVED, 4, 2, 0, 0, 0, 0), chessDestroy(chess));
+    ASSERT_TEST(isEvent(&events[5], CHESS_EVENT_TOURNAMENT_REMOVED, 5, 1, 0, 0, 0, 0), chessDestroy(chess));
+    ASSERT_TEST(chessSubscriptionRead(all, &position, events, 10) == 0, chessDestroy(chess));
+
+    // another reader of the same subscription starts from the beginning on its own
+    unsigned long long other = 0;
+    ASSERT_TEST(chessSubscriptionRead(all, &other, events, 1) == 1 && other == 1, chessDestroy(chess));
+    ASSERT_TEST(isEvent(&events[0], CHESS_EVENT_GAME_ADDED, 0, 1, 1, 2, FIRST_PLAYER, 10), chessDestroy(chess));
+
+    unsigned long long removals_position = 0;
+    ASSERT_TEST(readAll(removals, &removals_position, events, 10) == 2, chessDestroy(chess));
+    ASSERT_TEST(isEvent(&events[0], CHESS_EVENT_PLAYER_REMOVED, 0, 3, 0, 0, 0, 0), chessDestroy(chess));
+    ASSERT_TEST(isEvent(&events[1], CHESS_EVENT_PLAYER_REMOVED, 1, 2, 0, 0, 0, 0), chessDestroy(chess));
+
+    // after it is gone the others still receive events, and the rest are destroyed with the system
+    chessUnsubscribe(chess, removals);
+    ASSERT_TEST(chessAddTournament(chess, 1, 5, "London") == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddGame(chess, 1, 4, 5, SECOND_PLAYER, 1) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessSubscriptionRead(all, &position, events, 10) == 1, chessDestroy(chess));
+    ASSERT_TEST(isEvent(&events[0], CHESS_EVENT_GAME_ADDED, 6, 1, 4, 5, SECOND_PLAYER, 1), chessDestroy(chess));
+
+    chessDestroy(chess);
+    return true;
+}
+
+bool testFeedOverflow()
+{
+    ChessSystem chess = chessCreate();
+    ChessSubscription subscription = chessSubscribe(chess, CHESS_EVENT_ALL, 3, NULL); // rounded up to 4
+    ASSERT_TEST(subscription != NULL, chessDestroy(chess));
+    ASSERT_TEST(chessAddTournament(chess, 1, 20, "London") == CHESS_SUCCESS, chessDestroy(chess));
+    for (int i = 0; i < 10; i++)
+    {
+        ASSERT_TEST(chessAddGame(chess, 1, 1, 2 + i, FIRST_PLAYER, i + 1) == CHESS_SUCCESS, chessDestroy(chess));
+    }
+
+    ChessEvent events[10];
+    unsigned long long position = 0;
+    ASSERT_TEST(readAll(subscription, &position, events, 10) == 5 && position == 10, chessDestroy(chess));
+    ASSERT_TEST(isEvent(&events[0], CHESS_EVENT_OVERFLOW, 0, 6, 0, 0, 0, 0), chessDestroy(chess));
+    for (int i = 1; i < 5; i++)
+    {
+        ASSERT_TEST(isEvent(&events[i], CHESS_EVENT_GAME_ADDED, 5 + i, 1, 1, 7 + i, FIRST_PLAYER, 6 + i),
+                    chessDestroy(chess));
+    }
+
+    // a reader that is behind again loses only what it missed
+    for (int i = 10; i < 15; i++)
+    {
+        ASSERT_TEST(chessAddGame(chess, 1, 1, 2 + i, FIRST_PLAYER, i + 1) == CHESS_SUCCESS, chessDestroy(chess));
+    }
+    ASSERT_TEST(chessSubscriptionRead(subscription, &position, events, 10) == 5 && position == 15, chessDestroy(chess));
+    ASSERT_TEST(isEvent(&events[0], CHESS_EVENT_OVERFLOW, 10, 1, 0, 0, 0, 0), chessDestroy(chess));
+    ASSERT_TEST(events[1].sequence == 11 && events[4].sequence == 14, chessDestroy(chess));
+
+    chessDestroy(chess);
+    return true;
+}
+
+/**
+ * Check two subscriptions received the same events.
+ * */
+static bool sameEvents(ChessSubscription subscription1, ChessSubscription subscription2)
+{
+    static ChessEvent events1[MAX_EVENTS];
+    static ChessEvent events2[MAX_EVENTS];
+    unsigned long long position1 = 0;
+    unsigned long long position2 = 0;
+    int size = readAll(subscription1, &position1, events1, MAX_EVENTS);
+    return size < MAX_EVENTS && size == readAll(subscription2, &position2, events2, MAX_EVENTS)
+           && memcmp(events1, events2, sizeof(ChessEvent) * size) == 0;
+}
+
+bool testFeedEventsOfBatches()
+{
+    ChessSystem chess = chessCreate();
+    ChessSystem expected = chessCreate();
+    ChessSubscription subscription1 = chessSubscribe(chess, CHESS_EVENT_ALL, MAX_EVENTS, NULL);
+    ChessSubscription subscription2 = chessSubscribe(expected, CHESS_EVENT_ALL, MAX_EVENTS, NULL);
+    ASSERT_TEST(subscription1 != NULL && subscription2 != NULL, chessDestroy(chess); chessDestroy(expected));
+    ASSERT_TEST(testRunOperations(chess, 3, 2000) && testRunOperations(expected, 3, 2000),
+                chessDestroy(chess); chessDestroy(expected));
+
+    int tournament_ids[] = { 1, 3, 3, 5, 0, 7, 100 };
+    int player_ids[] = { 2, 4, 4, -1, 6, 8, 10, 12, 1000 };
+    ChessResult results[9];
+    ASSERT_TEST(chessEndTournaments(chess, tournament_ids, 7, results) == CHESS_SUCCESS,
+                chessDestroy(chess); chessDestroy(expected));
+    ASSERT_TEST(chessRemovePlayers(chess, player_ids, 9, results) == CHESS_SUCCESS,
+                chessDestroy(chess); chessDestroy(expected));
+    for (int i = 0; i < 7; i++)
+    {
+        chessEndTournament(expected, tournament_ids[i]);
+    }
+    for (int i = 0; i < 9; i++)
+    {
+        chessRemovePlayer(expected, player_ids[i]);
+    }
+    ASSERT_TEST(sameEvents(subscription1, subscription2), chessDestroy(chess); chessDestroy(expected));
+
+    chessDestroy(chess);
+    chessDestroy(expected);
+    return true;
+}
+
+typedef struct {
+    ChessSubscription subscription;
+    bool failed;
+} Reader;
+
+/**
+ * Follow the games while they are added: every one arrives once and in order.
+ * */
+static void* readGames(void* argument)
+{
+    Reader* reader = (Reader*)argument;
+    unsigned long long position = 0;
+    ChessEvent events[64];
+    int next = 0;
+    while (next < NUM_OF_GAMES && !reader->failed)
+    {
+        int size = chessSubscriptionRead(reader->subscription, &position, events, 64);
+        for (int i = 0; i < size && !reader->failed; i++, next++)
+        {
+            reader->failed = events[i].type != CHESS_EVENT_GAME_ADDED || events[i].sequence != (unsigned long long)next
+                             || events[i].args[4] != 1 + next;
+        }
+    }
+    return NULL;
+}
+
+bool testFeedReadWhileWriting()
+{
+    ChessSystem chess = chessCreate();
+    ChessSubscription subscription = chessSubscribe(chess, CHESS_EVENT_ALL, NUM_OF_GAMES, NULL);
+    ASSERT_TEST(subscription != NULL, chessDestroy(chess));
+    ASSERT_TEST(chessAddTournament(chess, 1, NUM_OF_GAMES, "London") == CHESS_SUCCESS, chessDestroy(chess));
+    Reader readers[NUM_OF_READERS];
+    pthread_t threads[NUM_OF_READERS];
+    for (int i = 0; i < NUM_OF_READERS; i++)
+    {
+        readers[i] = (Reader){ subscription, false };
+        pthread_create(&threads[i], NULL, readGames, &readers[i]);
+    }
+    bool failed = false;
+    for (int i = 0; i < NUM_OF_GAMES; i++)
+    {
+        int player1 = 1 + i % NUM_OF_PLAYERS;
+        int player2 = 1 + (player1 + i / NUM_OF_PLAYERS) % NUM_OF_PLAYERS;
+        failed = failed || chessAddGame(chess, 1, player1, player2, DRAW, 1 + i) != CHESS_SUCCESS;
+    }
+    for (int i = 0; i < NUM_OF_READERS; i++)
+    {
+        pthread_join(threads[i], NULL);
+        failed = failed || readers[i].failed;
+    }
+    ASSERT_TEST(!failed, chessDestroy(chess));
+
+    chessDestroy(chess);
+    return true;
+}
+
+bool testFeedArguments()
+{
+    ChessResult result = CHESS_SUCCESS;
+    ASSERT_TEST(chessSubscribe(NULL, CHESS_EVENT_ALL, 0, &result) == NULL && result == CHESS_NULL_ARGUMENT, );
+    ASSERT_TEST(chessSubscribe(NULL, CHESS_EVENT_ALL, 0, NULL) == NULL, );
+    ChessSystem chess = chessCreate();
+    ChessSubscription subscription = chessSubscribe(chess, 0, 0, NULL);
+    ASSERT_TEST(subscription != NULL, chessDestroy(chess));
+    ASSERT_TEST(chessAddTournament(chess, 1, 5, "London") == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddGame(chess, 1, 1, 2, DRAW, 5) == CHESS_SUCCESS, chessDestroy(chess));
+
+    ChessEvent events[1];
+    unsigned long long position = 0;
+    ASSERT_TEST(chessSubscriptionRead(subscription, &position, events, 1) == 0, chessDestroy(chess));
+    ASSERT_TEST(chessSubscriptionRead(NULL, &position, events, 1) == 0, chessDestroy(chess));
+    ASSERT_TEST(chessSubscriptionRead(subscription, NULL, events, 1) == 0, chessDestroy(chess));
+    ASSERT_TEST(chessSubscriptionRead(subscription, &position, NULL, 1) == 0, chessDestroy(chess));
+    chessUnsubscribe(NULL, subscription);
+    chessUnsubscribe(chess, NULL);
+    chessUnsubscribe(chess, subscription);
+
+    chessDestroy(chess);
+    return true;
+}
+
+int main()
+{
+    RUN_TEST(testFeedEventsOfChanges, "testFeedEventsOfChanges");
+    RUN_TEST(testFeedOverflow, "testFeedOverflow");
+    RUN_TEST(testFeedEventsOfBatches, "testFeedEventsOfBatches");
+    RUN_TEST(testFeedReadWhileWriting, "testFeedReadWhileWriting");
+    RUN_TEST(testFeedArguments, "testFeedArguments");
+    return TEST_EXIT_STATUS;
+}
\ No newline at end of file
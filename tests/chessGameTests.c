@@ -0,0 +1,124 @@
+#include "../chessSystem.h"
+#include "../chessGame.h"
+#include "../test_utilities.h"
+
+#define NUM_OF_GAMES 500
+
+/**
+ * Fill a list with games whose ids jump up and down, including big ids and removed (0) players.
+ * */
+static bool fillGames(GameList list, GameRecord* games)
+{
+    for (int i = 0; i < NUM_OF_GAMES; i++)
+    {
+        games[i].player1_id = (i % 7 == 0) ? 0 : 1 + (i * 7919) % 100000;
+        games[i].player2_id = (i % 11 == 0) ? 0 : 2000000000 - i;
+        games[i].winners_id = (i % 3 == 0) ? 0 : (i % 3 == 1 ? games[i].player1_id : games[i].player2_id);
+        games[i].length = (i % 5 == 0) ? 0 : i * 1000;
+        if (!gameListAdd(list, games[i].length, games[i].player1_id, games[i].player2_id, games[i].winners_id))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool sameGames(GameList list, const GameRecord* games)
+{
+    GameIterator iterator;
+    gameIteratorInit(&iterator);
+    int i = 0;
+    while (gameIteratorNext(list, &iterator))
+    {
+        if (i >= NUM_OF_GAMES || iterator.game.player1_id != games[i].player1_id ||
+            iterator.game.player2_id != games[i].player2_id || iterator.game.winners_id != games[i].winners_id ||
+            iterator.game.length != games[i].length)
+        {
+            return false;
+        }
+        i++;
+    }
+    return i == NUM_OF_GAMES && gameListGetSize(list) == NUM_OF_GAMES;
+}
+
+bool testFreezeKeepsGames()
+{
+    GameRecord games[NUM_OF_GAMES];
+    Arena arena = arenaCreate();
+    ASSERT_TEST(arena != NULL, );
+    ArenaMark mark = arenaGetMark(arena);
+    GameList list = gameListCreate(arena);
+    ASSERT_TEST(list != NULL && fillGames(list, games), arenaDestroy(arena));
+    ASSERT_TEST(sameGames(list, games) && !gameListIsFrozen(list), arenaDestroy(arena));
+
+    GameList frozen = gameListFreeze(list, arena, mark);
+    ASSERT_TEST(frozen != NULL && gameListIsFrozen(frozen), arenaDestroy(arena));
+    ASSERT_TEST(sameGames(frozen, games), arenaDestroy(arena));
+
+    // a frozen list is copied frozen
+    Arena other = arenaCreate();
+    ASSERT_TEST(other != NULL, arenaDestroy(arena));
+    GameList copy = gameListCopy(frozen, other);
+    arenaDestroy(arena);
+    ASSERT_TEST(copy != NULL && gameListIsFrozen(copy) && sameGames(copy, games), arenaDestroy(other));
+
+    arenaDestroy(other);
+    return true;
+}
+
+bool testFreezeEmptyList()
+{
+    Arena arena = arenaCreate();
+    ASSERT_TEST(arena != NULL, );
+    ArenaMark mark = arenaGetMark(arena);
+    GameList list = gameListCreate(arena);
+    ASSERT_TEST(list != NULL, arenaDestroy(arena));
+    GameList frozen = gameListFreeze(list, arena, mark);
+    ASSERT_TEST(frozen != NULL && gameListGetSize(frozen) == 0, arenaDestroy(arena));
+    GameIterator iterator;
+    gameIteratorInit(&iterator);
+    ASSERT_TEST(!gameIteratorNext(frozen, &iterator), arenaDestroy(arena));
+
+    arenaDestroy(arena);
+    return true;
+}
+
+bool testEndedTournamentKeepsStatistics()
+{
+    ChessSystem chess = chessCreate();
+    ChessResult result;
+    ASSERT_TEST(chessAddTournament(chess, 1, 10, "London") == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddTournament(chess, 2, 10, "Paris") == CHESS_SUCCESS, chessDestroy(chess));
+    for (int player = 2; player <= 9; player++)
+    {
+        ASSERT_TEST(chessAddGame(chess, 1, 1, player, player % 3, player * 10) == CHESS_SUCCESS, chessDestroy(chess));
+    }
+    ASSERT_TEST(chessAddGame(chess, 2, 1, 2, FIRST_PLAYER, 30) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessEndTournament(chess, 1) == CHESS_SUCCESS, chessDestroy(chess));
+
+    // games of the ended tournament can't be changed, but are still counted
+    ASSERT_TEST(chessAddGame(chess, 1, 1, 10, DRAW, 1) == CHESS_TOURNAMENT_ENDED, chessDestroy(chess));
+    ASSERT_TEST(chessRemovePlayer(chess, 3) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessCalculateAveragePlayTime(chess, 1, &result) == 470.0 / 9 && result == CHESS_SUCCESS,
+                chessDestroy(chess));
+    ASSERT_TEST(chessSaveTournamentStatistics(chess, "game_statistics.txt") == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(testFileContains("game_statistics.txt", "1\n90\n55.00\nLondon\n8\n9\n"), chessDestroy(chess));
+
+    // removing the ended tournament removes its games from the players
+    ASSERT_TEST(chessRemoveTournament(chess, 1) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessCalculateAveragePlayTime(chess, 1, &result) == 30.0 && result == CHESS_SUCCESS,
+                chessDestroy(chess));
+    chessCalculateAveragePlayTime(chess, 5, &result);
+    ASSERT_TEST(result == CHESS_PLAYER_NOT_EXIST, chessDestroy(chess));
+
+    chessDestroy(chess);
+    return true;
+}
+
+int main()
+{
+    RUN_TEST(testFreezeKeepsGames, "testFreezeKeepsGames");
+    RUN_TEST(testFreezeEmptyList, "testFreezeEmptyList");
+    RUN_TEST(testEndedTournamentKeepsStatistics, "testEndedTournamentKeepsStatistics");
+    return TEST_EXIT_STATUS;
+}
\ No newline at end of file
@@ -0,0 +1,173 @@
+#include <stdio.h>
+#include "../chessSystem.h"
+#include "../chessSystemExt.h"
+#include "chessTestUtilities.h"
+
+#define MAX_GENERATION 100
+
+/**
+ * Delete the files left by an earlier run of a journal.
+ * */
+static void removeJournal(const char* path)
+{
+    char name[256];
+    for (int generation = 1; generation <= MAX_GENERATION; generation++)
+    {
+        sprintf(name, "%s.%d.log", path, generation);
+        remove(name);
+        sprintf(name, "%s.%d.snap", path, generation);
+        remove(name);
+    }
+}
+
+/**
+ * Return true if recovering from the journal at path gives the same system as chess.
+ * */
+static bool recoversTo(const char* path, ChessSystem chess)
+{
+    if (chessJournalSync(chess) != CHESS_SUCCESS)
+    {
+        return false;
+    }
+    ChessResult result;
+    ChessSystem recovered = chessRecoverFromJournal(path, &result);
+    if (recovered == NULL || result != CHESS_SUCCESS)
+    {
+        return false;
+    }
+    bool same = testSameSystems(chess, recovered, TEST_NUM_OF_PLAYERS)
+                && chessSaveSnapshot(chess, "journal_live.snap") == CHESS_SUCCESS
+                && chessSaveSnapshot(recovered, "journal_recovered.snap") == CHESS_SUCCESS
+                && testFilesEqual("journal_live.snap", "journal_recovered.snap");
+    chessDestroy(recovered);
+    return same;
+}
+
+bool testJournalRecoversLiveState()
+{
+    removeJournal("journal_live");
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(chessJournalOpen(chess, "journal_live", NULL) == CHESS_SUCCESS, chessDestroy(chess));
+    for (unsigned int seed = 1; seed <= 4; seed++)
+    {
+        ASSERT_TEST(testRunOperations(chess, seed, 1500), chessDestroy(chess));
+        ASSERT_TEST(recoversTo("journal_live", chess), chessDestroy(chess));
+    }
+
+    chessDestroy(chess);
+    return true;
+}
+
+bool testJournalRecoversAfterCompaction()
+{
+    removeJournal("journal_compact");
+    ChessSystem chess = chessCreate();
+    ChessJournalOptions options = { 8, 1 };
+    ASSERT_TEST(chessJournalOpen(chess, "journal_compact", &options) == CHESS_SUCCESS, chessDestroy(chess));
+    for (unsigned int seed = 1; seed <= 6; seed++)
+    {
+        ASSERT_TEST(testRunOperations(chess, seed, 1000), chessDestroy(chess));
+        ASSERT_TEST(chessJournalCompact(chess) == CHESS_SUCCESS, chessDestroy(chess));
+        // records logged while the snapshot is being written go to the new log
+        ASSERT_TEST(testRunOperations(chess, seed + 50, 300), chessDestroy(chess));
+        ASSERT_TEST(recoversTo("journal_compact", chess), chessDestroy(chess));
+    }
+
+    chessDestroy(chess);
+    return true;
+}
+
+bool testJournalContinuesAfterRecovery()
+{
+    removeJournal("journal_continue");
+    ChessSystem chess = chessCreate();
+    ChessSystem expected = chessCreate();
+    ASSERT_TEST(chessJournalOpen(chess, "journal_continue", NULL) == CHESS_SUCCESS,
+                chessDestroy(chess); chessDestroy(expected));
+    ASSERT_TEST(testRunOperations(chess, 1, 2000) && testRunOperations(expected, 1, 2000),
+                chessDestroy(chess); chessDestroy(expected));
+    chessDestroy(chess);
+
+    ChessResult result;
+    chess = chessRecoverFromJournal("journal_continue", &result);
+    ASSERT_TEST(chess != NULL && result == CHESS_SUCCESS, chessDestroy(expected));
+    ASSERT_TEST(chessJournalOpen(chess, "journal_continue", NULL) == CHESS_SUCCESS,
+                chessDestroy(chess); chessDestroy(expected));
+    ASSERT_TEST(testRunOperations(chess, 2, 2000) && testRunOperations(expected, 2, 2000),
+                chessDestroy(chess); chessDestroy(expected));
+    ASSERT_TEST(recoversTo("journal_continue", chess), chessDestroy(chess); chessDestroy(expected));
+    ASSERT_TEST(testSameSystems(chess, expected, TEST_NUM_OF_PLAYERS), chessDestroy(chess); chessDestroy(expected));
+
+    chessDestroy(chess);
+    chessDestroy(expected);
+    return true;
+}
+
+bool testJournalOfNonEmptySystem()
+{
+    removeJournal("journal_nonempty");
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(testRunOperations(chess, 3, 1000), chessDestroy(chess));
+    // what the system held before the journal was opened is kept in a first snapshot
+    ASSERT_TEST(chessJournalOpen(chess, "journal_nonempty", NULL) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(testRunOperations(chess, 4, 1000), chessDestroy(chess));
+    ASSERT_TEST(recoversTo("journal_nonempty", chess), chessDestroy(chess));
+
+    chessDestroy(chess);
+    return true;
+}
+
+bool testJournalTornRecord()
+{
+    removeJournal("journal_torn");
+    ChessSystem chess = chessCreate();
+    ChessSystem expected = chessCreate();
+    ASSERT_TEST(chessJournalOpen(chess, "journal_torn", NULL) == CHESS_SUCCESS,
+                chessDestroy(chess); chessDestroy(expected));
+    ASSERT_TEST(testRunOperations(chess, 5, 1000) && testRunOperations(expected, 5, 1000),
+                chessDestroy(chess); chessDestroy(expected));
+    chessDestroy(chess);
+
+    // the process died in the middle of writing a record
+    FILE* log = fopen("journal_torn.1.log", "ab");
+    ASSERT_TEST(log != NULL, chessDestroy(expected));
+    fputc(12, log);
+    fputc(0, log);
+    fclose(log);
+
+    ChessResult result;
+    chess = chessRecoverFromJournal("journal_torn", &result);
+    ASSERT_TEST(chess != NULL && result == CHESS_SUCCESS, chessDestroy(expected));
+    ASSERT_TEST(testSameSystems(chess, expected, TEST_NUM_OF_PLAYERS), chessDestroy(chess); chessDestroy(expected));
+
+    chessDestroy(chess);
+    chessDestroy(expected);
+    return true;
+}
+
+bool testJournalArguments()
+{
+    removeJournal("journal_none");
+    ChessResult result;
+    ChessSystem chess = chessRecoverFromJournal("journal_none", &result);
+    ASSERT_TEST(chess != NULL && result == CHESS_SUCCESS, );
+    ASSERT_TEST(chessJournalSync(chess) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessJournalCompact(chess) == CHESS_SAVE_FAILURE, chessDestroy(chess));
+    ASSERT_TEST(chessJournalOpen(NULL, "journal_none", NULL) == CHESS_NULL_ARGUMENT, chessDestroy(chess));
+    ASSERT_TEST(chessJournalOpen(chess, NULL, NULL) == CHESS_NULL_ARGUMENT, chessDestroy(chess));
+    ASSERT_TEST(chessRecoverFromJournal(NULL, &result) == NULL && result == CHESS_NULL_ARGUMENT, chessDestroy(chess));
+
+    chessDestroy(chess);
+    return true;
+}
+
+int main()
+{
+    RUN_TEST(testJournalRecoversLiveState, "testJournalRecoversLiveState");
+    RUN_TEST(testJournalRecoversAfterCompaction, "testJournalRecoversAfterCompaction");
+    RUN_TEST(testJournalContinuesAfterRecovery, "testJournalContinuesAfterRecovery");
+    RUN_TEST(testJournalOfNonEmptySystem, "testJournalOfNonEmptySystem");
+    RUN_TEST(testJournalTornRecord, "testJournalTornRecord");
+    RUN_TEST(testJournalArguments, "testJournalArguments");
+    return TEST_EXIT_STATUS;
+}
\ No newline at end of file
@@ -0,0 +1,161 @@
+#include <stdio.h>
+#include "../chessSystem.h"
+#include "../chessSystemExt.h"
+#include "chessTestUtilities.h"
+
+/**
+ * Reading the levels and the statistics in testRunOnBoth applies the waiting removals of the lazy system.
+ * */
+bool testLazyRemovalLikeEager()
+{
+    ChessSystem lazy = chessCreate();
+    ChessSystem eager = chessCreate();
+    ASSERT_TEST(chessEnableLazyRemoval(lazy) == CHESS_SUCCESS, chessDestroy(lazy); chessDestroy(eager));
+    ASSERT_TEST(testRunOnBoth(lazy, eager, 1, 20), chessDestroy(lazy); chessDestroy(eager));
+    // calling it again does nothing
+    ASSERT_TEST(chessEnableLazyRemoval(lazy) == CHESS_SUCCESS, chessDestroy(lazy); chessDestroy(eager));
+    ASSERT_TEST(testRunOnBoth(lazy, eager, 100, 5), chessDestroy(lazy); chessDestroy(eager));
+    for (int tournament_id = 1; tournament_id <= TEST_NUM_OF_TOURNAMENTS; tournament_id++)
+    {
+        ASSERT_TEST(chessEndTournament(lazy, tournament_id) == chessEndTournament(eager, tournament_id),
+                    chessDestroy(lazy); chessDestroy(eager));
+    }
+    ASSERT_TEST(testSameSystems(lazy, eager, TEST_NUM_OF_PLAYERS), chessDestroy(lazy); chessDestroy(eager));
+
+    chessDestroy(lazy);
+    chessDestroy(eager);
+    return true;
+}
+
+/**
+ * Add games, remove their players, let one of them return to a tournament, and end it.
+ * */
+static bool runSequence(ChessSystem chess)
+{
+    bool succeeded = chessAddTournament(chess, 1, 3, "London") == CHESS_SUCCESS
+                     && chessAddTournament(chess, 2, 3, "Paris") == CHESS_SUCCESS;
+    succeeded = succeeded && chessAddGame(chess, 1, 1, 2, FIRST_PLAYER, 10) == CHESS_SUCCESS
+                && chessAddGame(chess, 1, 1, 3, SECOND_PLAYER, 20) == CHESS_SUCCESS
+                && chessAddGame(chess, 1, 2, 3, DRAW, 30) == CHESS_SUCCESS
+                && chessAddGame(chess, 2, 1, 4, DRAW, 40) == CHESS_SUCCESS
+                && chessAddGame(chess, 2, 2, 4, SECOND_PLAYER, 50) == CHESS_SUCCESS;
+    succeeded = succeeded && chessRemovePlayer(chess, 1) == CHESS_SUCCESS
+                && chessRemovePlayer(chess, 4) == CHESS_SUCCESS
+                && chessRemovePlayer(chess, 4) == CHESS_PLAYER_NOT_EXIST;
+    // the removed player returns, against the same player as before
+    succeeded = succeeded && chessAddGame(chess, 1, 1, 2, SECOND_PLAYER, 60) == CHESS_SUCCESS
+                && chessAddGame(chess, 2, 3, 4, FIRST_PLAYER, 70) == CHESS_SUCCESS;
+    succeeded = succeeded && chessEndTournament(chess, 1) == CHESS_SUCCESS
+                && chessRemovePlayer(chess, 2) == CHESS_SUCCESS
+                && chessEndTournament(chess, 2) == CHESS_SUCCESS;
+    return succeeded;
+}
+
+bool testLazyRemovalSequence()
+{
+    ChessSystem lazy = chessCreate();
+    ChessSystem eager = chessCreate();
+    ASSERT_TEST(chessEnableLazyRemoval(lazy) == CHESS_SUCCESS, chessDestroy(lazy); chessDestroy(eager));
+    ASSERT_TEST(runSequence(lazy) && runSequence(eager), chessDestroy(lazy); chessDestroy(eager));
+    ASSERT_TEST(testSameSystems(lazy, eager, 4), chessDestroy(lazy); chessDestroy(eager));
+
+    chessDestroy(lazy);
+    chessDestroy(eager);
+    return true;
+}
+
+/**
+ * Apply the waiting removals of chess in slices of max_games, checking fewer of them wait after every
+ * slice, and the averages don't change meanwhile.
+ * */
+static bool applyInSlices(ChessSystem chess, ChessSystem eager, int max_games)
+{
+    int waiting = chessApplyRemovals(chess, 0);
+    while (waiting > 0)
+    {
+        int left = chessApplyRemovals(chess, max_games);
+        if (left > waiting)
+        {
+            return false;
+        }
+        waiting = left;
+        for (int player_id = 1; player_id <= TEST_NUM_OF_PLAYERS; player_id++)
+        {
+            ChessResult result1;
+            ChessResult result2;
+            double average1 = chessCalculateAveragePlayTime(chess, player_id, &result1);
+            double average2 = chessCalculateAveragePlayTime(eager, player_id, &result2);
+            if (result1 != result2 || average1 != average2)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * The operations only read the tournaments they change, so removals wait until the slices apply them.
+ * */
+bool testLazyRemovalInSlices()
+{
+    int slices[] = { 1, 7, 100, 100000 };
+    for (int i = 0; i < (int)(sizeof(slices) / sizeof(slices[0])); i++)
+    {
+        ChessSystem lazy = chessCreate();
+        ChessSystem eager = chessCreate();
+        ASSERT_TEST(chessEnableLazyRemoval(lazy) == CHESS_SUCCESS, chessDestroy(lazy); chessDestroy(eager));
+        for (unsigned int seed = 1; seed <= 10; seed++)
+        {
+            ASSERT_TEST(testRunOperations(lazy, seed, 500) && testRunOperations(eager, seed, 500),
+                        chessDestroy(lazy); chessDestroy(eager));
+            ASSERT_TEST(applyInSlices(lazy, eager, slices[i]), chessDestroy(lazy); chessDestroy(eager));
+            ASSERT_TEST(chessApplyRemovals(lazy, 1) == 0, chessDestroy(lazy); chessDestroy(eager));
+            ASSERT_TEST(testSameSystems(lazy, eager, TEST_NUM_OF_PLAYERS), chessDestroy(lazy); chessDestroy(eager));
+        }
+        chessDestroy(lazy);
+        chessDestroy(eager);
+    }
+    return true;
+}
+
+/**
+ * A system that shares its state or has snapshot reads removes the games right away.
+ * */
+bool testLazyRemovalOfSharedSystem()
+{
+    ChessSystem chess = chessCreate();
+    ChessSystem eager = chessCreate();
+    ASSERT_TEST(chessEnableLazyRemoval(chess) == CHESS_SUCCESS && chessEnableSnapshotReads(chess) == CHESS_SUCCESS,
+                chessDestroy(chess); chessDestroy(eager));
+    ASSERT_TEST(testRunOperations(chess, 3, 2000) && testRunOperations(eager, 3, 2000),
+                chessDestroy(chess); chessDestroy(eager));
+    ASSERT_TEST(chessApplyRemovals(chess, 0) == 0, chessDestroy(chess); chessDestroy(eager));
+    ASSERT_TEST(testSameSystems(chess, eager, TEST_NUM_OF_PLAYERS), chessDestroy(chess); chessDestroy(eager));
+
+    chessDestroy(chess);
+    chessDestroy(eager);
+    return true;
+}
+
+bool testLazyRemovalArguments()
+{
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(chessEnableLazyRemoval(NULL) == CHESS_NULL_ARGUMENT, chessDestroy(chess));
+    ASSERT_TEST(chessApplyRemovals(NULL, 10) == 0, chessDestroy(chess));
+    // without lazy removal nothing waits
+    ASSERT_TEST(testRunOperations(chess, 4, 500) && chessApplyRemovals(chess, 10) == 0, chessDestroy(chess));
+
+    chessDestroy(chess);
+    return true;
+}
+
+int main()
+{
+    RUN_TEST(testLazyRemovalLikeEager, "testLazyRemovalLikeEager");
+    RUN_TEST(testLazyRemovalSequence, "testLazyRemovalSequence");
+    RUN_TEST(testLazyRemovalInSlices, "testLazyRemovalInSlices");
+    RUN_TEST(testLazyRemovalOfSharedSystem, "testLazyRemovalOfSharedSystem");
+    RUN_TEST(testLazyRemovalArguments, "testLazyRemovalArguments");
+    return TEST_EXIT_STATUS;
+}
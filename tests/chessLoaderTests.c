@@ -0,0 +1,255 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "../chessSystem.h"
+#include "../chessSystemExt.h"
+#include "chessTestUtilities.h"
+
+#define NUM_OF_RECORDS 3000
+#define NUM_OF_TOURNAMENTS 12
+#define NUM_OF_PLAYERS 80
+#define MAX_ERRORS NUM_OF_RECORDS
+#define CSV_FILE "loader_games.csv"
+#define BINARY_FILE "loader_games.bin"
+
+typedef struct {
+    int fields[5];
+} Record;
+
+typedef struct {
+    ChessLoadError errors[MAX_ERRORS];
+    int size;
+} Errors;
+
+static void collectError(const ChessLoadError* error, void* context)
+{
+    Errors* errors = (Errors*)context;
+    if (errors->size < MAX_ERRORS)
+    {
+        errors->errors[errors->size++] = *error;
+    }
+}
+
+/**
+ * Records with repeated games, exceeded games, bad ids and bad play times.
+ * Every 97th record has an invalid winner, which is malformed.
+ * */
+static void createRecords(Record* records)
+{
+    unsigned int seed = 12345;
+    for (int i = 0; i < NUM_OF_RECORDS; i++)
+    {
+        int* fields = records[i].fields;
+        for (int j = 0; j < 5; j++)
+        {
+            seed = seed * 1103515245u + 12345u;
+            fields[j] = (int)((seed >> 8) % 1000);
+        }
+        fields[0] = 1 + fields[0] % NUM_OF_TOURNAMENTS;
+        fields[1] = fields[1] % NUM_OF_PLAYERS;
+        fields[2] = 1 + fields[2] % NUM_OF_PLAYERS;
+        fields[3] = (i % 97 == 0) ? 5 : fields[3] % 3;
+        fields[4] = fields[4] % 200 - 2;
+    }
+}
+
+static bool writeFiles(const Record* records)
+{
+    FILE* csv = fopen(CSV_FILE, "w");
+    FILE* binary = fopen(BINARY_FILE, "wb");
+    bool written = csv != NULL && binary != NULL;
+    for (int i = 0; i < NUM_OF_RECORDS && written; i++)
+    {
+        const int* fields = records[i].fields;
+        fprintf(csv, "%d,%d,%d,%d,%d\n", fields[0], fields[1], fields[2], fields[3], fields[4]);
+        if (i % 500 == 0)
+        {
+            fprintf(csv, "\n"); // empty lines are skipped, and still counted
+        }
+        for (int j = 0; j < 5; j++)
+        {
+            unsigned int value = (unsigned int)fields[j];
+            unsigned char bytes[4] = { value & 0xff, (value >> 8) & 0xff, (value >> 16) & 0xff, value >> 24 };
+            written = written && fwrite(bytes, 1, 4, binary) == 4;
+        }
+    }
+    if (csv != NULL)
+    {
+        fclose(csv);
+    }
+    if (binary != NULL)
+    {
+        fclose(binary);
+    }
+    return written;
+}
+
+static ChessSystem createTournaments(const ChessSystemOptions* options)
+{
+    ChessSystem chess = options == NULL ? chessCreate() : chessCreateWithOptions(options);
+    for (int id = 1; id <= NUM_OF_TOURNAMENTS; id++)
+    {
+        chessAddTournament(chess, id, 1 + id % 5, id % 2 ? "London" : "Paris");
+    }
+    // tournaments that already have games, or have ended, are loaded in file order
+    chessAddGame(chess, 2, 1, 2, FIRST_PLAYER, 10);
+    chessAddGame(chess, 3, 1, 2, DRAW, 10);
+    chessEndTournament(chess, 3);
+    return chess;
+}
+
+/**
+ * The system and errors that adding the records one by one gives.
+ * */
+static ChessSystem addRecords(const Record* records, Errors* errors)
+{
+    ChessSystem chess = createTournaments(NULL);
+    errors->size = 0;
+    long line = 0;
+    for (int i = 0; i < NUM_OF_RECORDS; i++)
+    {
+        const int* fields = records[i].fields;
+        line++;
+        ChessLoadError error = { line, fields[3] > DRAW, CHESS_SUCCESS };
+        if (!error.malformed)
+        {
+            error.result = chessAddGame(chess, fields[0], fields[1], fields[2], (Winner)fields[3], fields[4]);
+        }
+        if (error.malformed || error.result != CHESS_SUCCESS)
+        {
+            errors->errors[errors->size++] = error;
+        }
+        if (i % 500 == 0)
+        {
+            line++;
+        }
+    }
+    return chess;
+}
+
+static bool sameErrors(const Errors* errors1, const Errors* errors2, bool binary)
+{
+    if (errors1->size != errors2->size)
+    {
+        return false;
+    }
+    for (int i = 0; i < errors1->size; i++)
+    {
+        const ChessLoadError* error = &errors2->errors[i];
+        // records of a binary file are counted from 0, with no empty lines
+        if (!binary && error->record != errors1->errors[i].record)
+        {
+            return false;
+        }
+        if (error->malformed != errors1->errors[i].malformed || error->result != errors1->errors[i].result)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static Record records[NUM_OF_RECORDS];
+static Errors expected_errors;
+static Errors errors;
+
+bool testLoadCsv()
+{
+    ChessSystem expected = addRecords(records, &expected_errors);
+    ChessSystem chess = createTournaments(NULL);
+    errors.size = 0;
+    ASSERT_TEST(chessLoadGamesFromFile(chess, CSV_FILE, CHESS_FORMAT_CSV, collectError, &errors) == CHESS_SUCCESS,
+                chessDestroy(chess); chessDestroy(expected));
+    ASSERT_TEST(sameErrors(&expected_errors, &errors, false), chessDestroy(chess); chessDestroy(expected));
+    ASSERT_TEST(testSameSystems(expected, chess, NUM_OF_PLAYERS), chessDestroy(chess); chessDestroy(expected));
+
+    chessDestroy(chess);
+    chessDestroy(expected);
+    return true;
+}
+
+bool testLoadBinary()
+{
+    ChessSystem expected = addRecords(records, &expected_errors);
+    ChessSystem chess = createTournaments(NULL);
+    errors.size = 0;
+    ASSERT_TEST(chessLoadGamesFromFile(chess, BINARY_FILE, CHESS_FORMAT_BINARY, collectError, &errors)
+                == CHESS_SUCCESS, chessDestroy(chess); chessDestroy(expected));
+    ASSERT_TEST(sameErrors(&expected_errors, &errors, true), chessDestroy(chess); chessDestroy(expected));
+    ASSERT_TEST(errors.errors[0].record == 0 && errors.errors[0].malformed, chessDestroy(chess); chessDestroy(expected));
+    ASSERT_TEST(testSameSystems(expected, chess, NUM_OF_PLAYERS), chessDestroy(chess); chessDestroy(expected));
+
+    chessDestroy(chess);
+    chessDestroy(expected);
+    return true;
+}
+
+/**
+ * The workers add the games of the open tournaments with no games at once, and the system and the
+ * errors are the same as when loading on one thread.
+ * */
+bool testLoadOnWorkers()
+{
+    ChessSystemOptions options = { 4 };
+    ChessSystem expected = addRecords(records, &expected_errors);
+    const char* paths[] = { CSV_FILE, BINARY_FILE };
+    ChessFileFormat formats[] = { CHESS_FORMAT_CSV, CHESS_FORMAT_BINARY };
+    for (int i = 0; i < 2; i++)
+    {
+        ChessSystem chess = createTournaments(&options);
+        ASSERT_TEST(chess != NULL, chessDestroy(expected));
+        errors.size = 0;
+        ASSERT_TEST(chessLoadGamesFromFile(chess, paths[i], formats[i], collectError, &errors) == CHESS_SUCCESS,
+                    chessDestroy(chess); chessDestroy(expected));
+        ASSERT_TEST(sameErrors(&expected_errors, &errors, formats[i] == CHESS_FORMAT_BINARY),
+                    chessDestroy(chess); chessDestroy(expected));
+        ASSERT_TEST(testSameSystems(expected, chess, NUM_OF_PLAYERS), chessDestroy(chess); chessDestroy(expected));
+        chessDestroy(chess);
+    }
+
+    chessDestroy(expected);
+    return true;
+}
+
+bool testLoadBadFiles()
+{
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(chessLoadGamesFromFile(NULL, CSV_FILE, CHESS_FORMAT_CSV, NULL, NULL) == CHESS_NULL_ARGUMENT,
+                chessDestroy(chess));
+    ASSERT_TEST(chessLoadGamesFromFile(chess, NULL, CHESS_FORMAT_CSV, NULL, NULL) == CHESS_NULL_ARGUMENT,
+                chessDestroy(chess));
+    ASSERT_TEST(chessLoadGamesFromFile(chess, "no_such_file.csv", CHESS_FORMAT_CSV, NULL, NULL)
+                == CHESS_SAVE_FAILURE, chessDestroy(chess));
+
+    FILE* file = fopen("loader_bad.csv", "w");
+    ASSERT_TEST(file != NULL, chessDestroy(chess));
+    fprintf(file, "1,2,3,0,10\n1,x,3,0,10\n1,2\n\n1,4,5,1,7");
+    fclose(file);
+    ASSERT_TEST(chessAddTournament(chess, 1, 5, "London") == CHESS_SUCCESS, chessDestroy(chess));
+    errors.size = 0;
+    ASSERT_TEST(chessLoadGamesFromFile(chess, "loader_bad.csv", CHESS_FORMAT_CSV, collectError, &errors)
+                == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(errors.size == 2 && errors.errors[0].record == 2 && errors.errors[1].record == 3,
+                chessDestroy(chess));
+    ASSERT_TEST(errors.errors[0].malformed && errors.errors[1].malformed, chessDestroy(chess));
+    ChessResult result;
+    ASSERT_TEST(chessCalculateAveragePlayTime(chess, 5, &result) == 7.0 && result == CHESS_SUCCESS,
+                chessDestroy(chess));
+
+    chessDestroy(chess);
+    return true;
+}
+
+int main()
+{
+    createRecords(records);
+    if (!writeFiles(records))
+    {
+        printf("Could not write the test files\n");
+        return 1;
+    }
+    RUN_TEST(testLoadCsv, "testLoadCsv");
+    RUN_TEST(testLoadBinary, "testLoadBinary");
+    RUN_TEST(testLoadOnWorkers, "testLoadOnWorkers");
+    RUN_TEST(testLoadBadFiles, "testLoadBadFiles");
+    return TEST_EXIT_STATUS;
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include <stdio.h>
+#include <string.h>
+#include "../chessSystem.h"
+#include "../chessLocation.h"
+#include "../test_utilities.h"
+
+bool testLocationInternSameId()
+{
+    LocationPool pool = locationPoolCreate();
+    ASSERT_TEST(pool != NULL, );
+    int london = locationIntern(pool, "London");
+    int paris = locationIntern(pool, "Paris");
+    ASSERT_TEST(london >= 0 && paris >= 0 && london != paris, locationPoolDestroy(pool));
+    ASSERT_TEST(locationIntern(pool, "London") == london, locationPoolDestroy(pool));
+    ASSERT_TEST(strcmp(locationGet(pool, london), "London") == 0, locationPoolDestroy(pool));
+    ASSERT_TEST(strcmp(locationGet(pool, paris), "Paris") == 0, locationPoolDestroy(pool));
+    ASSERT_TEST(locationPoolGetSize(pool) == 2, locationPoolDestroy(pool));
+
+    locationPoolDestroy(pool);
+    return true;
+}
+
+bool testLocationInvalid()
+{
+    LocationPool pool = locationPoolCreate();
+    ASSERT_TEST(pool != NULL, );
+    ASSERT_TEST(locationIntern(pool, "london") == LOCATION_INVALID, locationPoolDestroy(pool));
+    ASSERT_TEST(locationIntern(pool, "") == LOCATION_INVALID, locationPoolDestroy(pool));
+    ASSERT_TEST(locationIntern(pool, "Tel aviv") >= 0, locationPoolDestroy(pool));
+    ASSERT_TEST(locationIntern(pool, "Tel Aviv") == LOCATION_INVALID, locationPoolDestroy(pool));
+    ASSERT_TEST(locationPoolGetSize(pool) == 1, locationPoolDestroy(pool));
+
+    locationPoolDestroy(pool);
+    return true;
+}
+
+bool testLocationPoolGrows()
+{
+    LocationPool pool = locationPoolCreate();
+    ASSERT_TEST(pool != NULL, );
+    char location[16] = "Location ";
+    int ids[100];
+    for (int i = 0; i < 100; i++)
+    {
+        location[9] = 'a' + i % 26;
+        location[10] = 'a' + i / 26;
+        location[11] = '\0';
+        ids[i] = locationIntern(pool, location);
+        ASSERT_TEST(ids[i] == i, locationPoolDestroy(pool));
+    }
+    // ids and strings stay the same after the pool grows
+    for (int i = 0; i < 100; i++)
+    {
+        location[9] = 'a' + i % 26;
+        location[10] = 'a' + i / 26;
+        ASSERT_TEST(locationIntern(pool, location) == ids[i], locationPoolDestroy(pool));
+        ASSERT_TEST(strcmp(locationGet(pool, ids[i]), location) == 0, locationPoolDestroy(pool));
+    }
+    ASSERT_TEST(locationPoolGetSize(pool) == 100, locationPoolDestroy(pool));
+
+    locationPoolDestroy(pool);
+    return true;
+}
+
+bool testSharedLocationInStatistics()
+{
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(chessAddTournament(chess, 1, 4, "London") == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddTournament(chess, 2, 4, "London") == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddTournament(chess, 3, 4, "london") == CHESS_INVALID_LOCATION, chessDestroy(chess));
+    ASSERT_TEST(chessAddGame(chess, 2, 1, 2, SECOND_PLAYER, 10) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessEndTournament(chess, 2) == CHESS_SUCCESS, chessDestroy(chess));
+    // the location stays valid after the other tournament with it is removed
+    ASSERT_TEST(chessRemoveTournament(chess, 1) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessSaveTournamentStatistics(chess, "location_statistics.txt") == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(testFileContains("location_statistics.txt", "2\n10\n10.00\nLondon\n1\n2\n"), chessDestroy(chess));
+
+    chessDestroy(chess);
+    return true;
+}
+
+int main()
+{
+    RUN_TEST(testLocationInternSameId, "testLocationInternSameId");
+    RUN_TEST(testLocationInvalid, "testLocationInvalid");
+    RUN_TEST(testLocationPoolGrows, "testLocationPoolGrows");
+    RUN_TEST(testSharedLocationInStatistics, "testSharedLocationInStatistics");
+    return TEST_EXIT_STATUS;
+}
\ No newline at end of file
@@ -0,0 +1,331 @@
+#define _POSIX_C_SOURCE 200809L // mkdir
+
+#include <stdio.h>
+#include <sys/stat.h>
+#include "../chessSystem.h"
+#include "../chessSystemExt.h"
+#include "chessTestUtilities.h"
+
+#define NUM_OF_TOURNAMENTS 10
+#define NUM_OF_PLAYERS 30
+#define GAMES_PER_TOURNAMENT 80
+#define MAX_PLAYER_ID (NUM_OF_PLAYERS * (1 + NUM_OF_TOURNAMENTS / 4))
+#define JOURNAL "merge_journal"
+#define NEXT_LOG JOURNAL ".2.log" // the log a compaction of a new journal opens
+
+typedef ChessSystem (*Create)(void);
+
+static bool ends(int tournament_id)
+{
+    return tournament_id % 4 == 0;
+}
+
+/**
+ * Add the games of a tournament, the same ones every time. Some of them fail, the same way every time.
+ * The tournaments that end have players of their own: the winner of a tournament depends on the games
+ * its players had in other tournaments by the time it ended.
+ * */
+static void addGames(ChessSystem chess, int tournament_id)
+{
+    unsigned int seed = tournament_id;
+    int first_id = ends(tournament_id) ? 1 + tournament_id / 4 * NUM_OF_PLAYERS : 1;
+    for (int i = 0; i < GAMES_PER_TOURNAMENT; i++)
+    {
+        int player1 = first_id + testRandom(&seed, NUM_OF_PLAYERS);
+        int player2 = first_id + testRandom(&seed, NUM_OF_PLAYERS);
+        Winner winner = (Winner)testRandom(&seed, 3);
+        chessAddGame(chess, tournament_id, player1, player2, winner, 1 + testRandom(&seed, 100));
+    }
+}
+
+/**
+ * A system with the games of the tournaments whose id is odd (part 1), even (part 0), or all of them (part 2).
+ * The open tournaments are added to every part, so the parts share them, with games in only one of them.
+ * */
+static ChessSystem createPart(int part)
+{
+    ChessSystem chess = chessCreate();
+    for (int id = 1; id <= NUM_OF_TOURNAMENTS; id++)
+    {
+        bool has_games = part == 2 || id % 2 == part;
+        if (has_games || !ends(id))
+        {
+            chessAddTournament(chess, id, 3 + id % 3, id % 3 ? "London" : "Paris");
+        }
+        if (has_games)
+        {
+            addGames(chess, id);
+        }
+        if (has_games && ends(id))
+        {
+            chessEndTournament(chess, id);
+        }
+    }
+    return chess;
+}
+
+bool testMergeLikeOneSystem()
+{
+    ChessSystem expected = createPart(2);
+    for (int part = 0; part < 2; part++)
+    {
+        ChessSystem dst = createPart(part);
+        ChessSystem src = createPart(1 - part);
+        ChessSystem src_copy = createPart(1 - part);
+        ASSERT_TEST(chessMerge(dst, src) == CHESS_SUCCESS,
+                    chessDestroy(dst); chessDestroy(src); chessDestroy(src_copy); chessDestroy(expected));
+        ASSERT_TEST(testSameSystems(dst, expected, MAX_PLAYER_ID) && testSameSystems(src, src_copy, MAX_PLAYER_ID),
+                    chessDestroy(dst); chessDestroy(src); chessDestroy(src_copy); chessDestroy(expected));
+
+        // the merged system goes on like the one that had every game
+        ChessSystem other = createPart(2);
+        for (int id = 1; id <= NUM_OF_TOURNAMENTS; id++)
+        {
+            ASSERT_TEST(chessEndTournament(dst, id) == chessEndTournament(other, id),
+                        chessDestroy(dst); chessDestroy(src); chessDestroy(src_copy); chessDestroy(other);
+                        chessDestroy(expected));
+        }
+        ASSERT_TEST(testSameSystems(dst, other, MAX_PLAYER_ID),
+                    chessDestroy(dst); chessDestroy(src); chessDestroy(src_copy); chessDestroy(other);
+                    chessDestroy(expected));
+        chessDestroy(dst);
+        chessDestroy(src);
+        chessDestroy(src_copy);
+        chessDestroy(other);
+    }
+
+    // into an empty system, and of an empty system
+    ChessSystem empty = chessCreate();
+    ChessSystem other_empty = chessCreate();
+    ChessSystem all = createPart(2);
+    ASSERT_TEST(chessMerge(empty, all) == CHESS_SUCCESS && chessMerge(all, other_empty) == CHESS_SUCCESS,
+                chessDestroy(empty); chessDestroy(other_empty); chessDestroy(all); chessDestroy(expected));
+    ASSERT_TEST(testSameSystems(empty, expected, MAX_PLAYER_ID) && testSameSystems(all, expected, MAX_PLAYER_ID),
+                chessDestroy(empty); chessDestroy(other_empty); chessDestroy(all); chessDestroy(expected));
+
+    chessDestroy(empty);
+    chessDestroy(other_empty);
+    chessDestroy(all);
+    chessDestroy(expected);
+    return true;
+}
+
+/**
+ * Tournament 1 is open without games, 3 has games, 5 has ended, and 7 allows a single game per player.
+ * */
+static ChessSystem createDst(void)
+{
+    ChessSystem chess = chessCreate();
+    chessAddTournament(chess, 1, 2, "London");
+    chessAddTournament(chess, 3, 2, "Paris");
+    chessAddTournament(chess, 5, 2, "London");
+    chessAddTournament(chess, 7, 1, "London");
+    chessAddGame(chess, 3, 1, 2, FIRST_PLAYER, 10);
+    chessAddGame(chess, 3, 1, 3, DRAW, 20);
+    chessAddGame(chess, 5, 4, 5, SECOND_PLAYER, 30);
+    chessEndTournament(chess, 5);
+    return chess;
+}
+
+static ChessSystem createOtherLocation(void)
+{
+    ChessSystem chess = chessCreate();
+    chessAddTournament(chess, 1, 2, "Paris");
+    chessAddGame(chess, 1, 1, 2, FIRST_PLAYER, 10);
+    chessAddTournament(chess, 2, 2, "London");
+    chessAddGame(chess, 2, 8, 9, DRAW, 10);
+    return chess;
+}
+
+static ChessSystem createGamesInBoth(void)
+{
+    ChessSystem chess = chessCreate();
+    chessAddTournament(chess, 2, 2, "London");
+    chessAddGame(chess, 2, 8, 9, DRAW, 10);
+    chessAddTournament(chess, 3, 2, "Paris");
+    chessAddGame(chess, 3, 6, 7, DRAW, 10);
+    return chess;
+}
+
+static ChessSystem createOpenWhereEnded(void)
+{
+    ChessSystem chess = chessCreate();
+    chessAddTournament(chess, 2, 2, "London");
+    chessAddGame(chess, 2, 8, 9, DRAW, 10);
+    chessAddTournament(chess, 5, 2, "London");
+    return chess;
+}
+
+static ChessSystem createEndedWhereOpen(void)
+{
+    ChessSystem chess = chessCreate();
+    chessAddTournament(chess, 1, 2, "London");
+    chessAddGame(chess, 1, 1, 2, FIRST_PLAYER, 10);
+    chessEndTournament(chess, 1);
+    return chess;
+}
+
+/**
+ * Player 1 plays 3 games in tournament 1, which dst only allows 2 of.
+ * */
+static ChessSystem createExceeding(void)
+{
+    ChessSystem chess = chessCreate();
+    chessAddTournament(chess, 1, 5, "London");
+    chessAddGame(chess, 1, 1, 2, FIRST_PLAYER, 10);
+    chessAddGame(chess, 1, 1, 3, FIRST_PLAYER, 10);
+    chessAddGame(chess, 1, 1, 4, FIRST_PLAYER, 10);
+    return chess;
+}
+
+static ChessSystem createExceedingBeforeConflict(void)
+{
+    ChessSystem chess = createExceeding();
+    chessAddTournament(chess, 3, 2, "Paris");
+    chessAddGame(chess, 3, 6, 7, DRAW, 10);
+    return chess;
+}
+
+/**
+ * A conflict in tournament 1, and player 1 plays 2 games in tournament 7, which dst only allows 1 of.
+ * */
+static ChessSystem createConflictBeforeExceeding(void)
+{
+    ChessSystem chess = createOtherLocation();
+    chessAddTournament(chess, 7, 3, "London");
+    chessAddGame(chess, 7, 1, 2, FIRST_PLAYER, 10);
+    chessAddGame(chess, 7, 1, 3, FIRST_PLAYER, 10);
+    return chess;
+}
+
+/**
+ * Check that merging the system of create_src into that of create_dst fails with result,
+ * and leaves both systems as new ones.
+ * */
+static bool conflicts(Create create_dst, Create create_src, ChessResult result)
+{
+    ChessSystem dst = create_dst();
+    ChessSystem src = create_src();
+    ChessSystem dst_copy = create_dst();
+    ChessSystem src_copy = create_src();
+    bool same = chessMerge(dst, src) == result && testSameSystems(dst, dst_copy, NUM_OF_PLAYERS)
+                && testSameSystems(src, src_copy, NUM_OF_PLAYERS);
+
+    // and dst goes on as if nothing was merged into it
+    for (int id = 1; id <= 7 && same; id++)
+    {
+        same = chessAddGame(dst, id, 1, 9, DRAW, 5) == chessAddGame(dst_copy, id, 1, 9, DRAW, 5)
+               && chessAddGame(dst, id, 1, 10, DRAW, 5) == chessAddGame(dst_copy, id, 1, 10, DRAW, 5)
+               && chessEndTournament(dst, id) == chessEndTournament(dst_copy, id);
+    }
+    same = same && testSameSystems(dst, dst_copy, NUM_OF_PLAYERS);
+    chessDestroy(dst);
+    chessDestroy(src);
+    chessDestroy(dst_copy);
+    chessDestroy(src_copy);
+    return same;
+}
+
+bool testMergeConflicts()
+{
+    ASSERT_TEST(conflicts(createDst, createOtherLocation, CHESS_TOURNAMENT_ALREADY_EXISTS), );
+    ASSERT_TEST(conflicts(createDst, createGamesInBoth, CHESS_TOURNAMENT_ALREADY_EXISTS), );
+    ASSERT_TEST(conflicts(createDst, createOpenWhereEnded, CHESS_TOURNAMENT_ENDED), );
+    ASSERT_TEST(conflicts(createDst, createEndedWhereOpen, CHESS_TOURNAMENT_ENDED), );
+    ASSERT_TEST(conflicts(createDst, createExceeding, CHESS_EXCEEDED_GAMES), );
+    // the conflict of the lowest id is the one returned
+    ASSERT_TEST(conflicts(createDst, createExceedingBeforeConflict, CHESS_EXCEEDED_GAMES), );
+    ASSERT_TEST(conflicts(createDst, createConflictBeforeExceeding, CHESS_TOURNAMENT_ALREADY_EXISTS), );
+    return true;
+}
+
+/**
+ * The games of src respect the lower limit of dst, which the merged tournament keeps.
+ * */
+bool testMergeKeepsLimitOfDst()
+{
+    ChessSystem dst = createDst();
+    ChessSystem src = chessCreate();
+    ASSERT_TEST(chessAddTournament(src, 1, 5, "London") == CHESS_SUCCESS, chessDestroy(dst); chessDestroy(src));
+    ASSERT_TEST(chessAddGame(src, 1, 1, 2, FIRST_PLAYER, 10) == CHESS_SUCCESS, chessDestroy(dst); chessDestroy(src));
+    ASSERT_TEST(chessAddGame(src, 1, 3, 4, DRAW, 20) == CHESS_SUCCESS, chessDestroy(dst); chessDestroy(src));
+    ASSERT_TEST(chessMerge(dst, src) == CHESS_SUCCESS, chessDestroy(dst); chessDestroy(src));
+
+    ChessSystem expected = createDst();
+    ASSERT_TEST(chessAddGame(expected, 1, 1, 2, FIRST_PLAYER, 10) == CHESS_SUCCESS,
+                chessDestroy(dst); chessDestroy(src); chessDestroy(expected));
+    ASSERT_TEST(chessAddGame(expected, 1, 3, 4, DRAW, 20) == CHESS_SUCCESS,
+                chessDestroy(dst); chessDestroy(src); chessDestroy(expected));
+    ASSERT_TEST(testSameSystems(dst, expected, NUM_OF_PLAYERS), chessDestroy(dst); chessDestroy(src); chessDestroy(expected));
+    ASSERT_TEST(chessAddGame(dst, 1, 1, 5, FIRST_PLAYER, 10) == CHESS_SUCCESS,
+                chessDestroy(dst); chessDestroy(src); chessDestroy(expected));
+    ASSERT_TEST(chessAddGame(dst, 1, 1, 6, FIRST_PLAYER, 10) == CHESS_EXCEEDED_GAMES,
+                chessDestroy(dst); chessDestroy(src); chessDestroy(expected));
+
+    chessDestroy(dst);
+    chessDestroy(src);
+    chessDestroy(expected);
+    return true;
+}
+
+static void removeJournal(void)
+{
+    remove(JOURNAL ".1.snap");
+    remove(JOURNAL ".1.log");
+    remove(NEXT_LOG);
+}
+
+/**
+ * A journal that can't be compacted fails the merge only once dst is merged.
+ * */
+bool testMergeFailsToCompact()
+{
+    removeJournal();
+    ChessSystem dst = createDst();
+    ChessSystem src = chessCreate();
+    ASSERT_TEST(chessJournalOpen(dst, JOURNAL, NULL) == CHESS_SUCCESS, chessDestroy(dst); chessDestroy(src));
+    // a directory in place of the next log
+    ASSERT_TEST(mkdir(NEXT_LOG, 0777) == 0, chessDestroy(dst); chessDestroy(src); removeJournal());
+    ASSERT_TEST(chessAddTournament(src, 1, 5, "London") == CHESS_SUCCESS,
+                chessDestroy(dst); chessDestroy(src); removeJournal());
+    ASSERT_TEST(chessAddGame(src, 1, 1, 2, FIRST_PLAYER, 10) == CHESS_SUCCESS,
+                chessDestroy(dst); chessDestroy(src); removeJournal());
+    ASSERT_TEST(chessMerge(dst, src) == CHESS_SAVE_FAILURE, chessDestroy(dst); chessDestroy(src); removeJournal());
+
+    ChessSystem expected = createDst();
+    ASSERT_TEST(chessMerge(expected, src) == CHESS_SUCCESS,
+                chessDestroy(dst); chessDestroy(src); chessDestroy(expected); removeJournal());
+    ASSERT_TEST(testSameSystems(dst, expected, NUM_OF_PLAYERS),
+                chessDestroy(dst); chessDestroy(src); chessDestroy(expected); removeJournal());
+
+    chessDestroy(dst);
+    chessDestroy(src);
+    chessDestroy(expected);
+    removeJournal();
+    return true;
+}
+
+bool testMergeArguments()
+{
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(chessMerge(NULL, chess) == CHESS_NULL_ARGUMENT && chessMerge(chess, NULL) == CHESS_NULL_ARGUMENT,
+                chessDestroy(chess));
+    // a system merges into itself only while it has no games
+    ASSERT_TEST(chessAddTournament(chess, 1, 2, "London") == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessMerge(chess, chess) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddGame(chess, 1, 1, 2, DRAW, 10) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessMerge(chess, chess) == CHESS_TOURNAMENT_ALREADY_EXISTS, chessDestroy(chess));
+
+    chessDestroy(chess);
+    return true;
+}
+
+int main()
+{
+    RUN_TEST(testMergeLikeOneSystem, "testMergeLikeOneSystem");
+    RUN_TEST(testMergeConflicts, "testMergeConflicts");
+    RUN_TEST(testMergeKeepsLimitOfDst, "testMergeKeepsLimitOfDst");
+    RUN_TEST(testMergeFailsToCompact, "testMergeFailsToCompact");
+    RUN_TEST(testMergeArguments, "testMergeArguments");
+    return TEST_EXIT_STATUS;
+}
\ No newline at end of file
@@ -0,0 +1,237 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <locale.h>
+#include "../chessSystem.h"
+#include "../chessOutput.h"
+#include "../chessSystemExt.h"
+#include "../test_utilities.h"
+
+#define OUTPUT_FILE "output_test.txt"
+#define EXPECTED_FILE "output_expected.txt"
+#define NUM_OF_VALUES 20000
+#define NUM_OF_ITEMS 100000
+#define NUM_OF_TOURNAMENTS 500
+
+/**
+ * Doubles of all kinds: hundredths right on and around ties, exact binary halves,
+ * negative numbers and -0, and numbers too big for the fast path.
+ * */
+static double createValue(int index)
+{
+    switch (index % 8)
+    {
+        case 0: return index / 1000.0;                  // x.xx5 ties
+        case 1: return -index / 1000.0;
+        case 2: return index / 8.0;                     // exact halves of hundredths
+        case 3: return (index % 997) * 0.01 + 0.005;
+        case 4: return index * 123456.789;
+        case 5: return 1e9 + index / 1000.0;
+        case 6: return (index % 2 ? -1 : 1) * 1e300 / (index + 1);
+        default: return (index % 3) ? -0.0 : 1.0 / (index + 3);
+    }
+}
+
+/**
+ * Write the values with outputFixed2, one per line, in the current locale.
+ * */
+static bool writeValues(const char* path)
+{
+    Output output = outputOpen(path);
+    if (output == NULL)
+    {
+        return false;
+    }
+    for (int i = 0; i < NUM_OF_VALUES; i++)
+    {
+        outputFixed2(output, createValue(i));
+        outputChar(output, '\n');
+    }
+    return outputClose(output);
+}
+
+/**
+ * Write what printf writes for the values, in the C locale.
+ * */
+static bool writeExpectedValues(const char* path)
+{
+    FILE* file = fopen(path, "w");
+    if (file == NULL)
+    {
+        return false;
+    }
+    for (int i = 0; i < NUM_OF_VALUES; i++)
+    {
+        fprintf(file, "%.2lf\n", createValue(i));
+    }
+    return fclose(file) == 0;
+}
+
+bool testFixed2LikePrintf()
+{
+    ASSERT_TEST(writeExpectedValues(EXPECTED_FILE), );
+    ASSERT_TEST(writeValues(OUTPUT_FILE), );
+    ASSERT_TEST(testFilesEqual(OUTPUT_FILE, EXPECTED_FILE), );
+    return true;
+}
+
+/**
+ * The numbers left to snprintf must not take the decimal point of another locale.
+ * Uses the locale of the environment, or one of a few common ones with a ',' decimal point.
+ * */
+bool testFixed2IgnoresLocale()
+{
+    ASSERT_TEST(writeExpectedValues(EXPECTED_FILE), );
+    const char* locales[] = { "", "de_DE.UTF-8", "fr_FR.UTF-8", "de_DE", "fr_FR", "ru_RU.UTF-8" };
+    bool found = false;
+    for (int i = 0; i < (int)(sizeof(locales) / sizeof(locales[0])) && !found; i++)
+    {
+        found = setlocale(LC_NUMERIC, locales[i]) != NULL && strcmp(localeconv()->decimal_point, ".") != 0;
+    }
+    if (!found)
+    {
+        printf("(no locale with another decimal point) ");
+        setlocale(LC_NUMERIC, "C");
+        return true;
+    }
+    bool written = writeValues(OUTPUT_FILE);
+    setlocale(LC_NUMERIC, "C");
+    ASSERT_TEST(written, );
+    ASSERT_TEST(testFilesEqual(OUTPUT_FILE, EXPECTED_FILE), );
+    return true;
+}
+
+bool testIntLikePrintf()
+{
+    int values[] = { 0, 1, -1, 9, 10, -10, 123456789, INT_MAX, INT_MIN, INT_MIN + 1 };
+    int size = sizeof(values) / sizeof(values[0]);
+    Output output = outputOpen(OUTPUT_FILE);
+    FILE* file = fopen(EXPECTED_FILE, "w");
+    ASSERT_TEST(output != NULL && file != NULL, );
+    for (int i = 0; i < size; i++)
+    {
+        outputInt(output, values[i]);
+        outputChar(output, ' ');
+        fprintf(file, "%d ", values[i]);
+    }
+    outputString(output, "end\n");
+    fprintf(file, "end\n");
+    fclose(file);
+    ASSERT_TEST(outputClose(output), );
+    ASSERT_TEST(testFilesEqual(OUTPUT_FILE, EXPECTED_FILE), );
+    return true;
+}
+
+/**
+ * A stream output comes after what was already written to the stream.
+ * */
+bool testStreamAndMemoryOutputs()
+{
+    FILE* file = fopen(OUTPUT_FILE, "w");
+    ASSERT_TEST(file != NULL, );
+    fprintf(file, "first ");
+    Output output = outputForStream(file);
+    Output memory = outputInMemory();
+    ASSERT_TEST(output != NULL && memory != NULL, fclose(file));
+    outputString(memory, "second ");
+    outputFixed2(memory, 2.5);
+    outputString(output, "then ");
+    ASSERT_TEST(outputDrain(memory, output), outputClose(output); fclose(file));
+    ASSERT_TEST(outputClose(output), fclose(file));
+    fprintf(file, " last");
+    fclose(file);
+    ASSERT_TEST(testFileContains(OUTPUT_FILE, "first then second 2.50 last"), );
+    return true;
+}
+
+static void printItem(Output output, int index, void* context)
+{
+    outputInt(output, index);
+    outputChar(output, ' ');
+    outputFixed2(output, ((double*)context)[index]);
+    outputChar(output, '\n');
+}
+
+bool testItemsOnPool()
+{
+    double* values = (double*)malloc(sizeof(double) * NUM_OF_ITEMS);
+    ASSERT_TEST(values != NULL, );
+    for (int i = 0; i < NUM_OF_ITEMS; i++)
+    {
+        values[i] = createValue(i);
+    }
+    Output output = outputOpen(EXPECTED_FILE);
+    ASSERT_TEST(output != NULL, free(values));
+    outputItems(output, NUM_OF_ITEMS, printItem, values, NULL);
+    ASSERT_TEST(outputClose(output), free(values));
+
+    Pool pool = poolCreate(4);
+    ASSERT_TEST(pool != NULL, free(values));
+    output = outputOpen(OUTPUT_FILE);
+    ASSERT_TEST(output != NULL, poolDestroy(pool); free(values));
+    outputItems(output, NUM_OF_ITEMS, printItem, values, pool);
+    ASSERT_TEST(outputClose(output), poolDestroy(pool); free(values));
+    poolDestroy(pool);
+    free(values);
+    ASSERT_TEST(testFilesEqual(OUTPUT_FILE, EXPECTED_FILE), );
+    return true;
+}
+
+/**
+ * Fill a system with many ended tournaments, so their statistics are formatted on all the workers.
+ * */
+static bool addEndedTournaments(ChessSystem chess)
+{
+    for (int tournament_id = 1; tournament_id <= NUM_OF_TOURNAMENTS; tournament_id++)
+    {
+        if (chessAddTournament(chess, tournament_id, 10, tournament_id % 2 ? "London" : "Paris") != CHESS_SUCCESS)
+        {
+            return false;
+        }
+        for (int i = 0; i < tournament_id % 13; i++)
+        {
+            int player = 1 + (tournament_id * 7 + i) % 50;
+            if (chessAddGame(chess, tournament_id, player, player + 50 + i, (Winner)(i % 3), tournament_id + i * 3)
+                != CHESS_SUCCESS)
+            {
+                return false;
+            }
+        }
+        // some are left open, and are not saved. those without games can't end
+        if (tournament_id % 5 != 0 && tournament_id % 13 != 0 && chessEndTournament(chess, tournament_id) != CHESS_SUCCESS)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool testStatisticsOnWorkers()
+{
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(chess != NULL && addEndedTournaments(chess), chessDestroy(chess));
+    ASSERT_TEST(chessSaveTournamentStatistics(chess, EXPECTED_FILE) == CHESS_SUCCESS, chessDestroy(chess));
+    chessDestroy(chess);
+
+    ChessSystemOptions options = { 3 };
+    chess = chessCreateWithOptions(&options);
+    ASSERT_TEST(chess != NULL && addEndedTournaments(chess), chessDestroy(chess));
+    ASSERT_TEST(chessSaveTournamentStatistics(chess, OUTPUT_FILE) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(testFilesEqual(OUTPUT_FILE, EXPECTED_FILE), chessDestroy(chess));
+    ChessWorkerCounters counters[4];
+    ASSERT_TEST(chessGetWorkerCounters(chess, counters, 4) == 4, chessDestroy(chess));
+    chessDestroy(chess);
+    return true;
+}
+
+int main()
+{
+    RUN_TEST(testFixed2LikePrintf, "testFixed2LikePrintf");
+    RUN_TEST(testFixed2IgnoresLocale, "testFixed2IgnoresLocale");
+    RUN_TEST(testIntLikePrintf, "testIntLikePrintf");
+    RUN_TEST(testStreamAndMemoryOutputs, "testStreamAndMemoryOutputs");
+    RUN_TEST(testItemsOnPool, "testItemsOnPool");
+    RUN_TEST(testStatisticsOnWorkers, "testStatisticsOnWorkers");
+    return TEST_EXIT_STATUS;
+}
\ No newline at end of file
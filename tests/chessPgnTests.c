@@ -0,0 +1,251 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../chessSystem.h"
+#include "../chessSystemExt.h"
+#include "chessTestUtilities.h"
+
+#define NUM_OF_GAMES 20000 // a few MB, so the file is parsed in several chunks
+#define MAX_GAMES_PER_PLAYER 6
+#define MAX_ERRORS NUM_OF_GAMES
+#define PGN_FILE "pgn_games.pgn"
+#define EMPTY_FILE "pgn_empty.pgn"
+
+typedef struct {
+    int tournament_id;
+    int player1;
+    int player2;
+    Winner winner;
+    int play_time;
+    bool malformed;
+} PgnRecord;
+
+typedef struct {
+    ChessLoadError errors[MAX_ERRORS];
+    int size;
+    int bad_names;
+} Errors;
+
+static PgnRecord records[NUM_OF_GAMES];
+
+static void collectError(const ChessLoadError* error, void* context)
+{
+    Errors* errors = (Errors*)context;
+    if (errors->size < MAX_ERRORS)
+    {
+        errors->errors[errors->size++] = *error;
+    }
+}
+
+/**
+ * Map "Event 7", "Player \"12\"" and the like to the number in them.
+ * Counts the names in which a backslash was left.
+ * */
+static int nameToId(const char* name, void* context)
+{
+    int id = 0;
+    for (; *name != '\0'; name++)
+    {
+        if (*name >= '0' && *name <= '9')
+        {
+            id = 10 * id + (*name - '0');
+        }
+        else if (*name == '\\')
+        {
+            ((Errors*)context)->bad_names++;
+        }
+    }
+    return id;
+}
+
+/**
+ * Write a PGN file with moves, unknown tags, escaped names and CRLF lines, and every few games
+ * one without a Site, without a final result, or without a play time.
+ * The play time is in GameDuration, or in StartTime and EndTime, sometimes past midnight.
+ * */
+static bool writePgn(const char* path)
+{
+    static const char* results[] = { "1-0", "0-1", "1/2-1/2" };
+    FILE* file = fopen(path, "w");
+    if (file == NULL)
+    {
+        return false;
+    }
+    unsigned int seed = 777;
+    for (int i = 0; i < NUM_OF_GAMES; i++)
+    {
+        PgnRecord* record = &records[i];
+        record->tournament_id = 1 + testRandom(&seed, TEST_NUM_OF_TOURNAMENTS);
+        record->player1 = 1 + testRandom(&seed, TEST_NUM_OF_PLAYERS);
+        record->player2 = 1 + testRandom(&seed, TEST_NUM_OF_PLAYERS);
+        record->winner = (Winner)testRandom(&seed, 3);
+        record->play_time = testRandom(&seed, 4000);
+        int kind = i % 50;
+        record->malformed = kind < 3;
+        const char* end = (kind == 5) ? "\r\n" : "\n";
+
+        fprintf(file, "[Event \"Event %d\"]%s", record->tournament_id, end);
+        if (kind != 0)
+        {
+            fprintf(file, "[Site \"%s\"]%s", record->tournament_id % 2 ? "London" : "Paris", end);
+        }
+        fprintf(file, "[Date \"2020.01.01\"]%s", end);
+        fprintf(file, "[White \"Player \\\"%d\\\"\"]%s", record->player1, end);
+        fprintf(file, "[Black \"Player %d\"]%s", record->player2, end);
+        fprintf(file, "[Result \"%s\"]%s", kind == 1 ? "*" : results[record->winner], end);
+        if (kind == 3)
+        {
+            // past midnight
+            record->play_time = 120 + record->play_time % 60;
+            fprintf(file, "[StartTime \"23:59:00\"]%s[EndTime \"00:01:%02d\"]%s", end, record->play_time - 120, end);
+        }
+        else if (kind == 4)
+        {
+            fprintf(file, "[StartTime \"10:00:00\"]%s[EndTime \"%02d:%02d:%02d\"]%s", end,
+                    10 + record->play_time / 3600, record->play_time / 60 % 60, record->play_time % 60, end);
+        }
+        else if (kind != 2)
+        {
+            fprintf(file, "[GameDuration \"%d:%02d:%02d\"]%s",
+                    record->play_time / 3600, record->play_time / 60 % 60, record->play_time % 60, end);
+        }
+        fprintf(file, "[Annotator \"Someone\"]%s%s", end, end);
+        fprintf(file, "1. e4 e5 2. Nf3 Nc6 {[%%clk 0:03:00]} 3. Bb5 a6 %s%s",
+                kind == 1 ? "*" : results[record->winner], end);
+        fprintf(file, "%s", end);
+    }
+    return fclose(file) == 0;
+}
+
+/**
+ * Add the games of the file to a system with the API, the way chessImportPGN is documented to.
+ * */
+static bool addRecords(ChessSystem chess, Errors* errors)
+{
+    for (int i = 0; i < NUM_OF_GAMES; i++)
+    {
+        const PgnRecord* record = &records[i];
+        ChessLoadError error = { i, true, CHESS_SUCCESS };
+        if (record->malformed)
+        {
+            collectError(&error, errors);
+            continue;
+        }
+        const char* site = record->tournament_id % 2 ? "London" : "Paris";
+        ChessResult result = chessAddTournament(chess, record->tournament_id, MAX_GAMES_PER_PLAYER, site);
+        if (result == CHESS_SUCCESS || result == CHESS_TOURNAMENT_ALREADY_EXISTS)
+        {
+            result = chessAddGame(chess, record->tournament_id, record->player1, record->player2,
+                                  record->winner, record->play_time);
+        }
+        if (result == CHESS_OUT_OF_MEMORY)
+        {
+            return false;
+        }
+        if (result != CHESS_SUCCESS)
+        {
+            error.malformed = false;
+            error.result = result;
+            collectError(&error, errors);
+        }
+    }
+    return true;
+}
+
+static bool sameErrors(const Errors* errors1, const Errors* errors2)
+{
+    if (errors1->size != errors2->size)
+    {
+        return false;
+    }
+    for (int i = 0; i < errors1->size; i++)
+    {
+        const ChessLoadError* error1 = &errors1->errors[i];
+        const ChessLoadError* error2 = &errors2->errors[i];
+        if (error1->record != error2->record || error1->malformed != error2->malformed
+            || error1->result != error2->result)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Import the file with num_of_threads threads and check it gives the same system and errors
+ * as adding its games with the API.
+ * */
+static bool importLikeApi(int num_of_threads)
+{
+    static Errors expected_errors;
+    static Errors errors;
+    memset(&expected_errors, 0, sizeof(expected_errors));
+    memset(&errors, 0, sizeof(errors));
+    ChessSystem expected = chessCreate();
+    ChessSystem chess = chessCreate();
+    ChessPgnOptions options = { nameToId, nameToId, &errors, MAX_GAMES_PER_PLAYER, num_of_threads,
+                                collectError, &errors };
+    bool same = expected != NULL && chess != NULL && addRecords(expected, &expected_errors)
+                && chessImportPGN(chess, PGN_FILE, &options) == CHESS_SUCCESS
+                && errors.bad_names == 0
+                && errors.size > NUM_OF_GAMES / 50 * 3 // some games were rejected, not only malformed ones
+                && sameErrors(&errors, &expected_errors)
+                && testSameSystems(chess, expected, TEST_NUM_OF_PLAYERS);
+    chessDestroy(expected);
+    chessDestroy(chess);
+    return same;
+}
+
+bool testPgnImportLikeApi()
+{
+    ASSERT_TEST(writePgn(PGN_FILE), );
+    ASSERT_TEST(importLikeApi(1), );
+    return true;
+}
+
+/**
+ * The chunks are parsed in parallel, and still committed in file order.
+ * */
+bool testPgnImportOnThreads()
+{
+    ASSERT_TEST(writePgn(PGN_FILE), );
+    ASSERT_TEST(importLikeApi(3), );
+    ASSERT_TEST(importLikeApi(8), );
+    ASSERT_TEST(importLikeApi(0), );
+    return true;
+}
+
+bool testPgnImportArguments()
+{
+    ChessSystem chess = chessCreate();
+    static Errors errors;
+    memset(&errors, 0, sizeof(errors));
+    ChessPgnOptions options = { nameToId, nameToId, &errors, MAX_GAMES_PER_PLAYER, 1, collectError, &errors };
+
+    FILE* file = fopen(EMPTY_FILE, "w");
+    ASSERT_TEST(file != NULL, chessDestroy(chess));
+    fclose(file);
+    ASSERT_TEST(chessImportPGN(chess, EMPTY_FILE, &options) == CHESS_SUCCESS && errors.size == 0,
+                chessDestroy(chess));
+    ASSERT_TEST(chessImportPGN(chess, "no_such_file.pgn", &options) == CHESS_SAVE_FAILURE, chessDestroy(chess));
+
+    ASSERT_TEST(chessImportPGN(NULL, EMPTY_FILE, &options) == CHESS_NULL_ARGUMENT, chessDestroy(chess));
+    ASSERT_TEST(chessImportPGN(chess, NULL, &options) == CHESS_NULL_ARGUMENT, chessDestroy(chess));
+    ASSERT_TEST(chessImportPGN(chess, EMPTY_FILE, NULL) == CHESS_NULL_ARGUMENT, chessDestroy(chess));
+    options.player_id = NULL;
+    ASSERT_TEST(chessImportPGN(chess, EMPTY_FILE, &options) == CHESS_NULL_ARGUMENT, chessDestroy(chess));
+    options.player_id = nameToId;
+    options.tournament_id = NULL;
+    ASSERT_TEST(chessImportPGN(chess, EMPTY_FILE, &options) == CHESS_NULL_ARGUMENT, chessDestroy(chess));
+
+    chessDestroy(chess);
+    return true;
+}
+
+int main()
+{
+    RUN_TEST(testPgnImportLikeApi, "testPgnImportLikeApi");
+    RUN_TEST(testPgnImportOnThreads, "testPgnImportOnThreads");
+    RUN_TEST(testPgnImportArguments, "testPgnImportArguments");
+    return TEST_EXIT_STATUS;
+}
\ No newline at end of file
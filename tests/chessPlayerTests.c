@@ -0,0 +1,140 @@
+#include <stdio.h>
+#include "../chessSystem.h"
+#include "../chessSystemExt.h"
+#include "../chessBitmap.h"
+#include "../test_utilities.h"
+
+bool testBitmapSparseIds()
+{
+    Bitmap bitmap = bitmapCreate();
+    ASSERT_TEST(bitmap != NULL, );
+    int ids[] = { 0, 1, 63, 64, 65, 4095, 4096, 1000000, 2147483647 };
+    int size = sizeof(ids) / sizeof(ids[0]);
+    for (int i = size - 1; i >= 0; i--)
+    {
+        ASSERT_TEST(bitmapSet(bitmap, ids[i]), bitmapDestroy(bitmap));
+    }
+    ASSERT_TEST(!bitmapGet(bitmap, 2) && !bitmapGet(bitmap, 999999), bitmapDestroy(bitmap));
+
+    // ids come back in order
+    int found = 0;
+    for (int id = bitmapGetNext(bitmap, 0); id >= 0; id = id == 2147483647 ? -1 : bitmapGetNext(bitmap, id + 1))
+    {
+        ASSERT_TEST(found < size && id == ids[found], bitmapDestroy(bitmap));
+        found++;
+    }
+    ASSERT_TEST(found == size, bitmapDestroy(bitmap));
+
+    bitmapClear(bitmap, 64);
+    bitmapClear(bitmap, 1000000);
+    bitmapCompact(bitmap);
+    ASSERT_TEST(!bitmapGet(bitmap, 64) && !bitmapGet(bitmap, 1000000), bitmapDestroy(bitmap));
+    ASSERT_TEST(bitmapGet(bitmap, 63) && bitmapGet(bitmap, 65), bitmapDestroy(bitmap));
+    ASSERT_TEST(bitmapGetNext(bitmap, 4097) == 2147483647, bitmapDestroy(bitmap));
+
+    bitmapDestroy(bitmap);
+    return true;
+}
+
+bool testPlayerOncePlayed()
+{
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(chessAddTournament(chess, 1, 4, "London") == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddGame(chess, 1, 1, 2, FIRST_PLAYER, 5) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessPlayerOncePlayed(chess, 1) && chessPlayerOncePlayed(chess, 2), chessDestroy(chess));
+    ASSERT_TEST(!chessPlayerOncePlayed(chess, 3), chessDestroy(chess));
+
+    ASSERT_TEST(chessRemovePlayer(chess, 1) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessPlayerOncePlayed(chess, 1), chessDestroy(chess));
+    // a player left without games when its tournament is removed is remembered too
+    ASSERT_TEST(chessRemoveTournament(chess, 1) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessPlayerOncePlayed(chess, 1) && chessPlayerOncePlayed(chess, 2), chessDestroy(chess));
+    ChessResult result;
+    chessCalculateAveragePlayTime(chess, 2, &result);
+    ASSERT_TEST(result == CHESS_PLAYER_NOT_EXIST, chessDestroy(chess));
+
+    chessCompact(chess);
+    ASSERT_TEST(chessPlayerOncePlayed(chess, 1) && !chessPlayerOncePlayed(chess, 3), chessDestroy(chess));
+
+    chessDestroy(chess);
+    return true;
+}
+
+/**
+ * A player that is removed and then comes back is a new player:
+ * removing an ended tournament it played in under its old id doesn't touch its new games.
+ * */
+bool testReturningPlayerKeepsNewGames()
+{
+    ChessSystem chess = chessCreate();
+    ChessResult result;
+    ASSERT_TEST(chessAddTournament(chess, 1, 10, "London") == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddTournament(chess, 2, 10, "Paris") == CHESS_SUCCESS, chessDestroy(chess));
+    for (int player = 2; player <= 5; player++)
+    {
+        ASSERT_TEST(chessAddGame(chess, 1, 1, player, FIRST_PLAYER, 100) == CHESS_SUCCESS, chessDestroy(chess));
+    }
+    ASSERT_TEST(chessEndTournament(chess, 1) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessRemovePlayer(chess, 1) == CHESS_SUCCESS, chessDestroy(chess));
+
+    // player 1 comes back, with a single lost game
+    ASSERT_TEST(chessAddGame(chess, 2, 1, 6, SECOND_PLAYER, 10) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessRemoveTournament(chess, 1) == CHESS_SUCCESS, chessDestroy(chess));
+
+    ASSERT_TEST(chessCalculateAveragePlayTime(chess, 1, &result) == 10.0 && result == CHESS_SUCCESS,
+                chessDestroy(chess));
+    FILE* file = fopen("player_levels.txt", "w");
+    ASSERT_TEST(file != NULL, chessDestroy(chess));
+    ASSERT_TEST(chessSavePlayersLevels(chess, file) == CHESS_SUCCESS, fclose(file); chessDestroy(chess));
+    fclose(file);
+    ASSERT_TEST(testFileContains("player_levels.txt", "6 6.00\n1 -10.00\n"), chessDestroy(chess));
+
+    ASSERT_TEST(chessEndTournament(chess, 2) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessSaveTournamentStatistics(chess, "player_statistics.txt") == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(testFileContains("player_statistics.txt", "6\n10\n10.00\nParis\n1\n2\n"), chessDestroy(chess));
+
+    chessDestroy(chess);
+    return true;
+}
+
+/**
+ * Same, for a player that comes back in the tournament it was removed from, before it ends.
+ * */
+bool testReturningPlayerInSameTournament()
+{
+    ChessSystem chess = chessCreate();
+    ChessResult result;
+    ASSERT_TEST(chessAddTournament(chess, 1, 10, "London") == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddTournament(chess, 2, 10, "Paris") == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddGame(chess, 1, 1, 2, FIRST_PLAYER, 100) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddGame(chess, 1, 1, 3, FIRST_PLAYER, 100) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessRemovePlayer(chess, 1) == CHESS_SUCCESS, chessDestroy(chess));
+
+    ASSERT_TEST(chessAddGame(chess, 1, 1, 4, DRAW, 20) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddGame(chess, 2, 1, 5, DRAW, 40) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessEndTournament(chess, 1) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessRemoveTournament(chess, 1) == CHESS_SUCCESS, chessDestroy(chess));
+
+    // only the game in tournament 2 is left, for players 1 and 5
+    ASSERT_TEST(chessCalculateAveragePlayTime(chess, 1, &result) == 40.0 && result == CHESS_SUCCESS,
+                chessDestroy(chess));
+    chessCalculateAveragePlayTime(chess, 2, &result);
+    ASSERT_TEST(result == CHESS_PLAYER_NOT_EXIST, chessDestroy(chess));
+    FILE* file = fopen("player_levels.txt", "w");
+    ASSERT_TEST(file != NULL, chessDestroy(chess));
+    ASSERT_TEST(chessSavePlayersLevels(chess, file) == CHESS_SUCCESS, fclose(file); chessDestroy(chess));
+    fclose(file);
+    ASSERT_TEST(testFileContains("player_levels.txt", "1 2.00\n5 2.00\n"), chessDestroy(chess));
+
+    chessDestroy(chess);
+    return true;
+}
+
+int main()
+{
+    RUN_TEST(testBitmapSparseIds, "testBitmapSparseIds");
+    RUN_TEST(testPlayerOncePlayed, "testPlayerOncePlayed");
+    RUN_TEST(testReturningPlayerKeepsNewGames, "testReturningPlayerKeepsNewGames");
+    RUN_TEST(testReturningPlayerInSameTournament, "testReturningPlayerInSameTournament");
+    return TEST_EXIT_STATUS;
+}
\ No newline at end of file
@@ -0,0 +1,238 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "../chessPool.h"
+#include "../test_utilities.h"
+
+#define NUM_OF_WORKERS 4
+#define MAX_SIZE 100000
+#define NUM_OF_SPAWNS 5000
+#define NUM_OF_CALLERS 3
+
+static int visits[NUM_OF_CALLERS][MAX_SIZE];
+
+static void visitRange(void* context, int begin, int end)
+{
+    int* items = (int*)context;
+    for (int i = begin; i < end; i++)
+    {
+        items[i]++;
+    }
+}
+
+/**
+ * Return true if poolFor visits every item once.
+ * */
+static bool visitsOnce(Pool pool, int* items, int size, int grain)
+{
+    memset(items, 0, sizeof(int) * MAX_SIZE);
+    poolFor(pool, size, grain, visitRange, items);
+    for (int i = 0; i < MAX_SIZE; i++)
+    {
+        if (items[i] != (i < size ? 1 : 0))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool forOnPool(Pool pool)
+{
+    int sizes[] = { 0, 1, 2, 7, 1000, 4096, MAX_SIZE };
+    int grains[] = { 1, 3, 64, 100000 };
+    for (int i = 0; i < (int)(sizeof(sizes) / sizeof(sizes[0])); i++)
+    {
+        for (int j = 0; j < (int)(sizeof(grains) / sizeof(grains[0])); j++)
+        {
+            if (!visitsOnce(pool, visits[0], sizes[i], grains[j]))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool testPoolForVisitsEveryItemOnce()
+{
+    ASSERT_TEST(forOnPool(NULL), );
+    Pool pool = poolCreate(1);
+    ASSERT_TEST(pool != NULL && forOnPool(pool), poolDestroy(pool));
+    poolDestroy(pool);
+    pool = poolCreate(NUM_OF_WORKERS);
+    ASSERT_TEST(pool != NULL && forOnPool(pool), poolDestroy(pool));
+    poolDestroy(pool);
+    return true;
+}
+
+typedef struct {
+    Pool pool;
+    int n;
+    long result;
+} SumTask;
+
+/**
+ * Sum 1 to n by splitting in two tasks, each waiting for tasks of its own.
+ * */
+static void sumTask(void* context)
+{
+    SumTask* task = (SumTask*)context;
+    if (task->n <= 8)
+    {
+        task->result = (long)task->n * (task->n + 1) / 2;
+        return;
+    }
+    int half = task->n / 2;
+    SumTask low = { task->pool, half, 0 };
+    SumTask high = { task->pool, task->n - half, 0 };
+    PoolGroup group;
+    poolGroupInit(&group, task->pool);
+    poolSpawn(&group, sumTask, &low);
+    poolSpawn(&group, sumTask, &high);
+    poolWait(&group);
+    // the high half sums 1 to n - half, shifted by half
+    task->result = low.result + high.result + (long)half * (task->n - half);
+}
+
+bool testPoolNestedTasks()
+{
+    Pool pools[] = { NULL, poolCreate(1), poolCreate(NUM_OF_WORKERS) };
+    for (int i = 0; i < 3; i++)
+    {
+        ASSERT_TEST(i == 0 || pools[i] != NULL, poolDestroy(pools[1]); poolDestroy(pools[2]));
+        SumTask task = { pools[i], 100000, 0 };
+        sumTask(&task);
+        ASSERT_TEST(task.result == 100000L * 100001 / 2, poolDestroy(pools[1]); poolDestroy(pools[2]));
+    }
+    poolDestroy(pools[1]);
+    poolDestroy(pools[2]);
+    return true;
+}
+
+static void countTask(void* context)
+{
+    (*(int*)context)++;
+}
+
+/**
+ * More tasks than a queue holds: those that don't fit run at once.
+ * */
+bool testPoolManySpawns()
+{
+    static int counts[NUM_OF_SPAWNS];
+    memset(counts, 0, sizeof(counts));
+    Pool pool = poolCreate(NUM_OF_WORKERS);
+    ASSERT_TEST(pool != NULL, );
+    PoolGroup group;
+    poolGroupInit(&group, pool);
+    for (int i = 0; i < NUM_OF_SPAWNS; i++)
+    {
+        poolSpawn(&group, countTask, &counts[i]);
+    }
+    poolWait(&group);
+    for (int i = 0; i < NUM_OF_SPAWNS; i++)
+    {
+        ASSERT_TEST(counts[i] == 1, poolDestroy(pool));
+    }
+
+    ChessWorkerCounters counters[NUM_OF_WORKERS + 1];
+    ASSERT_TEST(poolGetCounters(pool, counters, NUM_OF_WORKERS + 1) == NUM_OF_WORKERS + 1, poolDestroy(pool));
+    long tasks_run = 0;
+    for (int i = 0; i <= NUM_OF_WORKERS; i++)
+    {
+        ASSERT_TEST(counters[i].tasks_stolen <= counters[i].tasks_run, poolDestroy(pool));
+        tasks_run += counters[i].tasks_run;
+    }
+    ASSERT_TEST(tasks_run > 0 && tasks_run <= NUM_OF_SPAWNS, poolDestroy(pool));
+    ASSERT_TEST(poolGetNumOfWorkers(pool) == NUM_OF_WORKERS, poolDestroy(pool));
+    poolDestroy(pool);
+
+    ASSERT_TEST(poolGetNumOfWorkers(NULL) == 0 && poolGetCounters(NULL, counters, 1) == 0, );
+    return true;
+}
+
+static int compareInts(const void* int1, const void* int2)
+{
+    int value1 = *(const int*)int1;
+    int value2 = *(const int*)int2;
+    return (value1 > value2) - (value1 < value2);
+}
+
+bool testPoolSortLikeQsort()
+{
+    static int values[MAX_SIZE];
+    static int expected[MAX_SIZE];
+    Pool pool = poolCreate(NUM_OF_WORKERS);
+    ASSERT_TEST(pool != NULL, );
+    int sizes[] = { 0, 1, 2, 100, 5000, MAX_SIZE };
+    unsigned int seed = 99;
+    for (int i = 0; i < (int)(sizeof(sizes) / sizeof(sizes[0])); i++)
+    {
+        for (int j = 0; j < sizes[i]; j++)
+        {
+            seed = seed * 1103515245u + 12345u;
+            values[j] = (int)(seed >> 4) % 1000 - 500; // many equal values
+        }
+        memcpy(expected, values, sizeof(int) * sizes[i]);
+        qsort(expected, sizes[i], sizeof(int), compareInts);
+        poolSort(i % 2 ? pool : NULL, values, sizes[i], sizeof(int), compareInts);
+        ASSERT_TEST(memcmp(values, expected, sizeof(int) * sizes[i]) == 0, poolDestroy(pool));
+        poolSort(pool, values, sizes[i], sizeof(int), compareInts);
+        ASSERT_TEST(memcmp(values, expected, sizeof(int) * sizes[i]) == 0, poolDestroy(pool));
+    }
+    poolDestroy(pool);
+    return true;
+}
+
+typedef struct {
+    Pool pool;
+    int* visits;
+    bool failed;
+} Caller;
+
+static void* callFor(void* argument)
+{
+    Caller* caller = (Caller*)argument;
+    for (int i = 0; i < 20 && !caller->failed; i++)
+    {
+        caller->failed = !visitsOnce(caller->pool, caller->visits, MAX_SIZE - i * 1000, 1 + i * 50);
+    }
+    return NULL;
+}
+
+/**
+ * Threads outside the pool share it at the same time.
+ * */
+bool testPoolSeveralCallers()
+{
+    Pool pool = poolCreate(NUM_OF_WORKERS);
+    ASSERT_TEST(pool != NULL, );
+    Caller callers[NUM_OF_CALLERS];
+    pthread_t threads[NUM_OF_CALLERS];
+    for (int i = 0; i < NUM_OF_CALLERS; i++)
+    {
+        callers[i] = (Caller){ pool, visits[i], false };
+        pthread_create(&threads[i], NULL, callFor, &callers[i]);
+    }
+    bool failed = false;
+    for (int i = 0; i < NUM_OF_CALLERS; i++)
+    {
+        pthread_join(threads[i], NULL);
+        failed = failed || callers[i].failed;
+    }
+    poolDestroy(pool);
+    ASSERT_TEST(!failed, );
+    return true;
+}
+
+int main()
+{
+    RUN_TEST(testPoolForVisitsEveryItemOnce, "testPoolForVisitsEveryItemOnce");
+    RUN_TEST(testPoolNestedTasks, "testPoolNestedTasks");
+    RUN_TEST(testPoolManySpawns, "testPoolManySpawns");
+    RUN_TEST(testPoolSortLikeQsort, "testPoolSortLikeQsort");
+    RUN_TEST(testPoolSeveralCallers, "testPoolSeveralCallers");
+    return TEST_EXIT_STATUS;
+}
\ No newline at end of file
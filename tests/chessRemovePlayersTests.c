@@ -0,0 +1,116 @@
+#include <stdio.h>
+#include "../chessSystem.h"
+#include "../chessSystemExt.h"
+#include "chessTestUtilities.h"
+
+/**
+ * Remove players between the operations, and end the tournaments at last: the winners depend on the
+ * players that are left.
+ * */
+static bool removeOnSystems(ChessSystem chess, ChessSystem expected)
+{
+    if (!testBatchOnSystems(chessRemovePlayers, chessRemovePlayer, chess, expected, TEST_NUM_OF_PLAYERS))
+    {
+        return false;
+    }
+    for (int tournament_id = 1; tournament_id <= TEST_NUM_OF_TOURNAMENTS; tournament_id++)
+    {
+        if (chessEndTournament(chess, tournament_id) != chessEndTournament(expected, tournament_id))
+        {
+            return false;
+        }
+    }
+    return testSameSystems(chess, expected, TEST_NUM_OF_PLAYERS);
+}
+
+bool testRemovePlayersLikeOneByOne()
+{
+    ChessSystem chess = chessCreate();
+    ChessSystem expected = chessCreate();
+    ASSERT_TEST(removeOnSystems(chess, expected), chessDestroy(chess); chessDestroy(expected));
+    chessDestroy(chess);
+    chessDestroy(expected);
+    return true;
+}
+
+bool testRemovePlayersOnWorkers()
+{
+    ChessSystemOptions options = { 3 };
+    ChessSystem chess = chessCreateWithOptions(&options);
+    ChessSystem expected = chessCreate();
+    ASSERT_TEST(chess != NULL, chessDestroy(expected));
+    ASSERT_TEST(removeOnSystems(chess, expected), chessDestroy(chess); chessDestroy(expected));
+    chessDestroy(chess);
+    chessDestroy(expected);
+    return true;
+}
+
+/**
+ * Every player of the system at once, so some games lose both of their players.
+ * */
+bool testRemovePlayersAll()
+{
+    ChessSystem chess = chessCreate();
+    ChessSystem expected = chessCreate();
+    ASSERT_TEST(testRunOperations(chess, 11, 3000) && testRunOperations(expected, 11, 3000),
+                chessDestroy(chess); chessDestroy(expected));
+    int ids[TEST_NUM_OF_PLAYERS];
+    for (int i = 0; i < TEST_NUM_OF_PLAYERS; i++)
+    {
+        ids[i] = TEST_NUM_OF_PLAYERS - i;
+    }
+    ASSERT_TEST(testBatchLikeOneByOne(chessRemovePlayers, chessRemovePlayer, chess, expected, ids,
+                                      TEST_NUM_OF_PLAYERS),
+                chessDestroy(chess); chessDestroy(expected));
+    ASSERT_TEST(testRunOperations(chess, 12, 1000) && testRunOperations(expected, 12, 1000),
+                chessDestroy(chess); chessDestroy(expected));
+    ASSERT_TEST(testSameSystems(chess, expected, TEST_NUM_OF_PLAYERS), chessDestroy(chess); chessDestroy(expected));
+
+    chessDestroy(chess);
+    chessDestroy(expected);
+    return true;
+}
+
+bool testRemovePlayersRepeatedId()
+{
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(chessAddTournament(chess, 1, 2, "London") == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddGame(chess, 1, 1, 2, FIRST_PLAYER, 10) == CHESS_SUCCESS, chessDestroy(chess));
+    int ids[] = { 1, 0, 3, 2, 1 };
+    ChessResult results[5];
+    ASSERT_TEST(chessRemovePlayers(chess, ids, 5, results) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(results[0] == CHESS_SUCCESS && results[1] == CHESS_INVALID_ID
+                    && results[2] == CHESS_PLAYER_NOT_EXIST && results[3] == CHESS_SUCCESS
+                    && results[4] == CHESS_PLAYER_NOT_EXIST,
+                chessDestroy(chess));
+    ChessResult result;
+    chessCalculateAveragePlayTime(chess, 1, &result);
+    ASSERT_TEST(result == CHESS_PLAYER_NOT_EXIST, chessDestroy(chess));
+
+    chessDestroy(chess);
+    return true;
+}
+
+bool testRemovePlayersArguments()
+{
+    ChessSystem chess = chessCreate();
+    int ids[] = { 1 };
+    ChessResult results[1];
+    ASSERT_TEST(chessRemovePlayers(NULL, ids, 1, results) == CHESS_NULL_ARGUMENT, chessDestroy(chess));
+    ASSERT_TEST(chessRemovePlayers(chess, NULL, 1, results) == CHESS_NULL_ARGUMENT, chessDestroy(chess));
+    ASSERT_TEST(chessRemovePlayers(chess, ids, 1, NULL) == CHESS_NULL_ARGUMENT, chessDestroy(chess));
+    ASSERT_TEST(chessRemovePlayers(chess, NULL, 0, NULL) == CHESS_SUCCESS, chessDestroy(chess));
+
+    chessDestroy(chess);
+    return true;
+}
+
+int main()
+{
+    RUN_TEST(testRemovePlayersLikeOneByOne, "testRemovePlayersLikeOneByOne");
+    RUN_TEST(testRemovePlayersOnWorkers, "testRemovePlayersOnWorkers");
+    RUN_TEST(testRemovePlayersAll, "testRemovePlayersAll");
+    RUN_TEST(testRemovePlayersRepeatedId, "testRemovePlayersRepeatedId");
+    RUN_TEST(testRemovePlayersArguments, "testRemovePlayersArguments");
+    return TEST_EXIT_STATUS;
+}
@@ -0,0 +1,229 @@
+#include <stdio.h>
+#include <time.h>
+#include "../chessSystem.h"
+#include "../chessSystemExt.h"
+#include "chessTestUtilities.h"
+
+#define SNAPSHOT_FILE "snapshot_test.snap"
+#define SNAPSHOT_COPY_FILE "snapshot_copy.snap"
+#define NUM_OF_MANY_PLAYERS 10000
+#define NUM_OF_MANY_TOURNAMENTS 100
+#define NUM_OF_TIMINGS 5
+
+bool testSnapshotRoundTrip()
+{
+    for (unsigned int seed = 1; seed <= 5; seed++)
+    {
+        ChessSystem chess = chessCreate();
+        ASSERT_TEST(testRunOperations(chess, seed, 3000), chessDestroy(chess));
+        ASSERT_TEST(chessSaveSnapshot(chess, SNAPSHOT_FILE) == CHESS_SUCCESS, chessDestroy(chess));
+        ChessResult result;
+        ChessSystem loaded = chessLoadSnapshot(SNAPSHOT_FILE, &result);
+        ASSERT_TEST(loaded != NULL && result == CHESS_SUCCESS, chessDestroy(chess));
+        ASSERT_TEST(testSameSystems(chess, loaded, TEST_NUM_OF_PLAYERS), chessDestroy(chess); chessDestroy(loaded));
+        for (int player_id = 1; player_id <= TEST_NUM_OF_PLAYERS; player_id++)
+        {
+            ASSERT_TEST(chessPlayerOncePlayed(chess, player_id) == chessPlayerOncePlayed(loaded, player_id),
+                        chessDestroy(chess); chessDestroy(loaded));
+        }
+
+        // saving the loaded system writes the same file
+        ASSERT_TEST(chessSaveSnapshot(loaded, SNAPSHOT_COPY_FILE) == CHESS_SUCCESS,
+                    chessDestroy(chess); chessDestroy(loaded));
+        ASSERT_TEST(testFilesEqual(SNAPSHOT_FILE, SNAPSHOT_COPY_FILE), chessDestroy(chess); chessDestroy(loaded));
+
+        // and the loaded system goes on like the original one
+        ASSERT_TEST(testRunOperations(chess, seed + 100, 2000) && testRunOperations(loaded, seed + 100, 2000),
+                    chessDestroy(chess); chessDestroy(loaded));
+        for (int tournament_id = 1; tournament_id <= TEST_NUM_OF_TOURNAMENTS; tournament_id++)
+        {
+            ASSERT_TEST(chessEndTournament(chess, tournament_id) == chessEndTournament(loaded, tournament_id),
+                        chessDestroy(chess); chessDestroy(loaded));
+        }
+        ASSERT_TEST(testSameSystems(chess, loaded, TEST_NUM_OF_PLAYERS), chessDestroy(chess); chessDestroy(loaded));
+
+        chessDestroy(chess);
+        chessDestroy(loaded);
+    }
+    return true;
+}
+
+/**
+ * Loading on workers gives the same system as loading on one thread.
+ * */
+bool testSnapshotOnWorkers()
+{
+    ChessSystemOptions options = { 4 };
+    for (unsigned int seed = 1; seed <= 3; seed++)
+    {
+        ChessSystem chess = chessCreate();
+        ASSERT_TEST(testRunOperations(chess, seed, 3000), chessDestroy(chess));
+        ASSERT_TEST(chessSaveSnapshot(chess, SNAPSHOT_FILE) == CHESS_SUCCESS, chessDestroy(chess));
+        chessDestroy(chess);
+        ChessResult result;
+        ChessSystem expected = chessLoadSnapshot(SNAPSHOT_FILE, &result);
+        ASSERT_TEST(expected != NULL && result == CHESS_SUCCESS, );
+        ChessSystem loaded = chessLoadSnapshotWithOptions(SNAPSHOT_FILE, &options, &result);
+        ASSERT_TEST(loaded != NULL && result == CHESS_SUCCESS, chessDestroy(expected));
+        ASSERT_TEST(testSameSystems(expected, loaded, TEST_NUM_OF_PLAYERS), chessDestroy(expected); chessDestroy(loaded));
+        for (int player_id = 1; player_id <= TEST_NUM_OF_PLAYERS; player_id++)
+        {
+            ASSERT_TEST(chessPlayerOncePlayed(expected, player_id) == chessPlayerOncePlayed(loaded, player_id),
+                        chessDestroy(expected); chessDestroy(loaded));
+        }
+        ASSERT_TEST(chessSaveSnapshot(loaded, SNAPSHOT_COPY_FILE) == CHESS_SUCCESS,
+                    chessDestroy(expected); chessDestroy(loaded));
+        ASSERT_TEST(testFilesEqual(SNAPSHOT_FILE, SNAPSHOT_COPY_FILE), chessDestroy(expected); chessDestroy(loaded));
+
+        // and both go on the same
+        ASSERT_TEST(testRunOperations(expected, seed + 100, 2000) && testRunOperations(loaded, seed + 100, 2000),
+                    chessDestroy(expected); chessDestroy(loaded));
+        ASSERT_TEST(testSameSystems(expected, loaded, TEST_NUM_OF_PLAYERS), chessDestroy(expected); chessDestroy(loaded));
+
+        chessDestroy(expected);
+        chessDestroy(loaded);
+    }
+    return true;
+}
+
+/**
+ * Save a system of num_of_players players, and return the shortest time it took to load it.
+ * Return -1 on failure.
+ * */
+static clock_t timeLoad(int num_of_players)
+{
+    ChessSystem chess = chessCreate();
+    bool created = true;
+    for (int tournament_id = 1; tournament_id <= NUM_OF_MANY_TOURNAMENTS; tournament_id++)
+    {
+        created = created && chessAddTournament(chess, tournament_id, 1, "London") == CHESS_SUCCESS;
+    }
+    for (int player = num_of_players; player > 0 && created; player -= 2)
+    {
+        created = chessAddGame(chess, 1 + player / 2 % NUM_OF_MANY_TOURNAMENTS, player, player - 1, FIRST_PLAYER,
+                               player % 100) == CHESS_SUCCESS;
+    }
+    ChessResult result = created ? chessSaveSnapshot(chess, SNAPSHOT_FILE) : CHESS_OUT_OF_MEMORY;
+    chessDestroy(chess);
+    clock_t shortest = -1;
+    for (int i = 0; i < NUM_OF_TIMINGS && result == CHESS_SUCCESS; i++)
+    {
+        clock_t start = clock();
+        ChessSystem loaded = chessLoadSnapshot(SNAPSHOT_FILE, &result);
+        clock_t time = clock() - start;
+        shortest = shortest < 0 || time < shortest ? time : shortest;
+        chessDestroy(loaded);
+    }
+    return result == CHESS_SUCCESS ? shortest : -1;
+}
+
+/**
+ * Loading puts every record at the head of the maps, so four times the players take about four times
+ * as long, not sixteen times.
+ * */
+bool testSnapshotLoadScales()
+{
+    clock_t time = timeLoad(NUM_OF_MANY_PLAYERS / 4);
+    clock_t four_times = timeLoad(NUM_OF_MANY_PLAYERS);
+    ASSERT_TEST(time >= 0 && four_times >= 0, );
+    ASSERT_TEST(four_times < 8 * time + CLOCKS_PER_SEC / 1000, );
+    return true;
+}
+
+bool testSnapshotEmptySystem()
+{
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(chessSaveSnapshot(chess, SNAPSHOT_FILE) == CHESS_SUCCESS, chessDestroy(chess));
+    ChessResult result;
+    ChessSystem loaded = chessLoadSnapshot(SNAPSHOT_FILE, &result);
+    ASSERT_TEST(loaded != NULL && result == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(testSameSystems(chess, loaded, 1), chessDestroy(chess); chessDestroy(loaded));
+    ASSERT_TEST(chessAddTournament(loaded, 1, 1, "London") == CHESS_SUCCESS, chessDestroy(chess); chessDestroy(loaded));
+
+    chessDestroy(chess);
+    chessDestroy(loaded);
+    return true;
+}
+
+/**
+ * Flip one byte of a file at offset. Return false if the file is shorter.
+ * */
+static bool corruptFile(const char* path, long offset)
+{
+    FILE* file = fopen(path, "r+b");
+    if (file == NULL || fseek(file, offset, SEEK_SET) != 0)
+    {
+        return false;
+    }
+    int byte = fgetc(file);
+    bool corrupted = byte != EOF && fseek(file, offset, SEEK_SET) == 0 && fputc(byte ^ 0x40, file) != EOF;
+    fclose(file);
+    return corrupted;
+}
+
+/**
+ * Copy at most size bytes of a file. Return how many bytes were copied.
+ * */
+static long copyFile(const char* from, const char* to, long size)
+{
+    FILE* source = fopen(from, "rb");
+    FILE* destination = fopen(to, "wb");
+    long copied = 0;
+    while (source != NULL && destination != NULL && copied < size)
+    {
+        int byte = fgetc(source);
+        if (byte == EOF || fputc(byte, destination) == EOF)
+        {
+            break;
+        }
+        copied++;
+    }
+    if (source != NULL)
+    {
+        fclose(source);
+    }
+    if (destination != NULL)
+    {
+        fclose(destination);
+    }
+    return copied;
+}
+
+bool testSnapshotRejectsBadFiles()
+{
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(testRunOperations(chess, 7, 1000), chessDestroy(chess));
+    ASSERT_TEST(chessSaveSnapshot(chess, SNAPSHOT_FILE) == CHESS_SUCCESS, chessDestroy(chess));
+    chessDestroy(chess);
+    ChessResult result;
+
+    long size = copyFile(SNAPSHOT_FILE, SNAPSHOT_COPY_FILE, 1L << 30);
+    ASSERT_TEST(size > 200, );
+
+    // a truncated file
+    ASSERT_TEST(copyFile(SNAPSHOT_FILE, SNAPSHOT_COPY_FILE, size - 1) == size - 1, );
+    ASSERT_TEST(chessLoadSnapshot(SNAPSHOT_COPY_FILE, &result) == NULL && result == CHESS_SAVE_FAILURE, );
+    ASSERT_TEST(copyFile(SNAPSHOT_FILE, SNAPSHOT_COPY_FILE, 10) == 10, );
+    ASSERT_TEST(chessLoadSnapshot(SNAPSHOT_COPY_FILE, &result) == NULL && result == CHESS_SAVE_FAILURE, );
+
+    // a changed byte in the header, then in the body
+    ASSERT_TEST(copyFile(SNAPSHOT_FILE, SNAPSHOT_COPY_FILE, size) == size && corruptFile(SNAPSHOT_COPY_FILE, 1), );
+    ASSERT_TEST(chessLoadSnapshot(SNAPSHOT_COPY_FILE, &result) == NULL && result == CHESS_SAVE_FAILURE, );
+    ASSERT_TEST(copyFile(SNAPSHOT_FILE, SNAPSHOT_COPY_FILE, size) == size && corruptFile(SNAPSHOT_COPY_FILE, 200), );
+    ASSERT_TEST(chessLoadSnapshot(SNAPSHOT_COPY_FILE, &result) == NULL && result == CHESS_SAVE_FAILURE, );
+
+    ASSERT_TEST(chessLoadSnapshot("no_such_file.snap", &result) == NULL && result == CHESS_SAVE_FAILURE, );
+    ASSERT_TEST(chessLoadSnapshot(NULL, &result) == NULL && result == CHESS_NULL_ARGUMENT, );
+    ASSERT_TEST(chessSaveSnapshot(NULL, SNAPSHOT_FILE) == CHESS_NULL_ARGUMENT, );
+    return true;
+}
+
+int main()
+{
+    RUN_TEST(testSnapshotRoundTrip, "testSnapshotRoundTrip");
+    RUN_TEST(testSnapshotOnWorkers, "testSnapshotOnWorkers");
+    RUN_TEST(testSnapshotLoadScales, "testSnapshotLoadScales");
+    RUN_TEST(testSnapshotEmptySystem, "testSnapshotEmptySystem");
+    RUN_TEST(testSnapshotRejectsBadFiles, "testSnapshotRejectsBadFiles");
+    return TEST_EXIT_STATUS;
+}
\ No newline at end of file
@@ -0,0 +1,158 @@
+#include <stdlib.h>
+#include <time.h>
+#include "../chessSystem.h"
+#include "../chessSystemExt.h"
+#include "../test_utilities.h"
+
+#define NUM_OF_PLAYERS 60
+#define NUM_OF_IDS 200
+#define NUM_OF_MANY_PLAYERS 10000
+#define NUM_OF_MANY_TOURNAMENTS 100
+#define NUM_OF_SPREAD_IDS 100
+#define NUM_OF_REPEATS 10
+
+/**
+ * A system with games between players 1 to NUM_OF_PLAYERS, some of which are removed.
+ * */
+static ChessSystem createPlayedSystem()
+{
+    ChessSystem chess = chessCreate();
+    chessAddTournament(chess, 1, 100, "London");
+    chessAddTournament(chess, 2, 100, "Paris");
+    for (int player = 1; player < NUM_OF_PLAYERS; player++)
+    {
+        chessAddGame(chess, 1 + player % 2, player, player + 1, player % 3, player * 3);
+        chessAddGame(chess, 1, player, 1 + (player * 7) % NUM_OF_PLAYERS, (player + 1) % 3, player);
+    }
+    chessEndTournament(chess, 2);
+    for (int player = 5; player < NUM_OF_PLAYERS; player += 9)
+    {
+        chessRemovePlayer(chess, player);
+    }
+    return chess;
+}
+
+bool testBatchMatchesSingleQueries()
+{
+    ChessSystem chess = createPlayedSystem();
+    int ids[NUM_OF_IDS];
+    ChessPlayerStats stats[NUM_OF_IDS];
+    // unsorted, with duplicates, invalid and unknown ids
+    for (int i = 0; i < NUM_OF_IDS; i++)
+    {
+        ids[i] = (i * 37) % (NUM_OF_PLAYERS + 20) - 5;
+    }
+    ASSERT_TEST(chessGetPlayersStats(chess, ids, NUM_OF_IDS, stats) == CHESS_SUCCESS, chessDestroy(chess));
+
+    for (int i = 0; i < NUM_OF_IDS; i++)
+    {
+        ChessResult result;
+        double average = chessCalculateAveragePlayTime(chess, ids[i], &result);
+        ASSERT_TEST(stats[i].player_id == ids[i] && stats[i].result == result, chessDestroy(chess));
+        if (result == CHESS_SUCCESS)
+        {
+            ASSERT_TEST(stats[i].average_play_time == average, chessDestroy(chess));
+            ASSERT_TEST(stats[i].wins + stats[i].losses + stats[i].draws > 0, chessDestroy(chess));
+        }
+        else
+        {
+            ASSERT_TEST(stats[i].wins == 0 && stats[i].losses == 0 && stats[i].draws == 0 && stats[i].level == 0,
+                        chessDestroy(chess));
+        }
+    }
+
+    chessDestroy(chess);
+    return true;
+}
+
+bool testBatchLevels()
+{
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(chessAddTournament(chess, 1, 4, "London") == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddGame(chess, 1, 1, 2, FIRST_PLAYER, 6) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddGame(chess, 1, 1, 3, DRAW, 3) == CHESS_SUCCESS, chessDestroy(chess));
+    int ids[] = { 3, 1, 2, 1 };
+    ChessPlayerStats stats[4];
+    ASSERT_TEST(chessGetPlayersStats(chess, ids, 4, stats) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(stats[0].level == 2.0 && stats[0].draws == 1, chessDestroy(chess));
+    ASSERT_TEST(stats[1].level == 4.0 && stats[1].wins == 1 && stats[1].draws == 1, chessDestroy(chess));
+    ASSERT_TEST(stats[2].level == -10.0 && stats[2].losses == 1, chessDestroy(chess));
+    ASSERT_TEST(stats[3].average_play_time == 4.5 && stats[3].result == CHESS_SUCCESS, chessDestroy(chess));
+
+    chessDestroy(chess);
+    return true;
+}
+
+/**
+ * One pass over the players costs less than a lookup per id, even for ids spread over many players.
+ * */
+bool testBatchScales()
+{
+    ChessSystem chess = chessCreate();
+    for (int tournament_id = 1; tournament_id <= NUM_OF_MANY_TOURNAMENTS; tournament_id++)
+    {
+        ASSERT_TEST(chessAddTournament(chess, tournament_id, 1, "London") == CHESS_SUCCESS, chessDestroy(chess));
+    }
+    // from the highest id, so every player is added at the head of the map
+    for (int player = NUM_OF_MANY_PLAYERS; player > 0; player -= 2)
+    {
+        ASSERT_TEST(chessAddGame(chess, 1 + player / 2 % NUM_OF_MANY_TOURNAMENTS, player, player - 1, FIRST_PLAYER,
+                                 player % 100) == CHESS_SUCCESS,
+                    chessDestroy(chess));
+    }
+    int ids[NUM_OF_SPREAD_IDS];
+    ChessPlayerStats stats[NUM_OF_SPREAD_IDS];
+    for (int i = 0; i < NUM_OF_SPREAD_IDS; i++)
+    {
+        ids[i] = (i + 1) * (NUM_OF_MANY_PLAYERS / NUM_OF_SPREAD_IDS);
+    }
+
+    clock_t start = clock();
+    for (int repeat = 0; repeat < NUM_OF_REPEATS; repeat++)
+    {
+        ASSERT_TEST(chessGetPlayersStats(chess, ids, NUM_OF_SPREAD_IDS, stats) == CHESS_SUCCESS, chessDestroy(chess));
+    }
+    clock_t batch_time = clock() - start;
+    start = clock();
+    for (int repeat = 0; repeat < NUM_OF_REPEATS; repeat++)
+    {
+        for (int i = 0; i < NUM_OF_SPREAD_IDS; i++)
+        {
+            ChessResult result;
+            double average = chessCalculateAveragePlayTime(chess, ids[i], &result);
+            ASSERT_TEST(result == CHESS_SUCCESS && stats[i].result == CHESS_SUCCESS
+                            && stats[i].average_play_time == average,
+                        chessDestroy(chess));
+        }
+    }
+    clock_t loop_time = clock() - start;
+    ASSERT_TEST(batch_time < loop_time, chessDestroy(chess));
+
+    chessDestroy(chess);
+    return true;
+}
+
+bool testBatchArguments()
+{
+    ChessSystem chess = chessCreate();
+    int ids[] = { 1 };
+    ChessPlayerStats stats[1];
+    ASSERT_TEST(chessGetPlayersStats(NULL, ids, 1, stats) == CHESS_NULL_ARGUMENT, chessDestroy(chess));
+    ASSERT_TEST(chessGetPlayersStats(chess, NULL, 1, stats) == CHESS_NULL_ARGUMENT, chessDestroy(chess));
+    ASSERT_TEST(chessGetPlayersStats(chess, ids, 1, NULL) == CHESS_NULL_ARGUMENT, chessDestroy(chess));
+    ASSERT_TEST(chessGetPlayersStats(chess, NULL, 0, NULL) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessGetPlayersStats(chess, ids, 1, stats) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(stats[0].result == CHESS_PLAYER_NOT_EXIST, chessDestroy(chess));
+
+    chessDestroy(chess);
+    return true;
+}
+
+int main()
+{
+    RUN_TEST(testBatchMatchesSingleQueries, "testBatchMatchesSingleQueries");
+    RUN_TEST(testBatchLevels, "testBatchLevels");
+    RUN_TEST(testBatchScales, "testBatchScales");
+    RUN_TEST(testBatchArguments, "testBatchArguments");
+    return TEST_EXIT_STATUS;
+}
\ No newline at end of file
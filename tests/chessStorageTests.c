@@ -0,0 +1,216 @@
+#define _POSIX_C_SOURCE 200809L // mkdir, opendir
+
+#include <stdio.h>
+#include <errno.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "../chessSystem.h"
+#include "../chessSystemExt.h"
+#include "chessTestUtilities.h"
+
+#define STORAGE_DIR "storage_test"
+#define BIG_TOURNAMENT_ID 100
+#define NUM_OF_BIG_GAMES 10000 // a few segments of blocks
+#define BIG_ROW 100
+#define BATCH_SIZE 256
+
+static bool createStorageDir()
+{
+    return mkdir(STORAGE_DIR, 0777) == 0 || errno == EEXIST;
+}
+
+/**
+ * The files are unlinked as soon as they are created, so the directory always looks empty.
+ * */
+static bool storageDirIsEmpty()
+{
+    DIR* dir = opendir(STORAGE_DIR);
+    if (dir == NULL)
+    {
+        return false;
+    }
+    int num_of_files = 0;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        num_of_files += entry->d_name[0] != '.';
+    }
+    closedir(dir);
+    return num_of_files == 0;
+}
+
+/**
+ * A tournament with more games than fit in one mapped segment, every pair of players once.
+ * */
+static bool addBigTournament(ChessSystem chess)
+{
+    if (chessAddTournament(chess, BIG_TOURNAMENT_ID, NUM_OF_BIG_GAMES, "Tel aviv") != CHESS_SUCCESS)
+    {
+        return false;
+    }
+    for (int i = 0; i < NUM_OF_BIG_GAMES; i++)
+    {
+        if (chessAddGame(chess, BIG_TOURNAMENT_ID, 1 + i % BIG_ROW, 1000 + i / BIG_ROW, (Winner)(i % 3), i % 1000)
+            != CHESS_SUCCESS)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Return true if the games cursor reads the same games of the tournament from both systems.
+ * */
+static bool sameGames(ChessSystem chess1, ChessSystem chess2, int tournament_id)
+{
+    ChessResult result1;
+    ChessResult result2;
+    ChessGamesCursor cursor1 = chessGamesCursorOpen(chess1, tournament_id, &result1);
+    ChessGamesCursor cursor2 = chessGamesCursorOpen(chess2, tournament_id, &result2);
+    bool same = result1 == result2;
+    ChessGameRow rows1[BATCH_SIZE];
+    ChessGameRow rows2[BATCH_SIZE];
+    int count = 1;
+    while (same && cursor1 != NULL && count > 0)
+    {
+        count = chessGamesCursorNext(cursor1, rows1, BATCH_SIZE);
+        same = count == chessGamesCursorNext(cursor2, rows2, BATCH_SIZE);
+        for (int i = 0; i < count && same; i++)
+        {
+            same = rows1[i].first_player == rows2[i].first_player && rows1[i].second_player == rows2[i].second_player
+                   && rows1[i].winner == rows2[i].winner && rows1[i].play_time == rows2[i].play_time;
+        }
+    }
+    chessGamesCursorClose(cursor1);
+    chessGamesCursorClose(cursor2);
+    return same;
+}
+
+static bool sameAllGames(ChessSystem chess1, ChessSystem chess2)
+{
+    for (int tournament_id = 1; tournament_id <= TEST_NUM_OF_TOURNAMENTS; tournament_id++)
+    {
+        if (!sameGames(chess1, chess2, tournament_id))
+        {
+            return false;
+        }
+    }
+    return sameGames(chess1, chess2, BIG_TOURNAMENT_ID);
+}
+
+/**
+ * A system with its games in files answers every query like one with its games in memory,
+ * while it changes, once its tournaments end, and once it is compacted.
+ * */
+bool testStorageLikeMemory()
+{
+    ASSERT_TEST(createStorageDir(), );
+    ChessSystem chess = chessCreate();
+    ChessSystem expected = chessCreate();
+    ASSERT_TEST(chessSetGameStorage(chess, STORAGE_DIR) == CHESS_SUCCESS, chessDestroy(chess); chessDestroy(expected));
+    ASSERT_TEST(addBigTournament(chess) && addBigTournament(expected), chessDestroy(chess); chessDestroy(expected));
+    for (unsigned int seed = 1; seed <= 4; seed++)
+    {
+        ASSERT_TEST(testRunOperations(chess, seed, 3000) && testRunOperations(expected, seed, 3000),
+                    chessDestroy(chess); chessDestroy(expected));
+        ASSERT_TEST(testSameSystems(chess, expected, TEST_NUM_OF_PLAYERS), chessDestroy(chess); chessDestroy(expected));
+        ASSERT_TEST(sameAllGames(chess, expected), chessDestroy(chess); chessDestroy(expected));
+        ASSERT_TEST(storageDirIsEmpty(), chessDestroy(chess); chessDestroy(expected));
+    }
+
+    // the players of the big tournament are updated in the files
+    for (int player_id = 1; player_id <= BIG_ROW; player_id += 7)
+    {
+        ASSERT_TEST(chessRemovePlayer(chess, player_id) == chessRemovePlayer(expected, player_id),
+                    chessDestroy(chess); chessDestroy(expected));
+    }
+    ASSERT_TEST(sameGames(chess, expected, BIG_TOURNAMENT_ID), chessDestroy(chess); chessDestroy(expected));
+    ASSERT_TEST(testSameSystems(chess, expected, BIG_ROW), chessDestroy(chess); chessDestroy(expected));
+
+    // ending moves the games to a file of their own
+    ASSERT_TEST(chessEndTournament(chess, BIG_TOURNAMENT_ID) == CHESS_SUCCESS
+                    && chessEndTournament(expected, BIG_TOURNAMENT_ID) == CHESS_SUCCESS,
+                chessDestroy(chess); chessDestroy(expected));
+    for (int tournament_id = 1; tournament_id <= TEST_NUM_OF_TOURNAMENTS; tournament_id++)
+    {
+        ASSERT_TEST(chessEndTournament(chess, tournament_id) == chessEndTournament(expected, tournament_id),
+                    chessDestroy(chess); chessDestroy(expected));
+    }
+    ASSERT_TEST(sameAllGames(chess, expected), chessDestroy(chess); chessDestroy(expected));
+    ASSERT_TEST(testSameSystems(chess, expected, BIG_ROW), chessDestroy(chess); chessDestroy(expected));
+    chessCompact(chess);
+    ASSERT_TEST(sameAllGames(chess, expected), chessDestroy(chess); chessDestroy(expected));
+    ASSERT_TEST(testSameSystems(chess, expected, BIG_ROW), chessDestroy(chess); chessDestroy(expected));
+    ASSERT_TEST(storageDirIsEmpty(), chessDestroy(chess); chessDestroy(expected));
+
+    chessDestroy(chess);
+    chessDestroy(expected);
+    ASSERT_TEST(storageDirIsEmpty(), );
+    return true;
+}
+
+/**
+ * Snapshots and background saves of a system with games in files are those of the same system in memory.
+ * */
+bool testStorageSaves()
+{
+    ASSERT_TEST(createStorageDir(), );
+    ChessSystem chess = chessCreate();
+    ChessSystem expected = chessCreate();
+    ASSERT_TEST(chessSetGameStorage(chess, STORAGE_DIR) == CHESS_SUCCESS, chessDestroy(chess); chessDestroy(expected));
+    ASSERT_TEST(testRunOperations(chess, 31, 5000) && testRunOperations(expected, 31, 5000),
+                chessDestroy(chess); chessDestroy(expected));
+    ASSERT_TEST(chessSaveSnapshot(chess, "storage_files.snap") == CHESS_SUCCESS
+                    && chessSaveSnapshot(expected, "storage_memory.snap") == CHESS_SUCCESS,
+                chessDestroy(chess); chessDestroy(expected));
+    ASSERT_TEST(testFilesEqual("storage_files.snap", "storage_memory.snap"), chessDestroy(chess); chessDestroy(expected));
+
+    ChessResult expected_result = chessSaveTournamentStatistics(expected, "storage_memory.txt");
+    ChessSave save = chessSaveTournamentStatisticsAsync(chess, "storage_files.txt", NULL);
+    ASSERT_TEST(save != NULL, chessDestroy(chess); chessDestroy(expected));
+    ASSERT_TEST(chessSaveWait(save) == expected_result, chessDestroy(chess); chessDestroy(expected));
+    ASSERT_TEST(expected_result != CHESS_SUCCESS || testFilesEqual("storage_files.txt", "storage_memory.txt"),
+                chessDestroy(chess); chessDestroy(expected));
+
+    // the loaded system keeps its games in memory, and answers the same
+    ChessResult result;
+    ChessSystem loaded = chessLoadSnapshot("storage_files.snap", &result);
+    ASSERT_TEST(loaded != NULL && result == CHESS_SUCCESS, chessDestroy(chess); chessDestroy(expected));
+    ASSERT_TEST(testSameSystems(loaded, chess, TEST_NUM_OF_PLAYERS) && sameAllGames(loaded, chess),
+                chessDestroy(loaded); chessDestroy(chess); chessDestroy(expected));
+
+    chessDestroy(loaded);
+    chessDestroy(chess);
+    chessDestroy(expected);
+    return true;
+}
+
+bool testStorageArguments()
+{
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(chessSetGameStorage(NULL, STORAGE_DIR) == CHESS_NULL_ARGUMENT, chessDestroy(chess));
+    ASSERT_TEST(chessSetGameStorage(chess, "no_such_dir") == CHESS_SAVE_FAILURE, chessDestroy(chess));
+    ASSERT_TEST(createStorageDir(), chessDestroy(chess));
+    ASSERT_TEST(chessSetGameStorage(chess, STORAGE_DIR) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddTournament(chess, 1, 2, "London") == CHESS_SUCCESS, chessDestroy(chess));
+    // back to memory for the tournaments that come next
+    ASSERT_TEST(chessSetGameStorage(chess, NULL) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddTournament(chess, 2, 2, "London") == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddGame(chess, 1, 1, 2, FIRST_PLAYER, 5) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddGame(chess, 2, 1, 2, SECOND_PLAYER, 7) == CHESS_SUCCESS, chessDestroy(chess));
+    ChessResult result;
+    ASSERT_TEST(chessCalculateAveragePlayTime(chess, 1, &result) == 6.0 && result == CHESS_SUCCESS,
+                chessDestroy(chess));
+
+    chessDestroy(chess);
+    return true;
+}
+
+int main()
+{
+    RUN_TEST(testStorageLikeMemory, "testStorageLikeMemory");
+    RUN_TEST(testStorageSaves, "testStorageSaves");
+    RUN_TEST(testStorageArguments, "testStorageArguments");
+    return TEST_EXIT_STATUS;
+}
\ No newline at end of file
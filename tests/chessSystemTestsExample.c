@@ -0,0 +1,142 @@
+#include <stdlib.h>
+#include "../chessSystem.h"
+#include "../test_utilities.h"
+
+/*The number of tests*/
+#define NUMBER_TESTS 5
+
+bool testChessAddTournament()
+{
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(chessAddTournament(chess, 1, 4, "London") == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddTournament(chess, 2, 5, "London") == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddTournament(chess, 1, 10, "Paris") == CHESS_TOURNAMENT_ALREADY_EXISTS, chessDestroy(chess));
+    ASSERT_TEST(chessAddTournament(chess, 3, 4, "london") == CHESS_INVALID_LOCATION, chessDestroy(chess));
+    ASSERT_TEST(chessAddTournament(chess, 3, 0, "London") == CHESS_INVALID_MAX_GAMES, chessDestroy(chess));
+    ASSERT_TEST(chessAddTournament(chess, -1, 4, "London") == CHESS_INVALID_ID, chessDestroy(chess));
+    ASSERT_TEST(chessAddTournament(NULL, 3, 4, "London") == CHESS_NULL_ARGUMENT, chessDestroy(chess));
+
+    chessDestroy(chess);
+    return true;
+}
+
+bool testChessAddGame()
+{
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(chessAddTournament(chess, 1, 2, "London") == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddGame(chess, 1, 1, 2, FIRST_PLAYER, 5) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddGame(chess, 1, 2, 1, DRAW, 5) == CHESS_GAME_ALREADY_EXISTS, chessDestroy(chess));
+    ASSERT_TEST(chessAddGame(chess, 1, 1, 3, SECOND_PLAYER, 5) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddGame(chess, 1, 1, 4, DRAW, 5) == CHESS_EXCEEDED_GAMES, chessDestroy(chess));
+    ASSERT_TEST(chessAddGame(chess, 1, 2, 3, DRAW, -1) == CHESS_INVALID_PLAY_TIME, chessDestroy(chess));
+    ASSERT_TEST(chessAddGame(chess, 2, 2, 3, DRAW, 5) == CHESS_TOURNAMENT_NOT_EXIST, chessDestroy(chess));
+    ASSERT_TEST(chessAddGame(chess, 1, 2, 2, DRAW, 5) == CHESS_INVALID_ID, chessDestroy(chess));
+
+    chessDestroy(chess);
+    return true;
+}
+
+bool testChessRemoveTournament()
+{
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(chessAddTournament(chess, 1, 4, "London") == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddTournament(chess, 2, 4, "London") == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddGame(chess, 1, 1, 2, FIRST_PLAYER, 5) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessRemoveTournament(chess, 1) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessRemoveTournament(chess, 1) == CHESS_TOURNAMENT_NOT_EXIST, chessDestroy(chess));
+    ASSERT_TEST(chessAddGame(chess, 2, 1, 2, FIRST_PLAYER, 5) == CHESS_SUCCESS, chessDestroy(chess));
+
+    chessDestroy(chess);
+    return true;
+}
+
+bool testChessCalculateAveragePlayTime()
+{
+    ChessSystem chess = chessCreate();
+    ChessResult result;
+    ASSERT_TEST(chessAddTournament(chess, 1, 4, "London") == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddGame(chess, 1, 1, 2, FIRST_PLAYER, 4) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddGame(chess, 1, 1, 3, DRAW, 7) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessCalculateAveragePlayTime(chess, 1, &result) == 5.5 && result == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessCalculateAveragePlayTime(chess, 2, &result) == 4.0 && result == CHESS_SUCCESS, chessDestroy(chess));
+    chessCalculateAveragePlayTime(chess, 4, &result);
+    ASSERT_TEST(result == CHESS_PLAYER_NOT_EXIST, chessDestroy(chess));
+
+    ASSERT_TEST(chessRemovePlayer(chess, 2) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessRemovePlayer(chess, 2) == CHESS_PLAYER_NOT_EXIST, chessDestroy(chess));
+    ASSERT_TEST(chessCalculateAveragePlayTime(chess, 1, &result) == 5.5 && result == CHESS_SUCCESS, chessDestroy(chess));
+
+    chessDestroy(chess);
+    return true;
+}
+
+bool testChessPrintLevelsAndTournamentStatistics()
+{
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(chessAddTournament(chess, 1, 4, "London") == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddTournament(chess, 2, 4, "Paris") == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddGame(chess, 1, 1, 2, FIRST_PLAYER, 6) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddGame(chess, 1, 1, 3, DRAW, 3) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessSaveTournamentStatistics(chess, "example_statistics.txt") == CHESS_NO_TOURNAMENTS_ENDED,
+                chessDestroy(chess));
+    ASSERT_TEST(chessEndTournament(chess, 1) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessEndTournament(chess, 1) == CHESS_TOURNAMENT_ENDED, chessDestroy(chess));
+    ASSERT_TEST(chessEndTournament(chess, 2) == CHESS_NO_GAMES, chessDestroy(chess));
+
+    FILE* file = fopen("example_levels.txt", "w");
+    ASSERT_TEST(file != NULL, chessDestroy(chess));
+    ASSERT_TEST(chessSavePlayersLevels(chess, file) == CHESS_SUCCESS, fclose(file); chessDestroy(chess));
+    fclose(file);
+    ASSERT_TEST(testFileContains("example_levels.txt", "1 4.00\n3 2.00\n2 -10.00\n"), chessDestroy(chess));
+
+    ASSERT_TEST(chessSaveTournamentStatistics(chess, "example_statistics.txt") == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(testFileContains("example_statistics.txt", "1\n6\n4.50\nLondon\n2\n3\n"), chessDestroy(chess));
+
+    chessDestroy(chess);
+    return true;
+}
+
+/*The functions for the tests should be added here*/
+bool (*tests[]) (void) = {
+        testChessAddTournament,
+        testChessAddGame,
+        testChessRemoveTournament,
+        testChessCalculateAveragePlayTime,
+        testChessPrintLevelsAndTournamentStatistics
+};
+
+/*The names of the test functions should be added here*/
+const char* testNames[] = {
+        "testChessAddTournament",
+        "testChessAddGame",
+        "testChessRemoveTournament",
+        "testChessCalculateAveragePlayTime",
+        "testChessPrintLevelsAndTournamentStatistics"
+};
+
+int main(int argc, char *argv[])
+{
+    if (argc == 1)
+    {
+        for (int test_index = 0; test_index < NUMBER_TESTS; test_index++)
+        {
+            RUN_TEST(tests[test_index], testNames[test_index]);
+        }
+        return TEST_EXIT_STATUS;
+    }
+    if (argc != 2)
+    {
+        fprintf(stdout, "Usage: chessSystem <test index>\n");
+        return 0;
+    }
+
+    int test_index = (int)strtol(argv[1], NULL, 10);
+    if (test_index < 1 || test_index > NUMBER_TESTS)
+    {
+        fprintf(stderr, "Invalid test index %d\n", test_index);
+        return 0;
+    }
+
+    RUN_TEST(tests[test_index - 1], testNames[test_index - 1]);
+    return TEST_EXIT_STATUS;
+}
\ No newline at end of file
@@ -0,0 +1,207 @@
+#ifndef CHESS_TEST_UTILITIES_H_
+#define CHESS_TEST_UTILITIES_H_
+
+#include <stdio.h>
+#include "../chessSystem.h"
+#include "../test_utilities.h"
+
+/**
+ * Helpers for tests that check two systems end up the same,
+ * by comparing what the public API writes for each of them.
+ */
+
+#define TEST_FILE1 "test_compare1.txt"
+#define TEST_FILE2 "test_compare2.txt"
+
+/**
+ * Return true if chessSavePlayersLevels gives the same result and file for both systems.
+ */
+static inline bool testSameLevels(ChessSystem chess1, ChessSystem chess2)
+{
+    FILE* file1 = fopen(TEST_FILE1, "w");
+    FILE* file2 = fopen(TEST_FILE2, "w");
+    if (file1 == NULL || file2 == NULL)
+    {
+        if (file1 != NULL)
+        {
+            fclose(file1);
+        }
+        if (file2 != NULL)
+        {
+            fclose(file2);
+        }
+        return false;
+    }
+    ChessResult result1 = chessSavePlayersLevels(chess1, file1);
+    ChessResult result2 = chessSavePlayersLevels(chess2, file2);
+    fclose(file1);
+    fclose(file2);
+    return result1 == result2 && testFilesEqual(TEST_FILE1, TEST_FILE2);
+}
+
+/**
+ * Return true if chessSaveTournamentStatistics gives the same result and file for both systems.
+ */
+static inline bool testSameStatistics(ChessSystem chess1, ChessSystem chess2)
+{
+    ChessResult result1 = chessSaveTournamentStatistics(chess1, TEST_FILE1);
+    ChessResult result2 = chessSaveTournamentStatistics(chess2, TEST_FILE2);
+    return result1 == result2 && testFilesEqual(TEST_FILE1, TEST_FILE2);
+}
+
+/**
+ * Return true if both systems give the same levels, statistics and average play times
+ * for players 1 to max_player_id.
+ */
+static inline bool testSameSystems(ChessSystem chess1, ChessSystem chess2, int max_player_id)
+{
+    for (int player_id = 1; player_id <= max_player_id; player_id++)
+    {
+        ChessResult result1;
+        ChessResult result2;
+        double average1 = chessCalculateAveragePlayTime(chess1, player_id, &result1);
+        double average2 = chessCalculateAveragePlayTime(chess2, player_id, &result2);
+        if (result1 != result2 || average1 != average2)
+        {
+            return false;
+        }
+    }
+    return testSameLevels(chess1, chess2) && testSameStatistics(chess1, chess2);
+}
+
+#define TEST_NUM_OF_TOURNAMENTS 12
+#define TEST_NUM_OF_PLAYERS 40
+
+static inline int testRandom(unsigned int* seed, int limit)
+{
+    *seed = *seed * 1103515245u + 12345u;
+    return (int)((*seed >> 8) % (unsigned int)limit);
+}
+
+/**
+ * Run steps pseudo random operations on a system: adding and removing tournaments, games and players,
+ * and ending tournaments, with ids from 1 to TEST_NUM_OF_TOURNAMENTS and TEST_NUM_OF_PLAYERS.
+ * The operations depend only on seed, so running the same seed on two systems that are the same
+ * must leave them the same. Return false if an operation returned CHESS_OUT_OF_MEMORY.
+ */
+static inline bool testRunOperations(ChessSystem chess, unsigned int seed, int steps)
+{
+    for (int step = 0; step < steps; step++)
+    {
+        int operation = testRandom(&seed, 100);
+        int tournament_id = 1 + testRandom(&seed, TEST_NUM_OF_TOURNAMENTS);
+        int player1 = 1 + testRandom(&seed, TEST_NUM_OF_PLAYERS);
+        int player2 = 1 + testRandom(&seed, TEST_NUM_OF_PLAYERS);
+        int value = testRandom(&seed, 30);
+        ChessResult result = CHESS_SUCCESS;
+        if (operation < 5)
+        {
+            result = chessAddTournament(chess, tournament_id, 1 + value % 6, value % 2 ? "London" : "Paris");
+        }
+        else if (operation < 75)
+        {
+            result = chessAddGame(chess, tournament_id, player1, player2, (Winner)(value % 3), value);
+        }
+        else if (operation < 87)
+        {
+            result = chessRemovePlayer(chess, player1);
+        }
+        else if (operation < 89)
+        {
+            result = chessRemoveTournament(chess, tournament_id);
+        }
+        else if (operation < 94)
+        {
+            result = chessEndTournament(chess, tournament_id);
+        }
+        if (result == CHESS_OUT_OF_MEMORY)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Run rounds of the operations of testRunOperations on both systems, from seed on, and return true
+ * if they answer the same after every round.
+ */
+static inline bool testRunOnBoth(ChessSystem chess, ChessSystem expected, unsigned int seed, int rounds)
+{
+    for (int round = 0; round < rounds; round++)
+    {
+        if (!testRunOperations(chess, seed + round, 300) || !testRunOperations(expected, seed + round, 300)
+            || !testSameSystems(chess, expected, TEST_NUM_OF_PLAYERS))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+#define TEST_MAX_IDS 64
+
+/**
+ * A call on many ids at once, and the call it must behave like for each of them in turn,
+ * e.g. chessEndTournaments and chessEndTournament.
+ */
+typedef ChessResult (*TestBatchCall)(ChessSystem chess, const int* ids, int n, ChessResult* results);
+typedef ChessResult (*TestSingleCall)(ChessSystem chess, int id);
+
+/**
+ * Fill ids with up to TEST_MAX_IDS ids of every kind for a batch call: invalid, missing, repeated
+ * and in any order, from -1 to max_id + 1. Return their number.
+ */
+static inline int testCreateIds(unsigned int seed, int max_id, int* ids)
+{
+    int n = 1 + testRandom(&seed, TEST_MAX_IDS);
+    for (int i = 0; i < n; i++)
+    {
+        ids[i] = testRandom(&seed, max_id + 3) - 1;
+    }
+    return n;
+}
+
+/**
+ * Call batch with the n ids on chess, and single with every id in turn on expected, and return true
+ * if every result and both systems are the same. n is at most TEST_MAX_IDS.
+ */
+static inline bool testBatchLikeOneByOne(TestBatchCall batch, TestSingleCall single, ChessSystem chess,
+                                         ChessSystem expected, const int* ids, int n)
+{
+    ChessResult results[TEST_MAX_IDS];
+    if (batch(chess, ids, n, results) != CHESS_SUCCESS)
+    {
+        return false;
+    }
+    for (int i = 0; i < n; i++)
+    {
+        if (results[i] != single(expected, ids[i]))
+        {
+            return false;
+        }
+    }
+    return testSameSystems(chess, expected, TEST_NUM_OF_PLAYERS);
+}
+
+/**
+ * Run the same operations on both systems, and testBatchLikeOneByOne after each few of them
+ * with the ids of testCreateIds, some of which the operations already removed or ended.
+ */
+static inline bool testBatchOnSystems(TestBatchCall batch, TestSingleCall single, ChessSystem chess,
+                                      ChessSystem expected, int max_id)
+{
+    for (unsigned int seed = 1; seed <= 30; seed++)
+    {
+        int ids[TEST_MAX_IDS];
+        int n = testCreateIds(seed * 7, max_id, ids);
+        if (!testRunOperations(chess, seed, 400) || !testRunOperations(expected, seed, 400)
+            || !testBatchLikeOneByOne(batch, single, chess, expected, ids, n))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+#endif /* CHESS_TEST_UTILITIES_H_ */
\ No newline at end of file
@@ -0,0 +1,257 @@
+#include <stdio.h>
+#include <string.h>
+#include "../chessSystem.h"
+#include "../chessSystemExt.h"
+#include "chessTestUtilities.h"
+
+#define TRACE_FILE "trace_test.trace"
+#define TRACE_SNAPSHOT_FILE "trace_test.trace.snap"
+#define LEVELS_FILE "trace_levels.txt"
+#define STATISTICS_FILE "trace_statistics.txt"
+#define REPLAY_STATISTICS_FILE "trace_replay_statistics.txt"
+
+/**
+ * Run the operations of seed, and the queries and saves in between, the way an application would.
+ * */
+static bool runCalls(ChessSystem chess, unsigned int seed)
+{
+    for (int round = 0; round < 5; round++)
+    {
+        if (!testRunOperations(chess, seed + round, 500))
+        {
+            return false;
+        }
+        ChessResult result;
+        for (int player_id = 0; player_id <= TEST_NUM_OF_PLAYERS; player_id += 3)
+        {
+            chessCalculateAveragePlayTime(chess, player_id, &result);
+        }
+        FILE* file = fopen(LEVELS_FILE, "w");
+        if (file == NULL)
+        {
+            return false;
+        }
+        chessSavePlayersLevels(chess, file);
+        fclose(file);
+        chessSavePlayersLevels(chess, NULL);
+        chessSaveTournamentStatistics(chess, STATISTICS_FILE);
+        chessAddTournament(chess, 1, 1, NULL);
+        chessAddTournament(chess, 1, 1, "not a location");
+    }
+    return true;
+}
+
+/**
+ * Replay the calls of the trace on chess, and count those whose result is not the recorded one.
+ * Return the number of calls replayed, or -1 if the trace could not be read.
+ * */
+static long replayTrace(ChessSystem chess, long* divergences)
+{
+    ChessTraceReader reader = chessTraceReaderOpen(TRACE_FILE, NULL);
+    FILE* file = fopen(LEVELS_FILE, "w");
+    if (reader == NULL || file == NULL)
+    {
+        chessTraceReaderClose(reader);
+        if (file != NULL)
+        {
+            fclose(file);
+        }
+        return -1;
+    }
+    long num_of_calls = 0;
+    *divergences = 0;
+    ChessTraceRecord record;
+    while (chessTraceReaderNext(reader, &record))
+    {
+        const int* args = record.args;
+        ChessResult result = CHESS_SUCCESS;
+        double average = 0.0;
+        switch (record.call)
+        {
+        case CHESS_TRACE_ADD_TOURNAMENT:
+            result = chessAddTournament(chess, args[0], args[1], record.text);
+            break;
+        case CHESS_TRACE_ADD_GAME:
+            result = chessAddGame(chess, args[0], args[1], args[2], (Winner)args[3], args[4]);
+            break;
+        case CHESS_TRACE_REMOVE_TOURNAMENT:
+            result = chessRemoveTournament(chess, args[0]);
+            break;
+        case CHESS_TRACE_REMOVE_PLAYER:
+            result = chessRemovePlayer(chess, args[0]);
+            break;
+        case CHESS_TRACE_END_TOURNAMENT:
+            result = chessEndTournament(chess, args[0]);
+            break;
+        case CHESS_TRACE_CALCULATE_AVERAGE_PLAY_TIME:
+            average = chessCalculateAveragePlayTime(chess, args[0], &result);
+            break;
+        case CHESS_TRACE_SAVE_PLAYERS_LEVELS:
+            result = chessSavePlayersLevels(chess, args[0] == -1 ? NULL : file);
+            break;
+        case CHESS_TRACE_SAVE_TOURNAMENT_STATISTICS:
+            result = chessSaveTournamentStatistics(chess, record.text == NULL ? NULL : REPLAY_STATISTICS_FILE);
+            break;
+        }
+        *divergences += result != record.result || average != record.average_play_time || record.latency < 0;
+        num_of_calls++;
+    }
+    fclose(file);
+    chessTraceReaderClose(reader);
+    return num_of_calls;
+}
+
+bool testTraceReplaysWithoutDivergence()
+{
+    for (unsigned int seed = 1; seed <= 3; seed++)
+    {
+        ChessSystem chess = chessCreate();
+        ASSERT_TEST(chessTraceOpen(chess, TRACE_FILE) == CHESS_SUCCESS, chessDestroy(chess));
+        ASSERT_TEST(runCalls(chess, seed), chessDestroy(chess));
+        ASSERT_TEST(chessTraceClose(chess) == CHESS_SUCCESS, chessDestroy(chess));
+
+        ChessTraceReader reader = chessTraceReaderOpen(TRACE_FILE, NULL);
+        ASSERT_TEST(reader != NULL && !chessTraceReaderHasSnapshot(reader), chessTraceReaderClose(reader); chessDestroy(chess));
+        chessTraceReaderClose(reader);
+
+        ChessSystem replayed = chessCreate();
+        long divergences;
+        ASSERT_TEST(replayTrace(replayed, &divergences) > 5 * 400, chessDestroy(replayed); chessDestroy(chess));
+        ASSERT_TEST(divergences == 0, chessDestroy(replayed); chessDestroy(chess));
+        ASSERT_TEST(testSameSystems(chess, replayed, TEST_NUM_OF_PLAYERS), chessDestroy(replayed); chessDestroy(chess));
+
+        chessDestroy(replayed);
+        chessDestroy(chess);
+    }
+    return true;
+}
+
+/**
+ * A trace of a system that is not empty starts from its snapshot.
+ * */
+bool testTraceFromSnapshot()
+{
+    remove(TRACE_SNAPSHOT_FILE);
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(runCalls(chess, 10), chessDestroy(chess));
+    ASSERT_TEST(chessTraceOpen(chess, TRACE_FILE) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(runCalls(chess, 20), chessDestroy(chess));
+    ASSERT_TEST(chessTraceClose(chess) == CHESS_SUCCESS, chessDestroy(chess));
+
+    ChessTraceReader reader = chessTraceReaderOpen(TRACE_FILE, NULL);
+    ASSERT_TEST(reader != NULL && chessTraceReaderHasSnapshot(reader), chessTraceReaderClose(reader); chessDestroy(chess));
+    chessTraceReaderClose(reader);
+    ChessResult result;
+    ChessSystem replayed = chessLoadSnapshot(TRACE_SNAPSHOT_FILE, &result);
+    ASSERT_TEST(replayed != NULL && result == CHESS_SUCCESS, chessDestroy(chess));
+    long divergences;
+    ASSERT_TEST(replayTrace(replayed, &divergences) > 0 && divergences == 0, chessDestroy(replayed); chessDestroy(chess));
+    ASSERT_TEST(testSameSystems(chess, replayed, TEST_NUM_OF_PLAYERS), chessDestroy(replayed); chessDestroy(chess));
+
+    chessDestroy(replayed);
+    chessDestroy(chess);
+    return true;
+}
+
+bool testTraceRecords()
+{
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(chessTraceOpen(chess, TRACE_FILE) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddTournament(chess, 4, 2, "London") == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddGame(chess, 4, 7, 8, SECOND_PLAYER, 90) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddGame(chess, 4, 7, 8, DRAW, 90) == CHESS_GAME_ALREADY_EXISTS, chessDestroy(chess));
+    ChessResult result;
+    ASSERT_TEST(chessCalculateAveragePlayTime(chess, 8, &result) == 90.0, chessDestroy(chess));
+    ASSERT_TEST(chessSaveTournamentStatistics(chess, STATISTICS_FILE) == CHESS_NO_TOURNAMENTS_ENDED,
+                chessDestroy(chess));
+    // destroying the system closes the trace
+    chessDestroy(chess);
+
+    ChessTraceReader reader = chessTraceReaderOpen(TRACE_FILE, &result);
+    ASSERT_TEST(reader != NULL && result == CHESS_SUCCESS, );
+    ChessTraceRecord record;
+    ASSERT_TEST(chessTraceReaderNext(reader, &record), chessTraceReaderClose(reader));
+    ASSERT_TEST(record.call == CHESS_TRACE_ADD_TOURNAMENT && record.args[0] == 4 && record.args[1] == 2
+                    && strcmp(record.text, "London") == 0 && record.result == CHESS_SUCCESS,
+                chessTraceReaderClose(reader));
+    ASSERT_TEST(chessTraceReaderNext(reader, &record), chessTraceReaderClose(reader));
+    ASSERT_TEST(record.call == CHESS_TRACE_ADD_GAME && record.args[0] == 4 && record.args[1] == 7 && record.args[2] == 8
+                    && record.args[3] == SECOND_PLAYER && record.args[4] == 90 && record.result == CHESS_SUCCESS,
+                chessTraceReaderClose(reader));
+    ASSERT_TEST(chessTraceReaderNext(reader, &record), chessTraceReaderClose(reader));
+    ASSERT_TEST(record.call == CHESS_TRACE_ADD_GAME && record.args[3] == DRAW
+                    && record.result == CHESS_GAME_ALREADY_EXISTS,
+                chessTraceReaderClose(reader));
+    ASSERT_TEST(chessTraceReaderNext(reader, &record), chessTraceReaderClose(reader));
+    ASSERT_TEST(record.call == CHESS_TRACE_CALCULATE_AVERAGE_PLAY_TIME && record.args[0] == 8
+                    && record.average_play_time == 90.0,
+                chessTraceReaderClose(reader));
+    ASSERT_TEST(chessTraceReaderNext(reader, &record), chessTraceReaderClose(reader));
+    ASSERT_TEST(record.call == CHESS_TRACE_SAVE_TOURNAMENT_STATISTICS && strcmp(record.text, STATISTICS_FILE) == 0
+                    && record.result == CHESS_NO_TOURNAMENTS_ENDED,
+                chessTraceReaderClose(reader));
+    ASSERT_TEST(!chessTraceReaderNext(reader, &record), chessTraceReaderClose(reader));
+    chessTraceReaderClose(reader);
+    return true;
+}
+
+/**
+ * A record cut at the end of the file ends the trace, the records before it are read.
+ * */
+bool testTraceTornRecord()
+{
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(chessTraceOpen(chess, TRACE_FILE) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddTournament(chess, 4, 2, "London") == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessAddGame(chess, 4, 7, 8, SECOND_PLAYER, 90) == CHESS_SUCCESS, chessDestroy(chess));
+    chessDestroy(chess);
+    FILE* file = fopen(TRACE_FILE, "ab");
+    ASSERT_TEST(file != NULL, );
+    fputc(CHESS_TRACE_ADD_GAME, file);
+    fputc(4, file);
+    fclose(file);
+
+    ChessTraceReader reader = chessTraceReaderOpen(TRACE_FILE, NULL);
+    ASSERT_TEST(reader != NULL, );
+    ChessTraceRecord record;
+    ASSERT_TEST(chessTraceReaderNext(reader, &record) && chessTraceReaderNext(reader, &record),
+                chessTraceReaderClose(reader));
+    ASSERT_TEST(record.call == CHESS_TRACE_ADD_GAME && record.args[4] == 90, chessTraceReaderClose(reader));
+    ASSERT_TEST(!chessTraceReaderNext(reader, &record), chessTraceReaderClose(reader));
+    chessTraceReaderClose(reader);
+    return true;
+}
+
+bool testTraceArguments()
+{
+    ChessSystem chess = chessCreate();
+    ChessResult result;
+    ASSERT_TEST(chessTraceOpen(NULL, TRACE_FILE) == CHESS_NULL_ARGUMENT, chessDestroy(chess));
+    ASSERT_TEST(chessTraceOpen(chess, NULL) == CHESS_NULL_ARGUMENT, chessDestroy(chess));
+    ASSERT_TEST(chessTraceOpen(chess, "no_such_dir/trace") == CHESS_SAVE_FAILURE, chessDestroy(chess));
+    ASSERT_TEST(chessTraceClose(chess) == CHESS_SAVE_FAILURE, chessDestroy(chess));
+    ASSERT_TEST(chessTraceClose(NULL) == CHESS_NULL_ARGUMENT, chessDestroy(chess));
+    ASSERT_TEST(chessTraceReaderOpen(NULL, &result) == NULL && result == CHESS_NULL_ARGUMENT, chessDestroy(chess));
+    ASSERT_TEST(chessTraceReaderOpen("no_such_file.trace", &result) == NULL && result == CHESS_SAVE_FAILURE,
+                chessDestroy(chess));
+    // a file that is not a trace
+    ASSERT_TEST(chessSaveSnapshot(chess, TRACE_SNAPSHOT_FILE) == CHESS_SUCCESS, chessDestroy(chess));
+    ASSERT_TEST(chessTraceReaderOpen(TRACE_SNAPSHOT_FILE, &result) == NULL && result == CHESS_SAVE_FAILURE,
+                chessDestroy(chess));
+    ChessTraceRecord record;
+    ASSERT_TEST(!chessTraceReaderNext(NULL, &record), chessDestroy(chess));
+    chessTraceReaderClose(NULL);
+
+    chessDestroy(chess);
+    return true;
+}
+
+int main()
+{
+    RUN_TEST(testTraceReplaysWithoutDivergence, "testTraceReplaysWithoutDivergence");
+    RUN_TEST(testTraceFromSnapshot, "testTraceFromSnapshot");
+    RUN_TEST(testTraceRecords, "testTraceRecords");
+    RUN_TEST(testTraceTornRecord, "testTraceTornRecord");
+    RUN_TEST(testTraceArguments, "testTraceArguments");
+    return TEST_EXIT_STATUS;
+}
\ No newline at end of file
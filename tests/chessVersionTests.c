@@ -0,0 +1,167 @@
+#include <stdio.h>
+#include <pthread.h>
+#include "../chessSystem.h"
+#include "../chessSystemExt.h"
+#include "chessTestUtilities.h"
+
+#define NUM_OF_WRITERS 4
+#define NUM_OF_READERS 3
+#define NUM_OF_PLAYERS 100
+#define GAMES_PER_WRITER 2000
+#define NUM_OF_READS 400
+#define PLAY_TIME 42
+
+typedef struct {
+    ChessSystem chess;
+    int tournament_id;
+    bool failed;
+} Thread;
+
+bool testVersionsLikeSystem()
+{
+    ChessSystem chess = chessCreate();
+    ChessSystem expected = chessCreate();
+    ASSERT_TEST(chessEnableSnapshotReads(chess) == CHESS_SUCCESS, chessDestroy(chess); chessDestroy(expected));
+    ASSERT_TEST(testRunOnBoth(chess, expected, 1, 20), chessDestroy(chess); chessDestroy(expected));
+    // calling it again does nothing
+    ASSERT_TEST(chessEnableSnapshotReads(chess) == CHESS_SUCCESS, chessDestroy(chess); chessDestroy(expected));
+    ASSERT_TEST(testRunOnBoth(chess, expected, 100, 5), chessDestroy(chess); chessDestroy(expected));
+    for (int player_id = 1; player_id <= TEST_NUM_OF_PLAYERS; player_id += 2)
+    {
+        ASSERT_TEST(chessRemovePlayer(chess, player_id) == chessRemovePlayer(expected, player_id),
+                    chessDestroy(chess); chessDestroy(expected));
+    }
+    ASSERT_TEST(testSameSystems(chess, expected, TEST_NUM_OF_PLAYERS), chessDestroy(chess); chessDestroy(expected));
+
+    chessDestroy(chess);
+    chessDestroy(expected);
+    return true;
+}
+
+/**
+ * The first version of a system that is not empty holds all of it.
+ * */
+bool testVersionsOfNonEmptySystem()
+{
+    ChessSystem chess = chessCreate();
+    ChessSystem expected = chessCreate();
+    ASSERT_TEST(testRunOperations(chess, 5, 3000) && testRunOperations(expected, 5, 3000),
+                chessDestroy(chess); chessDestroy(expected));
+    ASSERT_TEST(chessEnableSnapshotReads(chess) == CHESS_SUCCESS, chessDestroy(chess); chessDestroy(expected));
+    ASSERT_TEST(testSameSystems(chess, expected, TEST_NUM_OF_PLAYERS), chessDestroy(chess); chessDestroy(expected));
+    ASSERT_TEST(testRunOnBoth(chess, expected, 6, 10), chessDestroy(chess); chessDestroy(expected));
+
+    chessDestroy(chess);
+    chessDestroy(expected);
+    return true;
+}
+
+static void* writeGames(void* argument)
+{
+    Thread* writer = (Thread*)argument;
+    for (int i = 0; i < GAMES_PER_WRITER; i++)
+    {
+        int player1 = 1 + i % NUM_OF_PLAYERS;
+        int player2 = 1 + (player1 + i / NUM_OF_PLAYERS) % NUM_OF_PLAYERS;
+        ChessResult result = chessAddGame(writer->chess, writer->tournament_id, player1, player2,
+                                          (Winner)(i % 3), PLAY_TIME);
+        writer->failed = writer->failed || result != CHESS_SUCCESS;
+    }
+    return NULL;
+}
+
+/**
+ * Every game takes PLAY_TIME, so a query that reads the total time of a player and its number of games
+ * from two different states of the system gets another average.
+ * */
+static void* readAverages(void* argument)
+{
+    Thread* reader = (Thread*)argument;
+    FILE* file = fopen("/dev/null", "w");
+    reader->failed = file == NULL;
+    for (int i = 0; i < NUM_OF_READS && !reader->failed; i++)
+    {
+        for (int player_id = 1; player_id <= NUM_OF_PLAYERS && !reader->failed; player_id += 7)
+        {
+            ChessResult result;
+            double average = chessCalculateAveragePlayTime(reader->chess, player_id, &result);
+            reader->failed = result == CHESS_SUCCESS ? average != PLAY_TIME : result != CHESS_PLAYER_NOT_EXIST;
+        }
+        reader->failed = reader->failed || chessSavePlayersLevels(reader->chess, file) != CHESS_SUCCESS;
+    }
+    if (file != NULL)
+    {
+        fclose(file);
+    }
+    return NULL;
+}
+
+/**
+ * Queries read whole versions while several threads add games.
+ * */
+bool testVersionsWhileWriting()
+{
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(chessEnableConcurrency(chess) == CHESS_SUCCESS && chessEnableSnapshotReads(chess) == CHESS_SUCCESS,
+                chessDestroy(chess));
+    Thread writers[NUM_OF_WRITERS];
+    Thread readers[NUM_OF_READERS];
+    pthread_t writer_threads[NUM_OF_WRITERS];
+    pthread_t reader_threads[NUM_OF_READERS];
+    for (int i = 0; i < NUM_OF_WRITERS; i++)
+    {
+        ASSERT_TEST(chessAddTournament(chess, i + 1, GAMES_PER_WRITER, "London") == CHESS_SUCCESS, chessDestroy(chess));
+        writers[i] = (Thread){ chess, i + 1, false };
+    }
+    for (int i = 0; i < NUM_OF_READERS; i++)
+    {
+        readers[i] = (Thread){ chess, 0, false };
+        pthread_create(&reader_threads[i], NULL, readAverages, &readers[i]);
+    }
+    for (int i = 0; i < NUM_OF_WRITERS; i++)
+    {
+        pthread_create(&writer_threads[i], NULL, writeGames, &writers[i]);
+    }
+    bool failed = false;
+    for (int i = 0; i < NUM_OF_WRITERS; i++)
+    {
+        pthread_join(writer_threads[i], NULL);
+        failed = failed || writers[i].failed;
+    }
+    for (int i = 0; i < NUM_OF_READERS; i++)
+    {
+        pthread_join(reader_threads[i], NULL);
+        failed = failed || readers[i].failed;
+    }
+    ASSERT_TEST(!failed, chessDestroy(chess));
+
+    // and the last version is the system as it was left
+    ChessSystem expected = chessCreate();
+    for (int i = 0; i < NUM_OF_WRITERS; i++)
+    {
+        ASSERT_TEST(chessAddTournament(expected, i + 1, GAMES_PER_WRITER, "London") == CHESS_SUCCESS,
+                    chessDestroy(chess); chessDestroy(expected));
+        writers[i] = (Thread){ expected, i + 1, false };
+        writeGames(&writers[i]);
+    }
+    ASSERT_TEST(testSameSystems(chess, expected, NUM_OF_PLAYERS), chessDestroy(chess); chessDestroy(expected));
+
+    chessDestroy(chess);
+    chessDestroy(expected);
+    return true;
+}
+
+bool testVersionsArguments()
+{
+    ASSERT_TEST(chessEnableSnapshotReads(NULL) == CHESS_NULL_ARGUMENT, );
+    return true;
+}
+
+int main()
+{
+    RUN_TEST(testVersionsLikeSystem, "testVersionsLikeSystem");
+    RUN_TEST(testVersionsOfNonEmptySystem, "testVersionsOfNonEmptySystem");
+    RUN_TEST(testVersionsWhileWriting, "testVersionsWhileWriting");
+    RUN_TEST(testVersionsArguments, "testVersionsArguments");
+    return TEST_EXIT_STATUS;
+}
\ No newline at end of file